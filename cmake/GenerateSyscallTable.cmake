@@ -0,0 +1,57 @@
+# Generates the syscall tables used by the x86 ArchProcessor from syscalls.xml,
+# so that describing a syscall is an array lookup instead of an XML query.
+#
+# usage: cmake -DINPUT=syscalls.xml -DOUTPUT=SyscallTableData.h -P GenerateSyscallTable.cmake
+#
+# Each table is indexed by syscall number, numbers which have no syscall get
+# an entry without a name.
+
+file(STRINGS "${INPUT}" LINES)
+
+set(ARCHES)
+foreach(LINE IN LISTS LINES)
+	if(LINE MATCHES "<linux arch=\"([^\"]+)\">")
+		string(MAKE_C_IDENTIFIER "${CMAKE_MATCH_1}" ARCH)
+		string(TOUPPER "${ARCH}" ARCH)
+		list(APPEND ARCHES "${ARCH}")
+		set(MAX_${ARCH} -1)
+	elseif(LINE MATCHES "<syscall name=\"([^\"]+)\">")
+		set(NAME "${CMAKE_MATCH_1}")
+		set(INDEX)
+		set(ARGUMENTS)
+		set(ARGUMENT_COUNT 0)
+	elseif(LINE MATCHES "<index>([0-9]+)</index>")
+		set(INDEX "${CMAKE_MATCH_1}")
+	elseif(LINE MATCHES "<argument type=\"([^\"]*)\" register=\"([^\"]*)\"/>")
+		list(APPEND ARGUMENTS "{\"${CMAKE_MATCH_1}\", \"${CMAKE_MATCH_2}\"}")
+		math(EXPR ARGUMENT_COUNT "${ARGUMENT_COUNT} + 1")
+	elseif(LINE MATCHES "</syscall>")
+		if("${INDEX}" STREQUAL "")
+			message(FATAL_ERROR "syscall ${NAME} has no index")
+		endif()
+		if(DEFINED ENTRY_${ARCH}_${INDEX})
+			message(FATAL_ERROR "syscall ${NAME} has the same index as another one")
+		endif()
+
+		string(REPLACE ";" ", " ARGUMENTS "${ARGUMENTS}")
+		set(ENTRY_${ARCH}_${INDEX} "{\"${NAME}\", ${ARGUMENT_COUNT}, {${ARGUMENTS}}}")
+		if(INDEX GREATER MAX_${ARCH})
+			set(MAX_${ARCH} ${INDEX})
+		endif()
+	endif()
+endforeach()
+
+set(OUTPUT_TEXT "// generated from syscalls.xml by GenerateSyscallTable.cmake, do not edit\n")
+foreach(ARCH IN LISTS ARCHES)
+	string(APPEND OUTPUT_TEXT "\ninline constexpr SyscallEntry Syscalls${ARCH}[] = {\n")
+	foreach(INDEX RANGE 0 ${MAX_${ARCH}})
+		if(DEFINED ENTRY_${ARCH}_${INDEX})
+			string(APPEND OUTPUT_TEXT "\t${ENTRY_${ARCH}_${INDEX}}, // ${INDEX}\n")
+		else()
+			string(APPEND OUTPUT_TEXT "\t{nullptr, 0, {}}, // ${INDEX}\n")
+		endif()
+	endforeach()
+	string(APPEND OUTPUT_TEXT "};\n")
+endforeach()
+
+file(WRITE "${OUTPUT}" "${OUTPUT_TEXT}")
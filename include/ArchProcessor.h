@@ -43,6 +43,7 @@ public:
 public:
 	QStringList updateInstructionInfo(edb::address_t address);
 	bool canStepOver(const edb::Instruction &inst) const;
+	bool changesMemoryMap(const edb::Instruction &inst, const State &state) const;
 	bool isFilling(const edb::Instruction &inst) const;
 	//! Checks whether potentially conditional instruction's condition is satisfied
 	bool isExecuted(const edb::Instruction &inst, const State &state) const;
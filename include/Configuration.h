@@ -21,7 +21,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "API.h"
 #include "IBreakpoint.h"
+#include "IDebugger.h"
 #include <QList>
+#include <QMap>
 #include <QObject>
 #include <QString>
 
@@ -33,6 +35,7 @@ public:
 
 public:
 	void sendChangeNotification();
+	QMap<qlonglong, IDebugger::ExceptionDisposition> exceptionDispositions() const;
 
 Q_SIGNALS:
 	void settingsUpdated();
@@ -90,6 +93,7 @@ public:
 	bool disableASLR;
 	bool disableLazyBinding;
 	bool break_on_library_load;
+	bool nonstop_mode;
 	IBreakpoint::TypeId default_breakpoint_type;
 	QString tty_command;
 
@@ -115,6 +119,7 @@ public:
 	// Exceptions tab
 	bool enable_signals_message_box;
 	QList<qlonglong> ignored_exceptions;
+	QList<qlonglong> logged_exceptions;
 
 protected:
 	void readSettings();
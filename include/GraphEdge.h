@@ -20,15 +20,17 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define GRAPH_EDGE_H_20090903_
 
 #include <QColor>
-#include <QGraphicsItemGroup>
-#include <graphviz/cgraph.h>
-#include <graphviz/gvc.h>
+#include <QGraphicsItem>
+#include <QLineF>
+#include <QPolygonF>
 
 class GraphWidget;
 class GraphNode;
-class GraphicsLineItem;
 
-class GraphEdge final : public QGraphicsItemGroup {
+// below this level of detail, edges are drawn without their arrow heads
+constexpr qreal MinimumArrowDetail = 0.4;
+
+class GraphEdge final : public QGraphicsItem {
 public:
 	GraphEdge(GraphNode *from, GraphNode *to, const QColor &color = Qt::black, QGraphicsItem *parent = nullptr);
 	GraphEdge(const GraphEdge &)            = delete;
@@ -56,20 +58,22 @@ public:
 public:
 	void updateLines();
 
+public:
+	void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+	QRectF boundingRect() const override;
+	QPainterPath shape() const override;
+
 protected:
 	void createLine();
-	QGraphicsPolygonItem *addArrowHead(const QLineF &line);
-	QGraphicsPolygonItem *addArrowHead(const QLineF &line, int lineThickness, const QColor &color, int ZValue);
 	QLineF shortenLineToNode(QLineF line);
-	QGraphicsLineItem *createLineSegment(const QPointF &p1, const QPointF &p2, const QPen &pen);
-	QGraphicsLineItem *createLineSegment(const QLineF &line, const QPen &pen);
 
 protected:
 	GraphNode *from_    = nullptr;
 	GraphNode *to_      = nullptr;
 	GraphWidget *graph_ = nullptr;
-	Agedge_t *edge_     = nullptr;
 	QColor color_;
+	QLineF line_;
+	QPolygonF arrowHead_;
 };
 
 #endif
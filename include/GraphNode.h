@@ -22,8 +22,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QGraphicsItem>
 #include <QPicture>
 #include <QSet>
-#include <graphviz/cgraph.h>
-#include <graphviz/gvc.h>
 
 class QVariant;
 
@@ -36,6 +34,9 @@ constexpr int NodeHeight        = 50;
 constexpr int LabelFontSize     = 10;
 constexpr int BorderScaleFactor = 4;
 
+// below this level of detail, nodes are drawn as plain boxes
+constexpr qreal MinimumLabelDetail = 0.4;
+
 class GraphNode final : public QGraphicsItem {
 	friend class GraphWidget;
 	friend class GraphEdge;
@@ -77,7 +78,6 @@ protected:
 	QColor color_;
 	GraphWidget *graph_ = nullptr;
 	QSet<GraphEdge *> edges_;
-	Agnode_t *node_ = nullptr;
 };
 
 #endif
@@ -20,15 +20,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define GRAPH_WIDGET_H_20090903_
 
 #include <QGraphicsView>
-#include <graphviz/cgraph.h>
-#include <graphviz/gvcext.h>
+#include <QPointF>
+#include <QSet>
+#include <vector>
 
+class GraphEdge;
 class GraphNode;
 class QContextMenuEvent;
 class QGraphicsScene;
 class QLabel;
 class QMouseEvent;
+class QProgressBar;
 class QString;
+class QTimer;
 
 class GraphWidget final : public QGraphicsView {
 	Q_OBJECT
@@ -48,6 +52,7 @@ public:
 public Q_SLOTS:
 	void setScale(qreal factor);
 	void setHUDNotification(const QString &s, int duration = 1000);
+	void cancelLayout();
 
 Q_SIGNALS:
 	void backgroundContextMenuEvent(QContextMenuEvent *event);
@@ -63,16 +68,29 @@ protected:
 	void mouseDoubleClickEvent(QMouseEvent *event) override;
 
 private:
-	void setGraphAttribute(const QString name, const QString value);
-	void setNodeAttribute(const QString name, const QString value);
-	void setEdgeAttribute(const QString name, const QString value);
+	void addNode(GraphNode *node);
+	void removeNode(GraphNode *node);
+	void addEdge(GraphEdge *edge);
+	void removeEdge(GraphEdge *edge);
+	void applyLayout(const std::vector<GraphNode *> &nodes, const std::vector<QPointF> &points);
+	void populateBatch();
 
 private:
-	bool inLayout_      = false;
-	QLayout *HUDLayout_ = nullptr;
-	QLabel *HUDLabel_   = nullptr;
-	GVC_t *context_     = nullptr;
-	Agraph_t *graph_    = nullptr;
+	bool inLayout_                = false;
+	QLayout *HUDLayout_           = nullptr;
+	QLabel *HUDLabel_             = nullptr;
+	QWidget *layoutPanel_         = nullptr;
+	QLabel *layoutStatus_         = nullptr;
+	QProgressBar *layoutProgress_ = nullptr;
+	QTimer *populateTimer_        = nullptr;
+	int layoutGeneration_         = 0;
+	QSet<GraphNode *> nodes_;
+	QSet<GraphEdge *> edges_;
+
+	// the items still to be added to the scene, or updated, after a layout
+	std::vector<GraphNode *> pendingNodes_;
+	std::vector<GraphEdge *> pendingEdges_;
+	std::size_t pendingDone_ = 0;
 };
 
 #endif
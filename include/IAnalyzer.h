@@ -21,9 +21,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Function.h"
 #include "Types.h"
+#include <QFuture>
 #include <QSet>
 #include <functional>
 #include <memory>
+#include <vector>
 
 class IRegion;
 
@@ -45,16 +47,32 @@ public:
 		ADDRESS_FUNC_END     = 0x04
 	};
 
+public:
+	// a lightweight description of an analyzed function, pointers to these (and
+	// to the function they describe) stay valid until the analysis changes
+	struct FunctionRange {
+		edb::address_t entryAddress;
+		edb::address_t endAddress;
+		Function::Type type;
+		const Function *function;
+	};
+
 public:
 	virtual AddressCategory category(edb::address_t address) const              = 0;
 	virtual FunctionMap functions(const std::shared_ptr<IRegion> &region) const = 0;
 	virtual FunctionMap functions() const                                       = 0;
 	virtual QSet<edb::address_t> specifiedFunctions() const { return {}; }
+	virtual std::vector<edb::address_t> referencesTo(edb::address_t) const { return {}; }
 	virtual Result<edb::address_t, QString> findContainingFunction(edb::address_t address) const                                = 0;
-	virtual void analyze(const std::shared_ptr<IRegion> &region)                                                                = 0;
+	virtual QFuture<void> analyze(const std::shared_ptr<IRegion> &region)                                                       = 0;
+	virtual void cancelAnalysis(const std::shared_ptr<IRegion> &region)                                                         = 0;
+	virtual bool analysisPending(const std::shared_ptr<IRegion> &region) const                                                  = 0;
 	virtual void invalidateAnalysis()                                                                                           = 0;
 	virtual void invalidateAnalysis(const std::shared_ptr<IRegion> &region)                                                     = 0;
 	virtual bool forFuncsInRange(edb::address_t start, edb::address_t end, std::function<bool(const Function *)> functor) const = 0;
+	virtual bool forEachFunction(std::function<bool(const Function *)> functor) const                                           = 0;
+	virtual const FunctionRange *findFunctionRange(edb::address_t address) const                                                = 0;
+	virtual const Function *findFunction(edb::address_t address) const                                                          = 0;
 };
 
 #endif
@@ -21,12 +21,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "IBreakpoint.h"
 #include "OSTypes.h"
+#include "ProcessInfo.h"
 #include "Types.h"
 #include <QByteArray>
 #include <QHash>
 #include <QMap>
 #include <QString>
 #include <QtPlugin>
+#include <array>
 #include <chrono>
 #include <memory>
 #include <vector>
@@ -58,6 +60,23 @@ public:
 #endif
 	};
 
+	enum class WatchpointType {
+		Write,
+		ReadWrite,
+	};
+
+	struct Watchpoint {
+		edb::address_t address;
+		size_t size;
+		WatchpointType type;
+	};
+
+	enum class ExceptionDisposition {
+		Stop,       // report it like any other event
+		Pass,       // pass it to the application without stopping
+		LogAndPass, // the same, but note it in the log
+	};
+
 public:
 	// system properties
 	virtual std::size_t pageSize() const                  = 0;
@@ -81,6 +100,7 @@ public:
 	// general process data
 	virtual edb::pid_t parentPid(edb::pid_t pid) const                             = 0;
 	virtual QMap<edb::pid_t, std::shared_ptr<IProcess>> enumerateProcesses() const = 0;
+	virtual QMap<edb::pid_t, ProcessInfo> enumerateProcessInfo() const             = 0;
 
 public:
 	// basic process management
@@ -91,6 +111,15 @@ public:
 	virtual void kill()                                                                                                                      = 0;
 	virtual void endDebugSession()                                                                                                           = 0;
 
+public:
+	// post-mortem debugging, the process of a core file can be inspected like
+	// a paused process, but never resumed
+	virtual Status openCore(const QString &path) = 0;
+
+	// writes the paused process out as a core file, read only file mappings
+	// may be left out since they can be read from the files themselves
+	virtual Status generateCore(const QString &path, bool skipReadOnlyFiles) = 0;
+
 public:
 	// basic breakpoint managment
 	// TODO(eteran): these should be logically moved to IProcess
@@ -103,7 +132,24 @@ public:
 	virtual std::vector<IBreakpoint::BreakpointType> supportedBreakpointTypes() const    = 0;
 
 public:
-	virtual void setIgnoredExceptions(const QList<qlonglong> &exceptions) = 0;
+	// software watchpoints, unlike the hardware ones these aren't limited in
+	// number or size, but they are much slower to trigger
+	virtual Status addWatchpoint(edb::address_t address, size_t size, WatchpointType type) = 0;
+	virtual Status removeWatchpoint(edb::address_t address)                                = 0;
+	virtual std::vector<Watchpoint> watchpoints() const                                    = 0;
+
+public:
+	// the debug registers of the hardware breakpoints which are set on every
+	// thread, threads created later on are given the same ones
+	virtual void setDebugRegisterTemplate(const std::array<edb::reg_t, 8> &values) = 0;
+
+public:
+	// exceptions which aren't in the table stop
+	virtual void setExceptionDispositions(const QMap<qlonglong, ExceptionDisposition> &dispositions) = 0;
+
+	// how many of each exception were passed to the application without
+	// stopping, since it was started or attached to
+	virtual QMap<qlonglong, uint64_t> passedExceptionCounts() const = 0;
 
 public:
 	virtual std::unique_ptr<IState> createState() const = 0;
@@ -74,6 +74,22 @@ public:
 	virtual Status step(edb::EventStatus status)                                         = 0;
 	virtual bool isPaused() const                                                        = 0;
 	virtual QMap<edb::address_t, Patch> patches() const                                  = 0;
+
+public:
+	// act on a single thread, leaving the others as they are
+	virtual Status pause(IThread &thread)                           = 0;
+	virtual Status resume(IThread &thread, edb::EventStatus status) = 0;
+	virtual Status step(IThread &thread, edb::EventStatus status)   = 0;
+
+	// steps <thread> off of the breakpoint it is stopped on without removing
+	// the breakpoint, so that other threads can't run past it meanwhile. This
+	// fails for instructions which can't be stepped that way, in which case
+	// the caller has to disable the breakpoint for the step instead
+	virtual Status stepOverBreakpoint(IThread &thread, edb::EventStatus status) = 0;
+
+	// like stepOverBreakpoint, but then resumes the whole process without
+	// reporting the end of the step, unless something else happened on it
+	virtual Status runOverBreakpoint(IThread &thread, edb::EventStatus status) = 0;
 };
 
 #endif
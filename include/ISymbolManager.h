@@ -33,18 +33,19 @@ public:
 	virtual ~ISymbolManager() = default;
 
 public:
-	virtual const std::vector<std::shared_ptr<Symbol>> symbols() const                 = 0;
-	virtual const std::shared_ptr<Symbol> find(const QString &name) const              = 0;
-	virtual const std::shared_ptr<Symbol> find(edb::address_t address) const           = 0;
-	virtual const std::shared_ptr<Symbol> findNearSymbol(edb::address_t address) const = 0;
-	virtual void addSymbol(const std::shared_ptr<Symbol> &symbol)                      = 0;
-	virtual void clear()                                                               = 0;
-	virtual void loadSymbolFile(const QString &filename, edb::address_t base)          = 0;
-	virtual void setSymbolGenerator(ISymbolGenerator *generator)                       = 0;
-	virtual void setLabel(edb::address_t address, const QString &label)                = 0;
-	virtual QString findAddressName(edb::address_t address, bool prefixed = true)      = 0;
-	virtual QHash<edb::address_t, QString> labels() const                              = 0;
-	virtual QStringList files() const                                                  = 0;
+	virtual const std::vector<std::shared_ptr<Symbol>> symbols() const                                = 0;
+	virtual const std::shared_ptr<Symbol> find(const QString &name) const                             = 0;
+	virtual const std::shared_ptr<Symbol> find(edb::address_t address) const                          = 0;
+	virtual const std::shared_ptr<Symbol> findNearSymbol(edb::address_t address) const                = 0;
+	virtual std::vector<std::shared_ptr<Symbol>> search(const QString &text, std::size_t limit) const = 0;
+	virtual void addSymbol(const std::shared_ptr<Symbol> &symbol)                                     = 0;
+	virtual void clear()                                                                              = 0;
+	virtual void loadSymbolFile(const QString &filename, edb::address_t base)                         = 0;
+	virtual void setSymbolGenerator(ISymbolGenerator *generator)                                      = 0;
+	virtual void setLabel(edb::address_t address, const QString &label)                               = 0;
+	virtual QString findAddressName(edb::address_t address, bool prefixed = true)                     = 0;
+	virtual QHash<edb::address_t, QString> labels() const                                             = 0;
+	virtual QStringList files() const                                                                 = 0;
 };
 
 #endif
@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QAbstractItemModel>
 #include <QList>
 #include <memory>
+#include <vector>
 
 class IRegion;
 
@@ -43,13 +44,34 @@ public:
 	~MemoryRegions() override = default;
 
 public:
-	std::shared_ptr<IRegion> findRegion(edb::address_t address) const;
+	std::shared_ptr<IRegion> findRegion(edb::address_t address);
 	const QList<std::shared_ptr<IRegion>> &regions() const { return regions_; }
+	bool isStale() const { return stale_; }
 	void clear();
+	void invalidate();
+	void revalidate();
 	void sync();
 
+private:
+	void buildIndex();
+
+private:
+	struct RegionRange {
+		edb::address_t start;
+		edb::address_t end;
+		int row;
+	};
+
 private:
 	QList<std::shared_ptr<IRegion>> regions_;
+
+	// regions_ sorted by start address, for fast lookups by address
+	std::vector<RegionRange> index_;
+	size_t lastHit_ = 0;
+
+	// set when the process may have changed its memory map since the last
+	// sync, the regions are then read again the next time they are needed
+	bool stale_ = false;
 };
 
 #endif
@@ -0,0 +1,91 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MEMORY_SNAPSHOT_H_20261019_
+#define MEMORY_SNAPSHOT_H_20261019_
+
+#include "API.h"
+#include "Types.h"
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <memory>
+#include <vector>
+
+class IRegion;
+
+// The contents of a set of regions at one point in time. Every page is stored
+// along with a hash of its contents. When a snapshot is taken relative to a
+// previous one, pages which hash the same share the previous snapshot's copy,
+// so a series of snapshots only costs the pages which actually changed.
+class EDB_EXPORT MemorySnapshot {
+public:
+	struct Page {
+		uint64_t hash = 0;
+		std::shared_ptr<const QByteArray> bytes; // null if the page couldn't be read
+	};
+
+	struct Region {
+		edb::address_t start;
+		edb::address_t end;
+		QString name;
+		std::vector<Page> pages;
+	};
+
+public:
+	static std::shared_ptr<const MemorySnapshot> capture(const QList<std::shared_ptr<IRegion>> &regions, const std::shared_ptr<const MemorySnapshot> &previous = nullptr);
+
+public:
+	MemorySnapshot()                                  = default;
+	MemorySnapshot(const MemorySnapshot &)            = delete;
+	MemorySnapshot &operator=(const MemorySnapshot &) = delete;
+
+public:
+	const std::vector<Region> &regions() const { return regions_; }
+	const Region *findRegion(edb::address_t address) const;
+	size_t pageSize() const { return pageSize_; }
+
+private:
+	std::vector<Region> regions_;
+	size_t pageSize_ = 0;
+};
+
+// The bytes which differ between two snapshots
+class EDB_EXPORT MemoryDiff {
+public:
+	struct Range {
+		edb::address_t start;
+		edb::address_t end;
+	};
+
+public:
+	MemoryDiff() = default;
+	MemoryDiff(const MemorySnapshot &before, const MemorySnapshot &after);
+
+public:
+	const std::vector<Range> &ranges() const { return ranges_; }
+	const std::vector<edb::address_t> &pages() const { return pages_; }
+	bool isEmpty() const { return ranges_.empty(); }
+	bool changed(edb::address_t address, size_t size = 1) const;
+
+private:
+	std::vector<Range> ranges_;         // sorted and non-overlapping
+	std::vector<edb::address_t> pages_; // sorted
+};
+
+#endif
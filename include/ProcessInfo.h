@@ -0,0 +1,42 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROCESS_INFO_H_20261019_
+#define PROCESS_INFO_H_20261019_
+
+#include "OSTypes.h"
+#include <QString>
+
+// A cheap snapshot of a process which isn't being debugged, just enough to
+// list it for the user
+struct ProcessInfo {
+	edb::pid_t pid;
+	edb::uid_t uid;
+	QString user;
+	QString name;
+};
+
+inline bool operator==(const ProcessInfo &lhs, const ProcessInfo &rhs) {
+	return lhs.pid == rhs.pid && lhs.uid == rhs.uid && lhs.user == rhs.user && lhs.name == rhs.name;
+}
+
+inline bool operator!=(const ProcessInfo &lhs, const ProcessInfo &rhs) {
+	return !(lhs == rhs);
+}
+
+#endif
@@ -28,6 +28,7 @@ class Register;
 class QString;
 
 namespace DebuggerCorePlugin {
+class CoreThread;
 class DebuggerCore;
 class PlatformThread;
 }
@@ -38,6 +39,7 @@ class EDB_EXPORT State {
 
 	// TODO(eteran): I don't like needing to do this
 	// need to revisit the IState/State/PlatformState stuff...
+	friend class DebuggerCorePlugin::CoreThread;
 	friend class DebuggerCorePlugin::DebuggerCore;
 	friend class DebuggerCorePlugin::PlatformThread;
 
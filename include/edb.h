@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "IBinary.h"
 #include "Status.h"
 #include "Types.h"
+#include <QHash>
 #include <QMap>
 #include <QPointer>
 #include <QStringList>
@@ -40,6 +41,7 @@ class IDebugger;
 class IPlugin;
 class IRegion;
 class ISymbolManager;
+class MemoryDiff;
 class MemoryRegions;
 class Register;
 class State;
@@ -99,6 +101,14 @@ EDB_EXPORT void toggle_breakpoint(address_t address);
 
 EDB_EXPORT address_t current_data_view_address();
 
+// memory change tracking, regions are identified by their start address
+EDB_EXPORT void set_region_tracked(address_t region_start, bool tracked);
+EDB_EXPORT bool region_tracked(address_t region_start);
+EDB_EXPORT const MemoryDiff &memory_changes();
+
+// profiling, sample counts per instruction are shown as heat in the disassembly view
+EDB_EXPORT void set_instruction_heat(const QHash<address_t, uint64_t> &samples);
+
 // change what the various views show
 EDB_EXPORT bool dump_data_range(address_t address, address_t end_address, bool new_tab);
 EDB_EXPORT bool dump_data_range(address_t address, address_t end_address);
@@ -0,0 +1,341 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "AnalysisCache.h"
+#include "IRegion.h"
+#include "edb.h"
+#include "libELF/elf_header.h"
+#include "libELF/elf_model.h"
+#include "libELF/elf_nhdr.h"
+#include "libELF/elf_phdr.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <cstring>
+
+namespace AnalyzerPlugin {
+
+namespace {
+
+constexpr quint32 CacheMagic   = 0x41424445; // "EDBA"
+constexpr quint32 CacheVersion = 2;
+
+/**
+ * @brief align4
+ * @param n
+ * @return
+ */
+constexpr size_t align4(size_t n) {
+	return (n + 3) & ~size_t(3);
+}
+
+/**
+ * @brief find_build_id
+ * @param base the start of the mapped ELF file
+ * @param size the size of the mapped ELF file
+ * @return the contents of the NT_GNU_BUILD_ID note, or an empty array if there isn't one
+ */
+template <class M>
+QByteArray find_build_id(const uint8_t *base, size_t size) {
+
+	using elf_header = typename M::elf_header;
+	using elf_phdr   = typename M::elf_phdr;
+	using elf_nhdr   = typename M::elf_nhdr;
+
+	if (size < sizeof(elf_header)) {
+		return {};
+	}
+
+	auto header = reinterpret_cast<const elf_header *>(base);
+	if (header->e_phoff == 0 || header->e_phoff + header->e_phnum * sizeof(elf_phdr) > size) {
+		return {};
+	}
+
+	auto phdr = reinterpret_cast<const elf_phdr *>(base + header->e_phoff);
+	for (size_t i = 0; i < header->e_phnum; ++i) {
+		if (phdr[i].p_type != PT_NOTE || phdr[i].p_offset + phdr[i].p_filesz > size) {
+			continue;
+		}
+
+		const uint8_t *p         = base + phdr[i].p_offset;
+		const uint8_t *const end = p + phdr[i].p_filesz;
+
+		while (static_cast<size_t>(end - p) >= sizeof(elf_nhdr)) {
+			auto note = reinterpret_cast<const elf_nhdr *>(p);
+
+			const uint8_t *const name = p + sizeof(elf_nhdr);
+			const uint8_t *const desc = name + align4(note->n_namesz);
+			if (desc > end || static_cast<size_t>(end - desc) < note->n_descsz) {
+				break;
+			}
+
+			if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == sizeof(ELF_NOTE_GNU) && std::memcmp(name, ELF_NOTE_GNU, sizeof(ELF_NOTE_GNU)) == 0) {
+				return QByteArray(reinterpret_cast<const char *>(desc), static_cast<int>(note->n_descsz));
+			}
+
+			p = desc + align4(note->n_descsz);
+		}
+	}
+
+	return {};
+}
+
+/**
+ * @brief read_module_identity
+ * @param filename
+ * @return the ELF build-id of the file if it has one, otherwise the MD5 of the whole file
+ */
+QByteArray read_module_identity(const QString &filename) {
+
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return {};
+	}
+
+	QByteArray build_id;
+	if (auto ptr = file.map(0, file.size(), QFile::NoOptions)) {
+		if (file.size() > EI_CLASS && std::memcmp(ptr, ELFMAG, SELFMAG) == 0) {
+			switch (ptr[EI_CLASS]) {
+			case ELFCLASS32:
+				build_id = find_build_id<elf_model<32>>(ptr, static_cast<size_t>(file.size()));
+				break;
+			case ELFCLASS64:
+				build_id = find_build_id<elf_model<64>>(ptr, static_cast<size_t>(file.size()));
+				break;
+			}
+		}
+		file.unmap(ptr);
+	}
+
+	if (!build_id.isEmpty()) {
+		return build_id;
+	}
+
+	return edb::v1::get_file_md5(filename);
+}
+
+/**
+ * @brief module_identity
+ *
+ * Like read_module_identity, but only reads each file once for as long as it
+ * stays the same size and isn't modified. This is called from the analysis
+ * threads.
+ *
+ * @param filename
+ * @return
+ */
+QByteArray module_identity(const QString &filename) {
+
+	struct Identity {
+		qint64 size;
+		QDateTime modified;
+		QByteArray identity;
+	};
+
+	static QMutex mutex;
+	static QHash<QString, Identity> identities;
+
+	const QFileInfo info(filename);
+
+	QMutexLocker locker(&mutex);
+
+	auto it = identities.constFind(filename);
+	if (it != identities.constEnd() && it->size == info.size() && it->modified == info.lastModified()) {
+		return it->identity;
+	}
+
+	// NOTE(eteran): hashing a large file takes a while, but holding the lock
+	// meanwhile keeps two threads from hashing the same one
+	const QByteArray identity = read_module_identity(filename);
+	if (!identity.isEmpty()) {
+		identities.insert(filename, Identity{info.size(), info.lastModified(), identity});
+	}
+
+	return identity;
+}
+
+/**
+ * @brief operator <<
+ * @param stream
+ * @param values
+ * @return
+ */
+QDataStream &operator<<(QDataStream &stream, const std::vector<quint64> &values) {
+	stream << static_cast<quint64>(values.size());
+	for (quint64 value : values) {
+		stream << value;
+	}
+	return stream;
+}
+
+/**
+ * @brief operator >>
+ * @param stream
+ * @param values
+ * @return
+ */
+QDataStream &operator>>(QDataStream &stream, std::vector<quint64> &values) {
+	quint64 count;
+	stream >> count;
+
+	values.clear();
+	for (quint64 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+		quint64 value;
+		stream >> value;
+		values.push_back(value);
+	}
+	return stream;
+}
+
+}
+
+/**
+ * @brief analysis_cache_file
+ * @param region
+ * @return the name of the file which holds the cached analysis of <region>,
+ * or an empty string if the region isn't backed by a file we can identify
+ */
+QString analysis_cache_file(const std::shared_ptr<IRegion> &region) {
+
+	const QString name = region->name();
+	if (name.isEmpty() || !QFileInfo(name).isFile()) {
+		return {};
+	}
+
+	const QByteArray identity = module_identity(name);
+	if (identity.isEmpty()) {
+		return {};
+	}
+
+	const QStringList cacheDirectories = QStandardPaths::standardLocations(QStandardPaths::CacheLocation);
+	if (cacheDirectories.isEmpty()) {
+		return {};
+	}
+
+	// a module may have more than one executable mapping, the file offset
+	// tells them apart no matter where the module is loaded
+	return QString("%1/analysis/%2-%3.cache").arg(cacheDirectories[0], QString::fromLatin1(identity.toHex()), region->base().toHexString());
+}
+
+/**
+ * @brief load_analysis
+ * @param filename
+ * @param analysis
+ * @return
+ */
+bool load_analysis(const QString &filename, CachedAnalysis *analysis) {
+
+	Q_ASSERT(analysis);
+
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return false;
+	}
+
+	const QByteArray bytes = qUncompress(file.readAll());
+	if (bytes.isEmpty()) {
+		return false;
+	}
+
+	QDataStream stream(bytes);
+
+	quint32 magic;
+	quint32 version;
+	stream >> magic >> version;
+	if (magic != CacheMagic || version != CacheVersion) {
+		return false;
+	}
+
+	stream >> analysis->fuzzy >> analysis->regionSize >> analysis->md5 >> analysis->knownFunctions >> analysis->fuzzyFunctions;
+
+	quint64 block_count;
+	stream >> block_count;
+	analysis->blocks.clear();
+	for (quint64 i = 0; i < block_count && stream.status() == QDataStream::Ok; ++i) {
+		CachedBlock block;
+		quint64 reference_count;
+		stream >> block.start >> block.size >> reference_count;
+		for (quint64 j = 0; j < reference_count && stream.status() == QDataStream::Ok; ++j) {
+			quint64 refsite;
+			quint64 target;
+			stream >> refsite >> target;
+			block.references.emplace_back(refsite, target);
+		}
+		analysis->blocks.push_back(std::move(block));
+	}
+
+	quint64 function_count;
+	stream >> function_count;
+	analysis->functions.clear();
+	for (quint64 i = 0; i < function_count && stream.status() == QDataStream::Ok; ++i) {
+		CachedFunction function;
+		stream >> function.entry >> function.type >> function.referenceCount >> function.blocks;
+		analysis->functions.push_back(std::move(function));
+	}
+
+	return stream.status() == QDataStream::Ok;
+}
+
+/**
+ * @brief save_analysis
+ * @param filename
+ * @param analysis
+ * @return
+ */
+bool save_analysis(const QString &filename, const CachedAnalysis &analysis) {
+
+	QByteArray bytes;
+	QDataStream stream(&bytes, QIODevice::WriteOnly);
+
+	stream << CacheMagic << CacheVersion;
+	stream << analysis.fuzzy << analysis.regionSize << analysis.md5 << analysis.knownFunctions << analysis.fuzzyFunctions;
+
+	stream << static_cast<quint64>(analysis.blocks.size());
+	for (const CachedBlock &block : analysis.blocks) {
+		stream << block.start << block.size << static_cast<quint64>(block.references.size());
+		for (const std::pair<quint64, quint64> &ref : block.references) {
+			stream << ref.first << ref.second;
+		}
+	}
+
+	stream << static_cast<quint64>(analysis.functions.size());
+	for (const CachedFunction &function : analysis.functions) {
+		stream << function.entry << function.type << function.referenceCount << function.blocks;
+	}
+
+	QDir().mkpath(QFileInfo(filename).absolutePath());
+
+	QSaveFile file(filename);
+	if (!file.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+
+	file.write(qCompress(bytes));
+	return file.commit();
+}
+
+}
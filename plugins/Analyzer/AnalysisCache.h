@@ -0,0 +1,67 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ANALYSIS_CACHE_H_20261019_
+#define ANALYSIS_CACHE_H_20261019_
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+class IRegion;
+
+namespace AnalyzerPlugin {
+
+// NOTE(eteran): every address in the cache is stored as an offset from the
+// start of the region it was collected from. This way, the results can be
+// applied to the same module no matter where it is mapped.
+
+struct CachedBlock {
+	quint64 start;
+	quint64 size;
+	std::vector<std::pair<quint64, quint64>> references;
+};
+
+struct CachedFunction {
+	quint64 entry;
+	qint32 type;
+	qint32 referenceCount;
+	std::vector<quint64> blocks;
+};
+
+struct CachedAnalysis {
+	bool fuzzy         = false;
+	quint64 regionSize = 0;
+	QByteArray md5; // of the region's bytes as they were analyzed
+	std::vector<quint64> knownFunctions;
+	std::vector<quint64> fuzzyFunctions;
+	std::vector<CachedBlock> blocks;
+	std::vector<CachedFunction> functions;
+};
+
+QString analysis_cache_file(const std::shared_ptr<IRegion> &region);
+bool load_analysis(const QString &filename, CachedAnalysis *analysis);
+bool save_analysis(const QString &filename, const CachedAnalysis &analysis);
+
+}
+
+#endif
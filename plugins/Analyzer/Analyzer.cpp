@@ -17,6 +17,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "Analyzer.h"
+#include "AnalysisCache.h"
 #include "AnalyzerWidget.h"
 #include "Configuration.h"
 #include "DialogXRefs.h"
@@ -39,16 +40,21 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QDir>
 #include <QElapsedTimer>
 #include <QFileInfo>
+#include <QFutureWatcher>
 #include <QHash>
 #include <QMainWindow>
 #include <QMenu>
 #include <QMessageBox>
+#include <QMutexLocker>
 #include <QProgressDialog>
 #include <QSettings>
 #include <QStack>
+#include <QTimer>
 #include <QToolBar>
+#include <QtConcurrentRun>
 #include <QtDebug>
 
+#include <algorithm>
 #include <cstring>
 #include <functional>
 
@@ -57,28 +63,6 @@ namespace AnalyzerPlugin {
 namespace {
 
 constexpr int MinRefCount = 2;
-/**
- * @brief will_return
- * @param address
- * @return
- */
-bool will_return(edb::address_t address) {
-
-	const std::shared_ptr<Symbol> symbol = edb::v1::symbol_manager().find(address);
-	if (symbol) {
-		const QString symname   = symbol->name_no_prefix;
-		const QString func_name = symname.mid(0, symname.indexOf("@"));
-
-		if (const edb::Prototype *const info = edb::v1::get_function_info(func_name)) {
-			if (info->noreturn) {
-				return false;
-			}
-		}
-	}
-
-	return true;
-}
-
 /**
  * @brief is_entrypoint
  * @param sym
@@ -94,18 +78,23 @@ bool is_entrypoint(const Symbol &sym) {
 
 /**
  * @brief is_thunk
- * @param address
+ * @param function
  * @return true if the first instruction of the function is a jmp
  */
-bool is_thunk(edb::address_t address) {
-
-	uint8_t buf[edb::Instruction::MaxSize];
-	if (const int buf_size = edb::v1::get_instruction_bytes(address, buf)) {
-		const edb::Instruction inst(buf, buf + buf_size, address);
-		return is_unconditional_jump(inst);
-	}
+bool is_thunk(const Function &function) {
+	const BasicBlock &block = function.front();
+	return !block.empty() && is_unconditional_jump(*block.front());
+}
 
-	return false;
+/**
+ * @brief finished_future
+ * @return a future which has already finished
+ */
+QFuture<void> finished_future() {
+	QFutureInterface<void> future;
+	future.reportStarted();
+	future.reportFinished();
+	return future.future();
 }
 
 /**
@@ -116,9 +105,8 @@ void set_function_types(IAnalyzer::FunctionMap *results) {
 
 	Q_ASSERT(results);
 
-	// give bonus if we have a symbol for the address
 	std::for_each(results->begin(), results->end(), [](Function &function) {
-		if (is_thunk(function.entryAddress())) {
+		if (is_thunk(function)) {
 			function.setType(Function::Thunk);
 		} else {
 			function.setType(Function::Standard);
@@ -147,6 +135,18 @@ edb::address_t module_entry_point(const std::shared_ptr<IRegion> &region) {
  */
 Analyzer::Analyzer(QObject *parent)
 	: QObject(parent) {
+
+	progressTimer_ = new QTimer(this);
+	progressTimer_->setInterval(250);
+	connect(progressTimer_, &QTimer::timeout, this, &Analyzer::publishProgress);
+}
+
+/**
+ * @brief Analyzer::~Analyzer
+ */
+Analyzer::~Analyzer() {
+	cancelAllAnalysis();
+	threadPool_.waitForDone();
 }
 
 /**
@@ -204,6 +204,10 @@ QMenu *Analyzer::menu(QWidget *parent) {
  */
 void Analyzer::privateInit() {
 	edb::v1::set_analyzer(this);
+
+	if (edb::v1::debugger_ui) {
+		connect(edb::v1::debugger_ui, SIGNAL(detachEvent()), this, SLOT(cancelAllAnalysis()));
+	}
 }
 
 /**
@@ -260,16 +264,8 @@ void Analyzer::showXrefs() {
 
 	auto dialog = new DialogXRefs(edb::v1::debugger_ui);
 
-	for (const RegionData &data : analysisInfo_) {
-		for (const BasicBlock &bb : data.basicBlocks) {
-			const std::vector<std::pair<edb::address_t, edb::address_t>> refs = bb.references();
-
-			for (auto it = refs.begin(); it != refs.end(); ++it) {
-				if (it->second == address) {
-					dialog->addReference(*it);
-				}
-			}
-		}
+	for (const edb::address_t refsite : referencesTo(address)) {
+		dialog->addReference(std::make_pair(refsite, address));
 	}
 
 	dialog->setWindowTitle(tr("X-Refs For %1").arg(address.toPointerString()));
@@ -282,9 +278,8 @@ void Analyzer::gotoFunctionStart() {
 
 	const edb::address_t address = edb::v1::cpu_selected_address();
 
-	Function function;
-	if (findContainingFunction(address, &function)) {
-		edb::v1::jump_to_address(function.entryAddress());
+	if (const FunctionRange *function = findFunctionRange(address)) {
+		edb::v1::jump_to_address(function->entryAddress);
 		return;
 	}
 
@@ -301,9 +296,8 @@ void Analyzer::gotoFunctionEnd() {
 
 	const edb::address_t address = edb::v1::cpu_selected_address();
 
-	Function function;
-	if (findContainingFunction(address, &function)) {
-		edb::v1::jump_to_address(function.lastInstruction());
+	if (const FunctionRange *function = findFunctionRange(address)) {
+		edb::v1::jump_to_address(function->function->lastInstruction());
 		return;
 	}
 
@@ -343,12 +337,23 @@ QList<QAction *> Analyzer::cpuContextMenu() {
  */
 void Analyzer::doAnalysis(const std::shared_ptr<IRegion> &region) {
 	if (region && region->size() != 0) {
-		QProgressDialog progress(tr("Performing Analysis"), nullptr, 0, 100, edb::v1::debugger_ui);
-		connect(this, &Analyzer::updateProgress, &progress, &QProgressDialog::setValue);
-		progress.show();
-		progress.setValue(0);
+		const edb::address_t start = region->start();
+
+		auto progress = new QProgressDialog(tr("Performing Analysis"), tr("Cancel"), 0, 100, edb::v1::debugger_ui);
+		progress->setAttribute(Qt::WA_DeleteOnClose);
+		connect(this, &Analyzer::updateProgress, progress, &QProgressDialog::setValue);
+		connect(this, &Analyzer::analysisFinished, progress, [progress, start](edb::address_t address) {
+			if (address == start) {
+				progress->close();
+			}
+		});
+		connect(progress, &QProgressDialog::canceled, this, [this, region]() {
+			cancelAnalysis(region);
+		});
+
+		progress->show();
+		progress->setValue(0);
 		analyze(region);
-		edb::v1::repaint_cpu_view();
 	}
 }
 
@@ -420,15 +425,52 @@ void Analyzer::identHeader(Analyzer::RegionData *data) {
 }
 
 /**
- * @brief Analyzer::collectFunctions
+ * @brief Analyzer::collectNoReturnFunctions
  * @param data
  */
-void Analyzer::collectFunctions(Analyzer::RegionData *data) {
+void Analyzer::collectNoReturnFunctions(RegionData *data) const {
+
 	Q_ASSERT(data);
 
+	const std::vector<std::shared_ptr<Symbol>> symbols = edb::v1::symbol_manager().symbols();
+
+	for (const std::shared_ptr<Symbol> &sym : symbols) {
+		const QString symname   = sym->name_no_prefix;
+		const QString func_name = symname.mid(0, symname.indexOf("@"));
+
+		if (const edb::Prototype *const info = edb::v1::get_function_info(func_name)) {
+			if (info->noreturn) {
+				data->noReturnFunctions.insert(sym->address);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Analyzer::collectFunctions
+ *
+ * NOTE: this runs on the thread pool, it may only look at the job's snapshot of the region
+ *
+ * @param job
+ */
+void Analyzer::collectFunctions(AnalysisJob *job) const {
+	Q_ASSERT(job);
+
+	RegionData *const data = &job->data;
+
 	// results
 	QHash<edb::address_t, BasicBlock> basic_blocks;
 	FunctionMap functions;
+	std::vector<std::pair<edb::address_t, edb::address_t>> xrefs;
+
+	// records the reference in both the block and the reverse index
+	auto add_reference = [&xrefs](BasicBlock *block, edb::address_t refsite, edb::address_t target) {
+		block->addReference(refsite, target);
+		xrefs.emplace_back(target, refsite);
+	};
+
+	const uint8_t *const first = data->memory.data();
+	const uint8_t *const last  = first + data->memory.size();
 
 	// push all known functions onto a stack
 	QStack<edb::address_t> known_functions;
@@ -441,8 +483,16 @@ void Analyzer::collectFunctions(Analyzer::RegionData *data) {
 		known_functions.push(function);
 	}
 
+	QElapsedTimer publish_timer;
+	publish_timer.start();
+
 	// process all functions that are known
 	while (!known_functions.empty()) {
+
+		if (job->cancelled) {
+			return;
+		}
+
 		const edb::address_t function_address = known_functions.pop();
 
 		if (!functions.contains(function_address)) {
@@ -462,13 +512,12 @@ void Analyzer::collectFunctions(Analyzer::RegionData *data) {
 				if (!basic_blocks.contains(block_address)) {
 					while (data->region->contains(address)) {
 
-						uint8_t buffer[edb::Instruction::MaxSize];
-						const int buf_size = edb::v1::get_instruction_bytes(address, buffer);
-						if (buf_size == 0) {
+						const size_t offset = address - data->region->start();
+						if (offset >= static_cast<size_t>(data->memory.size())) {
 							break;
 						}
 
-						auto inst = std::make_shared<edb::Instruction>(buffer, buffer + buf_size, address);
+						auto inst = std::make_shared<edb::Instruction>(first + offset, last, address);
 						if (!inst->valid()) {
 							break;
 						}
@@ -488,11 +537,11 @@ void Analyzer::collectFunctions(Analyzer::RegionData *data) {
 								if (ea != address + inst->byteSize()) {
 									known_functions.push(ea);
 
-									if (!will_return(ea)) {
+									if (data->noReturnFunctions.contains(ea)) {
 										break;
 									}
 
-									block.addReference(address, ea);
+									add_reference(&block, address, ea);
 								}
 							} else if (is_expression(op)) {
 								// looks like: "call [...]", if it is of the form, call [C + REG]
@@ -523,7 +572,7 @@ void Analyzer::collectFunctions(Analyzer::RegionData *data) {
 									blocks.push(ea);
 								}
 
-								block.addReference(address, ea);
+								add_reference(&block, address, ea);
 							}
 							break;
 						} else if (is_conditional_jump(*inst)) {
@@ -538,7 +587,7 @@ void Analyzer::collectFunctions(Analyzer::RegionData *data) {
 								blocks.push(ea);
 								blocks.push(address + inst->byteSize());
 
-								block.addReference(address, ea);
+								add_reference(&block, address, ea);
 							}
 							break;
 						} else if (is_terminator(*inst)) {
@@ -560,36 +609,63 @@ void Analyzer::collectFunctions(Analyzer::RegionData *data) {
 
 			if (!func.empty()) {
 				functions.insert(function_address, func);
+
+				// let the GUI show what we have found so far every now and then
+				if (publish_timer.elapsed() > 250) {
+					QMutexLocker locker(&job->mutex);
+					job->partialFunctions = functions;
+					job->partialUpdated   = true;
+					job->progress         = 50 + util::percentage(functions.size(), functions.size() + known_functions.size()) * 45 / 100;
+					publish_timer.restart();
+				}
 			}
 		} else {
 			functions[function_address].addReference();
 		}
 	}
 
+	std::sort(xrefs.begin(), xrefs.end());
+
 	std::swap(data->basicBlocks, basic_blocks);
 	std::swap(data->functions, functions);
+	std::swap(data->xrefs, xrefs);
 }
 
 /**
  * @brief Analyzer::collectFuzzyFunctions
- * @param data
+ *
+ * NOTE: this runs on the thread pool, it may only look at the job's snapshot of the region
+ *
+ * @param job
  */
-void Analyzer::collectFuzzyFunctions(RegionData *data) {
-	Q_ASSERT(data);
+void Analyzer::collectFuzzyFunctions(AnalysisJob *job) const {
+	Q_ASSERT(job);
+
+	RegionData *const data = &job->data;
 
 	data->fuzzyFunctions.clear();
 
-	if (data->fuzzy) {
+	if (data->fuzzy && !data->memory.isEmpty()) {
 
 		QHash<edb::address_t, int> fuzzy_functions;
 
-		uint8_t *const first = &data->memory[0];
-		uint8_t *const last  = &first[data->memory.size()];
-
-		uint8_t *p = first;
+		const uint8_t *const first = data->memory.data();
+		const uint8_t *const last  = first + data->memory.size();
 
 		// fuzzy_functions, known_functions
-		for (edb::address_t addr = data->region->start(); addr != data->region->end(); ++addr) {
+		edb::address_t addr = data->region->start();
+		for (const uint8_t *p = first; p != last; ++p, ++addr) {
+
+			const size_t offset = p - first;
+			if ((offset % 0x10000) == 0) {
+				if (job->cancelled) {
+					return;
+				}
+
+				// this scan is roughly the first half of the work
+				job->progress = util::percentage(offset, data->memory.size()) / 2;
+			}
+
 			if (auto inst = edb::Instruction(p, last, addr)) {
 				if (is_call(inst)) {
 
@@ -610,7 +686,6 @@ void Analyzer::collectFuzzyFunctions(RegionData *data) {
 					}
 				}
 			}
-			++p;
 		}
 
 		// transfer results to data->fuzzy_functions
@@ -624,14 +699,27 @@ void Analyzer::collectFuzzyFunctions(RegionData *data) {
 
 /**
  * @brief Analyzer::analyze
+ *
+ * Takes a snapshot of the region and analyzes it on the thread pool. The parts
+ * of the analysis which need the debugger core or the symbol manager are done
+ * here before the job is started. Partial results become visible as they are
+ * found and analysisFinished is emitted once the region is done.
+ *
  * @param region
+ * @return a future which finishes along with the analysis
  */
-void Analyzer::analyze(const std::shared_ptr<IRegion> &region) {
+QFuture<void> Analyzer::analyze(const std::shared_ptr<IRegion> &region) {
 
-	QElapsedTimer t;
-	t.start();
+	// if the region was remapped since we started, the old job is useless
+	if (const std::shared_ptr<AnalysisJob> job = jobs_.value(region->start())) {
+		if (job->data.region->equals(region)) {
+			qDebug("[Analyzer] region is already being analyzed");
+			return job->done.future();
+		}
+
+		cancelAnalysis(region);
+	}
 
-	RegionData &region_data = analysisInfo_[region->start()];
 	qDebug() << "[Analyzer] Region name:" << region->name();
 
 	QSettings settings;
@@ -642,59 +730,382 @@ void Analyzer::analyze(const std::shared_ptr<IRegion> &region) {
 
 	QVector<uint8_t> memory = edb::v1::read_pages(region->start(), page_count);
 
-	const QByteArray md5      = (!memory.isEmpty()) ? edb::v1::get_md5(memory) : QByteArray();
-	const QByteArray prev_md5 = region_data.md5;
+	const QByteArray md5 = (!memory.isEmpty()) ? edb::v1::get_md5(memory) : QByteArray();
+	auto previous_data   = analysisInfo_.constFind(region->start());
+
+	if (previous_data != analysisInfo_.constEnd() && md5 == previous_data->md5 && fuzzy == previous_data->fuzzy) {
+		qDebug("[Analyzer] region unchanged, using previous analysis");
+		Q_EMIT updateProgress(100);
+		Q_EMIT analysisFinished(region->start());
+		return finished_future();
+	}
+
+	auto job = std::make_shared<AnalysisJob>();
+
+	RegionData &region_data = job->data;
+	region_data.memory      = memory;
+	region_data.region      = std::shared_ptr<IRegion>(region->clone());
+	region_data.md5         = md5;
+	region_data.fuzzy       = fuzzy;
+
+	// user marked functions change the results, so they can't go through the cache
+	job->useCache = settings.value("Analyzer/analysis_cache.enabled", true).toBool() &&
+					std::none_of(specifiedFunctions_.begin(), specifiedFunctions_.end(), [&region](edb::address_t addr) {
+						return region->contains(addr);
+					});
+
+	const struct {
+		const char *message;
+		std::function<void()> function;
+	} analysis_steps[] = {
+		{"identifying executable headers...", [this, &region_data]() { identHeader(&region_data); }},
+		{"adding entry points to the list...", [this, &region_data]() { bonusEntryPoint(&region_data); }},
+		{"attempting to add 'main' to the list...", [this, &region_data]() { bonusMain(&region_data); }},
+		{"attempting to add functions with symbols to the list...", [this, &region_data]() { bonusSymbols(&region_data); }},
+		{"attempting to add marked functions to the list...", [this, &region_data]() { bonusMarkedFunctions(&region_data); }},
+		{"collecting functions which do not return...", [this, &region_data]() { collectNoReturnFunctions(&region_data); }},
+	};
+
+	for (const auto &step : analysis_steps) {
+		qDebug("[Analyzer] %s", step.message);
+		step.function();
+	}
+
+	jobs_.insert(region->start(), job);
 
-	if (md5 != prev_md5 || fuzzy != region_data.fuzzy) {
+	auto watcher = new QFutureWatcher<void>(this);
+	connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, job]() {
+		finishAnalysis(job);
+		watcher->deleteLater();
+	});
+
+	job->done.reportStarted();
+	watcher->setFuture(QtConcurrent::run(&threadPool_, [this, job]() {
+		runAnalysis(job.get());
+	}));
 
-		region_data.basicBlocks.clear();
-		region_data.functions.clear();
-		region_data.fuzzyFunctions.clear();
-		region_data.knownFunctions.clear();
+	Q_EMIT updateProgress(0);
+	progressTimer_->start();
+	return job->done.future();
+}
+
+/**
+ * @brief Analyzer::runAnalysis
+ *
+ * NOTE: this runs on the thread pool, it may only look at the job
+ *
+ * @param job
+ */
+void Analyzer::runAnalysis(AnalysisJob *job) const {
 
-		region_data.memory = memory;
-		region_data.region = region;
-		region_data.md5    = md5;
-		region_data.fuzzy  = fuzzy;
+	Q_ASSERT(job);
 
-		const struct {
-			const char *message;
-			std::function<void()> function;
-		} analysis_steps[] = {
-			{"identifying executable headers...", [this, &region_data]() { identHeader(&region_data); }},
-			{"adding entry points to the list...", [this, &region_data]() { bonusEntryPoint(&region_data); }},
-			{"attempting to add 'main' to the list...", [this, &region_data]() { bonusMain(&region_data); }},
-			{"attempting to add functions with symbols to the list...", [this, &region_data]() { bonusSymbols(&region_data); }},
-			{"attempting to add marked functions to the list...", [this, &region_data]() { bonusMarkedFunctions(&region_data); }},
-			{"attempting to collect functions with fuzzy analysis...", [this, &region_data]() { collectFuzzyFunctions(&region_data); }},
-			{"collecting basic blocks...", [this, &region_data]() { collectFunctions(&region_data); }},
-		};
+	QElapsedTimer t;
+	t.start();
 
-		const int total_steps = sizeof(analysis_steps) / sizeof(analysis_steps[0]);
+	RegionData *const data = &job->data;
 
-		Q_EMIT updateProgress(util::percentage(0, total_steps));
-		for (int i = 0; i < total_steps; ++i) {
-			qDebug("[Analyzer] %s", analysis_steps[i].message);
-			analysis_steps[i].function();
-			Q_EMIT updateProgress(util::percentage(i + 1, total_steps));
+	if (job->useCache && loadCachedAnalysis(data)) {
+		qDebug("[Analyzer] using cached analysis");
+	} else {
+		qDebug("[Analyzer] attempting to collect functions with fuzzy analysis...");
+		collectFuzzyFunctions(job);
+
+		qDebug("[Analyzer] collecting basic blocks...");
+		collectFunctions(job);
+
+		if (job->cancelled) {
+			qDebug("[Analyzer] cancelled");
+			return;
 		}
 
 		qDebug("[Analyzer] determining function types...");
+		set_function_types(&data->functions);
+
+		if (job->useCache) {
+			saveCachedAnalysis(data);
+		}
+	}
+
+	job->progress = 100;
+	qDebug("[Analyzer] complete, elapsed: %lld ms", t.elapsed());
+}
+
+/**
+ * @brief Analyzer::finishAnalysis
+ * @param job
+ */
+void Analyzer::finishAnalysis(const std::shared_ptr<AnalysisJob> &job) {
+
+	const edb::address_t start = job->data.region->start();
+
+	// a cancelled job has already been forgotten about and may have been replaced
+	if (jobs_.value(start) == job) {
+		jobs_.remove(start);
+
+		if (!job->cancelled) {
+			analysisInfo_[start] = std::move(job->data);
+		}
 
-		set_function_types(&region_data.functions);
+		rebuildFunctionRanges();
+	}
 
-		qDebug("[Analyzer] complete");
+	if (jobs_.isEmpty()) {
+		progressTimer_->stop();
 		Q_EMIT updateProgress(100);
+	}
+
+	if (analyzerWidget_) {
+		analyzerWidget_->update();
+	}
+
+	edb::v1::repaint_cpu_view();
+
+	job->done.reportFinished();
+	Q_EMIT analysisFinished(start);
+}
+
+/**
+ * @brief Analyzer::publishProgress
+ *
+ * periodically brings the partial results of running jobs into view, until a
+ * job finishes they are shown in place of the region's previous results
+ */
+void Analyzer::publishProgress() {
+
+	if (jobs_.isEmpty()) {
+		return;
+	}
+
+	int progress = 0;
+	bool updated = false;
+
+	for (auto it = jobs_.begin(); it != jobs_.end(); ++it) {
+		const std::shared_ptr<AnalysisJob> &job = it.value();
+
+		progress += job->progress;
+
+		QMutexLocker locker(&job->mutex);
+		if (job->partialUpdated) {
+			job->publishedFunctions = job->partialFunctions;
+			job->partialUpdated     = false;
+			updated                 = true;
+		}
+	}
+
+	Q_EMIT updateProgress(progress / jobs_.size());
+
+	if (updated) {
+		rebuildFunctionRanges();
 
 		if (analyzerWidget_) {
 			analyzerWidget_->update();
 		}
 
-	} else {
-		qDebug("[Analyzer] region unchanged, using previous analysis");
+		edb::v1::repaint_cpu_view();
 	}
+}
 
-	qDebug("[Analyzer] elapsed: %lld ms", t.elapsed());
+/**
+ * @brief Analyzer::cancelAnalysis
+ * @param region
+ */
+void Analyzer::cancelAnalysis(const std::shared_ptr<IRegion> &region) {
+	if (const std::shared_ptr<AnalysisJob> job = jobs_.take(region->start())) {
+		job->cancelled = true;
+		job->done.reportCanceled();
+		job->done.reportFinished();
+
+		// its partial results are discarded along with it
+		if (!job->publishedFunctions.isEmpty()) {
+			rebuildFunctionRanges();
+		}
+	}
+}
+
+/**
+ * @brief Analyzer::cancelAllAnalysis
+ */
+void Analyzer::cancelAllAnalysis() {
+	for (const std::shared_ptr<AnalysisJob> &job : jobs_) {
+		job->cancelled = true;
+		job->done.reportCanceled();
+		job->done.reportFinished();
+	}
+
+	jobs_.clear();
+	rebuildFunctionRanges();
+}
+
+/**
+ * @brief Analyzer::analysisPending
+ * @param region
+ * @return true if <region> is currently being analyzed
+ */
+bool Analyzer::analysisPending(const std::shared_ptr<IRegion> &region) const {
+	return jobs_.contains(region->start());
+}
+
+/**
+ * @brief Analyzer::loadCachedAnalysis
+ *
+ * replaces the results of collectFuzzyFunctions/collectFunctions with those
+ * found in the on disk cache for this region's module, rebased to where the
+ * region is currently mapped.
+ *
+ * @param data
+ * @return true if the cached results were usable
+ */
+bool Analyzer::loadCachedAnalysis(RegionData *data) const {
+
+	Q_ASSERT(data);
+
+	if (data->memory.isEmpty()) {
+		return false;
+	}
+
+	const QString filename = analysis_cache_file(data->region);
+	if (filename.isEmpty()) {
+		return false;
+	}
+
+	CachedAnalysis cache;
+	// the module is identified by its file, but what matters is that the bytes
+	// in memory are the same ones which were analyzed
+	if (!load_analysis(filename, &cache) || cache.fuzzy != data->fuzzy || cache.regionSize != data->region->size() || cache.md5 != data->md5) {
+		return false;
+	}
+
+	const edb::address_t base  = data->region->start();
+	const uint8_t *const first = data->memory.data();
+	const uint8_t *const last  = first + data->memory.size();
+
+	QHash<edb::address_t, BasicBlock> basic_blocks;
+	FunctionMap functions;
+	std::vector<std::pair<edb::address_t, edb::address_t>> xrefs;
+
+	// the cache only stores the bounds of each block, so we decode the
+	// instructions again from our copy of the region
+	for (const CachedBlock &cached : cache.blocks) {
+		if (cached.start + cached.size > static_cast<quint64>(data->memory.size())) {
+			return false;
+		}
+
+		BasicBlock block;
+		edb::address_t address = base + cached.start;
+
+		for (const uint8_t *p = first + cached.start; p < first + cached.start + cached.size;) {
+			auto inst = std::make_shared<edb::Instruction>(p, last, address);
+			if (!inst->valid()) {
+				return false;
+			}
+
+			block.push_back(inst);
+			p += inst->byteSize();
+			address += inst->byteSize();
+		}
+
+		for (const std::pair<quint64, quint64> &ref : cached.references) {
+			block.addReference(base + ref.first, base + ref.second);
+			xrefs.emplace_back(base + ref.second, base + ref.first);
+		}
+
+		basic_blocks.insert(base + cached.start, block);
+	}
+
+	for (const CachedFunction &cached : cache.functions) {
+		Function func;
+		for (const quint64 offset : cached.blocks) {
+			auto it = basic_blocks.find(base + offset);
+			if (it == basic_blocks.end()) {
+				return false;
+			}
+			func.insert(*it);
+		}
+
+		// a type we don't know means the file is damaged or from a newer
+		// version, either way the region is analyzed again, which replaces it
+		if (cached.type != Function::Standard && cached.type != Function::Thunk) {
+			return false;
+		}
+
+		if (!func.empty()) {
+			func.setType(static_cast<Function::Type>(cached.type));
+			for (int i = 0; i < cached.referenceCount; ++i) {
+				func.addReference();
+			}
+			functions.insert(base + cached.entry, func);
+		}
+	}
+
+	for (const quint64 offset : cache.knownFunctions) {
+		data->knownFunctions.insert(base + offset);
+	}
+
+	for (const quint64 offset : cache.fuzzyFunctions) {
+		data->fuzzyFunctions.insert(base + offset);
+	}
+
+	std::sort(xrefs.begin(), xrefs.end());
+
+	std::swap(data->basicBlocks, basic_blocks);
+	std::swap(data->functions, functions);
+	std::swap(data->xrefs, xrefs);
+	return true;
+}
+
+/**
+ * @brief Analyzer::saveCachedAnalysis
+ * @param data
+ */
+void Analyzer::saveCachedAnalysis(const RegionData *data) const {
+
+	Q_ASSERT(data);
+
+	const QString filename = analysis_cache_file(data->region);
+	if (filename.isEmpty()) {
+		return;
+	}
+
+	const edb::address_t base = data->region->start();
+
+	CachedAnalysis cache;
+	cache.fuzzy      = data->fuzzy;
+	cache.regionSize = data->region->size();
+	cache.md5        = data->md5;
+
+	for (const edb::address_t addr : data->knownFunctions) {
+		cache.knownFunctions.push_back(addr - base);
+	}
+
+	for (const edb::address_t addr : data->fuzzyFunctions) {
+		cache.fuzzyFunctions.push_back(addr - base);
+	}
+
+	for (auto it = data->basicBlocks.begin(); it != data->basicBlocks.end(); ++it) {
+		CachedBlock block;
+		block.start = it.key() - base;
+		block.size  = it->byteSize();
+		for (const std::pair<edb::address_t, edb::address_t> &ref : it->references()) {
+			block.references.emplace_back(ref.first - base, ref.second - base);
+		}
+		cache.blocks.push_back(std::move(block));
+	}
+
+	for (auto it = data->functions.begin(); it != data->functions.end(); ++it) {
+		CachedFunction function;
+		function.entry          = it.key() - base;
+		function.type           = it->type();
+		function.referenceCount = it->referenceCount();
+		for (const auto &pair : *it) {
+			function.blocks.push_back(pair.first - base);
+		}
+		cache.functions.push_back(std::move(function));
+	}
+
+	if (!save_analysis(filename, cache)) {
+		qDebug() << "[Analyzer] failed to write analysis cache:" << filename;
+	}
 }
 
 /**
@@ -704,11 +1115,10 @@ void Analyzer::analyze(const std::shared_ptr<IRegion> &region) {
  */
 IAnalyzer::AddressCategory Analyzer::category(edb::address_t address) const {
 
-	Function func;
-	if (findContainingFunction(address, &func)) {
-		if (address == func.entryAddress()) {
+	if (const FunctionRange *func = findFunctionRange(address)) {
+		if (address == func->entryAddress) {
 			return ADDRESS_FUNC_START;
-		} else if (address == func.endAddress()) {
+		} else if (address == func->endAddress) {
 			return ADDRESS_FUNC_END;
 		} else {
 			return ADDRESS_FUNC_BODY;
@@ -723,7 +1133,13 @@ IAnalyzer::AddressCategory Analyzer::category(edb::address_t address) const {
  * @return
  */
 IAnalyzer::FunctionMap Analyzer::functions(const std::shared_ptr<IRegion> &region) const {
-	return analysisInfo_[region->start()].functions;
+	const std::shared_ptr<AnalysisJob> job = jobs_.value(region->start());
+	if (job && !job->publishedFunctions.isEmpty()) {
+		return job->publishedFunctions;
+	}
+
+	auto it = analysisInfo_.constFind(region->start());
+	return (it != analysisInfo_.constEnd()) ? it->functions : FunctionMap();
 }
 
 /**
@@ -743,43 +1159,95 @@ IAnalyzer::FunctionMap Analyzer::functions() const {
 }
 
 /**
- * @brief Analyzer::findContainingFunction
+ * @brief Analyzer::referencesTo
  * @param address
- * @param function
- * @return
+ * @return the addresses of all analyzed instructions which reference <address>
  */
-bool Analyzer::findContainingFunction(edb::address_t address, Function *function) const {
+std::vector<edb::address_t> Analyzer::referencesTo(edb::address_t address) const {
 
-	Q_ASSERT(function);
+	std::vector<edb::address_t> results;
 
-	if (std::shared_ptr<IRegion> region = edb::v1::memory_regions().findRegion(address)) {
-		const FunctionMap &funcs = functions(region);
+	for (const RegionData &data : analysisInfo_) {
+		auto it = std::lower_bound(data.xrefs.begin(), data.xrefs.end(), address, [](const std::pair<edb::address_t, edb::address_t> &ref, edb::address_t target) {
+			return ref.first < target;
+		});
 
-		// upperBound returns the first item that is >= address here, or end().
-		// Note the ">", it does not do the opposite of lowerBound!
-		auto iter = funcs.upperBound(address);
-		if (iter == funcs.end()) {
-			return false;
+		for (; it != data.xrefs.end() && it->first == address; ++it) {
+			results.push_back(it->second);
 		}
+	}
 
-		// handle address == entrypoint case
-		if ((*iter).entryAddress() == address) {
-			*function = *iter;
-			return true;
-		}
+	return results;
+}
 
-		// go to previous function and test it
-		if (iter == funcs.begin()) {
-			return false;
-		}
+/**
+ * @brief Analyzer::rebuildFunctionRanges
+ *
+ * must be called whenever the function map of any region changes, or a job
+ * with published partial results comes or goes
+ */
+void Analyzer::rebuildFunctionRanges() {
 
-		const Function &func = *(--iter);
-		if (address >= func.entryAddress() && address <= func.endAddress()) {
-			*function = func;
-			return true;
+	functionRanges_.clear();
+
+	auto add_functions = [this](const FunctionMap &functions) {
+		for (auto it = functions.constBegin(); it != functions.constEnd(); ++it) {
+			functionRanges_.push_back({it->entryAddress(), it->endAddress(), it->type(), &*it});
+		}
+	};
+
+	const QHash<edb::address_t, RegionData> &info = analysisInfo_;
+	for (auto it = info.constBegin(); it != info.constEnd(); ++it) {
+		// a running analysis shows its partial results instead
+		const std::shared_ptr<AnalysisJob> job = jobs_.value(it.key());
+		if (!job || job->publishedFunctions.isEmpty()) {
+			add_functions(it->functions);
 		}
 	}
-	return false;
+
+	for (const std::shared_ptr<AnalysisJob> &job : jobs_) {
+		add_functions(job->publishedFunctions);
+	}
+
+	std::sort(functionRanges_.begin(), functionRanges_.end(), [](const FunctionRange &lhs, const FunctionRange &rhs) {
+		return lhs.entryAddress < rhs.entryAddress;
+	});
+}
+
+/**
+ * @brief Analyzer::findFunctionRange
+ * @param address
+ * @return the function which contains <address>, or nullptr if there is none
+ */
+const IAnalyzer::FunctionRange *Analyzer::findFunctionRange(edb::address_t address) const {
+
+	// find the last function which starts at or before address
+	auto it = std::upper_bound(functionRanges_.begin(), functionRanges_.end(), address, [](edb::address_t addr, const FunctionRange &range) {
+		return addr < range.entryAddress;
+	});
+
+	if (it == functionRanges_.begin()) {
+		return nullptr;
+	}
+
+	--it;
+	if (address >= it->entryAddress && address <= it->endAddress) {
+		return &*it;
+	}
+
+	return nullptr;
+}
+
+/**
+ * @brief Analyzer::findFunction
+ * @param address
+ * @return the function which contains <address>, or nullptr if there is none
+ */
+const Function *Analyzer::findFunction(edb::address_t address) const {
+	if (const FunctionRange *range = findFunctionRange(address)) {
+		return range->function;
+	}
+	return nullptr;
 }
 
 /**
@@ -797,26 +1265,42 @@ bool Analyzer::findContainingFunction(edb::address_t address, Function *function
  * false if the iteration was halted early.
  */
 bool Analyzer::forFuncsInRange(edb::address_t start, edb::address_t end, std::function<bool(const Function *)> functor) const {
-	if (std::shared_ptr<IRegion> region = edb::v1::memory_regions().findRegion(start)) {
-		const FunctionMap &funcs = functions(region);
-		auto it                  = funcs.lowerBound(start - 4096);
 
-		while (it != funcs.end()) {
-			edb::address_t f_start = it->entryAddress();
-			edb::address_t f_end   = it->endAddress();
+	auto it = std::lower_bound(functionRanges_.begin(), functionRanges_.end(), start - 4096, [](const FunctionRange &range, edb::address_t addr) {
+		return range.entryAddress < addr;
+	});
 
-			// Only works if FunctionMap is a QMap
-			if (f_start > end) {
-				return true;
-			}
-			// ranges overlap: http://stackoverflow.com/a/3269471
-			if (f_start <= end && start <= f_end) {
-				if (!functor(&(*it))) {
-					return false;
-				}
+	for (; it != functionRanges_.end(); ++it) {
+
+		if (it->entryAddress > end) {
+			return true;
+		}
+
+		// ranges overlap: http://stackoverflow.com/a/3269471
+		if (it->entryAddress <= end && start <= it->endAddress) {
+			if (!functor(it->function)) {
+				return false;
 			}
+		}
+	}
+
+	return true;
+}
 
-			++it;
+/**
+ * @brief Analyzer::forEachFunction
+ *
+ * Calls functor once for every analyzed function, in order of their entry
+ * addresses. If the functor returns false, iteration is halted.
+ *
+ * @param functor
+ * @return true if all functions were iterated,
+ * false if the iteration was halted early.
+ */
+bool Analyzer::forEachFunction(std::function<bool(const Function *)> functor) const {
+	for (const FunctionRange &range : functionRanges_) {
+		if (!functor(range.function)) {
+			return false;
 		}
 	}
 	return true;
@@ -865,18 +1349,23 @@ void Analyzer::invalidateAnalysis(const std::shared_ptr<IRegion> &region) {
  */
 void Analyzer::invalidateDynamicAnalysis(const std::shared_ptr<IRegion> &region) {
 
+	cancelAnalysis(region);
+
 	RegionData info;
 	info.region = region;
 	info.fuzzy  = false;
 
 	analysisInfo_[region->start()] = info;
+	rebuildFunctionRanges();
 }
 
 /**
  * @brief Analyzer::invalidateAnalysis
  */
 void Analyzer::invalidateAnalysis() {
+	cancelAllAnalysis();
 	analysisInfo_.clear();
+	functionRanges_.clear();
 	specifiedFunctions_.clear();
 }
 
@@ -887,9 +1376,8 @@ void Analyzer::invalidateAnalysis() {
  */
 Result<edb::address_t, QString> Analyzer::findContainingFunction(edb::address_t address) const {
 
-	Function function;
-	if (findContainingFunction(address, &function)) {
-		return function.entryAddress();
+	if (const FunctionRange *function = findFunctionRange(address)) {
+		return function->entryAddress;
 	} else {
 		return make_unexpected(tr("Containing Function Not Found"));
 	}
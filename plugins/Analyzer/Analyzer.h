@@ -26,13 +26,21 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Symbol.h"
 #include "Types.h"
 
+#include <QFutureInterface>
 #include <QHash>
 #include <QList>
 #include <QMap>
+#include <QMutex>
 #include <QSet>
+#include <QThreadPool>
 #include <QVector>
 
+#include <atomic>
+#include <utility>
+#include <vector>
+
 class QMenu;
+class QTimer;
 
 namespace AnalyzerPlugin {
 
@@ -47,9 +55,11 @@ class Analyzer final : public QObject, public IAnalyzer, public IPlugin {
 
 private:
 	struct RegionData;
+	struct AnalysisJob;
 
 public:
 	explicit Analyzer(QObject *parent = nullptr);
+	~Analyzer() override;
 
 public:
 	QMenu *menu(QWidget *parent = nullptr) override;
@@ -64,28 +74,42 @@ public:
 	FunctionMap functions(const std::shared_ptr<IRegion> &region) const override;
 	FunctionMap functions() const override;
 	QSet<edb::address_t> specifiedFunctions() const override { return specifiedFunctions_; }
+	std::vector<edb::address_t> referencesTo(edb::address_t address) const override;
 	Result<edb::address_t, QString> findContainingFunction(edb::address_t address) const override;
-	void analyze(const std::shared_ptr<IRegion> &region) override;
+	QFuture<void> analyze(const std::shared_ptr<IRegion> &region) override;
+	void cancelAnalysis(const std::shared_ptr<IRegion> &region) override;
+	bool analysisPending(const std::shared_ptr<IRegion> &region) const override;
 	void invalidateAnalysis() override;
 	void invalidateAnalysis(const std::shared_ptr<IRegion> &region) override;
 	bool forFuncsInRange(edb::address_t start, edb::address_t end, std::function<bool(const Function *)> functor) const override;
+	bool forEachFunction(std::function<bool(const Function *)> functor) const override;
+	const FunctionRange *findFunctionRange(edb::address_t address) const override;
+	const Function *findFunction(edb::address_t address) const override;
 
 private:
-	bool findContainingFunction(edb::address_t address, Function *function) const;
 	void bonusEntryPoint(RegionData *data) const;
 	void bonusMain(RegionData *data) const;
 	void bonusMarkedFunctions(RegionData *data);
 	void bonusSymbols(RegionData *data);
-	void collectFunctions(RegionData *data);
-	void collectFuzzyFunctions(RegionData *data);
+	void collectFunctions(AnalysisJob *job) const;
+	void collectFuzzyFunctions(AnalysisJob *job) const;
+	void collectNoReturnFunctions(RegionData *data) const;
 	void doAnalysis(const std::shared_ptr<IRegion> &region);
+	void finishAnalysis(const std::shared_ptr<AnalysisJob> &job);
 	void identHeader(Analyzer::RegionData *data);
 	void invalidateDynamicAnalysis(const std::shared_ptr<IRegion> &region);
+	bool loadCachedAnalysis(RegionData *data) const;
+	void publishProgress();
+	void rebuildFunctionRanges();
+	void runAnalysis(AnalysisJob *job) const;
+	void saveCachedAnalysis(const RegionData *data) const;
 
 Q_SIGNALS:
 	void updateProgress(int);
+	void analysisFinished(edb::address_t regionStart);
 
 public Q_SLOTS:
+	void cancelAllAnalysis();
 	void doIpAnalysis();
 	void doViewAnalysis();
 	void gotoFunctionStart();
@@ -102,18 +126,52 @@ private:
 		FunctionMap functions;
 		QHash<edb::address_t, BasicBlock> basicBlocks;
 
+		// (target, refsite) pairs, sorted so that all references to a given
+		// target form a contiguous range which can be found with a binary search
+		std::vector<std::pair<edb::address_t, edb::address_t>> xrefs;
+
 		QByteArray md5;
 		bool fuzzy;
 		std::shared_ptr<IRegion> region;
 
 		// a copy of the whole region
 		QVector<uint8_t> memory;
+
+		// calls to these never return, gathered from the symbols up front
+		// so that the background analysis doesn't need the symbol manager
+		QSet<edb::address_t> noReturnFunctions;
+	};
+
+	// the state of a single region's analysis while it runs on the thread pool.
+	// Only the worker touches <data>, the GUI thread only reads the atomics and
+	// the partial results under the mutex. The partial results which are in
+	// view are a copy only the GUI thread touches, they go away with the job
+	struct AnalysisJob {
+		RegionData data;
+		bool useCache = false;
+		std::atomic<bool> cancelled{false};
+		std::atomic<int> progress{0};
+
+		QMutex mutex;
+		FunctionMap partialFunctions;
+		bool partialUpdated = false;
+
+		FunctionMap publishedFunctions;
+
+		// finishes once the results are in place, or the job was cancelled
+		QFutureInterface<void> done;
 	};
 
 	QMenu *menu_                    = nullptr;
 	AnalyzerWidget *analyzerWidget_ = nullptr;
+	QTimer *progressTimer_          = nullptr;
 	QHash<edb::address_t, RegionData> analysisInfo_;
+	QHash<edb::address_t, std::shared_ptr<AnalysisJob>> jobs_;
+
+	// every analyzed function of every region, sorted by entry address
+	std::vector<FunctionRange> functionRanges_;
 	QSet<edb::address_t> specifiedFunctions_;
+	QThreadPool threadPool_;
 };
 
 }
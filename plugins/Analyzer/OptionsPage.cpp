@@ -31,6 +31,7 @@ OptionsPage::OptionsPage(QWidget *parent, Qt::WindowFlags f)
 
 	ui.setupUi(this);
 	connect(ui.checkBox, &QCheckBox::toggled, this, &OptionsPage::checkBoxToggled);
+	connect(ui.checkBoxCache, &QCheckBox::toggled, this, &OptionsPage::checkBoxCacheToggled);
 }
 
 /**
@@ -42,6 +43,7 @@ void OptionsPage::showEvent(QShowEvent *event) {
 
 	QSettings settings;
 	ui.checkBox->setChecked(settings.value("Analyzer/fuzzy_logic_functions.enabled", true).toBool());
+	ui.checkBoxCache->setChecked(settings.value("Analyzer/analysis_cache.enabled", true).toBool());
 }
 
 /**
@@ -55,4 +57,15 @@ void OptionsPage::checkBoxToggled(bool checked) {
 	settings.setValue("Analyzer/fuzzy_logic_functions.enabled", ui.checkBox->isChecked());
 }
 
+/**
+ * @brief OptionsPage::checkBoxCacheToggled
+ * @param checked
+ */
+void OptionsPage::checkBoxCacheToggled(bool checked) {
+	Q_UNUSED(checked)
+
+	QSettings settings;
+	settings.setValue("Analyzer/analysis_cache.enabled", ui.checkBoxCache->isChecked());
+}
+
 }
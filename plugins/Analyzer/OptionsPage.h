@@ -36,6 +36,7 @@ public:
 
 private:
 	void checkBoxToggled(bool checked = false);
+	void checkBoxCacheToggled(bool checked = false);
 
 private:
 	Ui::OptionsPage ui;
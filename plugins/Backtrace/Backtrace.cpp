@@ -18,6 +18,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Backtrace.h"
 #include "DialogBacktrace.h"
+#include "OptionsPage.h"
 #include "edb.h"
 
 #include <QKeySequence>
@@ -40,6 +41,24 @@ Backtrace::~Backtrace() {
 	delete dialog_;
 }
 
+/**
+ * @brief Backtrace::privateInit
+ */
+void Backtrace::privateInit() {
+
+	// the modules may be rebuilt or replaced before the next session
+	if (edb::v1::debugger_ui) {
+		connect(edb::v1::debugger_ui, SIGNAL(detachEvent()), this, SLOT(clearModuleCache()));
+	}
+}
+
+/**
+ * @brief Backtrace::clearModuleCache
+ */
+void Backtrace::clearModuleCache() {
+	moduleCache_.clear();
+}
+
 /**
  * @brief Backtrace::menu
  * @param parent
@@ -60,12 +79,20 @@ QMenu *Backtrace::menu(QWidget *parent) {
 	return menu_;
 }
 
+/**
+ * @brief Backtrace::optionsPage
+ * @return
+ */
+QWidget *Backtrace::optionsPage() {
+	return new OptionsPage;
+}
+
 /**
  * @brief Backtrace::showMenu
  */
 void Backtrace::showMenu() {
 	if (!dialog_) {
-		dialog_ = new DialogBacktrace(edb::v1::debugger_ui);
+		dialog_ = new DialogBacktrace(&moduleCache_, edb::v1::debugger_ui);
 	}
 	dialog_->show();
 }
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef BACKTRACE_H_20191119_
 #define BACKTRACE_H_20191119_
 
+#include "EhFrameUnwinder.h"
 #include "IPlugin.h"
 
 class QMenu;
@@ -39,13 +40,21 @@ public:
 
 public:
 	QMenu *menu(QWidget *parent = nullptr) override;
+	QWidget *optionsPage() override;
+
+private:
+	void privateInit() override;
 
 public Q_SLOTS:
 	void showMenu();
 
+private Q_SLOTS:
+	void clearModuleCache();
+
 private:
 	QMenu *menu_              = nullptr;
 	QPointer<QDialog> dialog_ = nullptr;
+	EhFrameModuleCache moduleCache_;
 };
 
 }
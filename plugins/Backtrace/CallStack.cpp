@@ -17,7 +17,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "CallStack.h"
-#include "Expression.h"
+#include "EhFrameUnwinder.h"
 #include "IDebugger.h"
 #include "IProcess.h"
 #include "IRegion.h"
@@ -27,12 +27,37 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "State.h"
 #include "edb.h"
 
+#include <QHash>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include <vector>
+
 // TODO: This may be specific to x86... Maybe abstract this in the future.
 
+namespace {
+
+// Never look at more than this much of the stack, no matter how big the
+// stack region is
+constexpr size_t MaxStackSnapshot = 1024 * 1024;
+
+// Makes assumption of size of call.
+constexpr uint8_t CallMinSize = 2;
+constexpr uint8_t CallMaxSize = 7;
+
+}
+
 /**
  * @brief CallStack::CallStack
+ * @param moduleCache the parsed unwind information of the modules
+ * @param maxFrames the maximum number of frames to unwind
+ * @param useEhFrame whether to use the DWARF unwind information of the
+ * modules before falling back to frame pointers and heuristics
  */
-CallStack::CallStack() {
+CallStack::CallStack(BacktracePlugin::EhFrameModuleCache *moduleCache, size_t maxFrames, bool useEhFrame)
+	: moduleCache_(moduleCache), maxFrames_(maxFrames), useEhFrame_(useEhFrame) {
 	getCallStack();
 }
 
@@ -57,54 +82,226 @@ void CallStack::getCallStack() {
 			const edb::address_t rbp = state.framePointer();
 			const edb::address_t rsp = state.stackPointer();
 
-			// Check the alignment.  rbp and rsp should be aligned to the stack.
-			if (rbp % edb::v1::pointer_size() != 0 || rsp % edb::v1::pointer_size() != 0) {
-				qDebug("It appears that the application is not using frame pointers, call stack unavailable.");
+			tid_            = thread->tid();
+			instructionPtr_ = state.instructionPointer();
+			stackPtr_       = rsp;
+			framePtr_       = rbp;
+
+			const size_t pointerSize = edb::v1::pointer_size();
+
+			// Check the alignment. rsp should be aligned to the stack.
+			if (rsp % pointerSize != 0) {
+				qDebug("The stack pointer is misaligned, call stack unavailable.");
 				return;
 			}
 
-			// Make sure frame pointer is pointing in the same region as stack pointer.
-			// If not, then it's being used as a GPR, and we don't have enough info.
 			// This assumes the stack pointer is always pointing somewhere in the stack.
-			edb::v1::memory_regions().sync();
+			edb::v1::memory_regions().revalidate();
 			std::shared_ptr<IRegion> region_rsp = edb::v1::memory_regions().findRegion(rsp);
-			std::shared_ptr<IRegion> region_rbp = edb::v1::memory_regions().findRegion(rbp);
-			if (!region_rsp || !region_rbp || (region_rbp != region_rsp)) {
+			if (!region_rsp) {
 				return;
 			}
 
-			// But if we're good, then scan from rbp downward and look for return addresses.
-			// Code is largely from CommentServer.cpp.  Makes assumption of size of call.
-			constexpr uint8_t CallMinSize = 2;
-			constexpr uint8_t CallMaxSize = 7;
-
-			uint8_t buffer[edb::Instruction::MaxSize];
-			for (edb::address_t addr = rbp; region_rbp->contains(addr); addr += edb::v1::pointer_size()) {
-
-				// Get the stack value so that we can see if it's a pointer
-				bool ok;
-				ExpressionError err;
-				edb::address_t possible_ret = edb::v1::get_value(addr, &ok, &err);
-
-				if (process->readBytes(possible_ret - CallMaxSize, buffer, sizeof(buffer))) { // 0xfffff... if not a ptr.
-					for (int i = (CallMaxSize - CallMinSize); i >= 0; --i) {
-						edb::Instruction inst(buffer + i, buffer + sizeof(buffer), 0);
-
-						// If it's a call, then make a frame
-						if (is_call(inst)) {
-							StackFrame frame;
-							frame.ret    = possible_ret;
-							frame.caller = possible_ret - CallMaxSize + i;
-							stackFrames_.push_back(frame);
-							break;
+			// Only executable regions can contain return addresses, so remember
+			// where they are, that lets us skip most words without reading
+			// any more memory
+			std::vector<std::pair<edb::address_t, edb::address_t>> code_ranges;
+			for (const std::shared_ptr<IRegion> &region : edb::v1::memory_regions().regions()) {
+				if (region->executable()) {
+					code_ranges.emplace_back(region->start(), region->end());
+				}
+			}
+
+			std::sort(code_ranges.begin(), code_ranges.end());
+
+			auto is_code = [&code_ranges](edb::address_t address) {
+				auto it = std::upper_bound(code_ranges.begin(), code_ranges.end(), address, [](edb::address_t addr, const std::pair<edb::address_t, edb::address_t> &range) {
+					return addr < range.first;
+				});
+
+				return it != code_ranges.begin() && address < std::prev(it)->second;
+			};
+
+			// The live part of the stack is everything from the stack pointer to
+			// the end of the region, grab it all in one go
+			const size_t stack_size = std::min<size_t>(region_rsp->end() - rsp, MaxStackSnapshot);
+			std::vector<uint8_t> stack(stack_size);
+			if (!process->readBytes(rsp, stack.data(), stack.size())) {
+				return;
+			}
+
+			const edb::address_t stack_end = rsp + stack_size;
+
+			auto read_stack = [&](edb::address_t address, edb::address_t *value) {
+				if (address < rsp || address + pointerSize > stack_end) {
+					return false;
+				}
+
+				*value = 0;
+				std::memcpy(value, &stack[address - rsp], pointerSize);
+				return true;
+			};
+
+			// A return address must point into code, right after a call.
+			// The same return address is often found more than once, so we
+			// remember the answer for each candidate.
+			QHash<edb::address_t, edb::address_t> callers;
+
+			auto find_caller = [&](edb::address_t possible_ret, edb::address_t *caller) {
+				if (possible_ret < CallMaxSize || !is_code(possible_ret)) {
+					return false;
+				}
+
+				auto it = callers.find(possible_ret);
+				if (it == callers.end()) {
+					edb::address_t call_address = 0;
+
+					uint8_t buffer[edb::Instruction::MaxSize];
+					if (process->readBytes(possible_ret - CallMaxSize, buffer, sizeof(buffer))) {
+						for (int i = (CallMaxSize - CallMinSize); i >= 0; --i) {
+							edb::Instruction inst(buffer + i, buffer + sizeof(buffer), 0);
+
+							// If it's a call, then make a frame
+							if (is_call(inst) && inst.byteSize() == static_cast<size_t>(CallMaxSize - i)) {
+								call_address = possible_ret - CallMaxSize + i;
+								break;
+							}
 						}
 					}
+
+					it = callers.insert(possible_ret, call_address);
+				}
+
+				*caller = *it;
+				return *caller != 0;
+			};
+
+			auto push_frame = [this, &find_caller](edb::address_t possible_ret) {
+				edb::address_t caller;
+				if (find_caller(possible_ret, &caller)) {
+					StackFrame frame;
+					frame.ret    = possible_ret;
+					frame.caller = caller;
+					stackFrames_.push_back(frame);
+					return true;
+				}
+				return false;
+			};
+
+			// The unwind information is exact when we have it, so use it for as
+			// many frames as we can. When it runs out (hand written assembly,
+			// JIT code, ...) we carry on from the last frame it recovered.
+			edb::address_t frame_sp = rsp;
+			edb::address_t frame_fp = rbp;
+
+			if (useEhFrame_) {
+				BacktracePlugin::EhFrameUnwinder unwinder(state, moduleCache_, [&](edb::address_t address, void *buffer, size_t size) {
+					if (address >= rsp && address + size <= stack_end) {
+						std::memcpy(buffer, &stack[address - rsp], size);
+						return true;
+					}
+
+					return process->readBytes(address, buffer, size);
+				});
+
+				while (stackFrames_.size() < maxFrames_ && unwinder.step()) {
+					StackFrame frame;
+					frame.ret = unwinder.instructionPointer();
+
+					// frames interrupted by a signal don't return to a call
+					if (!find_caller(frame.ret, &frame.caller)) {
+						frame.caller = frame.ret;
+					}
+
+					stackFrames_.push_back(frame);
+
+					frame_sp = unwinder.stackPointer();
+					frame_fp = unwinder.framePointer();
+				}
+
+				if (unwinder.complete()) {
+					return;
+				}
+			}
+
+			// Next, follow the frame pointer chain for as long as it makes sense.
+			// If rbp isn't pointing into the stack, then it's being used as a GPR,
+			// and we have to fall back to scanning from the stack pointer.
+			edb::address_t scan_address = frame_sp;
+			bool chain_complete         = false;
+
+			if (frame_fp % pointerSize == 0 && frame_fp >= frame_sp && frame_fp < stack_end) {
+				scan_address = frame_fp;
+
+				edb::address_t frame = frame_fp;
+				while (stackFrames_.size() < maxFrames_) {
+					edb::address_t next_frame;
+					edb::address_t possible_ret;
+					if (!read_stack(frame, &next_frame) || !read_stack(frame + pointerSize, &possible_ret)) {
+						break;
+					}
+
+					if (!push_frame(possible_ret)) {
+						break;
+					}
+
+					scan_address = frame + 2 * pointerSize;
+
+					// a null frame pointer marks the outermost frame
+					if (next_frame == 0) {
+						chain_complete = true;
+						break;
+					}
+
+					// frames must move toward the base of the stack, otherwise
+					// this isn't really a frame pointer chain
+					if (next_frame <= frame || next_frame % pointerSize != 0) {
+						break;
+					}
+
+					frame = next_frame;
+				}
+			}
+
+			// If the chain broke somewhere, scan what's left of the stack for
+			// anything which looks like a return address
+			if (!chain_complete) {
+				for (edb::address_t addr = scan_address; stackFrames_.size() < maxFrames_; addr += pointerSize) {
+
+					edb::address_t possible_ret;
+					if (!read_stack(addr, &possible_ret)) {
+						break;
+					}
+
+					push_frame(possible_ret);
 				}
 			}
 		}
 	}
 }
 
+/**
+ * @brief CallStack::isCurrent
+ *
+ * The call stack can only change when the thread runs, or the user edits its
+ * registers, so as long as the registers we unwound from are the same, there
+ * is no need to unwind again.
+ *
+ * @return true if the call stack was derived from the current state of the
+ * current thread
+ */
+bool CallStack::isCurrent() const {
+	if (IProcess *process = edb::v1::debugger_core->process()) {
+		if (std::shared_ptr<IThread> thread = process->currentThread()) {
+			State state;
+			thread->getState(&state);
+			return tid_ == thread->tid() && instructionPtr_ == state.instructionPointer() && stackPtr_ == state.stackPointer() && framePtr_ == state.framePointer();
+		}
+	}
+
+	return false;
+}
+
 /**
  * @brief CallStack::operator []
  *
@@ -22,9 +22,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "edb.h"
 #include <deque>
 
+namespace BacktracePlugin {
+class EhFrameModuleCache;
+}
+
 class CallStack {
 public:
-	CallStack();
+	static constexpr size_t DefaultMaxFrames = 256;
+
+public:
+	explicit CallStack(BacktracePlugin::EhFrameModuleCache *moduleCache, size_t maxFrames = DefaultMaxFrames, bool useEhFrame = true);
 	~CallStack() = default;
 
 public:
@@ -44,8 +51,22 @@ public:
 	StackFrame *bottom();
 	void push(StackFrame frame);
 
+public:
+	bool isCurrent() const;
+	size_t maxFrames() const { return maxFrames_; }
+	bool useEhFrame() const { return useEhFrame_; }
+
 private:
 	std::deque<StackFrame> stackFrames_;
+	BacktracePlugin::EhFrameModuleCache *moduleCache_;
+	size_t maxFrames_;
+	bool useEhFrame_;
+
+	// the registers the call stack was derived from
+	edb::tid_t tid_                = 0;
+	edb::address_t instructionPtr_ = 0;
+	edb::address_t stackPtr_       = 0;
+	edb::address_t framePtr_       = 0;
 };
 
 #endif
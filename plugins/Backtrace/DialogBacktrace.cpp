@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Symbol.h"
 
 #include <QPushButton>
+#include <QSettings>
 #include <QTableWidget>
 
 namespace BacktracePlugin {
@@ -81,11 +82,12 @@ bool is_ret(const QTableWidgetItem *item) {
  * current RIP/PC, and "Run To Return" should do a "Step Out"
  * (the behavior for the 1st row should be different than all others.
  *
+ * @param moduleCache
  * @param parent
  * @param f
  */
-DialogBacktrace::DialogBacktrace(QWidget *parent, Qt::WindowFlags f)
-	: QDialog(parent, f) {
+DialogBacktrace::DialogBacktrace(EhFrameModuleCache *moduleCache, QWidget *parent, Qt::WindowFlags f)
+	: QDialog(parent, f), moduleCache_(moduleCache) {
 
 	ui.setupUi(this);
 
@@ -127,6 +129,9 @@ DialogBacktrace::DialogBacktrace(QWidget *parent, Qt::WindowFlags f)
 	});
 
 	ui.buttonBox->addButton(buttonReturnTo_, QDialogButtonBox::ActionRole);
+
+	// Anything may have changed once the debuggee ran
+	connect(edb::v1::debugger_ui, SIGNAL(debugEvent()), this, SLOT(invalidateCallStack()));
 }
 
 /**
@@ -158,6 +163,16 @@ void DialogBacktrace::populateTable() {
 	// TODO: The first row should break protocol and display the current RIP/PC.
 	//		It should be treated specially on "Run To Return" and do a "Step Out"
 
+	// The UI is updated far more often than the debuggee actually stops, so
+	// only unwind the stack again if we are looking at a different stop
+	QSettings settings;
+	const size_t max_frames = settings.value("Backtrace/max_frames", static_cast<qulonglong>(CallStack::DefaultMaxFrames)).toULongLong();
+	const bool use_eh_frame = settings.value("Backtrace/use_eh_frame", true).toBool();
+
+	if (callStack_ && callStack_->maxFrames() == max_frames && callStack_->useEhFrame() == use_eh_frame && callStack_->isCurrent()) {
+		return;
+	}
+
 	// Remove rows of the table (clearing does not remove rows)
 	// Yes, we depend on i going negative.
 	for (int i = table_->rowCount() - 1; i >= 0; i--) {
@@ -165,8 +180,9 @@ void DialogBacktrace::populateTable() {
 	}
 
 	// Get the call stack and populate the table with entries.
-	CallStack call_stack;
-	const size_t size = call_stack.size();
+	callStack_            = std::make_unique<CallStack>(moduleCache_, max_frames, use_eh_frame);
+	CallStack &call_stack = *callStack_;
+	const size_t size     = call_stack.size();
 	for (size_t i = 0; i < size; i++) {
 
 		// Create the row to insert info
@@ -229,6 +245,18 @@ void DialogBacktrace::populateTable() {
  */
 void DialogBacktrace::hideEvent(QHideEvent *) {
 	disconnect(edb::v1::debugger_ui, SIGNAL(uiUpdated()), this, SLOT(populateTable()));
+	invalidateCallStack();
+}
+
+/**
+ * @brief DialogBacktrace::invalidateCallStack
+ *
+ * Forgets the cached call stack so that the next call to populateTable()
+ * unwinds the stack again.
+ *
+ */
+void DialogBacktrace::invalidateCallStack() {
+	callStack_ = nullptr;
 }
 
 /**
@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "ui_DialogBacktrace.h"
 #include <QDialog>
 #include <QTableWidget>
+#include <memory>
 
 namespace BacktracePlugin {
 
@@ -30,7 +31,7 @@ class DialogBacktrace : public QDialog {
 	Q_OBJECT
 
 public:
-	explicit DialogBacktrace(QWidget *parent = nullptr, Qt::WindowFlags f = Qt::WindowFlags());
+	explicit DialogBacktrace(EhFrameModuleCache *moduleCache, QWidget *parent = nullptr, Qt::WindowFlags f = Qt::WindowFlags());
 	~DialogBacktrace() override = default;
 
 protected:
@@ -43,11 +44,14 @@ public Q_SLOTS:
 private Q_SLOTS:
 	void on_tableWidgetCallStack_itemDoubleClicked(QTableWidgetItem *item);
 	void on_tableWidgetCallStack_cellClicked(int row, int column);
+	void invalidateCallStack();
 
 private:
 	Ui::DialogBacktrace ui;
 	QTableWidget *table_;
 	QPushButton *buttonReturnTo_;
+	EhFrameModuleCache *moduleCache_;
+	std::unique_ptr<CallStack> callStack_;
 };
 
 }
@@ -0,0 +1,1408 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "EhFrameUnwinder.h"
+#include "IRegion.h"
+#include "MemoryRegions.h"
+#include "Register.h"
+#include "State.h"
+#include "edb.h"
+#include "libELF/elf_header.h"
+#include "libELF/elf_model.h"
+#include "libELF/elf_phdr.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace BacktracePlugin {
+
+namespace {
+
+// pointer encodings used by .eh_frame and .eh_frame_hdr
+constexpr uint8_t DW_EH_PE_absptr  = 0x00;
+constexpr uint8_t DW_EH_PE_uleb128 = 0x01;
+constexpr uint8_t DW_EH_PE_udata2  = 0x02;
+constexpr uint8_t DW_EH_PE_udata4  = 0x03;
+constexpr uint8_t DW_EH_PE_udata8  = 0x04;
+constexpr uint8_t DW_EH_PE_sleb128 = 0x09;
+constexpr uint8_t DW_EH_PE_sdata2  = 0x0a;
+constexpr uint8_t DW_EH_PE_sdata4  = 0x0b;
+constexpr uint8_t DW_EH_PE_sdata8  = 0x0c;
+constexpr uint8_t DW_EH_PE_pcrel   = 0x10;
+constexpr uint8_t DW_EH_PE_datarel = 0x30;
+constexpr uint8_t DW_EH_PE_omit    = 0xff;
+
+// call frame instructions
+constexpr uint8_t DW_CFA_advance_loc                  = 0x40;
+constexpr uint8_t DW_CFA_offset                       = 0x80;
+constexpr uint8_t DW_CFA_restore                      = 0xc0;
+constexpr uint8_t DW_CFA_nop                          = 0x00;
+constexpr uint8_t DW_CFA_set_loc                      = 0x01;
+constexpr uint8_t DW_CFA_advance_loc1                 = 0x02;
+constexpr uint8_t DW_CFA_advance_loc2                 = 0x03;
+constexpr uint8_t DW_CFA_advance_loc4                 = 0x04;
+constexpr uint8_t DW_CFA_offset_extended              = 0x05;
+constexpr uint8_t DW_CFA_restore_extended             = 0x06;
+constexpr uint8_t DW_CFA_undefined                    = 0x07;
+constexpr uint8_t DW_CFA_same_value                   = 0x08;
+constexpr uint8_t DW_CFA_register                     = 0x09;
+constexpr uint8_t DW_CFA_remember_state               = 0x0a;
+constexpr uint8_t DW_CFA_restore_state                = 0x0b;
+constexpr uint8_t DW_CFA_def_cfa                      = 0x0c;
+constexpr uint8_t DW_CFA_def_cfa_register             = 0x0d;
+constexpr uint8_t DW_CFA_def_cfa_offset               = 0x0e;
+constexpr uint8_t DW_CFA_def_cfa_expression           = 0x0f;
+constexpr uint8_t DW_CFA_expression                   = 0x10;
+constexpr uint8_t DW_CFA_offset_extended_sf           = 0x11;
+constexpr uint8_t DW_CFA_def_cfa_sf                   = 0x12;
+constexpr uint8_t DW_CFA_def_cfa_offset_sf            = 0x13;
+constexpr uint8_t DW_CFA_val_offset                   = 0x14;
+constexpr uint8_t DW_CFA_val_offset_sf                = 0x15;
+constexpr uint8_t DW_CFA_val_expression               = 0x16;
+constexpr uint8_t DW_CFA_GNU_args_size                = 0x2e;
+constexpr uint8_t DW_CFA_GNU_negative_offset_extended = 0x2f;
+
+// the subset of DWARF expression operations which show up in CFI
+constexpr uint8_t DW_OP_deref       = 0x06;
+constexpr uint8_t DW_OP_const1u     = 0x08;
+constexpr uint8_t DW_OP_const1s     = 0x09;
+constexpr uint8_t DW_OP_const2u     = 0x0a;
+constexpr uint8_t DW_OP_const2s     = 0x0b;
+constexpr uint8_t DW_OP_const4u     = 0x0c;
+constexpr uint8_t DW_OP_const4s     = 0x0d;
+constexpr uint8_t DW_OP_const8u     = 0x0e;
+constexpr uint8_t DW_OP_const8s     = 0x0f;
+constexpr uint8_t DW_OP_constu      = 0x10;
+constexpr uint8_t DW_OP_consts      = 0x11;
+constexpr uint8_t DW_OP_dup         = 0x12;
+constexpr uint8_t DW_OP_drop        = 0x13;
+constexpr uint8_t DW_OP_over        = 0x14;
+constexpr uint8_t DW_OP_swap        = 0x16;
+constexpr uint8_t DW_OP_and         = 0x1a;
+constexpr uint8_t DW_OP_minus       = 0x1c;
+constexpr uint8_t DW_OP_mul         = 0x1e;
+constexpr uint8_t DW_OP_neg         = 0x1f;
+constexpr uint8_t DW_OP_not         = 0x20;
+constexpr uint8_t DW_OP_or          = 0x21;
+constexpr uint8_t DW_OP_plus        = 0x22;
+constexpr uint8_t DW_OP_plus_uconst = 0x23;
+constexpr uint8_t DW_OP_shl         = 0x24;
+constexpr uint8_t DW_OP_shr         = 0x25;
+constexpr uint8_t DW_OP_shra        = 0x26;
+constexpr uint8_t DW_OP_xor         = 0x27;
+constexpr uint8_t DW_OP_eq          = 0x29;
+constexpr uint8_t DW_OP_ge          = 0x2a;
+constexpr uint8_t DW_OP_gt          = 0x2b;
+constexpr uint8_t DW_OP_le          = 0x2c;
+constexpr uint8_t DW_OP_lt          = 0x2d;
+constexpr uint8_t DW_OP_ne          = 0x2e;
+constexpr uint8_t DW_OP_lit0        = 0x30;
+constexpr uint8_t DW_OP_lit31       = 0x4f;
+constexpr uint8_t DW_OP_reg0        = 0x50;
+constexpr uint8_t DW_OP_reg31       = 0x6f;
+constexpr uint8_t DW_OP_breg0       = 0x70;
+constexpr uint8_t DW_OP_breg31      = 0x8f;
+constexpr uint8_t DW_OP_regx        = 0x90;
+constexpr uint8_t DW_OP_bregx       = 0x92;
+constexpr uint8_t DW_OP_nop         = 0x96;
+
+// How the DWARF register numbers map onto the machine
+struct Architecture {
+	size_t registerCount;
+	size_t stackPointer;
+	size_t framePointer;
+	size_t returnAddress;
+	std::array<size_t, 16> gprIndex; // DWARF register number -> index for State::gpRegister
+};
+
+#if defined(EDB_X86) || defined(EDB_X86_64)
+constexpr Architecture ArchX86_64 = {17, 7, 6, 16, {{0, 2, 1, 3, 6, 7, 5, 4, 8, 9, 10, 11, 12, 13, 14, 15}}};
+constexpr Architecture ArchX86    = {9, 4, 5, 8, {{0, 1, 2, 3, 4, 5, 6, 7}}};
+#endif
+
+/**
+ * @brief architecture
+ * @param is64Bit
+ * @return the register numbering of the debuggee, or nullptr if we don't know
+ * how to unwind its stack
+ */
+const Architecture *architecture(bool is64Bit) {
+#if defined(EDB_X86) || defined(EDB_X86_64)
+	return is64Bit ? &ArchX86_64 : &ArchX86;
+#else
+	Q_UNUSED(is64Bit)
+	return nullptr;
+#endif
+}
+
+/**
+ * @brief The Reader class
+ *
+ * A bounds checked cursor over a block of unwind information which also knows
+ * which (link time) address it is looking at, for pc relative pointers.
+ * Reading past the end marks the reader as failed and yields zeroes.
+ */
+class Reader {
+public:
+	Reader() = default;
+	Reader(const uint8_t *first, const uint8_t *last, uint64_t address)
+		: first_(first), ptr_(first), last_(last), address_(address) {
+	}
+
+public:
+	bool failed() const { return failed_; }
+	bool atEnd() const { return ptr_ >= last_; }
+	size_t remaining() const { return static_cast<size_t>(last_ - ptr_); }
+	uint64_t address() const { return address_ + static_cast<uint64_t>(ptr_ - first_); }
+
+public:
+	template <class T>
+	T read() {
+		T value = 0;
+		if (remaining() < sizeof(T)) {
+			fail();
+			return value;
+		}
+
+		std::memcpy(&value, ptr_, sizeof(T));
+		ptr_ += sizeof(T);
+		return value;
+	}
+
+	void skip(uint64_t n) {
+		if (remaining() < n) {
+			fail();
+			return;
+		}
+		ptr_ += n;
+	}
+
+	Reader sub(uint64_t n) {
+		if (remaining() < n) {
+			fail();
+			return Reader();
+		}
+
+		Reader r(ptr_, ptr_ + n, address());
+		ptr_ += n;
+		return r;
+	}
+
+	uint64_t uleb128() {
+		uint64_t result = 0;
+		unsigned shift  = 0;
+		uint8_t byte;
+		do {
+			byte = read<uint8_t>();
+			if (shift < 64) {
+				result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			}
+			shift += 7;
+		} while ((byte & 0x80) && !failed_);
+		return result;
+	}
+
+	int64_t sleb128() {
+		uint64_t result = 0;
+		unsigned shift  = 0;
+		uint8_t byte;
+		do {
+			byte = read<uint8_t>();
+			if (shift < 64) {
+				result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			}
+			shift += 7;
+		} while ((byte & 0x80) && !failed_);
+
+		if (shift < 64 && (byte & 0x40)) {
+			result |= ~uint64_t(0) << shift;
+		}
+		return static_cast<int64_t>(result);
+	}
+
+	uint64_t encoded(uint8_t encoding, bool is64Bit, uint64_t dataBase = 0) {
+
+		if (encoding == DW_EH_PE_omit) {
+			return 0;
+		}
+
+		const uint64_t field = address();
+
+		uint64_t value;
+		switch (encoding & 0x0f) {
+		case DW_EH_PE_absptr:
+			value = is64Bit ? read<uint64_t>() : read<uint32_t>();
+			break;
+		case DW_EH_PE_uleb128:
+			value = uleb128();
+			break;
+		case DW_EH_PE_udata2:
+			value = read<uint16_t>();
+			break;
+		case DW_EH_PE_udata4:
+			value = read<uint32_t>();
+			break;
+		case DW_EH_PE_udata8:
+			value = read<uint64_t>();
+			break;
+		case DW_EH_PE_sleb128:
+			value = static_cast<uint64_t>(sleb128());
+			break;
+		case DW_EH_PE_sdata2:
+			value = static_cast<uint64_t>(static_cast<int64_t>(read<int16_t>()));
+			break;
+		case DW_EH_PE_sdata4:
+			value = static_cast<uint64_t>(static_cast<int64_t>(read<int32_t>()));
+			break;
+		case DW_EH_PE_sdata8:
+			value = static_cast<uint64_t>(read<int64_t>());
+			break;
+		default:
+			fail();
+			return 0;
+		}
+
+		// NOTE(eteran): DW_EH_PE_indirect is only used for personality routines,
+		// which we skip over anyway, so it is quietly ignored here
+		switch (encoding & 0x70) {
+		case 0:
+			break;
+		case DW_EH_PE_pcrel:
+			value += field;
+			break;
+		case DW_EH_PE_datarel:
+			value += dataBase;
+			break;
+		default:
+			fail();
+			return 0;
+		}
+
+		return is64Bit ? value : (value & 0xffffffff);
+	}
+
+private:
+	void fail() {
+		failed_ = true;
+		ptr_    = last_;
+	}
+
+private:
+	const uint8_t *first_ = nullptr;
+	const uint8_t *ptr_   = nullptr;
+	const uint8_t *last_  = nullptr;
+	uint64_t address_     = 0;
+	bool failed_          = false;
+};
+
+struct Cie {
+	uint64_t codeAlignment         = 1;
+	int64_t dataAlignment          = 0;
+	uint64_t returnAddressRegister = 0;
+	uint8_t fdeEncoding            = DW_EH_PE_absptr;
+	bool hasAugmentationData       = false;
+	bool signalFrame               = false;
+	Reader instructions;
+};
+
+struct Fde {
+	uint64_t pcBegin = 0;
+	uint64_t pcEnd   = 0;
+	Cie cie;
+	Reader instructions;
+};
+
+enum RuleType {
+	RULE_SAME_VALUE,
+	RULE_UNDEFINED,
+	RULE_OFFSET,
+	RULE_VAL_OFFSET,
+	RULE_REGISTER,
+	RULE_EXPRESSION,
+	RULE_VAL_EXPRESSION,
+};
+
+struct Rule {
+	RuleType type = RULE_SAME_VALUE;
+	int64_t value = 0;
+	Reader expression;
+};
+
+// one row of the call frame information table
+struct Row {
+	uint64_t cfaRegister = 0;
+	int64_t cfaOffset    = 0;
+	bool cfaIsExpression = false;
+	Reader cfaExpression;
+	std::array<Rule, EhFrameUnwinder::MaxRegisters> rules;
+};
+
+/**
+ * @brief read_entry_header
+ *
+ * Reads the length and id fields of a CIE or FDE
+ *
+ * @param reader
+ * @param entry receives a reader over the rest of the entry
+ * @param idAddress receives the address of the id field
+ * @param id
+ * @return
+ */
+bool read_entry_header(Reader &reader, Reader *entry, uint64_t *idAddress, uint64_t *id) {
+
+	uint64_t length    = reader.read<uint32_t>();
+	const bool dwarf64 = (length == 0xffffffff);
+	if (dwarf64) {
+		length = reader.read<uint64_t>();
+	}
+
+	if (length == 0 || reader.failed()) {
+		return false;
+	}
+
+	*entry     = reader.sub(length);
+	*idAddress = entry->address();
+	*id        = dwarf64 ? entry->read<uint64_t>() : entry->read<uint32_t>();
+	return !entry->failed();
+}
+
+/**
+ * @brief set_rule
+ * @param row
+ * @param reg
+ * @param type
+ * @param value
+ * @param expression
+ */
+void set_rule(Row *row, uint64_t reg, RuleType type, int64_t value = 0, const Reader &expression = Reader()) {
+	// rules for registers we don't track (vector registers and such) are
+	// simply dropped
+	if (reg < row->rules.size()) {
+		Rule &rule      = row->rules[reg];
+		rule.type       = type;
+		rule.value      = value;
+		rule.expression = expression;
+	}
+}
+
+/**
+ * @brief execute_cfa_program
+ *
+ * Runs call frame instructions until the row describing <target> is built
+ *
+ * @param program
+ * @param cie
+ * @param is64Bit
+ * @param location the address the program starts at
+ * @param target
+ * @param initial the row produced by the CIE's initial instructions
+ * @param row
+ * @return
+ */
+bool execute_cfa_program(Reader program, const Cie &cie, bool is64Bit, uint64_t location, uint64_t target, const Row &initial, Row *row) {
+
+	std::vector<Row> stack;
+
+	auto advance = [&](uint64_t delta) {
+		location += delta * cie.codeAlignment;
+		return location <= target;
+	};
+
+	while (!program.atEnd()) {
+		const uint8_t op = program.read<uint8_t>();
+
+		switch (op & 0xc0) {
+		case DW_CFA_advance_loc:
+			if (!advance(op & 0x3f)) {
+				return true;
+			}
+			continue;
+		case DW_CFA_offset:
+			set_rule(row, op & 0x3f, RULE_OFFSET, static_cast<int64_t>(program.uleb128()) * cie.dataAlignment);
+			continue;
+		case DW_CFA_restore:
+			if ((op & 0x3f) < row->rules.size()) {
+				row->rules[op & 0x3f] = initial.rules[op & 0x3f];
+			}
+			continue;
+		default:
+			break;
+		}
+
+		switch (op) {
+		case DW_CFA_nop:
+			break;
+		case DW_CFA_set_loc:
+			location = program.encoded(cie.fdeEncoding, is64Bit);
+			if (location > target) {
+				return true;
+			}
+			break;
+		case DW_CFA_advance_loc1:
+			if (!advance(program.read<uint8_t>())) {
+				return true;
+			}
+			break;
+		case DW_CFA_advance_loc2:
+			if (!advance(program.read<uint16_t>())) {
+				return true;
+			}
+			break;
+		case DW_CFA_advance_loc4:
+			if (!advance(program.read<uint32_t>())) {
+				return true;
+			}
+			break;
+		case DW_CFA_offset_extended: {
+			const uint64_t reg = program.uleb128();
+			set_rule(row, reg, RULE_OFFSET, static_cast<int64_t>(program.uleb128()) * cie.dataAlignment);
+			break;
+		}
+		case DW_CFA_offset_extended_sf: {
+			const uint64_t reg = program.uleb128();
+			set_rule(row, reg, RULE_OFFSET, program.sleb128() * cie.dataAlignment);
+			break;
+		}
+		case DW_CFA_GNU_negative_offset_extended: {
+			const uint64_t reg = program.uleb128();
+			set_rule(row, reg, RULE_OFFSET, -static_cast<int64_t>(program.uleb128()) * cie.dataAlignment);
+			break;
+		}
+		case DW_CFA_val_offset: {
+			const uint64_t reg = program.uleb128();
+			set_rule(row, reg, RULE_VAL_OFFSET, static_cast<int64_t>(program.uleb128()) * cie.dataAlignment);
+			break;
+		}
+		case DW_CFA_val_offset_sf: {
+			const uint64_t reg = program.uleb128();
+			set_rule(row, reg, RULE_VAL_OFFSET, program.sleb128() * cie.dataAlignment);
+			break;
+		}
+		case DW_CFA_restore_extended: {
+			const uint64_t reg = program.uleb128();
+			if (reg < row->rules.size()) {
+				row->rules[reg] = initial.rules[reg];
+			}
+			break;
+		}
+		case DW_CFA_undefined:
+			set_rule(row, program.uleb128(), RULE_UNDEFINED);
+			break;
+		case DW_CFA_same_value:
+			set_rule(row, program.uleb128(), RULE_SAME_VALUE);
+			break;
+		case DW_CFA_register: {
+			const uint64_t reg = program.uleb128();
+			set_rule(row, reg, RULE_REGISTER, static_cast<int64_t>(program.uleb128()));
+			break;
+		}
+		case DW_CFA_remember_state:
+			stack.push_back(*row);
+			break;
+		case DW_CFA_restore_state:
+			if (stack.empty()) {
+				return false;
+			}
+			*row = stack.back();
+			stack.pop_back();
+			break;
+		case DW_CFA_def_cfa:
+			row->cfaRegister     = program.uleb128();
+			row->cfaOffset       = static_cast<int64_t>(program.uleb128());
+			row->cfaIsExpression = false;
+			break;
+		case DW_CFA_def_cfa_sf:
+			row->cfaRegister     = program.uleb128();
+			row->cfaOffset       = program.sleb128() * cie.dataAlignment;
+			row->cfaIsExpression = false;
+			break;
+		case DW_CFA_def_cfa_register:
+			row->cfaRegister     = program.uleb128();
+			row->cfaIsExpression = false;
+			break;
+		case DW_CFA_def_cfa_offset:
+			row->cfaOffset = static_cast<int64_t>(program.uleb128());
+			break;
+		case DW_CFA_def_cfa_offset_sf:
+			row->cfaOffset = program.sleb128() * cie.dataAlignment;
+			break;
+		case DW_CFA_def_cfa_expression:
+			row->cfaExpression   = program.sub(program.uleb128());
+			row->cfaIsExpression = true;
+			break;
+		case DW_CFA_expression: {
+			const uint64_t reg = program.uleb128();
+			set_rule(row, reg, RULE_EXPRESSION, 0, program.sub(program.uleb128()));
+			break;
+		}
+		case DW_CFA_val_expression: {
+			const uint64_t reg = program.uleb128();
+			set_rule(row, reg, RULE_VAL_EXPRESSION, 0, program.sub(program.uleb128()));
+			break;
+		}
+		case DW_CFA_GNU_args_size:
+			program.uleb128();
+			break;
+		default:
+			// something we don't understand, we can't trust the row
+			return false;
+		}
+
+		if (program.failed()) {
+			return false;
+		}
+	}
+
+	return !program.failed();
+}
+
+}
+
+/**
+ * @brief The EhFrameModule class
+ *
+ * The unwind information of a single ELF file, along with a table of all of
+ * its FDEs sorted by the address of the code they describe. Everything is
+ * expressed in the file's own (link time) addresses.
+ */
+class EhFrameModule {
+public:
+	explicit EhFrameModule(const QString &filename);
+	EhFrameModule(const EhFrameModule &)            = delete;
+	EhFrameModule &operator=(const EhFrameModule &) = delete;
+
+public:
+	bool is64Bit() const { return is64Bit_; }
+	const QDateTime &lastModified() const { return lastModified_; }
+	bool addressForOffset(uint64_t offset, uint64_t *address) const;
+	bool findFde(uint64_t address, Fde *fde) const;
+
+private:
+	template <class M>
+	void load();
+	void walkEhFrame(uint64_t address);
+	bool parseCie(uint64_t address, Cie *cie) const;
+	bool parseFde(uint64_t address, Fde *fde) const;
+	Reader reader(uint64_t address) const;
+
+private:
+	struct Segment {
+		uint64_t address;
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	struct FdeEntry {
+		uint64_t pcBegin;
+		uint64_t fde;
+	};
+
+private:
+	QFile file_;
+	QDateTime lastModified_;
+	const uint8_t *data_ = nullptr;
+	uint64_t size_       = 0;
+	bool is64Bit_        = false;
+	std::vector<Segment> segments_;
+	std::vector<FdeEntry> entries_;
+};
+
+/**
+ * @brief EhFrameModule::EhFrameModule
+ * @param filename
+ */
+EhFrameModule::EhFrameModule(const QString &filename)
+	: file_(filename), lastModified_(QFileInfo(filename).lastModified()) {
+
+	if (!file_.open(QIODevice::ReadOnly)) {
+		return;
+	}
+
+	// NOTE(eteran): we keep the file mapped for as long as the module is
+	// cached, only the pages we actually look at will ever be read
+	data_ = file_.map(0, file_.size(), QFile::NoOptions);
+	size_ = data_ ? static_cast<uint64_t>(file_.size()) : 0;
+
+	if (size_ > EI_CLASS && std::memcmp(data_, ELFMAG, SELFMAG) == 0) {
+		switch (data_[EI_CLASS]) {
+		case ELFCLASS32:
+			load<elf_model<32>>();
+			break;
+		case ELFCLASS64:
+			is64Bit_ = true;
+			load<elf_model<64>>();
+			break;
+		}
+	}
+}
+
+/**
+ * @brief EhFrameModule::load
+ *
+ * Finds the .eh_frame_hdr through the program headers and builds the FDE
+ * table, either from the binary search table in the header, or if there isn't
+ * a usable one, by walking all of .eh_frame
+ */
+template <class M>
+void EhFrameModule::load() {
+
+	using elf_header = typename M::elf_header;
+	using elf_phdr   = typename M::elf_phdr;
+
+	if (size_ < sizeof(elf_header)) {
+		return;
+	}
+
+	auto header = reinterpret_cast<const elf_header *>(data_);
+	if (header->e_phoff == 0 || header->e_phoff + header->e_phnum * sizeof(elf_phdr) > size_) {
+		return;
+	}
+
+	uint64_t hdr_address = 0;
+	bool have_hdr        = false;
+
+	auto phdr = reinterpret_cast<const elf_phdr *>(data_ + header->e_phoff);
+	for (size_t i = 0; i < header->e_phnum; ++i) {
+		switch (phdr[i].p_type) {
+		case PT_LOAD:
+			if (phdr[i].p_filesz != 0 && phdr[i].p_offset + phdr[i].p_filesz <= size_) {
+				segments_.push_back({phdr[i].p_vaddr, phdr[i].p_offset, phdr[i].p_filesz});
+			}
+			break;
+		case PT_GNU_EH_FRAME:
+			hdr_address = phdr[i].p_vaddr;
+			have_hdr    = true;
+			break;
+		}
+	}
+
+	if (!have_hdr) {
+		return;
+	}
+
+	Reader hdr = reader(hdr_address);
+
+	const uint8_t version          = hdr.read<uint8_t>();
+	const uint8_t eh_frame_ptr_enc = hdr.read<uint8_t>();
+	const uint8_t fde_count_enc    = hdr.read<uint8_t>();
+	const uint8_t table_enc        = hdr.read<uint8_t>();
+	if (version != 1 || hdr.failed()) {
+		return;
+	}
+
+	const uint64_t eh_frame = hdr.encoded(eh_frame_ptr_enc, is64Bit_, hdr_address);
+	if (hdr.failed()) {
+		return;
+	}
+
+	// the linker almost always gives us a table we can use directly
+	if (fde_count_enc != DW_EH_PE_omit && table_enc == (DW_EH_PE_datarel | DW_EH_PE_sdata4)) {
+		const uint64_t count = hdr.encoded(fde_count_enc, is64Bit_, hdr_address);
+		if (!hdr.failed() && count <= hdr.remaining() / 8) {
+			entries_.reserve(count);
+			for (uint64_t i = 0; i < count; ++i) {
+				const int32_t pc_begin = hdr.read<int32_t>();
+				const int32_t fde      = hdr.read<int32_t>();
+
+				uint64_t entry_pc  = hdr_address + static_cast<uint64_t>(static_cast<int64_t>(pc_begin));
+				uint64_t entry_fde = hdr_address + static_cast<uint64_t>(static_cast<int64_t>(fde));
+				if (!is64Bit_) {
+					entry_pc &= 0xffffffff;
+					entry_fde &= 0xffffffff;
+				}
+
+				entries_.push_back({entry_pc, entry_fde});
+			}
+
+			if (std::is_sorted(entries_.begin(), entries_.end(), [](const FdeEntry &lhs, const FdeEntry &rhs) { return lhs.pcBegin < rhs.pcBegin; })) {
+				return;
+			}
+
+			entries_.clear();
+		}
+	}
+
+	walkEhFrame(eh_frame);
+}
+
+/**
+ * @brief EhFrameModule::walkEhFrame
+ * @param address the address of the .eh_frame section
+ */
+void EhFrameModule::walkEhFrame(uint64_t address) {
+
+	Reader eh_frame = reader(address);
+	while (!eh_frame.atEnd()) {
+		const uint64_t entry_address = eh_frame.address();
+
+		Reader entry;
+		uint64_t id_address;
+		uint64_t id;
+		if (!read_entry_header(eh_frame, &entry, &id_address, &id)) {
+			break;
+		}
+
+		// CIEs have an id of zero, for FDEs it is the distance back to their CIE
+		if (id == 0) {
+			continue;
+		}
+
+		Cie cie;
+		if (!parseCie(id_address - id, &cie)) {
+			continue;
+		}
+
+		const uint64_t pc_begin = entry.encoded(cie.fdeEncoding, is64Bit_);
+		if (!entry.failed()) {
+			entries_.push_back({pc_begin, entry_address});
+		}
+	}
+
+	std::sort(entries_.begin(), entries_.end(), [](const FdeEntry &lhs, const FdeEntry &rhs) {
+		return lhs.pcBegin < rhs.pcBegin;
+	});
+}
+
+/**
+ * @brief EhFrameModule::reader
+ * @param address
+ * @return a reader from <address> to the end of the segment which contains it
+ */
+Reader EhFrameModule::reader(uint64_t address) const {
+	for (const Segment &segment : segments_) {
+		if (address >= segment.address && address - segment.address < segment.size) {
+			const uint8_t *first = data_ + segment.offset + (address - segment.address);
+			const uint8_t *last  = data_ + segment.offset + segment.size;
+			return Reader(first, last, address);
+		}
+	}
+
+	return Reader();
+}
+
+/**
+ * @brief EhFrameModule::addressForOffset
+ * @param offset a file offset
+ * @param address receives the address that offset is loaded at, before relocation
+ * @return
+ */
+bool EhFrameModule::addressForOffset(uint64_t offset, uint64_t *address) const {
+	for (const Segment &segment : segments_) {
+		if (offset >= segment.offset && offset - segment.offset < segment.size) {
+			*address = segment.address + (offset - segment.offset);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief EhFrameModule::parseCie
+ * @param address
+ * @param cie
+ * @return
+ */
+bool EhFrameModule::parseCie(uint64_t address, Cie *cie) const {
+
+	Reader r = reader(address);
+
+	Reader entry;
+	uint64_t id_address;
+	uint64_t id;
+	if (!read_entry_header(r, &entry, &id_address, &id) || id != 0) {
+		return false;
+	}
+
+	const uint8_t version = entry.read<uint8_t>();
+	if (version != 1 && version != 3) {
+		return false;
+	}
+
+	std::string augmentation;
+	while (char ch = static_cast<char>(entry.read<uint8_t>())) {
+		augmentation.push_back(ch);
+	}
+
+	// ancient GCC's "eh" augmentation has an extra field we don't bother with
+	if (augmentation.find("eh") != std::string::npos) {
+		return false;
+	}
+
+	cie->codeAlignment         = entry.uleb128();
+	cie->dataAlignment         = entry.sleb128();
+	cie->returnAddressRegister = (version == 1) ? entry.read<uint8_t>() : entry.uleb128();
+
+	if (!augmentation.empty()) {
+		if (augmentation[0] != 'z') {
+			return false;
+		}
+
+		cie->hasAugmentationData = true;
+
+		Reader data = entry.sub(entry.uleb128());
+		for (size_t i = 1; i < augmentation.size(); ++i) {
+			switch (augmentation[i]) {
+			case 'L':
+				data.read<uint8_t>();
+				break;
+			case 'P':
+				data.encoded(data.read<uint8_t>(), is64Bit_);
+				break;
+			case 'R':
+				cie->fdeEncoding = data.read<uint8_t>();
+				break;
+			case 'S':
+				cie->signalFrame = true;
+				break;
+			default:
+				// the rest of the augmentation data is skipped by its length
+				i = augmentation.size();
+				break;
+			}
+		}
+	}
+
+	cie->instructions = entry;
+	return !entry.failed();
+}
+
+/**
+ * @brief EhFrameModule::parseFde
+ * @param address
+ * @param fde
+ * @return
+ */
+bool EhFrameModule::parseFde(uint64_t address, Fde *fde) const {
+
+	Reader r = reader(address);
+
+	Reader entry;
+	uint64_t id_address;
+	uint64_t id;
+	if (!read_entry_header(r, &entry, &id_address, &id) || id == 0) {
+		return false;
+	}
+
+	if (!parseCie(id_address - id, &fde->cie)) {
+		return false;
+	}
+
+	fde->pcBegin = entry.encoded(fde->cie.fdeEncoding, is64Bit_);
+	fde->pcEnd   = fde->pcBegin + entry.encoded(fde->cie.fdeEncoding & 0x0f, is64Bit_);
+
+	if (fde->cie.hasAugmentationData) {
+		entry.skip(entry.uleb128());
+	}
+
+	fde->instructions = entry;
+	return !entry.failed();
+}
+
+/**
+ * @brief EhFrameModule::findFde
+ * @param address
+ * @param fde
+ * @return true if an FDE describing <address> was found
+ */
+bool EhFrameModule::findFde(uint64_t address, Fde *fde) const {
+
+	auto it = std::upper_bound(entries_.begin(), entries_.end(), address, [](uint64_t addr, const FdeEntry &entry) {
+		return addr < entry.pcBegin;
+	});
+
+	if (it == entries_.begin()) {
+		return false;
+	}
+
+	--it;
+	return parseFde(it->fde, fde) && address >= fde->pcBegin && address < fde->pcEnd;
+}
+
+/**
+ * @brief EhFrameModuleCache::find
+ * @param filename
+ * @return the parsed unwind information of <filename>, which is parsed again if
+ * the file changed since it was last parsed
+ */
+std::shared_ptr<EhFrameModule> EhFrameModuleCache::find(const QString &filename) {
+
+	std::shared_ptr<EhFrameModule> &module = modules_[filename];
+	if (!module || module->lastModified() != QFileInfo(filename).lastModified()) {
+		module = std::make_shared<EhFrameModule>(filename);
+	}
+
+	return module;
+}
+
+/**
+ * @brief EhFrameModuleCache::clear
+ */
+void EhFrameModuleCache::clear() {
+	modules_.clear();
+}
+
+/**
+ * @brief EhFrameUnwinder::EhFrameUnwinder
+ *
+ * On architectures whose registers we don't know how to number, the unwinder
+ * never gets past the innermost frame.
+ *
+ * @param state the registers of the innermost frame
+ * @param cache where the parsed modules are kept between unwinders
+ * @param reader used to read the stack of the thread
+ */
+EhFrameUnwinder::EhFrameUnwinder(const State &state, EhFrameModuleCache *cache, MemoryReader reader)
+	: cache_(cache), reader_(std::move(reader)), is64Bit_(edb::v1::debuggeeIs64Bit()) {
+
+	Q_ASSERT(cache_);
+
+	const Architecture *const arch_ptr = architecture(is64Bit_);
+	if (!arch_ptr) {
+		return;
+	}
+
+	const Architecture &arch = *arch_ptr;
+
+	for (size_t i = 0; i < arch.returnAddress; ++i) {
+		if (const Register reg = state.gpRegister(arch.gprIndex[i])) {
+			registers_[i] = reg.valueAsInteger();
+			valid_[i]     = true;
+		}
+	}
+
+	registers_[arch.returnAddress] = state.instructionPointer();
+	valid_[arch.returnAddress]     = true;
+}
+
+/**
+ * @brief EhFrameUnwinder::findModule
+ * @param filename
+ * @return
+ */
+std::shared_ptr<EhFrameModule> EhFrameUnwinder::findModule(const QString &filename) {
+
+	auto it = modules_.find(filename);
+	if (it != modules_.end()) {
+		return *it;
+	}
+
+	std::shared_ptr<EhFrameModule> module = cache_->find(filename);
+	modules_.insert(filename, module);
+	return module;
+}
+
+/**
+ * @brief EhFrameUnwinder::step
+ *
+ * Replaces the registers of the current frame with those of its caller.
+ *
+ * @return true if the caller's frame was found. If not, complete() tells if
+ * that is because we reached the outermost frame, or because the unwind
+ * information was missing or not understood.
+ */
+bool EhFrameUnwinder::step() {
+
+	if (complete_) {
+		return false;
+	}
+
+	const Architecture *const arch_ptr = architecture(is64Bit_);
+	if (!arch_ptr) {
+		return false;
+	}
+
+	const Architecture &arch = *arch_ptr;
+	if (!valid_[arch.returnAddress]) {
+		return false;
+	}
+
+	// the return address of a call which never returns may be the first byte
+	// of the next function, so we look up the call instead. Except, of course,
+	// for the frame which is actually executing or was interrupted by a signal
+	const uint64_t pc     = registers_[arch.returnAddress];
+	const uint64_t lookup = (firstFrame_ || signalFrame_) ? pc : pc - 1;
+
+	std::shared_ptr<IRegion> region = edb::v1::memory_regions().findRegion(lookup);
+	if (!region || !region->executable() || region->name().isEmpty()) {
+		return false;
+	}
+
+	std::shared_ptr<EhFrameModule> module = findModule(region->name());
+	if (!module || module->is64Bit() != is64Bit_) {
+		return false;
+	}
+
+	uint64_t region_address;
+	if (!module->addressForOffset(region->base(), &region_address)) {
+		return false;
+	}
+
+	const uint64_t bias    = region->start() - region_address;
+	const uint64_t address = lookup - bias;
+
+	Fde fde;
+	if (!module->findFde(address, &fde)) {
+		return false;
+	}
+
+	if (fde.cie.returnAddressRegister >= arch.registerCount) {
+		return false;
+	}
+
+	Row initial;
+	if (!execute_cfa_program(fde.cie.instructions, fde.cie, is64Bit_, fde.pcBegin, address, initial, &initial)) {
+		return false;
+	}
+
+	Row row = initial;
+	if (!execute_cfa_program(fde.instructions, fde.cie, is64Bit_, fde.pcBegin, address, initial, &row)) {
+		return false;
+	}
+
+	const uint64_t mask = is64Bit_ ? ~uint64_t(0) : 0xffffffff;
+
+	auto read_pointer = [this](uint64_t address, uint64_t *value) {
+		*value = 0;
+		return reader_(address, value, is64Bit_ ? 8 : 4);
+	};
+
+	auto evaluate = [&](Reader expression, bool pushCfa, uint64_t cfa, uint64_t *result) {
+		std::vector<uint64_t> stack;
+		if (pushCfa) {
+			stack.push_back(cfa);
+		}
+
+		auto push_register = [&](uint64_t reg, int64_t offset) {
+			if (reg >= arch.registerCount || !valid_[reg]) {
+				return false;
+			}
+			stack.push_back(registers_[reg] + static_cast<uint64_t>(offset));
+			return true;
+		};
+
+		while (!expression.atEnd()) {
+			const uint8_t op = expression.read<uint8_t>();
+
+			if (op >= DW_OP_lit0 && op <= DW_OP_lit31) {
+				stack.push_back(op - DW_OP_lit0);
+				continue;
+			}
+
+			if (op >= DW_OP_reg0 && op <= DW_OP_reg31) {
+				if (!push_register(op - DW_OP_reg0, 0)) {
+					return false;
+				}
+				continue;
+			}
+
+			if (op >= DW_OP_breg0 && op <= DW_OP_breg31) {
+				if (!push_register(op - DW_OP_breg0, expression.sleb128())) {
+					return false;
+				}
+				continue;
+			}
+
+			switch (op) {
+			case DW_OP_nop:
+				continue;
+			case DW_OP_const1u:
+				stack.push_back(expression.read<uint8_t>());
+				continue;
+			case DW_OP_const1s:
+				stack.push_back(static_cast<uint64_t>(static_cast<int64_t>(expression.read<int8_t>())));
+				continue;
+			case DW_OP_const2u:
+				stack.push_back(expression.read<uint16_t>());
+				continue;
+			case DW_OP_const2s:
+				stack.push_back(static_cast<uint64_t>(static_cast<int64_t>(expression.read<int16_t>())));
+				continue;
+			case DW_OP_const4u:
+				stack.push_back(expression.read<uint32_t>());
+				continue;
+			case DW_OP_const4s:
+				stack.push_back(static_cast<uint64_t>(static_cast<int64_t>(expression.read<int32_t>())));
+				continue;
+			case DW_OP_const8u:
+			case DW_OP_const8s:
+				stack.push_back(expression.read<uint64_t>());
+				continue;
+			case DW_OP_constu:
+				stack.push_back(expression.uleb128());
+				continue;
+			case DW_OP_consts:
+				stack.push_back(static_cast<uint64_t>(expression.sleb128()));
+				continue;
+			case DW_OP_regx: {
+				if (!push_register(expression.uleb128(), 0)) {
+					return false;
+				}
+				continue;
+			}
+			case DW_OP_bregx: {
+				const uint64_t reg = expression.uleb128();
+				if (!push_register(reg, expression.sleb128())) {
+					return false;
+				}
+				continue;
+			}
+			default:
+				break;
+			}
+
+			// everything else needs at least one operand
+			if (stack.empty()) {
+				return false;
+			}
+
+			const uint64_t top = stack.back();
+
+			switch (op) {
+			case DW_OP_dup:
+				stack.push_back(top);
+				continue;
+			case DW_OP_drop:
+				stack.pop_back();
+				continue;
+			case DW_OP_deref: {
+				uint64_t value;
+				if (!read_pointer(top & mask, &value)) {
+					return false;
+				}
+				stack.back() = value;
+				continue;
+			}
+			case DW_OP_neg:
+				stack.back() = static_cast<uint64_t>(-static_cast<int64_t>(top));
+				continue;
+			case DW_OP_not:
+				stack.back() = ~top;
+				continue;
+			case DW_OP_plus_uconst:
+				stack.back() = top + expression.uleb128();
+				continue;
+			default:
+				break;
+			}
+
+			// and the rest are binary operations
+			if (stack.size() < 2) {
+				return false;
+			}
+
+			const uint64_t rhs = stack.back();
+			stack.pop_back();
+			const uint64_t lhs = stack.back();
+			uint64_t &value    = stack.back();
+
+			switch (op) {
+			case DW_OP_over:
+				stack.push_back(lhs);
+				stack.push_back(rhs);
+				std::swap(stack[stack.size() - 1], stack[stack.size() - 2]);
+				break;
+			case DW_OP_swap:
+				value = rhs;
+				stack.push_back(lhs);
+				break;
+			case DW_OP_and:
+				value = lhs & rhs;
+				break;
+			case DW_OP_or:
+				value = lhs | rhs;
+				break;
+			case DW_OP_xor:
+				value = lhs ^ rhs;
+				break;
+			case DW_OP_plus:
+				value = lhs + rhs;
+				break;
+			case DW_OP_minus:
+				value = lhs - rhs;
+				break;
+			case DW_OP_mul:
+				value = lhs * rhs;
+				break;
+			case DW_OP_shl:
+				value = (rhs < 64) ? (lhs << rhs) : 0;
+				break;
+			case DW_OP_shr:
+				value = (rhs < 64) ? (lhs >> rhs) : 0;
+				break;
+			case DW_OP_shra:
+				value = static_cast<uint64_t>(static_cast<int64_t>(lhs) >> std::min<uint64_t>(rhs, 63));
+				break;
+			case DW_OP_eq:
+				value = static_cast<int64_t>(lhs) == static_cast<int64_t>(rhs);
+				break;
+			case DW_OP_ne:
+				value = static_cast<int64_t>(lhs) != static_cast<int64_t>(rhs);
+				break;
+			case DW_OP_ge:
+				value = static_cast<int64_t>(lhs) >= static_cast<int64_t>(rhs);
+				break;
+			case DW_OP_gt:
+				value = static_cast<int64_t>(lhs) > static_cast<int64_t>(rhs);
+				break;
+			case DW_OP_le:
+				value = static_cast<int64_t>(lhs) <= static_cast<int64_t>(rhs);
+				break;
+			case DW_OP_lt:
+				value = static_cast<int64_t>(lhs) < static_cast<int64_t>(rhs);
+				break;
+			default:
+				// branches, piece operations and such don't show up in CFI
+				return false;
+			}
+		}
+
+		if (expression.failed() || stack.empty()) {
+			return false;
+		}
+
+		*result = stack.back() & mask;
+		return true;
+	};
+
+	// find the canonical frame address, the value of the stack pointer
+	// right before the call that created this frame
+	uint64_t cfa;
+	if (row.cfaIsExpression) {
+		if (!evaluate(row.cfaExpression, false, 0, &cfa)) {
+			return false;
+		}
+	} else {
+		if (row.cfaRegister >= arch.registerCount || !valid_[row.cfaRegister]) {
+			return false;
+		}
+		cfa = (registers_[row.cfaRegister] + static_cast<uint64_t>(row.cfaOffset)) & mask;
+	}
+
+	// and then recover the caller's registers
+	std::array<uint64_t, MaxRegisters> registers = registers_;
+	std::bitset<MaxRegisters> valid              = valid_;
+
+	for (size_t i = 0; i < arch.registerCount; ++i) {
+		const Rule &rule = row.rules[i];
+		uint64_t address;
+
+		switch (rule.type) {
+		case RULE_SAME_VALUE:
+			break;
+		case RULE_UNDEFINED:
+			valid[i] = false;
+			break;
+		case RULE_OFFSET:
+			if (!read_pointer((cfa + static_cast<uint64_t>(rule.value)) & mask, &registers[i])) {
+				return false;
+			}
+			valid[i] = true;
+			break;
+		case RULE_VAL_OFFSET:
+			registers[i] = (cfa + static_cast<uint64_t>(rule.value)) & mask;
+			valid[i]     = true;
+			break;
+		case RULE_REGISTER:
+			if (static_cast<uint64_t>(rule.value) < arch.registerCount && valid_[rule.value]) {
+				registers[i] = registers_[rule.value];
+				valid[i]     = true;
+			} else {
+				valid[i] = false;
+			}
+			break;
+		case RULE_EXPRESSION:
+			if (!evaluate(rule.expression, true, cfa, &address) || !read_pointer(address, &registers[i])) {
+				return false;
+			}
+			valid[i] = true;
+			break;
+		case RULE_VAL_EXPRESSION:
+			if (!evaluate(rule.expression, true, cfa, &registers[i])) {
+				return false;
+			}
+			valid[i] = true;
+			break;
+		}
+	}
+
+	// by definition, the caller's stack pointer is the CFA
+	if (row.rules[arch.stackPointer].type == RULE_SAME_VALUE) {
+		registers[arch.stackPointer] = cfa;
+		valid[arch.stackPointer]     = true;
+	}
+
+	const size_t ra_column = static_cast<size_t>(fde.cie.returnAddressRegister);
+
+	// an undefined return address marks the outermost frame
+	if (!valid[ra_column] || registers[ra_column] == 0) {
+		complete_ = true;
+		return false;
+	}
+
+	registers[arch.returnAddress] = registers[ra_column];
+	valid[arch.returnAddress]     = true;
+
+	// each frame must be further up the stack than the last one, or we'd
+	// loop forever on bad unwind information. Signal frames may switch stacks
+	if (!fde.cie.signalFrame && valid_[arch.stackPointer] && registers[arch.stackPointer] <= registers_[arch.stackPointer]) {
+		return false;
+	}
+
+	registers_   = registers;
+	valid_       = valid;
+	firstFrame_  = false;
+	signalFrame_ = fde.cie.signalFrame;
+	return true;
+}
+
+/**
+ * @brief EhFrameUnwinder::instructionPointer
+ * @return the instruction pointer of the current frame, for any frame but the
+ * innermost one, this is the return address
+ */
+edb::address_t EhFrameUnwinder::instructionPointer() const {
+	const Architecture *const arch = architecture(is64Bit_);
+	return (arch && valid_[arch->returnAddress]) ? registers_[arch->returnAddress] : 0;
+}
+
+/**
+ * @brief EhFrameUnwinder::stackPointer
+ * @return the stack pointer of the current frame
+ */
+edb::address_t EhFrameUnwinder::stackPointer() const {
+	const Architecture *const arch = architecture(is64Bit_);
+	return (arch && valid_[arch->stackPointer]) ? registers_[arch->stackPointer] : 0;
+}
+
+/**
+ * @brief EhFrameUnwinder::framePointer
+ * @return the frame pointer of the current frame, or zero if it is unknown
+ */
+edb::address_t EhFrameUnwinder::framePointer() const {
+	const Architecture *const arch = architecture(is64Bit_);
+	return (arch && valid_[arch->framePointer]) ? registers_[arch->framePointer] : 0;
+}
+
+}
@@ -0,0 +1,89 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef EH_FRAME_UNWINDER_H_20261019_
+#define EH_FRAME_UNWINDER_H_20261019_
+
+#include "Types.h"
+#include <QHash>
+#include <QString>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+class State;
+
+namespace BacktracePlugin {
+
+class EhFrameModule;
+
+// Parsing a module's unwind information is the expensive part of unwinding,
+// so the parsed modules are kept for as long as their files don't change.
+// The owner clears the cache once the debuggee goes away.
+class EhFrameModuleCache {
+public:
+	std::shared_ptr<EhFrameModule> find(const QString &filename);
+	void clear();
+
+private:
+	QHash<QString, std::shared_ptr<EhFrameModule>> modules_;
+};
+
+// Unwinds a thread's stack one frame at a time using the call frame
+// information in the .eh_frame section of each module. Unlike following the
+// frame pointer chain, this works for code built with -fomit-frame-pointer.
+class EhFrameUnwinder {
+public:
+	using MemoryReader = std::function<bool(edb::address_t address, void *buffer, size_t size)>;
+
+	// enough for the x86-64 general purpose registers and the return address
+	static constexpr size_t MaxRegisters = 17;
+
+public:
+	EhFrameUnwinder(const State &state, EhFrameModuleCache *cache, MemoryReader reader);
+
+public:
+	bool step();
+	bool complete() const { return complete_; }
+
+public:
+	edb::address_t instructionPointer() const;
+	edb::address_t stackPointer() const;
+	edb::address_t framePointer() const;
+
+private:
+	std::shared_ptr<EhFrameModule> findModule(const QString &filename);
+
+private:
+	EhFrameModuleCache *cache_;
+	MemoryReader reader_;
+	QHash<QString, std::shared_ptr<EhFrameModule>> modules_;
+	std::array<uint64_t, MaxRegisters> registers_ = {};
+	std::bitset<MaxRegisters> valid_;
+	bool is64Bit_;
+	bool firstFrame_  = true;
+	bool signalFrame_ = false;
+	bool complete_    = false;
+};
+
+}
+
+#endif
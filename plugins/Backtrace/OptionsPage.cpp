@@ -0,0 +1,65 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OptionsPage.h"
+#include "CallStack.h"
+#include <QSettings>
+
+namespace BacktracePlugin {
+
+/**
+ * @brief OptionsPage::OptionsPage
+ * @param parent
+ * @param f
+ */
+OptionsPage::OptionsPage(QWidget *parent, Qt::WindowFlags f)
+	: QWidget(parent, f) {
+	ui.setupUi(this);
+}
+
+/**
+ * @brief OptionsPage::showEvent
+ * @param event
+ */
+void OptionsPage::showEvent(QShowEvent *event) {
+	Q_UNUSED(event)
+
+	QSettings settings;
+	ui.spinMaxFrames->setValue(settings.value("Backtrace/max_frames", static_cast<qulonglong>(CallStack::DefaultMaxFrames)).toInt());
+	ui.checkUseEhFrame->setChecked(settings.value("Backtrace/use_eh_frame", true).toBool());
+}
+
+/**
+ * @brief OptionsPage::on_spinMaxFrames_valueChanged
+ * @param value
+ */
+void OptionsPage::on_spinMaxFrames_valueChanged(int value) {
+	QSettings settings;
+	settings.setValue("Backtrace/max_frames", value);
+}
+
+/**
+ * @brief OptionsPage::on_checkUseEhFrame_toggled
+ * @param checked
+ */
+void OptionsPage::on_checkUseEhFrame_toggled(bool checked) {
+	QSettings settings;
+	settings.setValue("Backtrace/use_eh_frame", checked);
+}
+
+}
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "BinarySearcher.h"
 #include "DialogAsciiString.h"
 #include "DialogBinaryString.h"
+#include "DialogValueScanner.h"
 #include "edb.h"
 #include <QMenu>
 
@@ -44,6 +45,7 @@ QMenu *BinarySearcher::menu(QWidget *parent) {
 	if (!menu_) {
 		menu_ = new QMenu(tr("BinarySearcher"), parent);
 		menu_->addAction(tr("&Binary String Search"), this, SLOT(showMenu()), QKeySequence(tr("Ctrl+F")));
+		menu_->addAction(tr("&Value Scanner"), this, SLOT(showValueScanner()));
 	}
 
 	return menu_;
@@ -72,6 +74,14 @@ void BinarySearcher::showMenu() {
 	dialog->show();
 }
 
+/**
+ * @brief BinarySearcher::showValueScanner
+ */
+void BinarySearcher::showValueScanner() {
+	static auto dialog = new DialogValueScanner(edb::v1::debugger_ui);
+	dialog->show();
+}
+
 /**
  * @brief BinarySearcher::mnuStackFindAscii
  */
@@ -43,6 +43,7 @@ public:
 
 public Q_SLOTS:
 	void showMenu();
+	void showValueScanner();
 	void mnuStackFindAscii();
 
 private:
@@ -0,0 +1,302 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DialogValueScanner.h"
+#include "IDebugger.h"
+#include "IProcess.h"
+#include "IRegion.h"
+#include "MemoryRegions.h"
+#include "edb.h"
+
+#include <QFutureWatcher>
+#include <QMessageBox>
+#include <QPushButton>
+#include <cstring>
+
+namespace BinarySearcherPlugin {
+
+namespace {
+
+// how many candidates we are willing to list
+constexpr size_t MaxResults = 1000;
+
+}
+
+/**
+ * @brief DialogValueScanner::DialogValueScanner
+ * @param parent
+ * @param f
+ */
+DialogValueScanner::DialogValueScanner(QWidget *parent, Qt::WindowFlags f)
+	: QDialog(parent, f) {
+
+	ui.setupUi(this);
+	ui.progressBar->setValue(0);
+
+	buttonFirstScan_ = new QPushButton(QIcon::fromTheme("edit-find"), tr("First Scan"));
+	buttonNextScan_  = new QPushButton(tr("Next Scan"));
+	buttonReset_     = new QPushButton(tr("Reset"));
+
+	connect(buttonFirstScan_, &QPushButton::clicked, this, [this]() {
+		doScan(true);
+	});
+
+	connect(buttonNextScan_, &QPushButton::clicked, this, [this]() {
+		doScan(false);
+	});
+
+	connect(buttonReset_, &QPushButton::clicked, this, &DialogValueScanner::resetScan);
+
+	ui.buttonBox->addButton(buttonFirstScan_, QDialogButtonBox::ActionRole);
+	ui.buttonBox->addButton(buttonNextScan_, QDialogButtonBox::ActionRole);
+	ui.buttonBox->addButton(buttonReset_, QDialogButtonBox::ResetRole);
+
+	// the values shown are re-read whenever the debuggee stops, and a scan
+	// doesn't survive the process going away
+	connect(edb::v1::debugger_ui, SIGNAL(uiUpdated()), this, SLOT(updateResults()));
+	connect(edb::v1::debugger_ui, SIGNAL(detachEvent()), this, SLOT(resetScan()));
+
+	updatePredicates();
+	updateResults();
+}
+
+/**
+ * @brief DialogValueScanner::on_cmbPredicate_currentIndexChanged
+ * @param index
+ */
+void DialogValueScanner::on_cmbPredicate_currentIndexChanged(int index) {
+
+	const auto predicate = static_cast<ValueScanner::Predicate>(ui.cmbPredicate->itemData(index).toInt());
+
+	ui.txtValue->setEnabled(predicate == ValueScanner::Predicate::Equal || predicate == ValueScanner::Predicate::NotEqual || predicate == ValueScanner::Predicate::InRange);
+	ui.txtValueMax->setEnabled(predicate == ValueScanner::Predicate::InRange);
+}
+
+/**
+ * @brief DialogValueScanner::updatePredicates
+ *
+ * The predicates which compare against the previous value are only offered
+ * once there is a previous value.
+ */
+void DialogValueScanner::updatePredicates() {
+
+	const QVariant current = ui.cmbPredicate->currentData();
+
+	ui.cmbPredicate->clear();
+	ui.cmbPredicate->addItem(tr("Exact Value"), static_cast<int>(ValueScanner::Predicate::Equal));
+	ui.cmbPredicate->addItem(tr("Not Equal To Value"), static_cast<int>(ValueScanner::Predicate::NotEqual));
+	ui.cmbPredicate->addItem(tr("Value Between"), static_cast<int>(ValueScanner::Predicate::InRange));
+
+	if (scanner_.started()) {
+		ui.cmbPredicate->addItem(tr("Changed Value"), static_cast<int>(ValueScanner::Predicate::Changed));
+		ui.cmbPredicate->addItem(tr("Unchanged Value"), static_cast<int>(ValueScanner::Predicate::Unchanged));
+		ui.cmbPredicate->addItem(tr("Increased Value"), static_cast<int>(ValueScanner::Predicate::Increased));
+		ui.cmbPredicate->addItem(tr("Decreased Value"), static_cast<int>(ValueScanner::Predicate::Decreased));
+	} else {
+		ui.cmbPredicate->addItem(tr("Unknown Initial Value"), static_cast<int>(ValueScanner::Predicate::Unknown));
+	}
+
+	const int index = ui.cmbPredicate->findData(current);
+	ui.cmbPredicate->setCurrentIndex(index != -1 ? index : 0);
+
+	ui.cmbType->setEnabled(!scanner_.started());
+	ui.chkAligned->setEnabled(!scanner_.started());
+	buttonNextScan_->setEnabled(scanner_.started() && !scanner_.isScanning());
+}
+
+/**
+ * @brief DialogValueScanner::readOperand
+ * @param edit
+ * @param operand
+ * @return true if the text of <edit> is a valid value of the selected type
+ */
+bool DialogValueScanner::readOperand(const QLineEdit *edit, ValueScanner::Operand *operand) {
+
+	const auto type = static_cast<ValueScanner::ValueType>(ui.cmbType->currentIndex());
+
+	bool ok = false;
+	if (type == ValueScanner::ValueType::Float || type == ValueScanner::ValueType::Double) {
+		operand->real = edit->text().toDouble(&ok);
+	} else {
+		operand->integer = edit->text().toULongLong(&ok, 0);
+
+		const size_t size = ValueScanner::valueSize(type);
+		if (ok && size < sizeof(uint64_t) && (operand->integer >> (size * 8)) != 0) {
+			ok = false;
+		}
+	}
+
+	if (!ok) {
+		QMessageBox::information(this, tr("Invalid Value"), tr("'%1' is not a valid value for the selected type.").arg(edit->text()));
+	}
+
+	return ok;
+}
+
+/**
+ * @brief DialogValueScanner::doScan
+ * @param first
+ */
+void DialogValueScanner::doScan(bool first) {
+
+	const auto type      = static_cast<ValueScanner::ValueType>(ui.cmbType->currentIndex());
+	const auto predicate = static_cast<ValueScanner::Predicate>(ui.cmbPredicate->currentData().toInt());
+
+	ValueScanner::Operand lhs;
+	ValueScanner::Operand rhs;
+
+	if (ui.txtValue->isEnabled() && !readOperand(ui.txtValue, &lhs)) {
+		return;
+	}
+
+	if (ui.txtValueMax->isEnabled() && !readOperand(ui.txtValueMax, &rhs)) {
+		return;
+	}
+
+	buttonFirstScan_->setEnabled(false);
+	buttonNextScan_->setEnabled(false);
+	ui.progressBar->setValue(0);
+
+	auto watcher = new QFutureWatcher<void>(this);
+	connect(watcher, &QFutureWatcher<void>::progressValueChanged, ui.progressBar, &QProgressBar::setValue);
+	connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher]() {
+		watcher->deleteLater();
+
+		// a canceled scan has already been reset
+		if (!watcher->isCanceled()) {
+			ui.progressBar->setValue(100);
+		}
+
+		buttonFirstScan_->setEnabled(true);
+		updatePredicates();
+		updateResults();
+	});
+
+	if (first) {
+		edb::v1::memory_regions().sync();
+
+		QList<std::shared_ptr<IRegion>> regions;
+		for (const std::shared_ptr<IRegion> &region : edb::v1::memory_regions().regions()) {
+			if (region->readable() && region->writable()) {
+				regions.push_back(region);
+			}
+		}
+
+		watcher->setFuture(scanner_.firstScan(regions, type, ui.chkAligned->isChecked(), predicate, lhs, rhs));
+	} else {
+		watcher->setFuture(scanner_.nextScan(predicate, lhs, rhs));
+	}
+}
+
+/**
+ * @brief DialogValueScanner::resetScan
+ */
+void DialogValueScanner::resetScan() {
+	scanner_.reset();
+	ui.progressBar->setValue(0);
+	updatePredicates();
+	updateResults();
+}
+
+/**
+ * @brief DialogValueScanner::formatValue
+ * @param bits the raw bits of a value of the scanned type
+ * @return
+ */
+QString DialogValueScanner::formatValue(uint64_t bits) const {
+	switch (scanner_.type()) {
+	case ValueScanner::ValueType::Float: {
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return QString::number(value);
+	}
+	case ValueScanner::ValueType::Double: {
+		double value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return QString::number(value);
+	}
+	default:
+		return QString::number(bits);
+	}
+}
+
+/**
+ * @brief DialogValueScanner::updateResults
+ *
+ * Lists the first few candidates, along with their current values
+ */
+void DialogValueScanner::updateResults() {
+
+	// the candidates are being filtered, the table is refreshed once they are
+	if (scanner_.isScanning()) {
+		return;
+	}
+
+	ui.tableResults->setRowCount(0);
+
+	if (!scanner_.started()) {
+		ui.labelCount->setText(QString());
+		return;
+	}
+
+	if (scanner_.count() > MaxResults) {
+		ui.labelCount->setText(tr("%1 candidates, showing the first %2").arg(scanner_.count()).arg(MaxResults));
+	} else {
+		ui.labelCount->setText(tr("%1 candidates").arg(scanner_.count()));
+	}
+
+	IProcess *process = edb::v1::debugger_core->process();
+
+	const size_t value_size                            = ValueScanner::valueSize(scanner_.type());
+	const std::vector<ValueScanner::Candidate> results = scanner_.candidates(MaxResults);
+
+	ui.tableResults->setRowCount(static_cast<int>(results.size()));
+
+	int row = 0;
+	for (const ValueScanner::Candidate &candidate : results) {
+
+		QString current;
+		uint64_t bits = 0;
+		if (process && process->readBytes(candidate.address, &bits, value_size) == value_size) {
+			current = formatValue(bits);
+		}
+
+		auto address_item = new QTableWidgetItem(edb::v1::format_pointer(candidate.address));
+		address_item->setData(Qt::UserRole, static_cast<qulonglong>(candidate.address));
+
+		ui.tableResults->setItem(row, 0, address_item);
+		ui.tableResults->setItem(row, 1, new QTableWidgetItem(current));
+		ui.tableResults->setItem(row, 2, new QTableWidgetItem(formatValue(candidate.previous)));
+		++row;
+	}
+}
+
+/**
+ * @brief DialogValueScanner::on_tableResults_cellDoubleClicked
+ * @param row
+ * @param column
+ */
+void DialogValueScanner::on_tableResults_cellDoubleClicked(int row, int column) {
+	Q_UNUSED(column)
+
+	if (QTableWidgetItem *const item = ui.tableResults->item(row, 0)) {
+		edb::v1::dump_data(item->data(Qt::UserRole).toULongLong(), false);
+	}
+}
+
+}
@@ -0,0 +1,57 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DIALOG_VALUE_SCANNER_H_20261019_
+#define DIALOG_VALUE_SCANNER_H_20261019_
+
+#include "ValueScanner.h"
+#include "ui_DialogValueScanner.h"
+#include <QDialog>
+
+namespace BinarySearcherPlugin {
+
+class DialogValueScanner : public QDialog {
+	Q_OBJECT
+
+public:
+	explicit DialogValueScanner(QWidget *parent = nullptr, Qt::WindowFlags f = Qt::WindowFlags());
+	~DialogValueScanner() override = default;
+
+private Q_SLOTS:
+	void on_cmbPredicate_currentIndexChanged(int index);
+	void on_tableResults_cellDoubleClicked(int row, int column);
+	void updateResults();
+	void resetScan();
+
+private:
+	void doScan(bool first);
+	void updatePredicates();
+	bool readOperand(const QLineEdit *edit, ValueScanner::Operand *operand);
+	QString formatValue(uint64_t bits) const;
+
+private:
+	Ui::DialogValueScanner ui;
+	ValueScanner scanner_;
+	QPushButton *buttonFirstScan_ = nullptr;
+	QPushButton *buttonNextScan_  = nullptr;
+	QPushButton *buttonReset_     = nullptr;
+};
+
+}
+
+#endif
@@ -0,0 +1,708 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ValueScanner.h"
+#include "IDebugger.h"
+#include "IProcess.h"
+#include "IRegion.h"
+#include "edb.h"
+#include "util/Math.h"
+
+#include <QFutureInterface>
+#include <QFutureWatcher>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <type_traits>
+
+namespace BinarySearcherPlugin {
+
+namespace {
+
+// regions are split into blocks of this many slots' worth of bytes, a block
+// is the unit of work which gets scanned in parallel, and its offsets always
+// fit in 32-bits
+constexpr size_t BlockBytes = 16 * 1024 * 1024;
+
+// how much memory we read before handing it to the workers
+constexpr size_t BatchBytes = 256 * 1024 * 1024;
+
+template <class T>
+T load(const uint8_t *p) {
+	T value;
+	std::memcpy(&value, p, sizeof(T));
+	return value;
+}
+
+template <class T>
+void store(uint8_t *p, T value) {
+	std::memcpy(p, &value, sizeof(T));
+}
+
+template <class T>
+T operand_value(const ValueScanner::Operand &operand) {
+	if constexpr (std::is_floating_point_v<T>) {
+		return static_cast<T>(operand.real);
+	} else {
+		return static_cast<T>(operand.integer);
+	}
+}
+
+/**
+ * @brief with_type
+ *
+ * Calls <func> with a value of the C++ type which corresponds to <type>
+ *
+ * @param type
+ * @param func
+ */
+template <class F>
+void with_type(ValueScanner::ValueType type, F func) {
+	switch (type) {
+	case ValueScanner::ValueType::U8:
+		func(uint8_t());
+		break;
+	case ValueScanner::ValueType::U16:
+		func(uint16_t());
+		break;
+	case ValueScanner::ValueType::U32:
+		func(uint32_t());
+		break;
+	case ValueScanner::ValueType::U64:
+		func(uint64_t());
+		break;
+	case ValueScanner::ValueType::Float:
+		func(float());
+		break;
+	case ValueScanner::ValueType::Double:
+		func(double());
+		break;
+	}
+}
+
+/**
+ * @brief with_predicate
+ *
+ * Calls <func> with a function object implementing <predicate>. Each predicate
+ * is its own type so that the kernels get instantiated once per predicate,
+ * leaving their inner loops free of branches for the compiler to vectorize.
+ *
+ * @param predicate
+ * @param lhs
+ * @param rhs
+ * @param func
+ */
+template <class T, class F>
+void with_predicate(ValueScanner::Predicate predicate, T lhs, T rhs, F func) {
+	switch (predicate) {
+	case ValueScanner::Predicate::Unknown:
+		func([](T, T) { return true; });
+		break;
+	case ValueScanner::Predicate::Equal:
+		func([lhs](T value, T) { return value == lhs; });
+		break;
+	case ValueScanner::Predicate::NotEqual:
+		func([lhs](T value, T) { return value != lhs; });
+		break;
+	case ValueScanner::Predicate::InRange:
+		func([lhs, rhs](T value, T) { return (value >= lhs) & (value <= rhs); });
+		break;
+	case ValueScanner::Predicate::Changed:
+		func([](T value, T previous) { return value != previous; });
+		break;
+	case ValueScanner::Predicate::Unchanged:
+		func([](T value, T previous) { return value == previous; });
+		break;
+	case ValueScanner::Predicate::Increased:
+		func([](T value, T previous) { return value > previous; });
+		break;
+	case ValueScanner::Predicate::Decreased:
+		func([](T value, T previous) { return value < previous; });
+		break;
+	}
+}
+
+}
+
+// The candidates within one block of a region
+struct ValueScanner::Block {
+	edb::address_t start;
+	size_t size; // includes the bytes shared with the next block
+	uint64_t count = 0;
+	bool dense     = true;
+
+	// dense blocks: a bit per slot, and a copy of the whole block as of the
+	// last scan (null before the first scan)
+	std::vector<uint64_t> bitmap;
+	std::unique_ptr<uint8_t[]> bytes;
+
+	// sparse blocks: the sorted offsets of the candidates and their values as
+	// of the last scan, packed one after the other
+	std::vector<uint32_t> offsets;
+	std::vector<uint8_t> values;
+};
+
+namespace {
+
+struct Job {
+	ValueScanner::Block *block;
+	std::unique_ptr<uint8_t[]> buffer;
+	size_t valid; // for dense blocks, how many bytes from the start could be read
+};
+
+size_t slot_count(size_t size, size_t value_size, size_t stride) {
+	return size >= value_size ? (size - value_size) / stride + 1 : 0;
+}
+
+size_t page_count(size_t size, size_t page_size) {
+	return (size + page_size - 1) / page_size;
+}
+
+/**
+ * @brief read_dense
+ * @param process
+ * @param page_size
+ * @param job
+ */
+void read_dense(IProcess *process, size_t page_size, Job &job) {
+	const size_t pages_read = process->readPages(job.block->start, job.buffer.get(), page_count(job.block->size, page_size));
+	job.valid               = std::min(pages_read * page_size, job.block->size);
+}
+
+/**
+ * @brief read_sparse
+ *
+ * Only reads the pages which hold candidates, candidates whose pages can no
+ * longer be read are dropped.
+ *
+ * @param process
+ * @param page_size
+ * @param value_size
+ * @param job
+ */
+void read_sparse(IProcess *process, size_t page_size, size_t value_size, Job &job) {
+
+	ValueScanner::Block *const block     = job.block;
+	const std::vector<uint32_t> &offsets = block->offsets;
+
+	std::vector<std::pair<size_t, size_t>> failed;
+
+	size_t i = 0;
+	while (i < offsets.size()) {
+		const size_t first_page = offsets[i] / page_size;
+		size_t last_page        = (offsets[i] + value_size - 1) / page_size;
+
+		// gather the candidates on this run of consecutive pages
+		size_t j = i + 1;
+		while (j < offsets.size() && offsets[j] / page_size <= last_page + 1) {
+			last_page = std::max(last_page, (offsets[j] + value_size - 1) / page_size);
+			++j;
+		}
+
+		const size_t page_count = last_page - first_page + 1;
+		const size_t pages_read = process->readPages(block->start + first_page * page_size, job.buffer.get() + first_page * page_size, page_count);
+		if (pages_read < page_count) {
+			failed.emplace_back((first_page + pages_read) * page_size, (last_page + 1) * page_size);
+		}
+
+		i = j;
+	}
+
+	if (failed.empty()) {
+		return;
+	}
+
+	size_t out = 0;
+	for (size_t k = 0; k < offsets.size(); ++k) {
+		const size_t offset = offsets[k];
+
+		const bool unreadable = std::any_of(failed.begin(), failed.end(), [offset, value_size](const std::pair<size_t, size_t> &range) {
+			return offset < range.second && offset + value_size > range.first;
+		});
+
+		if (!unreadable) {
+			block->offsets[out] = block->offsets[k];
+			std::memmove(&block->values[out * value_size], &block->values[k * value_size], value_size);
+			++out;
+		}
+	}
+
+	block->offsets.resize(out);
+	block->values.resize(out * value_size);
+}
+
+/**
+ * @brief scan_dense
+ *
+ * Tests 64 slots at a time, producing a mask of the ones which match which is
+ * then and-ed with the candidate bitmap.
+ *
+ * @param job
+ * @param stride
+ * @param pred
+ */
+template <class T, class P>
+void scan_dense(Job &job, size_t stride, P pred) {
+
+	ValueScanner::Block *const block = job.block;
+
+	const uint8_t *const current  = job.buffer.get();
+	const uint8_t *const previous = block->bytes ? block->bytes.get() : current;
+	const size_t slots            = slot_count(job.valid, sizeof(T), stride);
+
+	uint64_t count = 0;
+	for (size_t w = 0; w < block->bitmap.size(); ++w) {
+		uint64_t mask = block->bitmap[w];
+		if (mask == 0) {
+			continue;
+		}
+
+		const size_t base = w * 64;
+		if (base >= slots) {
+			block->bitmap[w] = 0;
+			continue;
+		}
+
+		const size_t n = std::min<size_t>(64, slots - base);
+
+		uint64_t matches = 0;
+		for (size_t j = 0; j < n; ++j) {
+			const size_t offset = (base + j) * stride;
+			matches |= static_cast<uint64_t>(pred(load<T>(current + offset), load<T>(previous + offset))) << j;
+		}
+
+		mask &= matches;
+		block->bitmap[w] = mask;
+		count += std::bitset<64>(mask).count();
+	}
+
+	block->count = count;
+}
+
+/**
+ * @brief scan_sparse
+ * @param job
+ * @param pred
+ */
+template <class T, class P>
+void scan_sparse(Job &job, P pred) {
+
+	ValueScanner::Block *const block = job.block;
+	const uint8_t *const current     = job.buffer.get();
+
+	size_t out = 0;
+	for (size_t i = 0; i < block->offsets.size(); ++i) {
+		const uint32_t offset = block->offsets[i];
+		const T value         = load<T>(current + offset);
+
+		if (pred(value, load<T>(&block->values[i * sizeof(T)]))) {
+			block->offsets[out] = offset;
+			store<T>(&block->values[out * sizeof(T)], value);
+			++out;
+		}
+	}
+
+	block->offsets.resize(out);
+	block->values.resize(out * sizeof(T));
+	block->count = out;
+}
+
+/**
+ * @brief compact
+ *
+ * Converts a dense block to a sparse one, if that takes less memory.
+ *
+ * @param job
+ * @param stride
+ */
+template <class T>
+void compact(Job &job, size_t stride) {
+
+	ValueScanner::Block *const block = job.block;
+
+	if (!block->dense) {
+		return;
+	}
+
+	const size_t dense_bytes  = block->bitmap.size() * sizeof(uint64_t) + block->size;
+	const size_t sparse_bytes = block->count * (sizeof(uint32_t) + sizeof(T));
+
+	if (sparse_bytes >= dense_bytes) {
+		block->bytes = std::move(job.buffer);
+		return;
+	}
+
+	block->offsets.reserve(block->count);
+	block->values.resize(block->count * sizeof(T));
+
+	size_t out = 0;
+	for (size_t w = 0; w < block->bitmap.size(); ++w) {
+		const uint64_t mask = block->bitmap[w];
+		if (mask == 0) {
+			continue;
+		}
+
+		for (size_t j = 0; j < 64; ++j) {
+			if (mask & (uint64_t(1) << j)) {
+				const size_t offset = (w * 64 + j) * stride;
+				block->offsets.push_back(static_cast<uint32_t>(offset));
+				std::memcpy(&block->values[out * sizeof(T)], job.buffer.get() + offset, sizeof(T));
+				++out;
+			}
+		}
+	}
+
+	block->dense = false;
+	block->bitmap.clear();
+	block->bitmap.shrink_to_fit();
+	block->bytes = nullptr;
+}
+
+}
+
+struct ValueScanner::Scan {
+	Predicate predicate;
+	Operand lhs;
+	Operand rhs;
+	size_t next   = 0; // the first block of the next batch
+	bool canceled = false;
+	std::vector<Job> jobs;
+	QFutureInterface<void> done;
+};
+
+/**
+ * @brief ValueScanner::ValueScanner
+ */
+ValueScanner::ValueScanner() = default;
+
+/**
+ * @brief ValueScanner::~ValueScanner
+ */
+ValueScanner::~ValueScanner() {
+	reset();
+}
+
+/**
+ * @brief ValueScanner::isRelative
+ * @param predicate
+ * @return true if <predicate> compares against the value seen by the previous
+ * scan, which makes it unusable for a first scan
+ */
+bool ValueScanner::isRelative(Predicate predicate) {
+	switch (predicate) {
+	case Predicate::Changed:
+	case Predicate::Unchanged:
+	case Predicate::Increased:
+	case Predicate::Decreased:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief ValueScanner::valueSize
+ * @param type
+ * @return
+ */
+size_t ValueScanner::valueSize(ValueType type) {
+	size_t size = 0;
+	with_type(type, [&size](auto value) {
+		size = sizeof(value);
+	});
+	return size;
+}
+
+/**
+ * @brief ValueScanner::reset
+ *
+ * Cancels the scan in progress, if any, and forgets every candidate
+ */
+void ValueScanner::reset() {
+
+	if (scan_) {
+		// the batch being filtered still refers to our blocks
+		scan_->canceled = true;
+		batch_.waitForFinished();
+		scan_->done.reportCanceled();
+		scan_->done.reportFinished();
+		scan_ = nullptr;
+	}
+
+	blocks_.clear();
+	count_   = 0;
+	started_ = false;
+}
+
+/**
+ * @brief ValueScanner::firstScan
+ *
+ * Starts a new scan of <regions>, every properly aligned address is a
+ * candidate which is then tested against <predicate>.
+ *
+ * @param regions
+ * @param type
+ * @param aligned
+ * @param predicate
+ * @param lhs
+ * @param rhs
+ * @return a future which finishes along with the scan
+ */
+QFuture<void> ValueScanner::firstScan(const QList<std::shared_ptr<IRegion>> &regions, ValueType type, bool aligned, Predicate predicate, const Operand &lhs, const Operand &rhs) {
+
+	Q_ASSERT(!isRelative(predicate));
+
+	reset();
+
+	const size_t value_size = valueSize(type);
+
+	type_    = type;
+	stride_  = aligned ? value_size : 1;
+	started_ = true;
+
+	for (const std::shared_ptr<IRegion> &region : regions) {
+		for (edb::address_t address = region->start(); address < region->end(); address += BlockBytes) {
+			auto block   = std::make_unique<Block>();
+			block->start = address;
+
+			// a block also covers the first few bytes of the next one, so that
+			// the values which straddle the two are seen, but it only owns the
+			// slots which start before the next block does
+			block->size = std::min<size_t>(BlockBytes + value_size - 1, region->end() - address);
+
+			const size_t slots = std::min(slot_count(block->size, value_size, stride_), BlockBytes / stride_);
+			if (slots == 0) {
+				continue;
+			}
+
+			block->bitmap.assign((slots + 63) / 64, ~uint64_t(0));
+			if (slots % 64) {
+				block->bitmap.back() = (uint64_t(1) << (slots % 64)) - 1;
+			}
+
+			blocks_.push_back(std::move(block));
+		}
+	}
+
+	return scan(predicate, lhs, rhs);
+}
+
+/**
+ * @brief ValueScanner::nextScan
+ *
+ * Narrows the current candidates down to the ones which satisfy <predicate>
+ *
+ * @param predicate
+ * @param lhs
+ * @param rhs
+ * @return a future which finishes along with the scan
+ */
+QFuture<void> ValueScanner::nextScan(Predicate predicate, const Operand &lhs, const Operand &rhs) {
+	Q_ASSERT(started_);
+	Q_ASSERT(!scan_);
+	return scan(predicate, lhs, rhs);
+}
+
+/**
+ * @brief ValueScanner::scan
+ *
+ * Blocks are read in batches on the calling thread, since the process may
+ * only be readable from the thread which is tracing it, then each batch is
+ * filtered on the thread pool while the calling thread goes back to its event
+ * loop. The future reports the progress as a percentage.
+ *
+ * @param predicate
+ * @param lhs
+ * @param rhs
+ * @return a future which finishes along with the scan
+ */
+QFuture<void> ValueScanner::scan(Predicate predicate, const Operand &lhs, const Operand &rhs) {
+
+	auto scan       = std::make_shared<Scan>();
+	scan->predicate = predicate;
+	scan->lhs       = lhs;
+	scan->rhs       = rhs;
+
+	scan->done.reportStarted();
+	scan->done.setProgressRange(0, 100);
+
+	scan_ = scan;
+	scanBatch(scan);
+	return scan->done.future();
+}
+
+/**
+ * @brief ValueScanner::scanBatch
+ *
+ * Reads the next batch of blocks and hands it to the thread pool, the scan
+ * carries on with the following batch once this one has been filtered.
+ *
+ * @param scan
+ */
+void ValueScanner::scanBatch(const std::shared_ptr<Scan> &scan) {
+
+	IProcess *process = edb::v1::debugger_core ? edb::v1::debugger_core->process() : nullptr;
+	if (!process) {
+		blocks_.clear();
+		started_ = false;
+		finishScan(scan);
+		return;
+	}
+
+	if (scan->next == blocks_.size()) {
+		finishScan(scan);
+		return;
+	}
+
+	const size_t page_size  = edb::v1::debugger_core->pageSize();
+	const size_t value_size = valueSize(type_);
+	const size_t stride     = stride_;
+	const ValueType type    = type_;
+
+	scan->jobs.clear();
+
+	size_t batch_bytes = 0;
+	while (scan->next < blocks_.size() && batch_bytes < BatchBytes) {
+		Block *const block = blocks_[scan->next++].get();
+
+		Job job;
+		job.block  = block;
+		job.buffer = std::make_unique<uint8_t[]>(page_count(block->size, page_size) * page_size);
+		job.valid  = 0;
+
+		if (block->dense) {
+			read_dense(process, page_size, job);
+		} else {
+			read_sparse(process, page_size, value_size, job);
+		}
+
+		batch_bytes += block->size;
+		scan->jobs.push_back(std::move(job));
+	}
+
+	auto watcher = new QFutureWatcher<void>();
+	QObject::connect(watcher, &QFutureWatcher<void>::finished, watcher, [this, watcher, scan]() {
+		watcher->deleteLater();
+
+		// reset() has already thrown this scan away
+		if (scan->canceled) {
+			return;
+		}
+
+		scan->done.setProgressValue(util::percentage(scan->next, blocks_.size()));
+		scanBatch(scan);
+	});
+
+	const Predicate predicate = scan->predicate;
+	const Operand lhs         = scan->lhs;
+	const Operand rhs         = scan->rhs;
+
+	batch_ = QtConcurrent::map(scan->jobs, [=](Job &job) {
+		with_type(type, [&](auto tag) {
+			using T = decltype(tag);
+			with_predicate<T>(predicate, operand_value<T>(lhs), operand_value<T>(rhs), [&](auto pred) {
+				if (job.block->dense) {
+					scan_dense<T>(job, stride, pred);
+				} else {
+					scan_sparse<T>(job, pred);
+				}
+			});
+			compact<T>(job, stride);
+		});
+	});
+
+	watcher->setFuture(batch_);
+}
+
+/**
+ * @brief ValueScanner::finishScan
+ *
+ * Drops the blocks which no longer have any candidates and finishes <scan>
+ *
+ * @param scan
+ */
+void ValueScanner::finishScan(const std::shared_ptr<Scan> &scan) {
+
+	auto is_empty = [](const std::unique_ptr<Block> &block) {
+		return block->count == 0;
+	};
+
+	blocks_.erase(std::remove_if(blocks_.begin(), blocks_.end(), is_empty), blocks_.end());
+
+	count_ = 0;
+	for (const std::unique_ptr<Block> &block : blocks_) {
+		count_ += block->count;
+	}
+
+	scan->jobs.clear();
+	scan_ = nullptr;
+
+	scan->done.setProgressValue(100);
+	scan->done.reportFinished();
+}
+
+/**
+ * @brief ValueScanner::candidates
+ * @param limit
+ * @return the first <limit> candidates, in address order
+ */
+std::vector<ValueScanner::Candidate> ValueScanner::candidates(size_t limit) const {
+
+	const size_t value_size = valueSize(type_);
+
+	std::vector<Candidate> results;
+	if (limit == 0) {
+		return results;
+	}
+
+	auto add = [&](const Block &block, size_t offset, const uint8_t *value) {
+		Candidate candidate;
+		candidate.address  = block.start + offset;
+		candidate.previous = 0;
+		std::memcpy(&candidate.previous, value, value_size);
+		results.push_back(candidate);
+		return results.size() < limit;
+	};
+
+	for (const std::unique_ptr<Block> &block : blocks_) {
+		if (block->dense) {
+			for (size_t w = 0; w < block->bitmap.size(); ++w) {
+				for (size_t j = 0; j < 64; ++j) {
+					if (block->bitmap[w] & (uint64_t(1) << j)) {
+						const size_t offset = (w * 64 + j) * stride_;
+						if (!add(*block, offset, block->bytes.get() + offset)) {
+							return results;
+						}
+					}
+				}
+			}
+		} else {
+			for (size_t i = 0; i < block->offsets.size(); ++i) {
+				if (!add(*block, block->offsets[i], &block->values[i * value_size])) {
+					return results;
+				}
+			}
+		}
+	}
+
+	return results;
+}
+
+}
@@ -0,0 +1,122 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef VALUE_SCANNER_H_20261019_
+#define VALUE_SCANNER_H_20261019_
+
+#include "Types.h"
+#include <QFuture>
+#include <QList>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class IRegion;
+
+namespace BinarySearcherPlugin {
+
+// An iterative value scanner. The first scan finds every address in the
+// scanned regions holding a value which satisfies a predicate, each following
+// scan narrows that set down to the candidates which still satisfy it.
+//
+// Candidates are kept per block of memory. Blocks with many candidates keep
+// a bitmap of them along with a copy of the whole block, blocks with few keep
+// a sorted array of offsets along with just the candidates' values.
+//
+// Scans run in the background, batches of blocks are read on the calling
+// thread and then filtered on the global thread pool.
+class ValueScanner {
+public:
+	enum class ValueType {
+		U8,
+		U16,
+		U32,
+		U64,
+		Float,
+		Double,
+	};
+
+	enum class Predicate {
+		Unknown, // matches anything, used to start from every address
+		Equal,
+		NotEqual,
+		InRange,
+		Changed,
+		Unchanged,
+		Increased,
+		Decreased,
+	};
+
+	// the operands of a predicate, the field used depends on the value type
+	struct Operand {
+		uint64_t integer = 0;
+		double real      = 0.0;
+	};
+
+	struct Candidate {
+		edb::address_t address;
+		uint64_t previous; // the raw bits of the value seen by the last scan
+	};
+
+	// the candidates within one block of memory, defined in ValueScanner.cpp
+	struct Block;
+
+	// the state of a scan in progress, defined in ValueScanner.cpp
+	struct Scan;
+
+public:
+	ValueScanner();
+	ValueScanner(const ValueScanner &)            = delete;
+	ValueScanner &operator=(const ValueScanner &) = delete;
+	~ValueScanner();
+
+public:
+	static bool isRelative(Predicate predicate);
+	static size_t valueSize(ValueType type);
+
+public:
+	QFuture<void> firstScan(const QList<std::shared_ptr<IRegion>> &regions, ValueType type, bool aligned, Predicate predicate, const Operand &lhs, const Operand &rhs);
+	QFuture<void> nextScan(Predicate predicate, const Operand &lhs, const Operand &rhs);
+	void reset();
+
+public:
+	bool isScanning() const { return scan_ != nullptr; }
+	bool isEmpty() const { return count_ == 0; }
+	bool started() const { return started_; }
+	uint64_t count() const { return count_; }
+	ValueType type() const { return type_; }
+	std::vector<Candidate> candidates(size_t limit) const;
+
+private:
+	QFuture<void> scan(Predicate predicate, const Operand &lhs, const Operand &rhs);
+	void scanBatch(const std::shared_ptr<Scan> &scan);
+	void finishScan(const std::shared_ptr<Scan> &scan);
+
+private:
+	std::vector<std::unique_ptr<Block>> blocks_;
+	std::shared_ptr<Scan> scan_;
+	QFuture<void> batch_;
+	ValueType type_ = ValueType::U32;
+	size_t stride_  = 4;
+	uint64_t count_ = 0;
+	bool started_   = false;
+};
+
+}
+
+#endif
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "DebuggerCoreBase.h"
 #include "Breakpoint.h"
 #include "Configuration.h"
+#include "Status.h"
 #include "edb.h"
 #include <QtDebug>
 
@@ -31,7 +32,13 @@ namespace DebuggerCorePlugin {
  */
 void DebuggerCoreBase::clearBreakpoints() {
 	if (attached()) {
-		breakpoints_.clear();
+		// NOTE(eteran): breakpoints restore the original bytes when they are
+		// destroyed, which reads memory, so that has to happen outside the lock
+		BreakpointList breakpoints;
+		{
+			std::unique_lock<std::shared_mutex> lock(breakpointsMutex_);
+			breakpoints.swap(breakpoints_);
+		}
 	}
 }
 
@@ -50,7 +57,9 @@ std::shared_ptr<IBreakpoint> DebuggerCoreBase::addBreakpoint(edb::address_t addr
 				return bp;
 			}
 
-			auto bp               = std::make_shared<Breakpoint>(address);
+			auto bp = std::make_shared<Breakpoint>(address);
+
+			std::unique_lock<std::shared_mutex> lock(breakpointsMutex_);
 			breakpoints_[address] = bp;
 			return bp;
 		}
@@ -69,8 +78,9 @@ std::shared_ptr<IBreakpoint> DebuggerCoreBase::addBreakpoint(edb::address_t addr
  */
 std::shared_ptr<IBreakpoint> DebuggerCoreBase::findBreakpoint(edb::address_t address) {
 	if (attached()) {
-		auto it = breakpoints_.find(address);
-		if (it != breakpoints_.end()) {
+		std::shared_lock<std::shared_mutex> lock(breakpointsMutex_);
+		auto it = breakpoints_.constFind(address);
+		if (it != breakpoints_.constEnd()) {
 			return it.value();
 		}
 	}
@@ -112,9 +122,15 @@ void DebuggerCoreBase::removeBreakpoint(edb::address_t address) {
 
 	// TODO(eteran): assert paused
 	if (attached()) {
-		auto it = breakpoints_.find(address);
-		if (it != breakpoints_.end()) {
-			breakpoints_.erase(it);
+		// keep the breakpoint alive until we are out of the lock
+		std::shared_ptr<IBreakpoint> bp;
+		{
+			std::unique_lock<std::shared_mutex> lock(breakpointsMutex_);
+			auto it = breakpoints_.find(address);
+			if (it != breakpoints_.end()) {
+				bp = it.value();
+				breakpoints_.erase(it);
+			}
 		}
 	}
 }
@@ -152,6 +168,7 @@ void DebuggerCoreBase::endDebugSession() {
  * @return a list of shared_ptr's to the BPs
  */
 DebuggerCoreBase::BreakpointList DebuggerCoreBase::backupBreakpoints() const {
+	std::shared_lock<std::shared_mutex> lock(breakpointsMutex_);
 	return breakpoints_;
 }
 
@@ -171,4 +188,76 @@ std::vector<IBreakpoint::BreakpointType> DebuggerCoreBase::supportedBreakpointTy
 	return Breakpoint::supportedTypes();
 }
 
+/**
+ * @brief DebuggerCoreBase::addWatchpoint
+ *
+ * Software watchpoints are only available on some platforms
+ *
+ * @param address
+ * @param size
+ * @param type
+ * @return
+ */
+Status DebuggerCoreBase::addWatchpoint(edb::address_t address, size_t size, WatchpointType type) {
+	Q_UNUSED(address)
+	Q_UNUSED(size)
+	Q_UNUSED(type)
+	return Status(tr("Software watchpoints are not supported on this platform"));
+}
+
+/**
+ * @brief DebuggerCoreBase::removeWatchpoint
+ * @param address
+ * @return
+ */
+Status DebuggerCoreBase::removeWatchpoint(edb::address_t address) {
+	Q_UNUSED(address)
+	return Status::Ok;
+}
+
+/**
+ * @brief DebuggerCoreBase::watchpoints
+ * @return
+ */
+std::vector<IDebugger::Watchpoint> DebuggerCoreBase::watchpoints() const {
+	return {};
+}
+
+/**
+ * @brief DebuggerCoreBase::setDebugRegisterTemplate
+ *
+ * Only needed on platforms where new threads don't inherit the debug
+ * registers and the core sets them up itself
+ *
+ * @param values
+ */
+void DebuggerCoreBase::setDebugRegisterTemplate(const std::array<edb::reg_t, 8> &values) {
+	Q_UNUSED(values)
+}
+
+/**
+ * @brief DebuggerCoreBase::openCore
+ *
+ * Core files are only available on some platforms
+ *
+ * @param path
+ * @return
+ */
+Status DebuggerCoreBase::openCore(const QString &path) {
+	Q_UNUSED(path)
+	return Status(tr("Core files are not supported on this platform"));
+}
+
+/**
+ * @brief DebuggerCoreBase::generateCore
+ * @param path
+ * @param skipReadOnlyFiles
+ * @return
+ */
+Status DebuggerCoreBase::generateCore(const QString &path, bool skipReadOnlyFiles) {
+	Q_UNUSED(path)
+	Q_UNUSED(skipReadOnlyFiles)
+	return Status(tr("Core files are not supported on this platform"));
+}
+
 }
@@ -21,6 +21,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "IDebugger.h"
 
+#include <shared_mutex>
+
 class Status;
 
 namespace DebuggerCorePlugin {
@@ -49,10 +51,23 @@ public:
 
 	std::vector<IBreakpoint::BreakpointType> supportedBreakpointTypes() const override;
 
+public:
+	Status addWatchpoint(edb::address_t address, size_t size, WatchpointType type) override;
+	Status removeWatchpoint(edb::address_t address) override;
+	std::vector<Watchpoint> watchpoints() const override;
+	void setDebugRegisterTemplate(const std::array<edb::reg_t, 8> &values) override;
+
+public:
+	Status openCore(const QString &path) override;
+	Status generateCore(const QString &path, bool skipReadOnlyFiles) override;
+
 protected:
 	bool attached() const;
 
 protected:
+	// NOTE(eteran): memory may be read from worker threads, and reads need to
+	// look at the breakpoints, so changes to the list are done under this lock
+	mutable std::shared_mutex breakpointsMutex_;
 	BreakpointList breakpoints_;
 };
 
@@ -0,0 +1,470 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CoreFile.h"
+#include "CoreLayout.h"
+
+#include <QFile>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace DebuggerCorePlugin {
+namespace {
+
+/**
+ * @brief read_value
+ *
+ * Notes are only aligned to 4 bytes, even in 64-bit cores, so their fields
+ * are copied out rather than accessed in place
+ *
+ * @param p
+ * @return
+ */
+template <class T>
+T read_value(const uint8_t *p) {
+	T value;
+	std::memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+/**
+ * @brief read_string
+ * @param p
+ * @param max
+ * @return the NUL terminated string at <p>, which is at most <max> bytes long
+ */
+QByteArray read_string(const uint8_t *p, size_t max) {
+	const char *const str = reinterpret_cast<const char *>(p);
+	return QByteArray(str, static_cast<int>(qstrnlen(str, static_cast<uint>(max))));
+}
+
+/**
+ * @brief map_file
+ * @param path
+ * @param size
+ * @return the contents of <path> mapped read only, or nullptr with errno set
+ */
+const uint8_t *map_file(const QString &path, size_t *size) {
+
+	const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
+		return nullptr;
+	}
+
+	void *p = MAP_FAILED;
+
+	struct stat st;
+	if (::fstat(fd, &st) == 0) {
+		if (st.st_size > 0) {
+			p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		} else {
+			errno = EINVAL;
+		}
+	}
+
+	// the mapping keeps the file alive on its own
+	const int err = errno;
+	::close(fd);
+
+	if (p == MAP_FAILED) {
+		errno = err;
+		return nullptr;
+	}
+
+	*size = static_cast<size_t>(st.st_size);
+	return static_cast<const uint8_t *>(p);
+}
+
+}
+
+/**
+ * @brief CoreFile::open
+ * @param path
+ * @return
+ */
+Result<std::shared_ptr<CoreFile>, QString> CoreFile::open(const QString &path) {
+
+	std::shared_ptr<CoreFile> core(new CoreFile);
+	core->path_ = path;
+
+	core->core_.data = map_file(path, &core->core_.size);
+	if (!core->core_.data) {
+		return make_unexpected(tr("Could not open %1: %2").arg(path, QString::fromLocal8Bit(std::strerror(errno))));
+	}
+
+	const uint8_t *const ident = core->core_.data;
+	if (core->core_.size < EI_NIDENT || std::memcmp(ident, ELFMAG, SELFMAG) != 0) {
+		return make_unexpected(tr("%1 is not an ELF file").arg(path));
+	}
+
+	Status status = Status::Ok;
+	if (ident[EI_CLASS] == ELFCLASS64) {
+		status = core->parse<elf_model<64>>();
+	} else if (ident[EI_CLASS] == ELFCLASS32) {
+		status = core->parse<elf_model<32>>();
+	} else {
+		status = Status(tr("%1 is neither a 32 nor a 64 bit ELF file").arg(path));
+	}
+
+	if (!status) {
+		return make_unexpected(status.error());
+	}
+
+	return core;
+}
+
+/**
+ * @brief CoreFile::~CoreFile
+ */
+CoreFile::~CoreFile() {
+	if (core_.data) {
+		::munmap(const_cast<uint8_t *>(core_.data), core_.size);
+	}
+
+	for (const Mapping &file : files_) {
+		if (file.data) {
+			::munmap(const_cast<uint8_t *>(file.data), file.size);
+		}
+	}
+}
+
+/**
+ * @brief CoreFile::parse
+ *
+ * Collects the segments from the program headers and everything else from the
+ * notes. Segments which go past the end of the file are cut short rather than
+ * rejected, a truncated core is still worth looking at.
+ *
+ * @return
+ */
+template <class Model>
+Status CoreFile::parse() {
+
+	using elf_header = typename Model::elf_header;
+	using elf_phdr   = typename Model::elf_phdr;
+
+	if (core_.size < sizeof(elf_header)) {
+		return Status(tr("%1 is truncated").arg(path_));
+	}
+
+	auto header = reinterpret_cast<const elf_header *>(core_.data);
+	if (header->e_type != ET_CORE) {
+		return Status(tr("%1 is not a core file").arg(path_));
+	}
+
+	if (header->e_phentsize != sizeof(elf_phdr) || header->e_phoff > core_.size || (core_.size - header->e_phoff) / sizeof(elf_phdr) < header->e_phnum) {
+		return Status(tr("The program headers of %1 are corrupt").arg(path_));
+	}
+
+	is64Bit_ = (sizeof(typename Model::elf_addr) == sizeof(uint64_t));
+	machine_ = header->e_machine;
+
+	auto phdrs = reinterpret_cast<const elf_phdr *>(core_.data + header->e_phoff);
+	for (size_t i = 0; i < header->e_phnum; ++i) {
+		const elf_phdr &phdr = phdrs[i];
+
+		const uint64_t available = (phdr.p_offset < core_.size) ? core_.size - phdr.p_offset : 0;
+
+		if (phdr.p_type == PT_LOAD) {
+			IRegion::permissions_t permissions = 0;
+			if (phdr.p_flags & PF_R) permissions |= PROT_READ;
+			if (phdr.p_flags & PF_W) permissions |= PROT_WRITE;
+			if (phdr.p_flags & PF_X) permissions |= PROT_EXEC;
+
+			segments_.push_back(Segment{phdr.p_vaddr, static_cast<uint64_t>(phdr.p_vaddr) + phdr.p_memsz, phdr.p_offset, std::min<uint64_t>(phdr.p_filesz, available), permissions});
+		} else if (phdr.p_type == PT_NOTE) {
+			parseNotes<Model>(core_.data + phdr.p_offset, std::min<uint64_t>(phdr.p_filesz, available));
+		}
+	}
+
+	std::sort(segments_.begin(), segments_.end(), [](const Segment &lhs, const Segment &rhs) {
+		return lhs.start < rhs.start;
+	});
+
+	std::sort(mappedFiles_.begin(), mappedFiles_.end(), [](const MappedFile &lhs, const MappedFile &rhs) {
+		return lhs.start < rhs.start;
+	});
+
+	if (threads_.empty()) {
+		return Status(tr("%1 doesn't describe any threads").arg(path_));
+	}
+
+	if (pid_ == 0) {
+		pid_ = threads_.front().tid;
+	}
+
+	return Status::Ok;
+}
+
+/**
+ * @brief CoreFile::parseNotes
+ *
+ * Every thread has an NT_PRSTATUS note, followed by the notes for the rest of
+ * its registers
+ *
+ * @param p
+ * @param size
+ */
+template <class Model>
+void CoreFile::parseNotes(const uint8_t *p, size_t size) {
+
+	using Layout     = CoreLayout<Model>;
+	using elf_addr   = typename Model::elf_addr;
+	using elf_auxv_t = typename Model::elf_auxv_t;
+	using elf_nhdr   = typename Model::elf_nhdr;
+
+	size_t offset = 0;
+	while (size - offset >= sizeof(elf_nhdr)) {
+		const auto nhdr = read_value<elf_nhdr>(p + offset);
+		offset += sizeof(elf_nhdr);
+
+		if (note_align(nhdr.n_namesz) > size - offset) {
+			break;
+		}
+
+		offset += note_align(nhdr.n_namesz);
+
+		if (nhdr.n_descsz > size - offset) {
+			break;
+		}
+
+		const Note desc{p + offset, nhdr.n_descsz};
+		offset += std::min(note_align(nhdr.n_descsz), size - offset);
+
+		switch (nhdr.n_type) {
+		case NtPrStatus:
+			if (desc.size > Layout::PrStatusRegs + Layout::PrStatusTail) {
+				Thread thread = {};
+				thread.tid    = read_value<int32_t>(desc.data + Layout::PrStatusPid);
+				thread.signal = read_value<int16_t>(desc.data + Layout::PrStatusSignal);
+				thread.regs   = Note{desc.data + Layout::PrStatusRegs, desc.size - Layout::PrStatusRegs - Layout::PrStatusTail};
+				threads_.push_back(thread);
+			}
+			break;
+		case NtFpRegSet:
+			if (!threads_.empty()) {
+				threads_.back().fpregs = desc;
+			}
+			break;
+		case NtPrXFpReg:
+			if (!threads_.empty()) {
+				threads_.back().fpxregs = desc;
+			}
+			break;
+		case NtX86XState:
+			if (!threads_.empty()) {
+				threads_.back().xstate = desc;
+			}
+			break;
+		case NtPrPsInfo:
+			if (desc.size >= Layout::PrPsInfoArgs + PrPsInfoArgsSize) {
+				uid_  = read_value<typename Layout::uid_type>(desc.data + Layout::PrPsInfoUid);
+				pid_  = read_value<int32_t>(desc.data + Layout::PrPsInfoPid);
+				name_ = QString::fromLocal8Bit(read_string(desc.data + Layout::PrPsInfoName, PrPsInfoNameSize));
+
+				// NOTE(eteran): the kernel only keeps the start of the command
+				// line, with the arguments separated by spaces
+				const QByteArray args = read_string(desc.data + Layout::PrPsInfoArgs, PrPsInfoArgsSize);
+				for (const QByteArray &arg : args.split(' ')) {
+					if (!arg.isEmpty()) {
+						arguments_.push_back(arg);
+					}
+				}
+			}
+			break;
+		case NtAuxv:
+			for (size_t i = 0; i + sizeof(elf_auxv_t) <= desc.size; i += sizeof(elf_auxv_t)) {
+				const auto entry = read_value<elf_auxv_t>(desc.data + i);
+				if (entry.a_type == AT_ENTRY) {
+					entryPoint_ = entry.a_un.a_val;
+				}
+			}
+			break;
+		case NtFile:
+			// a count and a page size, followed by a start, end and page offset
+			// for each file, followed by their names
+			if (desc.size >= 2 * sizeof(elf_addr)) {
+				const uint64_t count     = read_value<elf_addr>(desc.data);
+				const uint64_t page_size = read_value<elf_addr>(desc.data + sizeof(elf_addr));
+
+				const uint8_t *const entries = desc.data + 2 * sizeof(elf_addr);
+				const uint8_t *const end     = desc.data + desc.size;
+
+				if (count > static_cast<uint64_t>(end - entries) / (3 * sizeof(elf_addr))) {
+					break;
+				}
+
+				const uint8_t *name = entries + count * 3 * sizeof(elf_addr);
+				for (uint64_t i = 0; i < count && name < end; ++i) {
+					const uint8_t *const entry = entries + i * 3 * sizeof(elf_addr);
+					const QByteArray path      = read_string(name, static_cast<size_t>(end - name));
+
+					MappedFile file;
+					file.start  = read_value<elf_addr>(entry);
+					file.end    = read_value<elf_addr>(entry + sizeof(elf_addr));
+					file.offset = read_value<elf_addr>(entry + 2 * sizeof(elf_addr)) * page_size;
+					file.path   = QFile::decodeName(path);
+					mappedFiles_.push_back(file);
+
+					name += path.size() + 1;
+				}
+			}
+			break;
+		}
+	}
+}
+
+/**
+ * @brief CoreFile::findSegment
+ * @param address
+ * @return
+ */
+const CoreFile::Segment *CoreFile::findSegment(edb::address_t address) const {
+
+	auto it = std::upper_bound(segments_.begin(), segments_.end(), address, [](edb::address_t addr, const Segment &segment) {
+		return addr < segment.start;
+	});
+
+	if (it == segments_.begin()) {
+		return nullptr;
+	}
+
+	--it;
+	return (address < it->end) ? &*it : nullptr;
+}
+
+/**
+ * @brief CoreFile::findMappedFile
+ * @param address
+ * @return
+ */
+const CoreFile::MappedFile *CoreFile::findMappedFile(edb::address_t address) const {
+
+	auto it = std::upper_bound(mappedFiles_.begin(), mappedFiles_.end(), address, [](edb::address_t addr, const MappedFile &file) {
+		return addr < file.start;
+	});
+
+	if (it == mappedFiles_.begin()) {
+		return nullptr;
+	}
+
+	--it;
+	return (address < it->end) ? &*it : nullptr;
+}
+
+/**
+ * @brief CoreFile::read
+ *
+ * Copies straight out of the mapping of the core, or of the original file for
+ * the parts of a segment which weren't dumped. Stops at the first byte whose
+ * contents can't be known.
+ *
+ * @param address
+ * @param buf
+ * @param len
+ * @return the number of bytes read
+ */
+size_t CoreFile::read(edb::address_t address, void *buf, size_t len) const {
+
+	auto out    = static_cast<uint8_t *>(buf);
+	size_t done = 0;
+
+	while (done < len) {
+		const edb::address_t addr = address + done;
+
+		const Segment *segment = findSegment(addr);
+		if (!segment) {
+			break;
+		}
+
+		const uint64_t delta = addr - segment->start;
+		size_t n             = static_cast<size_t>(std::min<uint64_t>(len - done, segment->end - addr));
+
+		if (delta < segment->fileSize) {
+			n = static_cast<size_t>(std::min<uint64_t>(n, segment->fileSize - delta));
+			std::memcpy(out + done, core_.data + segment->offset + delta, n);
+		} else if (const MappedFile *file = findMappedFile(addr)) {
+			n = static_cast<size_t>(std::min<uint64_t>(n, file->end - addr));
+			if (!readMappedFile(*file, addr, out + done, n)) {
+				break;
+			}
+		} else {
+			// neither dumped nor backed by a file, the contents are lost
+			break;
+		}
+
+		done += n;
+	}
+
+	return done;
+}
+
+/**
+ * @brief CoreFile::readMappedFile
+ *
+ * The kernel doesn't dump file backed pages which weren't modified, so these
+ * are read from the file which was mapped there, assuming it didn't change
+ * since.
+ *
+ * @param file
+ * @param address
+ * @param buf
+ * @param len
+ * @return false if the file couldn't be read
+ */
+bool CoreFile::readMappedFile(const MappedFile &file, edb::address_t address, uint8_t *buf, size_t len) const {
+
+	Mapping mapping;
+	{
+		std::lock_guard<std::mutex> lock(filesMutex_);
+
+		auto it = files_.find(file.path);
+		if (it == files_.end()) {
+			// a file which can't be mapped is remembered too, so we only try once
+			Mapping m;
+			m.data = map_file(file.path, &m.size);
+			it     = files_.insert(file.path, m);
+		}
+
+		mapping = *it;
+	}
+
+	if (!mapping.data) {
+		return false;
+	}
+
+	// whatever is past the end of the file reads as zeros
+	const uint64_t offset  = file.offset + (address - file.start);
+	const size_t available = (offset < mapping.size) ? static_cast<size_t>(std::min<uint64_t>(len, mapping.size - offset)) : 0;
+
+	if (available) {
+		std::memcpy(buf, mapping.data + offset, available);
+	}
+
+	std::memset(buf + available, 0, len - available);
+	return true;
+}
+
+}
@@ -0,0 +1,141 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CORE_FILE_H_20261019_
+#define CORE_FILE_H_20261019_
+
+#include "IRegion.h"
+#include "OSTypes.h"
+#include "Status.h"
+#include "Types.h"
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace DebuggerCorePlugin {
+
+// An ELF core file, mapped into memory as a whole. Nothing is copied up front,
+// the notes are parsed in place and memory is read straight out of the
+// mapping, so opening even a very large core is about as fast as opening the
+// file. Pages which the kernel didn't dump, because they were file backed and
+// unmodified, are read from the original files instead.
+class CoreFile {
+	Q_DECLARE_TR_FUNCTIONS(CoreFile)
+
+public:
+	// the descriptor of a note, pointing into the mapping
+	struct Note {
+		const uint8_t *data = nullptr;
+		size_t size         = 0;
+	};
+
+	struct Segment {
+		edb::address_t start;
+		edb::address_t end;
+		uint64_t offset;   // where the contents start in the core
+		uint64_t fileSize; // how much of the contents were dumped
+		IRegion::permissions_t permissions;
+	};
+
+	struct MappedFile {
+		edb::address_t start;
+		edb::address_t end;
+		uint64_t offset; // in bytes, into the file
+		QString path;
+	};
+
+	struct Thread {
+		edb::tid_t tid;
+		int signal;
+		Note regs;    // pr_reg of NT_PRSTATUS
+		Note fpregs;  // NT_FPREGSET
+		Note fpxregs; // NT_PRXFPREG
+		Note xstate;  // NT_X86_XSTATE
+	};
+
+public:
+	static Result<std::shared_ptr<CoreFile>, QString> open(const QString &path);
+
+public:
+	~CoreFile();
+	CoreFile(const CoreFile &)            = delete;
+	CoreFile &operator=(const CoreFile &) = delete;
+
+private:
+	CoreFile() = default;
+
+public:
+	QString path() const { return path_; }
+	bool is64Bit() const { return is64Bit_; }
+	int machine() const { return machine_; }
+	const std::vector<Segment> &segments() const { return segments_; }
+	const std::vector<MappedFile> &mappedFiles() const { return mappedFiles_; }
+	const std::vector<Thread> &threads() const { return threads_; }
+	edb::pid_t pid() const { return pid_; }
+	edb::uid_t uid() const { return uid_; }
+	QString name() const { return name_; }
+	QList<QByteArray> arguments() const { return arguments_; }
+	edb::address_t entryPoint() const { return entryPoint_; }
+
+public:
+	size_t read(edb::address_t address, void *buf, size_t len) const;
+	const MappedFile *findMappedFile(edb::address_t address) const;
+
+private:
+	struct Mapping {
+		const uint8_t *data = nullptr;
+		size_t size         = 0;
+	};
+
+private:
+	template <class Model>
+	Status parse();
+
+	template <class Model>
+	void parseNotes(const uint8_t *p, size_t size);
+
+	const Segment *findSegment(edb::address_t address) const;
+	bool readMappedFile(const MappedFile &file, edb::address_t address, uint8_t *buf, size_t len) const;
+
+private:
+	QString path_;
+	Mapping core_;
+	bool is64Bit_              = false;
+	int machine_               = 0;
+	edb::pid_t pid_            = 0;
+	edb::uid_t uid_            = 0;
+	edb::address_t entryPoint_ = 0;
+	QString name_;
+	QList<QByteArray> arguments_;
+	std::vector<Segment> segments_;       // sorted by address
+	std::vector<MappedFile> mappedFiles_; // sorted by address
+	std::vector<Thread> threads_;
+
+	// the original files, mapped when they are first needed
+	mutable std::mutex filesMutex_;
+	mutable QHash<QString, Mapping> files_;
+};
+
+}
+
+#endif
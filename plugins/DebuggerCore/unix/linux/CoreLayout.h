@@ -0,0 +1,94 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CORE_LAYOUT_H_20261019_
+#define CORE_LAYOUT_H_20261019_
+
+#include "libELF/elf_model.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace DebuggerCorePlugin {
+
+// the notes of a core file we know about, see <elf.h>
+constexpr uint32_t NtPrStatus  = 1;
+constexpr uint32_t NtFpRegSet  = 2;
+constexpr uint32_t NtPrPsInfo  = 3;
+constexpr uint32_t NtAuxv      = 6;
+constexpr uint32_t NtX86XState = 0x202;
+constexpr uint32_t NtFile      = 0x46494c45;
+constexpr uint32_t NtPrXFpReg  = 0x46e62b7f;
+
+constexpr size_t PrPsInfoNameSize = 16;
+constexpr size_t PrPsInfoArgsSize = 80;
+
+// where the fields we need are found in the elf_prstatus and elf_prpsinfo
+// notes, which are laid out differently for 32 and 64 bit processes. The
+// registers of elf_prstatus are followed by pr_fpvalid and padding, and are
+// sized by the architecture, so they are whatever is between the two
+template <class Model>
+struct CoreLayout;
+
+template <>
+struct CoreLayout<elf_model<64>> {
+	using uid_type = uint32_t;
+
+	static constexpr size_t PrStatusSignal = 12;
+	static constexpr size_t PrStatusPid    = 32;
+	static constexpr size_t PrStatusRegs   = 112;
+	static constexpr size_t PrStatusTail   = 8;
+	static constexpr size_t PrPsInfoState  = 0;
+	static constexpr size_t PrPsInfoUid    = 16;
+	static constexpr size_t PrPsInfoPid    = 24;
+	static constexpr size_t PrPsInfoName   = 40;
+	static constexpr size_t PrPsInfoArgs   = 56;
+	static constexpr size_t PrPsInfoSize   = 136;
+};
+
+template <>
+struct CoreLayout<elf_model<32>> {
+	using uid_type = uint16_t;
+
+	static constexpr size_t PrStatusSignal = 12;
+	static constexpr size_t PrStatusPid    = 24;
+	static constexpr size_t PrStatusRegs   = 72;
+	static constexpr size_t PrStatusTail   = 4;
+	static constexpr size_t PrPsInfoState  = 0;
+	static constexpr size_t PrPsInfoUid    = 8;
+	static constexpr size_t PrPsInfoPid    = 12;
+	static constexpr size_t PrPsInfoName   = 28;
+	static constexpr size_t PrPsInfoArgs   = 44;
+	static constexpr size_t PrPsInfoSize   = 124;
+};
+
+/**
+ * @brief note_align
+ *
+ * The name and descriptor of a note are padded to 4 bytes, even in 64-bit
+ * cores
+ *
+ * @param n
+ * @return
+ */
+constexpr size_t note_align(size_t n) {
+	return (n + 3) & ~size_t(3);
+}
+
+}
+
+#endif
@@ -0,0 +1,397 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CoreProcess.h"
+#include "CoreFile.h"
+#include "CoreThread.h"
+#include "IDebugger.h"
+#include "Module.h"
+#include "PlatformRegion.h"
+#include "edb.h"
+
+#include <QDateTime>
+#include <QSet>
+
+#include <cstring>
+
+#include <pwd.h>
+
+namespace DebuggerCorePlugin {
+
+/**
+ * @brief CoreProcess::CoreProcess
+ * @param core
+ */
+CoreProcess::CoreProcess(std::shared_ptr<CoreFile> core)
+	: core_(std::move(core)) {
+
+	for (const CoreFile::Segment &segment : core_->segments()) {
+		edb::address_t base = 0;
+		QString name;
+
+		if (const CoreFile::MappedFile *file = core_->findMappedFile(segment.start)) {
+			base = file->offset + (segment.start - file->start);
+			name = file->path;
+		}
+
+		regions_.push_back(std::make_shared<PlatformRegion>(segment.start, segment.end, base, name, segment.permissions));
+	}
+
+	for (size_t i = 0; i < core_->threads().size(); ++i) {
+		threads_.push_back(std::make_shared<CoreThread>(core_, i));
+	}
+
+	// the thread which took the signal that killed the process is the first
+	currentThread_ = threads_.front();
+}
+
+/**
+ * @brief CoreProcess::startTime
+ * @return
+ */
+QDateTime CoreProcess::startTime() const {
+	return QDateTime();
+}
+
+/**
+ * @brief CoreProcess::arguments
+ * @return
+ */
+QList<QByteArray> CoreProcess::arguments() const {
+	return core_->arguments();
+}
+
+/**
+ * @brief CoreProcess::currentWorkingDirectory
+ * @return
+ */
+QString CoreProcess::currentWorkingDirectory() const {
+	return QString();
+}
+
+/**
+ * @brief CoreProcess::executable
+ * @return the file which the entry point is in
+ */
+QString CoreProcess::executable() const {
+	if (const CoreFile::MappedFile *file = core_->findMappedFile(core_->entryPoint())) {
+		return file->path;
+	}
+
+	return QString();
+}
+
+/**
+ * @brief CoreProcess::standardInput
+ * @return
+ */
+QString CoreProcess::standardInput() const {
+	return QString();
+}
+
+/**
+ * @brief CoreProcess::standardOutput
+ * @return
+ */
+QString CoreProcess::standardOutput() const {
+	return QString();
+}
+
+/**
+ * @brief CoreProcess::pid
+ * @return
+ */
+edb::pid_t CoreProcess::pid() const {
+	return core_->pid();
+}
+
+/**
+ * @brief CoreProcess::parent
+ * @return
+ */
+std::shared_ptr<IProcess> CoreProcess::parent() const {
+	return nullptr;
+}
+
+/**
+ * @brief CoreProcess::codeAddress
+ * @return
+ */
+edb::address_t CoreProcess::codeAddress() const {
+	return 0;
+}
+
+/**
+ * @brief CoreProcess::dataAddress
+ * @return
+ */
+edb::address_t CoreProcess::dataAddress() const {
+	return 0;
+}
+
+/**
+ * @brief CoreProcess::entryPoint
+ * @return
+ */
+edb::address_t CoreProcess::entryPoint() const {
+	return core_->entryPoint();
+}
+
+/**
+ * @brief CoreProcess::regions
+ * @return
+ */
+QList<std::shared_ptr<IRegion>> CoreProcess::regions() const {
+	return regions_;
+}
+
+/**
+ * @brief CoreProcess::threads
+ * @return
+ */
+QList<std::shared_ptr<IThread>> CoreProcess::threads() const {
+	return threads_;
+}
+
+/**
+ * @brief CoreProcess::currentThread
+ * @return
+ */
+std::shared_ptr<IThread> CoreProcess::currentThread() const {
+	return currentThread_;
+}
+
+/**
+ * @brief CoreProcess::setCurrentThread
+ * @param thread
+ */
+void CoreProcess::setCurrentThread(IThread &thread) {
+	for (const std::shared_ptr<IThread> &t : threads_) {
+		if (t->tid() == thread.tid()) {
+			currentThread_ = t;
+			edb::v1::update_ui();
+			break;
+		}
+	}
+}
+
+/**
+ * @brief CoreProcess::uid
+ * @return
+ */
+edb::uid_t CoreProcess::uid() const {
+	return core_->uid();
+}
+
+/**
+ * @brief CoreProcess::user
+ * @return
+ */
+QString CoreProcess::user() const {
+	if (const struct passwd *const pwd = ::getpwuid(uid())) {
+		return pwd->pw_name;
+	}
+
+	return QString();
+}
+
+/**
+ * @brief CoreProcess::name
+ * @return
+ */
+QString CoreProcess::name() const {
+	return core_->name();
+}
+
+/**
+ * @brief CoreProcess::loadedModules
+ *
+ * Every ELF file which was mapped from its start, at the address it was mapped
+ * at. Their symbols are then found in the original files.
+ *
+ * @return
+ */
+QList<Module> CoreProcess::loadedModules() const {
+
+	QList<Module> modules;
+	QSet<QString> seen;
+
+	for (const CoreFile::MappedFile &file : core_->mappedFiles()) {
+		if (file.offset != 0 || seen.contains(file.path)) {
+			continue;
+		}
+
+		char magic[4];
+		if (core_->read(file.start, magic, sizeof(magic)) == sizeof(magic) && std::memcmp(magic, "\177ELF", sizeof(magic)) == 0) {
+			seen.insert(file.path);
+
+			Module module;
+			module.name        = file.path;
+			module.baseAddress = file.start;
+			modules.push_back(module);
+		}
+	}
+
+	return modules;
+}
+
+/**
+ * @brief CoreProcess::pause
+ * @return
+ */
+Status CoreProcess::pause() {
+	return Status(tr("The process of a core file can't run"));
+}
+
+/**
+ * @brief CoreProcess::resume
+ * @param status
+ * @return
+ */
+Status CoreProcess::resume(edb::EventStatus status) {
+	Q_UNUSED(status)
+	return Status(tr("The process of a core file can't run"));
+}
+
+/**
+ * @brief CoreProcess::step
+ * @param status
+ * @return
+ */
+Status CoreProcess::step(edb::EventStatus status) {
+	Q_UNUSED(status)
+	return Status(tr("The process of a core file can't run"));
+}
+
+/**
+ * @brief CoreProcess::isPaused
+ * @return
+ */
+bool CoreProcess::isPaused() const {
+	return true;
+}
+
+/**
+ * @brief CoreProcess::pause
+ * @param thread
+ * @return
+ */
+Status CoreProcess::pause(IThread &thread) {
+	Q_UNUSED(thread)
+	return pause();
+}
+
+/**
+ * @brief CoreProcess::resume
+ * @param thread
+ * @param status
+ * @return
+ */
+Status CoreProcess::resume(IThread &thread, edb::EventStatus status) {
+	return thread.resume(status);
+}
+
+/**
+ * @brief CoreProcess::step
+ * @param thread
+ * @param status
+ * @return
+ */
+Status CoreProcess::step(IThread &thread, edb::EventStatus status) {
+	return thread.step(status);
+}
+
+/**
+ * @brief CoreProcess::stepOverBreakpoint
+ * @param thread
+ * @param status
+ * @return
+ */
+Status CoreProcess::stepOverBreakpoint(IThread &thread, edb::EventStatus status) {
+	return thread.step(status);
+}
+
+/**
+ * @brief CoreProcess::runOverBreakpoint
+ * @param thread
+ * @param status
+ * @return
+ */
+Status CoreProcess::runOverBreakpoint(IThread &thread, edb::EventStatus status) {
+	return resume(thread, status);
+}
+
+/**
+ * @brief CoreProcess::writeBytes
+ * @param address
+ * @param buf
+ * @param len
+ * @return
+ */
+std::size_t CoreProcess::writeBytes(edb::address_t address, const void *buf, size_t len) {
+	Q_UNUSED(address)
+	Q_UNUSED(buf)
+	Q_UNUSED(len)
+	return 0;
+}
+
+/**
+ * @brief CoreProcess::patchBytes
+ * @param address
+ * @param buf
+ * @param len
+ * @return
+ */
+std::size_t CoreProcess::patchBytes(edb::address_t address, const void *buf, size_t len) {
+	return writeBytes(address, buf, len);
+}
+
+/**
+ * @brief CoreProcess::readBytes
+ * @param address
+ * @param buf
+ * @param len
+ * @return
+ */
+std::size_t CoreProcess::readBytes(edb::address_t address, void *buf, size_t len) const {
+	Q_ASSERT(buf);
+	return core_->read(address, buf, len);
+}
+
+/**
+ * @brief CoreProcess::readPages
+ * @param address
+ * @param buf
+ * @param count
+ * @return
+ */
+std::size_t CoreProcess::readPages(edb::address_t address, void *buf, size_t count) const {
+	Q_ASSERT(buf);
+	const size_t page_size = edb::v1::debugger_core->pageSize();
+	return core_->read(address, buf, count * page_size) / page_size;
+}
+
+/**
+ * @brief CoreProcess::patches
+ * @return
+ */
+QMap<edb::address_t, Patch> CoreProcess::patches() const {
+	return QMap<edb::address_t, Patch>();
+}
+
+}
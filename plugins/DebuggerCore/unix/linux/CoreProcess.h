@@ -0,0 +1,93 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CORE_PROCESS_H_20261019_
+#define CORE_PROCESS_H_20261019_
+
+#include "IProcess.h"
+#include "Status.h"
+
+#include <QCoreApplication>
+
+namespace DebuggerCorePlugin {
+
+class CoreFile;
+
+// The process described by a core file. Its memory and threads can be
+// inspected like those of any other process, but it is read only and can't be
+// resumed.
+class CoreProcess final : public IProcess {
+	Q_DECLARE_TR_FUNCTIONS(CoreProcess)
+
+public:
+	explicit CoreProcess(std::shared_ptr<CoreFile> core);
+	~CoreProcess() override                     = default;
+	CoreProcess(const CoreProcess &)            = delete;
+	CoreProcess &operator=(const CoreProcess &) = delete;
+
+public:
+	QDateTime startTime() const override;
+	QList<QByteArray> arguments() const override;
+	QString currentWorkingDirectory() const override;
+	QString executable() const override;
+	QString standardInput() const override;
+	QString standardOutput() const override;
+	edb::pid_t pid() const override;
+	std::shared_ptr<IProcess> parent() const override;
+	edb::address_t codeAddress() const override;
+	edb::address_t dataAddress() const override;
+	edb::address_t entryPoint() const override;
+	QList<std::shared_ptr<IRegion>> regions() const override;
+	QList<std::shared_ptr<IThread>> threads() const override;
+	std::shared_ptr<IThread> currentThread() const override;
+	void setCurrentThread(IThread &thread) override;
+	edb::uid_t uid() const override;
+	QString user() const override;
+	QString name() const override;
+	QList<Module> loadedModules() const override;
+
+public:
+	Status pause() override;
+	Status resume(edb::EventStatus status) override;
+	Status step(edb::EventStatus status) override;
+	bool isPaused() const override;
+
+public:
+	Status pause(IThread &thread) override;
+	Status resume(IThread &thread, edb::EventStatus status) override;
+	Status step(IThread &thread, edb::EventStatus status) override;
+	Status stepOverBreakpoint(IThread &thread, edb::EventStatus status) override;
+	Status runOverBreakpoint(IThread &thread, edb::EventStatus status) override;
+
+public:
+	std::size_t writeBytes(edb::address_t address, const void *buf, size_t len) override;
+	std::size_t patchBytes(edb::address_t address, const void *buf, size_t len) override;
+	std::size_t readBytes(edb::address_t address, void *buf, size_t len) const override;
+	std::size_t readPages(edb::address_t address, void *buf, size_t count) const override;
+	QMap<edb::address_t, Patch> patches() const override;
+
+private:
+	std::shared_ptr<CoreFile> core_;
+	QList<std::shared_ptr<IRegion>> regions_;
+	QList<std::shared_ptr<IThread>> threads_;
+	std::shared_ptr<IThread> currentThread_;
+};
+
+}
+
+#endif
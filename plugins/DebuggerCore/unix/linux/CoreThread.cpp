@@ -0,0 +1,125 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CoreThread.h"
+#include "CoreFile.h"
+#include "Status.h"
+
+#include <cassert>
+
+namespace DebuggerCorePlugin {
+
+/**
+ * @brief CoreThread::CoreThread
+ * @param core
+ * @param index which of the threads of <core> this is
+ */
+CoreThread::CoreThread(std::shared_ptr<CoreFile> core, size_t index)
+	: core_(std::move(core)), index_(index) {
+	assert(core_);
+	assert(index_ < core_->threads().size());
+}
+
+/**
+ * @brief CoreThread::tid
+ * @return
+ */
+edb::tid_t CoreThread::tid() const {
+	return core_->threads()[index_].tid;
+}
+
+/**
+ * @brief CoreThread::name
+ *
+ * Core files only name the process, so every thread gets that name
+ *
+ * @return
+ */
+QString CoreThread::name() const {
+	return core_->name();
+}
+
+/**
+ * @brief CoreThread::priority
+ * @return
+ */
+int CoreThread::priority() const {
+	return 0;
+}
+
+/**
+ * @brief CoreThread::runState
+ * @return
+ */
+QString CoreThread::runState() const {
+	return tr("Dumped (signal %1)").arg(core_->threads()[index_].signal);
+}
+
+/**
+ * @brief CoreThread::setState
+ * @param state
+ */
+void CoreThread::setState(const State &state) {
+	Q_UNUSED(state)
+}
+
+/**
+ * @brief CoreThread::step
+ * @return
+ */
+Status CoreThread::step() {
+	return Status(tr("The threads of a core file can't be stepped"));
+}
+
+/**
+ * @brief CoreThread::step
+ * @param status
+ * @return
+ */
+Status CoreThread::step(edb::EventStatus status) {
+	Q_UNUSED(status)
+	return step();
+}
+
+/**
+ * @brief CoreThread::resume
+ * @return
+ */
+Status CoreThread::resume() {
+	return Status(tr("The threads of a core file can't be resumed"));
+}
+
+/**
+ * @brief CoreThread::resume
+ * @param status
+ * @return
+ */
+Status CoreThread::resume(edb::EventStatus status) {
+	Q_UNUSED(status)
+	return resume();
+}
+
+/**
+ * @brief CoreThread::isPaused
+ * @return
+ */
+bool CoreThread::isPaused() const {
+	return true;
+}
+
+}
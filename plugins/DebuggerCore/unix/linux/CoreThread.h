@@ -0,0 +1,68 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CORE_THREAD_H_20261019_
+#define CORE_THREAD_H_20261019_
+
+#include "IThread.h"
+#include <QCoreApplication>
+#include <memory>
+
+namespace DebuggerCorePlugin {
+
+class CoreFile;
+
+// A thread of a core file. Its registers are what they were when the process
+// died, and it can never run again.
+class CoreThread final : public IThread {
+	Q_DECLARE_TR_FUNCTIONS(CoreThread)
+
+public:
+	CoreThread(std::shared_ptr<CoreFile> core, size_t index);
+	~CoreThread() override                    = default;
+	CoreThread(const CoreThread &)            = delete;
+	CoreThread &operator=(const CoreThread &) = delete;
+
+public:
+	edb::tid_t tid() const override;
+	QString name() const override;
+	int priority() const override;
+	edb::address_t instructionPointer() const override;
+	QString runState() const override;
+
+public:
+	void getState(State *state) override;
+	void setState(const State &state) override;
+
+public:
+	Status step() override;
+	Status step(edb::EventStatus status) override;
+	Status resume() override;
+	Status resume(edb::EventStatus status) override;
+
+public:
+	bool isPaused() const override;
+
+private:
+	std::shared_ptr<CoreFile> core_;
+	size_t index_;
+};
+
+}
+
+#endif
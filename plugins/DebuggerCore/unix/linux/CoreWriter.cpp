@@ -0,0 +1,487 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LARGEFILE64_SOURCE
+#define _LARGEFILE64_SOURCE
+#endif
+
+#include "CoreWriter.h"
+#include "CoreLayout.h"
+#include "IProcess.h"
+
+#include <QFile>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace DebuggerCorePlugin {
+namespace {
+
+// How much memory a reader reads at once, each reader has a buffer this big
+constexpr size_t ChunkSize = 1024 * 1024;
+
+/**
+ * @brief write_value
+ * @param buffer
+ * @param offset
+ * @param value
+ */
+template <class T>
+void write_value(QByteArray *buffer, size_t offset, T value) {
+	std::memcpy(buffer->data() + offset, &value, sizeof(value));
+}
+
+/**
+ * @brief is_zero
+ * @param p
+ * @param n
+ * @return true if all <n> bytes at <p> are zero
+ */
+bool is_zero(const uint8_t *p, size_t n) {
+	return p[0] == 0 && std::memcmp(p, p + 1, n - 1) == 0;
+}
+
+/**
+ * @brief write_all
+ * @param fd
+ * @param buf
+ * @param len
+ * @param offset
+ * @return 0 on success, otherwise the errno of the failed write
+ */
+int write_all(int fd, const void *buf, size_t len, uint64_t offset) {
+	auto p = static_cast<const uint8_t *>(buf);
+
+	while (len != 0) {
+		const ssize_t n = ::pwrite64(fd, p, len, static_cast<off64_t>(offset));
+		if (n == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return errno;
+		}
+
+		p += n;
+		len -= static_cast<size_t>(n);
+		offset += static_cast<size_t>(n);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief prstatus
+ * @param tid
+ * @param regs
+ * @param size
+ * @return an elf_prstatus of the layout of <Model>, holding <regs>
+ */
+template <class Model>
+QByteArray prstatus(edb::tid_t tid, const void *regs, size_t size) {
+	using Layout = CoreLayout<Model>;
+
+	QByteArray status(static_cast<int>(Layout::PrStatusRegs + size + Layout::PrStatusTail), '\0');
+	write_value(&status, Layout::PrStatusPid, static_cast<int32_t>(tid));
+	std::memcpy(status.data() + Layout::PrStatusRegs, regs, size);
+
+	// pr_fpvalid, the floating point registers follow in their own notes
+	write_value(&status, Layout::PrStatusRegs + size, int32_t(1));
+	return status;
+}
+
+}
+
+/**
+ * @brief CoreWriter::CoreWriter
+ * @param process
+ * @param is64Bit
+ * @param machine the e_machine of the core
+ * @param pageSize
+ */
+CoreWriter::CoreWriter(IProcess *process, bool is64Bit, int machine, size_t pageSize)
+	: process_(process), is64Bit_(is64Bit), machine_(machine), pageSize_(pageSize) {
+}
+
+/**
+ * @brief CoreWriter::addRegion
+ *
+ * Regions which aren't dumped still get a segment, just without any of their
+ * contents in the file, the same as the kernel does for the regions it
+ * filters out.
+ *
+ * @param region
+ * @param dump
+ */
+void CoreWriter::addRegion(const IRegion &region, bool dump) {
+	segments_.push_back(Segment{region.start(), region.end(), region.base(), region.name(), region.permissions(), dump});
+}
+
+/**
+ * @brief CoreWriter::addNote
+ * @param notes
+ * @param type
+ * @param desc
+ * @param size
+ */
+void CoreWriter::addNote(QByteArray *notes, uint32_t type, const void *desc, size_t size) {
+
+	// the notes which only Linux has are named differently
+	const char *const name = (type == NtPrXFpReg || type == NtX86XState) ? "LINUX" : "CORE";
+	const size_t name_size = std::strlen(name) + 1;
+
+	// NOTE(eteran): the note header is the same for both classes
+	elf32_nhdr header;
+	header.n_namesz = static_cast<elf32_word>(name_size);
+	header.n_descsz = static_cast<elf32_word>(size);
+	header.n_type   = type;
+
+	notes->append(reinterpret_cast<const char *>(&header), sizeof(header));
+	notes->append(name, static_cast<int>(name_size));
+	notes->append(QByteArray(static_cast<int>(note_align(name_size) - name_size), '\0'));
+	notes->append(static_cast<const char *>(desc), static_cast<int>(size));
+	notes->append(QByteArray(static_cast<int>(note_align(size) - size), '\0'));
+}
+
+/**
+ * @brief CoreWriter::addPrStatus
+ * @param tid
+ * @param regs the general purpose registers, as the kernel lays them out
+ * @param size
+ */
+void CoreWriter::addPrStatus(edb::tid_t tid, const void *regs, size_t size) {
+	const QByteArray status = is64Bit_ ? prstatus<elf_model<64>>(tid, regs, size) : prstatus<elf_model<32>>(tid, regs, size);
+	addNote(&threadNotes_, NtPrStatus, status.constData(), static_cast<size_t>(status.size()));
+}
+
+/**
+ * @brief CoreWriter::processNotes
+ * @return the notes which describe the process as a whole
+ */
+template <class Model>
+QByteArray CoreWriter::processNotes() const {
+	using Layout   = CoreLayout<Model>;
+	using elf_addr = typename Model::elf_addr;
+
+	QByteArray notes;
+
+	// the process is stopped, pr_state and pr_sname as the kernel would have
+	// them for TASK_STOPPED
+	QByteArray psinfo(static_cast<int>(Layout::PrPsInfoSize), '\0');
+	write_value(&psinfo, Layout::PrPsInfoState, int8_t(3));
+	write_value(&psinfo, Layout::PrPsInfoState + 1, 'T');
+	write_value(&psinfo, Layout::PrPsInfoUid, static_cast<typename Layout::uid_type>(process_->uid()));
+	write_value(&psinfo, Layout::PrPsInfoPid, static_cast<int32_t>(process_->pid()));
+
+	const QByteArray name = QFile::encodeName(process_->name()).left(PrPsInfoNameSize - 1);
+	std::memcpy(psinfo.data() + Layout::PrPsInfoName, name.constData(), static_cast<size_t>(name.size()));
+
+	QByteArray args;
+	for (const QByteArray &arg : process_->arguments()) {
+		if (!args.isEmpty()) {
+			args += ' ';
+		}
+		args += arg;
+	}
+
+	args = args.left(PrPsInfoArgsSize - 1);
+	std::memcpy(psinfo.data() + Layout::PrPsInfoArgs, args.constData(), static_cast<size_t>(args.size()));
+
+	addNote(&notes, NtPrPsInfo, psinfo.constData(), static_cast<size_t>(psinfo.size()));
+
+	// the auxiliary vector is taken as is from the kernel
+	QFile auxv(QString("/proc/%1/auxv").arg(process_->pid()));
+	if (auxv.open(QIODevice::ReadOnly)) {
+		const QByteArray data = auxv.readAll();
+		if (!data.isEmpty()) {
+			addNote(&notes, NtAuxv, data.constData(), static_cast<size_t>(data.size()));
+		}
+	}
+
+	// NT_FILE is a count and page size, followed by (start, end, page offset)
+	// for every mapped file, followed by their names
+	QByteArray entries;
+	QByteArray names;
+	elf_addr count = 0;
+
+	for (const Segment &segment : segments_) {
+		if (!segment.name.startsWith('/')) {
+			continue;
+		}
+
+		const elf_addr entry[3] = {
+			static_cast<elf_addr>(segment.start),
+			static_cast<elf_addr>(segment.end),
+			static_cast<elf_addr>(segment.fileOffset / pageSize_),
+		};
+
+		entries.append(reinterpret_cast<const char *>(entry), sizeof(entry));
+		names += QFile::encodeName(segment.name);
+		names += '\0';
+		++count;
+	}
+
+	if (count != 0) {
+		const elf_addr header[2] = {count, static_cast<elf_addr>(pageSize_)};
+
+		QByteArray file(reinterpret_cast<const char *>(header), sizeof(header));
+		file += entries;
+		file += names;
+		addNote(&notes, NtFile, file.constData(), static_cast<size_t>(file.size()));
+	}
+
+	return notes;
+}
+
+/**
+ * @brief CoreWriter::headers
+ *
+ * Lays out the file, the ELF header, the program headers and the notes come
+ * first, followed by the contents of the dumped segments, each starting on a
+ * page boundary.
+ *
+ * @param notes
+ * @param size receives the size of the whole file
+ * @return everything which precedes the contents of the segments
+ */
+template <class Model>
+QByteArray CoreWriter::headers(const QByteArray &notes, uint64_t *size) {
+	using elf_header = typename Model::elf_header;
+	using elf_phdr   = typename Model::elf_phdr;
+
+	const size_t phnum          = segments_.size() + 1;
+	const uint64_t notes_offset = sizeof(elf_header) + phnum * sizeof(elf_phdr);
+
+	uint64_t offset = (notes_offset + static_cast<uint64_t>(notes.size()) + pageSize_ - 1) / pageSize_ * pageSize_;
+	for (Segment &segment : segments_) {
+		segment.offset = offset;
+		if (segment.dump) {
+			offset += segment.end - segment.start;
+		}
+	}
+
+	*size = offset;
+
+	elf_header header = {};
+	std::memcpy(header.e_ident, ELFMAG, SELFMAG);
+	header.e_ident[EI_CLASS]   = elf_header::ELFCLASS;
+	header.e_ident[EI_DATA]    = ELFDATA2LSB;
+	header.e_ident[EI_VERSION] = EV_CURRENT;
+	header.e_ident[EI_OSABI]   = ELFOSABI_NONE;
+	header.e_type              = ET_CORE;
+	header.e_machine           = static_cast<decltype(header.e_machine)>(machine_);
+	header.e_version           = EV_CURRENT;
+	header.e_phoff             = sizeof(elf_header);
+	header.e_ehsize            = sizeof(elf_header);
+	header.e_phentsize         = sizeof(elf_phdr);
+	header.e_phnum             = static_cast<decltype(header.e_phnum)>(phnum);
+
+	QByteArray result(reinterpret_cast<const char *>(&header), sizeof(header));
+
+	elf_phdr note = {};
+	note.p_type   = PT_NOTE;
+	note.p_offset = notes_offset;
+	note.p_filesz = static_cast<uint64_t>(notes.size());
+	result.append(reinterpret_cast<const char *>(&note), sizeof(note));
+
+	for (const Segment &segment : segments_) {
+		elf_phdr phdr = {};
+		phdr.p_type   = PT_LOAD;
+		phdr.p_offset = segment.offset;
+		phdr.p_vaddr  = segment.start;
+		phdr.p_memsz  = segment.end - segment.start;
+		phdr.p_filesz = segment.dump ? phdr.p_memsz : 0;
+		phdr.p_align  = pageSize_;
+
+		if (segment.permissions & PROT_READ) phdr.p_flags |= PF_R;
+		if (segment.permissions & PROT_WRITE) phdr.p_flags |= PF_W;
+		if (segment.permissions & PROT_EXEC) phdr.p_flags |= PF_X;
+
+		result.append(reinterpret_cast<const char *>(&phdr), sizeof(phdr));
+	}
+
+	result += notes;
+	return result;
+}
+
+/**
+ * @brief CoreWriter::nextChunk
+ * @param chunk receives the next part of memory to be read
+ * @return false once everything has been handed out, or a reader failed
+ */
+bool CoreWriter::nextChunk(Chunk *chunk) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	while (error_ == 0 && nextSegment_ < segments_.size()) {
+		const Segment &segment = segments_[nextSegment_];
+		const uint64_t size    = segment.end - segment.start;
+
+		if (!segment.dump || nextOffset_ >= size) {
+			++nextSegment_;
+			nextOffset_ = 0;
+			continue;
+		}
+
+		chunk->address = segment.start + nextOffset_;
+		chunk->offset  = segment.offset + nextOffset_;
+		chunk->pages   = static_cast<size_t>(std::min<uint64_t>(ChunkSize, size - nextOffset_) / pageSize_);
+		nextOffset_ += chunk->pages * pageSize_;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief CoreWriter::readChunks
+ *
+ * Reads chunks of memory and writes them to where they belong in the file
+ * until there are none left. Several of these may run at once, the order in
+ * which the chunks are written doesn't matter.
+ *
+ * @param fd
+ */
+void CoreWriter::readChunks(int fd) {
+
+	std::vector<uint8_t> buffer(ChunkSize);
+
+	Chunk chunk;
+	while (nextChunk(&chunk)) {
+
+		// a page which can't be read is retried on its own, so that one bad
+		// page doesn't lose the rest of the chunk. If it still fails it stays
+		// zero, which is what a hole reads as
+		size_t i = 0;
+		while (i < chunk.pages) {
+			const size_t n = process_->readPages(chunk.address + i * pageSize_, &buffer[i * pageSize_], chunk.pages - i);
+			if (n == 0) {
+				std::memset(&buffer[i * pageSize_], 0, pageSize_);
+				++i;
+			} else {
+				i += n;
+			}
+		}
+
+		// only runs of pages which aren't all zeros are written, the rest
+		// are left as holes
+		size_t first = 0;
+		while (first < chunk.pages) {
+			if (is_zero(&buffer[first * pageSize_], pageSize_)) {
+				++first;
+				continue;
+			}
+
+			size_t last = first + 1;
+			while (last < chunk.pages && !is_zero(&buffer[last * pageSize_], pageSize_)) {
+				++last;
+			}
+
+			if (const int err = write_all(fd, &buffer[first * pageSize_], (last - first) * pageSize_, chunk.offset + first * pageSize_)) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (error_ == 0) {
+					error_ = err;
+				}
+				return;
+			}
+
+			first = last;
+		}
+	}
+}
+
+/**
+ * @brief CoreWriter::write
+ *
+ * Writes the core to <path>. The memory is read by <readers> threads at once,
+ * which is only safe if the process can be read from any thread.
+ *
+ * @param path
+ * @param readers
+ * @return
+ */
+Status CoreWriter::write(const QString &path, size_t readers) {
+
+	// NOTE(eteran): past this many segments the count has to be stored in the
+	// first section header instead, we don't support that
+	if (segments_.size() + 1 >= PN_XNUM) {
+		return Status(tr("The process has too many memory regions for a core file"));
+	}
+
+	uint64_t size = 0;
+	QByteArray notes;
+	QByteArray header;
+
+	if (is64Bit_) {
+		notes  = processNotes<elf_model<64>>() + threadNotes_;
+		header = headers<elf_model<64>>(notes, &size);
+	} else {
+		notes  = processNotes<elf_model<32>>() + threadNotes_;
+		header = headers<elf_model<32>>(notes, &size);
+	}
+
+	const QByteArray filename = QFile::encodeName(path);
+
+	const int fd = ::open(filename.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+	if (fd == -1) {
+		return Status(tr("Could not create %1: %2").arg(path, QString::fromLocal8Bit(std::strerror(errno))));
+	}
+
+	nextSegment_ = 0;
+	nextOffset_  = 0;
+	error_       = 0;
+
+	// sizing the file up front means that anything which is never written is
+	// a hole
+	int err = (::ftruncate64(fd, static_cast<off64_t>(size)) == -1) ? errno : 0;
+	if (err == 0) {
+		err = write_all(fd, header.constData(), static_cast<size_t>(header.size()), 0);
+	}
+
+	if (err == 0) {
+		std::vector<std::thread> workers;
+		for (size_t i = 1; i < readers; ++i) {
+			workers.emplace_back([this, fd]() { readChunks(fd); });
+		}
+
+		readChunks(fd);
+
+		for (std::thread &worker : workers) {
+			worker.join();
+		}
+
+		err = error_;
+	}
+
+	if (::close(fd) == -1 && err == 0) {
+		err = errno;
+	}
+
+	if (err != 0) {
+		::unlink(filename.constData());
+		return Status(tr("Could not write %1: %2").arg(path, QString::fromLocal8Bit(std::strerror(err))));
+	}
+
+	return Status::Ok;
+}
+
+}
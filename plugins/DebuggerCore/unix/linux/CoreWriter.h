@@ -0,0 +1,102 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CORE_WRITER_H_20261019_
+#define CORE_WRITER_H_20261019_
+
+#include "IRegion.h"
+#include "OSTypes.h"
+#include "Status.h"
+#include "Types.h"
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QString>
+#include <mutex>
+#include <vector>
+
+class IProcess;
+
+namespace DebuggerCorePlugin {
+
+class PlatformState;
+
+// Writes a stopped process out as an ELF core file, in the same format as the
+// kernel does. The memory is streamed straight to the file in fixed size
+// chunks, one buffer per reader, so no matter how big the process is the
+// memory used stays the same. Pages which are all zeros aren't written at
+// all, leaving holes in the file instead.
+class CoreWriter {
+	Q_DECLARE_TR_FUNCTIONS(CoreWriter)
+
+public:
+	CoreWriter(IProcess *process, bool is64Bit, int machine, size_t pageSize);
+	CoreWriter(const CoreWriter &)            = delete;
+	CoreWriter &operator=(const CoreWriter &) = delete;
+
+public:
+	void addThread(edb::tid_t tid, const PlatformState &state);
+	void addRegion(const IRegion &region, bool dump);
+	Status write(const QString &path, size_t readers);
+
+private:
+	struct Segment {
+		edb::address_t start;
+		edb::address_t end;
+		edb::address_t fileOffset; // of the mapped file, if there is one
+		QString name;
+		IRegion::permissions_t permissions;
+		bool dump;
+		uint64_t offset = 0; // in the core
+	};
+
+	struct Chunk {
+		edb::address_t address;
+		uint64_t offset;
+		size_t pages;
+	};
+
+private:
+	template <class Model>
+	QByteArray processNotes() const;
+
+	template <class Model>
+	QByteArray headers(const QByteArray &notes, uint64_t *size);
+
+	static void addNote(QByteArray *notes, uint32_t type, const void *desc, size_t size);
+	void addPrStatus(edb::tid_t tid, const void *regs, size_t size);
+	bool nextChunk(Chunk *chunk);
+	void readChunks(int fd);
+
+private:
+	IProcess *process_;
+	bool is64Bit_;
+	int machine_;
+	size_t pageSize_;
+	QByteArray threadNotes_;
+	std::vector<Segment> segments_;
+
+	// shared by the readers
+	std::mutex mutex_;
+	size_t nextSegment_  = 0;
+	uint64_t nextOffset_ = 0; // in the next segment
+	int error_           = 0;
+};
+
+}
+
+#endif
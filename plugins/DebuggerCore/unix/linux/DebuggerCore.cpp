@@ -18,6 +18,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "DebuggerCore.h"
 #include "Configuration.h"
+#include "CoreFile.h"
+#include "CoreProcess.h"
+#include "CoreWriter.h"
 #include "DialogMemoryAccess.h"
 #include "FeatureDetect.h"
 #include "MemoryRegions.h"
@@ -39,8 +42,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QDir>
 #include <QSettings>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
+#include <deque>
+#include <thread>
 
 #ifndef _GNU_SOURCE
 #define _GNU_SOURCE /* or _BSD_SOURCE or _SVID_SOURCE */
@@ -50,6 +56,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <cpuid.h>
 #endif
 
+#include <elf.h>
+#include <fcntl.h>
+#include <pwd.h>
+#include <unistd.h>
+
 #include <sys/mman.h>
 #include <sys/personality.h>
 #include <sys/ptrace.h>
@@ -66,10 +77,34 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define PTRACE_EVENT_CLONE 3
 #endif
 
+#ifndef PTRACE_SEIZE
+#define PTRACE_SEIZE static_cast<__ptrace_request>(0x4206)
+#endif
+
+#ifndef PTRACE_INTERRUPT
+#define PTRACE_INTERRUPT static_cast<__ptrace_request>(0x4207)
+#endif
+
+#ifndef PTRACE_LISTEN
+#define PTRACE_LISTEN static_cast<__ptrace_request>(0x4208)
+#endif
+
+#ifndef PTRACE_EVENT_EXEC
+#define PTRACE_EVENT_EXEC 4
+#endif
+
+#ifndef PTRACE_EVENT_STOP
+#define PTRACE_EVENT_STOP 128
+#endif
+
 #ifndef PTRACE_O_TRACECLONE
 #define PTRACE_O_TRACECLONE (1 << PTRACE_EVENT_CLONE)
 #endif
 
+#ifndef PTRACE_O_TRACEEXEC
+#define PTRACE_O_TRACEEXEC (1 << PTRACE_EVENT_EXEC)
+#endif
+
 #ifndef PTRACE_O_EXITKILL
 #define PTRACE_O_EXITKILL (1 << 20)
 #endif
@@ -124,6 +159,48 @@ constexpr bool is_exit_trace_event(int status) {
 	return (status >> 8 == (SIGTRAP | (PTRACE_EVENT_EXIT << 8)));
 }
 
+/**
+ * @brief is_exec_event
+ * @param status
+ * @return
+ */
+constexpr bool is_exec_event(int status) {
+	return (status >> 8 == (SIGTRAP | (PTRACE_EVENT_EXEC << 8)));
+}
+
+/**
+ * @brief is_stop_event
+ * @param status
+ * @return true if this is the stop of a seized thread which was interrupted,
+ * just created or put in a group-stop
+ */
+constexpr bool is_stop_event(int status) {
+	return (status >> 16) == PTRACE_EVENT_STOP;
+}
+
+/**
+ * @brief is_group_stop
+ * @param status
+ * @return true if this is the stop of a seized thread which was stopped by a
+ * stopping signal, such as the SIGTSTP of a shell's job control. Any other
+ * event stop reports SIGTRAP
+ */
+constexpr bool is_group_stop(int status) {
+	if (!is_stop_event(status)) {
+		return false;
+	}
+
+	switch ((status >> 8) & 0xff) {
+	case SIGSTOP:
+	case SIGTSTP:
+	case SIGTTIN:
+	case SIGTTOU:
+		return true;
+	default:
+		return false;
+	}
+}
+
 #if defined(EDB_X86) || defined(EDB_X86_64)
 /**
  * @brief in_64bit_segment
@@ -171,6 +248,102 @@ bool os_is_64_bit() {
 }
 #endif
 
+/**
+ * @brief user_name
+ * @param uid
+ * @return the name of the user with the given uid
+ */
+QString user_name(edb::uid_t uid) {
+
+	// NOTE(eteran): getpwuid may well go over the network, and there are
+	// usually only a handful of distinct users, so we remember the answers
+	static QHash<edb::uid_t, QString> names;
+
+	auto it = names.constFind(uid);
+	if (it != names.constEnd()) {
+		return *it;
+	}
+
+	QString name;
+	if (const struct passwd *const pwd = ::getpwuid(uid)) {
+		name = QString::fromLocal8Bit(pwd->pw_name);
+	}
+
+	names.insert(uid, name);
+	return name;
+}
+
+/**
+ * @brief read_process_info
+ *
+ * Reads everything we need to list a process from /proc/<pid>/status in a
+ * single read, without opening any other files of the process
+ *
+ * @param pid
+ * @param info
+ * @return
+ */
+bool read_process_info(edb::pid_t pid, ProcessInfo *info) {
+
+	char path[64];
+	snprintf(path, sizeof(path), "/proc/%d/status", pid);
+
+	const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
+		return false;
+	}
+
+	// Name and Uid are always among the first few lines
+	char buffer[1024];
+	const ssize_t n = ::read(fd, buffer, sizeof(buffer) - 1);
+	::close(fd);
+
+	if (n <= 0) {
+		return false;
+	}
+
+	buffer[n] = '\0';
+
+	bool have_name = false;
+	bool have_uid  = false;
+
+	char *line = buffer;
+	while (line && *line) {
+		char *next = std::strchr(line, '\n');
+		if (next) {
+			*next++ = '\0';
+		}
+
+		if (std::strncmp(line, "Name:", 5) == 0) {
+			const char *name = line + 5;
+			while (*name == ' ' || *name == '\t') {
+				++name;
+			}
+
+			info->name = QString::fromLocal8Bit(name);
+			have_name  = true;
+		} else if (std::strncmp(line, "Uid:", 4) == 0) {
+			// real, effective, saved and filesystem, we want the effective one
+			unsigned int real;
+			unsigned int effective;
+			if (sscanf(line + 4, "%u %u", &real, &effective) == 2) {
+				info->uid = effective;
+				have_uid  = true;
+			}
+		}
+
+		if (have_name && have_uid) {
+			info->pid  = pid;
+			info->user = user_name(info->uid);
+			return true;
+		}
+
+		line = next;
+	}
+
+	return false;
+}
+
 }
 
 /**
@@ -300,11 +473,18 @@ Status DebuggerCore::ptraceGetSigInfo(edb::tid_t tid, siginfo_t *siginfo) {
 }
 
 /**
- * @brief DebuggerCore::ptraceTraceme
+ * @brief DebuggerCore::ptraceInterrupt
+ * @param tid
  * @return
  */
-long DebuggerCore::ptraceTraceme() {
-	return ptrace(PTRACE_TRACEME, 0, 0, 0);
+Status DebuggerCore::ptraceInterrupt(edb::tid_t tid) {
+	Q_ASSERT(tid != 0);
+	if (ptrace(PTRACE_INTERRUPT, tid, 0, 0) == -1) {
+		const char *const strError = strerror(errno);
+		qWarning() << "Unable to interrupt thread" << tid << ": PTRACE_INTERRUPT failed:" << strError;
+		return Status(strError);
+	}
+	return Status::Ok;
 }
 
 /**
@@ -319,12 +499,31 @@ Status DebuggerCore::ptraceContinue(edb::tid_t tid, long status) {
 	//               in the first place if we aren't stopped on this TID :-(
 	if (util::contains(waitedThreads_, tid)) {
 		Q_ASSERT(tid != 0);
+
+		// a thread which was stopped by a stopping signal stays stopped, as it
+		// would without us, until something sends it a SIGCONT. It then
+		// reports an event stop, which lets it go for real
+		if (status == 0 && util::contains(groupStopped_, tid)) {
+			if (ptrace(PTRACE_LISTEN, tid, 0, 0) != -1) {
+				waitedThreads_.erase(tid);
+				steppingThreads_.erase(tid);
+				pendingEvents_.erase(tid);
+				return Status::Ok;
+			}
+
+			// it isn't in an event stop anymore, so the group-stop is over
+			groupStopped_.erase(tid);
+		}
+
 		if (ptrace(PTRACE_CONT, tid, 0, status) == -1) {
 			const char *const strError = strerror(errno);
 			qWarning() << "Unable to continue thread" << tid << ": PTRACE_CONT failed:" << strError;
 			return Status(strError);
 		}
 		waitedThreads_.erase(tid);
+		steppingThreads_.erase(tid);
+		pendingEvents_.erase(tid);
+		++resumeCount_;
 		return Status::Ok;
 	}
 	return Status(tr("ptrace_continue(): waited_threads_ doesn't contain tid %1").arg(tid));
@@ -348,25 +547,132 @@ Status DebuggerCore::ptraceStep(edb::tid_t tid, long status) {
 			return Status(strError);
 		}
 		waitedThreads_.erase(tid);
+		steppingThreads_.insert(tid);
+		groupStopped_.erase(tid);
+		pendingEvents_.erase(tid);
+		++resumeCount_;
 		return Status::Ok;
 	}
 	return Status(tr("ptrace_step(): waited_threads_ doesn't contain tid %1").arg(tid));
 }
 
 /**
- * @brief DebuggerCore::ptraceSetOptions
+ * @brief DebuggerCore::stepOverBreakpoint
+ *
+ * Steps the instruction under the breakpoint <tid> is stopped on out of line,
+ * see DisplacedStepping.
+ *
  * @param tid
- * @param options
+ * @param status
  * @return
  */
-Status DebuggerCore::ptraceSetOptions(edb::tid_t tid, long options) {
-	Q_ASSERT(util::contains(waitedThreads_, tid));
-	Q_ASSERT(tid != 0);
-	if (ptrace(PTRACE_SETOPTIONS, tid, 0, options) == -1) {
-		const char *const strError = strerror(errno);
-		qWarning() << "Unable to set ptrace options for thread" << tid << ": PTRACE_SETOPTIONS failed:" << strError;
-		return Status(strError);
+Status DebuggerCore::stepOverBreakpoint(edb::tid_t tid, edb::EventStatus status) {
+
+	auto it = threads_.find(tid);
+	if (it == threads_.end() || !util::contains(waitedThreads_, tid)) {
+		return Status(tr("stepOverBreakpoint(): thread %1 is not stopped").arg(tid));
+	}
+
+	// NOTE(eteran): a signal's handler would run with the instruction pointer
+	// in the scratch page, and then return there, so those are left to the
+	// usual way of stepping
+	const int code = (status == edb::DEBUG_EXCEPTION_NOT_HANDLED) ? resume_code(it.value()->status_) : 0;
+	if (code != 0) {
+		return Status(tr("A signal can't be delivered while stepping out of line"));
+	}
+
+	// NOTE(eteran): a fault on a watched page is stepped again from where the
+	// thread is, which for an out of line step would be onto the breakpoint
+	if (!pageWatchpoints_.watchpoints().empty()) {
+		return Status(tr("Breakpoints can't be stepped out of line while there are software watchpoints"));
+	}
+
+	mapScratch(tid);
+
+	if (Status prepared = displacedStepping_.prepare(process_.get(), tid, it.value()->instructionPointer()); !prepared) {
+		return prepared;
+	}
+
+	if (Status stepped = ptraceStep(tid, 0); !stepped) {
+		displacedStepping_.finish(process_.get(), tid);
+		return stepped;
+	}
+
+	return Status::Ok;
+}
+
+/**
+ * @brief DebuggerCore::runOverBreakpoint
+ *
+ * Like stepOverBreakpoint, but once the step is done the thread is continued
+ * without the end of the step being reported.
+ *
+ * @param tid
+ * @param status
+ * @return
+ */
+Status DebuggerCore::runOverBreakpoint(edb::tid_t tid, edb::EventStatus status) {
+
+	if (Status stepped = stepOverBreakpoint(tid, status); !stepped) {
+		return stepped;
+	}
+
+	runningOverBreakpoint_.insert(tid);
+	return Status::Ok;
+}
+
+/**
+ * @brief DebuggerCore::finishInterruptedSteps
+ *
+ * Moves every thread besides <tid> which was stopped in the middle of a step
+ * out of line back to the real code, so that it is neither seen nor resumed
+ * in the scratch page. A thread which didn't get to run the instruction yet
+ * is moved back onto its breakpoint, which it then runs into again once
+ * resumed.
+ *
+ * @param tid the thread which reported the event, its step was dealt with
+ * along with the event
+ */
+void DebuggerCore::finishInterruptedSteps(edb::tid_t tid) {
+
+	for (auto it = threads_.begin(); it != threads_.end(); ++it) {
+		const edb::tid_t other = it.key();
+		if (other == tid || !util::contains(waitedThreads_, other) || !displacedStepping_.isStepping(other)) {
+			continue;
+		}
+
+		displacedStepping_.finish(process_.get(), other);
+		runningOverBreakpoint_.erase(other);
+
+		// the end of the step may have been reported before the interrupt
+		// was, that trap was ours and mustn't be delivered on resume
+		const int other_status = it.value()->status_;
+		if (WIFSTOPPED(other_status) && (other_status >> 16) == 0 && WSTOPSIG(other_status) == SIGTRAP) {
+			it.value()->status_ = (PTRACE_EVENT_STOP << 16) | (SIGTRAP << 8) | 0x7f;
+		}
+	}
+}
+
+/**
+ * @brief DebuggerCore::pauseThread
+ *
+ * Asks <tid> to stop. Its stop is reported like a SIGSTOP, so that it looks
+ * the same as any other pause to the rest of edb.
+ *
+ * @param tid
+ * @return
+ */
+Status DebuggerCore::pauseThread(edb::tid_t tid) {
+
+	if (util::contains(waitedThreads_, tid)) {
+		return Status::Ok;
+	}
+
+	if (Status status = ptraceInterrupt(tid); !status) {
+		return status;
 	}
+
+	pauseRequested_.insert(tid);
 	return Status::Ok;
 }
 
@@ -395,8 +701,9 @@ Status DebuggerCore::ptraceGetEventMessage(edb::tid_t tid, unsigned long *messag
  */
 long DebuggerCore::ptraceOptions() const {
 
-	// we want to trace clone (thread) creation events
-	long options = PTRACE_O_TRACECLONE;
+	// we want to trace clone (thread) creation events, and execs, which a
+	// seized thread doesn't report otherwise
+	long options = PTRACE_O_TRACECLONE | PTRACE_O_TRACEEXEC;
 
 	// if applicable, we want an auto SIGKILL sent to the child
 	// process and its threads
@@ -431,6 +738,10 @@ void DebuggerCore::handleThreadExit(edb::tid_t tid, int status) {
 
 	threads_.remove(tid);
 	waitedThreads_.erase(tid);
+	steppingThreads_.erase(tid);
+	displacedStepping_.remove(tid);
+	runningOverBreakpoint_.erase(tid);
+	pendingEvents_.erase(tid);
 }
 
 /**
@@ -465,21 +776,17 @@ std::shared_ptr<IDebugEvent> DebuggerCore::handleThreadCreate(edb::tid_t tid, in
 			return nullptr;
 		}
 
-		if (!WIFSTOPPED(thread_status) || WSTOPSIG(thread_status) != SIGSTOP) {
-			qWarning("handle_event(): new thread [%d] received an event besides SIGSTOP: status=0x%x", static_cast<int>(new_tid), thread_status);
+		// threads of a seized process start with an event stop
+		if (!WIFSTOPPED(thread_status) || !is_stop_event(thread_status)) {
+			qWarning("handle_event(): new thread [%d] received an event besides the initial stop: status=0x%x", static_cast<int>(new_tid), thread_status);
 		}
 
 		new_thread->status_ = thread_status;
 
-		// copy the hardware debug registers from the current thread to the new thread
-		if (process_) {
-			if (auto cur_thread = process_->currentThread()) {
-				auto old_thread = std::static_pointer_cast<PlatformThread>(cur_thread);
-				for (size_t i = 0; i < 8; ++i) {
-					new_thread->setDebugRegister(i, old_thread->getDebugRegister(i));
-				}
-			}
-		}
+#if defined(EDB_X86) || defined(EDB_X86_64)
+		// give the new thread the process wide hardware breakpoints
+		new_thread->initDebugRegisters(debugRegisterTemplate_);
+#endif
 
 		new_thread->resume();
 	}
@@ -488,6 +795,60 @@ std::shared_ptr<IDebugEvent> DebuggerCore::handleThreadCreate(edb::tid_t tid, in
 	return nullptr;
 }
 
+/**
+ * @brief DebuggerCore::handleExec
+ *
+ * A thread ran execve. By the time it reports so, every other thread is gone
+ * and it has taken over the pid, along with a new address space which has
+ * neither our scratch page nor the protection of any watched page.
+ *
+ * @param tid
+ * @param status
+ */
+void DebuggerCore::handleExec(edb::tid_t tid, int status) {
+
+	const edb::pid_t pid = process_->pid();
+
+	for (auto it = threads_.begin(); it != threads_.end(); ++it) {
+		const edb::tid_t other = it.key();
+		if (other != tid && other != pid) {
+			// their exits are usually reported first, but they may not have
+			// been waited for yet
+			Posix::waitpid(other, nullptr, __WALL | WNOHANG);
+		}
+
+#if defined(EDB_X86) || defined(EDB_X86_64)
+		// the exec cleared the debug registers, which whoever still holds on
+		// to one of these must not be told otherwise
+		it.value()->invalidateDebugRegisters();
+#endif
+	}
+
+	threads_.clear();
+	waitedThreads_.clear();
+	steppingThreads_.clear();
+	groupStopped_.clear();
+	pauseRequested_.clear();
+	runningOverBreakpoint_.clear();
+	pendingEvents_.clear();
+	displacedStepping_.reset();
+	pageWatchpoints_.reset();
+
+	auto thread     = std::make_shared<PlatformThread>(this, process_, pid);
+	thread->status_ = status;
+
+	threads_.insert(pid, thread);
+	waitedThreads_.insert(pid);
+
+#if defined(EDB_X86) || defined(EDB_X86_64)
+	// the debug registers are cleared by the exec as well
+	debugRegisterTemplate_.fill(0);
+#endif
+
+	activeThread_ = pid;
+	detectCpuMode();
+}
+
 /**
  * @brief DebuggerCore::handleEvent
  * @param tid
@@ -496,8 +857,18 @@ std::shared_ptr<IDebugEvent> DebuggerCore::handleThreadCreate(edb::tid_t tid, in
  */
 std::shared_ptr<IDebugEvent> DebuggerCore::handleEvent(edb::tid_t tid, int status) {
 
+	// a SIGCONT ends the group-stop of every thread
+	if (WIFSTOPPED(status) && WSTOPSIG(status) == SIGCONT && (status >> 16) == 0) {
+		groupStopped_.clear();
+	}
+
+	if (passSignal(tid, status)) {
+		return nullptr;
+	}
+
 	// note that we have waited on this thread
 	waitedThreads_.insert(tid);
+	const bool was_stepping = steppingThreads_.erase(tid) != 0;
 
 	// was it a thread exit event?
 	if (WIFEXITED(status)) {
@@ -520,6 +891,45 @@ std::shared_ptr<IDebugEvent> DebuggerCore::handleEvent(edb::tid_t tid, int statu
 		return handleThreadCreate(tid, status);
 	}
 
+	if (is_exec_event(status)) {
+		handleExec(tid, status);
+	}
+
+	if (is_stop_event(status)) {
+		if (pauseRequested_.erase(tid)) {
+			// the stop which pauseThread asked for, which is reported like the
+			// SIGSTOP the rest of edb knows a pause by. It is still an event
+			// stop though, so no signal gets delivered when it is resumed
+			if (is_group_stop(status)) {
+				groupStopped_.insert(tid);
+			}
+
+			status = (PTRACE_EVENT_STOP << 16) | (SIGSTOP << 8) | 0x7f;
+		} else if (is_group_stop(status)) {
+			// stopped by a stopping signal, such as the SIGTSTP of a shell's
+			// job control. The thread is left in that stop, as it would be
+			// without us, and reports an event stop once it is continued
+			groupStopped_.insert(tid);
+			ptraceContinue(tid, 0);
+			if (was_stepping) {
+				steppingThreads_.insert(tid);
+			}
+			return nullptr;
+		} else {
+			// a stop which we asked for while attaching or stopping the
+			// threads, but which was overtaken by another event, or the end
+			// of a group-stop. There is nothing here for the user to see, the
+			// thread just carries on with what it was resumed for
+			groupStopped_.erase(tid);
+			if (was_stepping) {
+				ptraceStep(tid, 0);
+			} else {
+				ptraceContinue(tid, 0);
+			}
+			return nullptr;
+		}
+	}
+
 	// normal event
 	auto e = std::make_shared<PlatformEvent>();
 
@@ -530,15 +940,130 @@ std::shared_ptr<IDebugEvent> DebuggerCore::handleEvent(edb::tid_t tid, int statu
 		// TODO: handle no info?
 	}
 
-	// if necessary, just ignore this event
-	if (util::contains(ignoredExceptions_, e->code())) {
-		ptraceContinue(tid, resume_code(status));
+	if (is_stop_event(status)) {
+		e->siginfo_.si_signo = SIGSTOP;
+		e->siginfo_.si_code  = SI_USER;
+		e->siginfo_.si_pid   = getpid();
+	}
+
+	// a thread which was stepping an instruction out of line is moved back to
+	// where the instruction would have left it before anything looks at it.
+	// A signal which arrives in the meantime, rather than being caused by
+	// the instruction, is set aside until the step is done. Its handler would
+	// otherwise run with the instruction pointer in the scratch page
+	if (WIFSTOPPED(status) && displacedStepping_.isStepping(tid)) {
+		switch (WSTOPSIG(status)) {
+		case SIGTRAP:
+			displacedStepping_.finish(process_.get(), tid);
+
+			// the end of a step off of a breakpoint while running, unless the
+			// instruction also hit a hardware breakpoint, there is nothing
+			// here to stop for
+			if (runningOverBreakpoint_.erase(tid) && e->siginfo_.si_code == TRAP_TRACE) {
+#if defined(EDB_X86) || defined(EDB_X86_64)
+				auto it = threads_.find(tid);
+				if (it != threads_.end() && (it.value()->getDebugRegister(6) & 0x0f) != 0) {
+					break;
+				}
+#endif
+				ptraceContinue(tid, 0);
+				return nullptr;
+			}
+			break;
+		case SIGSEGV:
+		case SIGBUS:
+		case SIGILL:
+		case SIGFPE:
+			displacedStepping_.finish(process_.get(), tid);
+			runningOverBreakpoint_.erase(tid);
+			break;
+		default:
+			if ((status >> 16) == 0) {
+				displacedStepping_.defer(tid, WSTOPSIG(status));
+				ptraceStep(tid, 0);
+				return nullptr;
+			}
+
+			displacedStepping_.finish(process_.get(), tid);
+			runningOverBreakpoint_.erase(tid);
+			break;
+		}
+	}
+
+	// faults on pages which were protected for a watchpoint are dealt with
+	// before the event is reported, most of them will be accesses to the
+	// parts of the page which aren't watched
+	if (WIFSTOPPED(status) && WSTOPSIG(status) == SIGSEGV) {
+		const auto address = edb::address_t::fromZeroExtended(e->siginfo_.si_addr);
+		if (pageWatchpoints_.isWatchedPage(address)) {
+			int new_status = 0;
+			Watchpoint watchpoint;
+
+			// the page is unprotected while the access is stepped, so nothing
+			// else may run meanwhile or its accesses would go unnoticed
+			const std::vector<edb::tid_t> stopped = stopOtherThreads();
+
+			const PageWatchpoints::Fault fault = pageWatchpoints_.handleFault(process_.get(), tid, address, &new_status, &watchpoint);
+			if (fault != PageWatchpoints::Fault::NotWatched) {
+				// the thread ran, so any cached register state is stale
+				++resumeCount_;
+			}
+
+			// in all-stop mode, an event which is reported keeps them stopped
+			if (nonStop_ || fault == PageWatchpoints::Fault::Missed) {
+				resumeStoppedThreads(stopped);
+			}
+
+			switch (fault) {
+			case PageWatchpoints::Fault::Missed:
+				if (!nonStop_ && !pendingEvents_.empty()) {
+					// one of the others stopped for something to report, this
+					// thread stays stopped along with it, past the access
+					if (auto it = threads_.find(tid); it != threads_.end()) {
+						it.value()->status_ = (PTRACE_EVENT_STOP << 16) | (SIGTRAP << 8) | 0x7f;
+					}
+
+					activeThread_ = *pendingEvents_.begin();
+					return handlePendingEvent();
+				}
+
+				ptraceContinue(tid, 0);
+				return nullptr;
+			case PageWatchpoints::Fault::Interrupted:
+				if (new_status == -1) {
+					return nullptr;
+				}
+				return handleEvent(tid, new_status);
+			case PageWatchpoints::Fault::Triggered:
+				qDebug() << "Watchpoint at" << watchpoint.address.toHexString() << "triggered by an access to" << address.toHexString();
+				// the thread is stopped just after the access, so report it
+				// like the end of a step rather than a breakpoint
+				status               = SIGTRAP << 8 | 0x7f;
+				e->status_           = status;
+				e->siginfo_.si_signo = SIGTRAP;
+				e->siginfo_.si_code  = TRAP_TRACE;
+				break;
+			case PageWatchpoints::Fault::NotWatched:
+				break;
+			}
+		}
+	}
+
+	// if necessary, just pass the signal along. A thread which was stepping
+	// keeps doing so, the step then ends in the signal's handler
+	if (WIFSTOPPED(status) && (status >> 16) == 0 && signalDisposition(WSTOPSIG(status)) != ExceptionDisposition::Stop) {
+		notePassedSignal(tid, WSTOPSIG(status));
+		if (was_stepping) {
+			ptraceStep(tid, resume_code(status));
+		} else {
+			ptraceContinue(tid, resume_code(status));
+		}
 		return nullptr;
 	}
 
 	/* NOTE(eteran): OK, so when we get an event, we generally want to stop
 	 * any other threads as well. So we will call stopThreads() below
-	 * which sends a SIGSTOP.
+	 * which interrupts them.
 	 *
 	 * We need to be very careful to avoid those future events causing the
 	 * active thread to be set, because we want it to remain set to the thread
@@ -547,8 +1072,11 @@ std::shared_ptr<IDebugEvent> DebuggerCore::handleEvent(edb::tid_t tid, int statu
 	 * get signaled, and the rest get resumed properly.
 	 *
 	 * To do this, we simply only alter the activeThread_ variable if this
-	 * event was the first we saw after a resume/run (phew!).*/
-	if (waitedThreads_.size() == 1) {
+	 * event was the first we saw after a resume/run (phew!).
+	 *
+	 * In non-stop mode, the other threads are left running, so every event
+	 * is the first one for its thread. */
+	if (waitedThreads_.size() == 1 || nonStop_) {
 		activeThread_ = tid;
 	}
 
@@ -557,7 +1085,16 @@ std::shared_ptr<IDebugEvent> DebuggerCore::handleEvent(edb::tid_t tid, int statu
 		it.value()->status_ = status;
 	}
 
-	stopThreads();
+	// the process stops for this event anyway, which is all a pause asked for
+	// meanwhile wants. If its interrupt is still pending, the stop it causes
+	// later on is continued silently
+	if (!nonStop_) {
+		stopThreads();
+		finishInterruptedSteps(tid);
+		pauseRequested_.clear();
+	} else {
+		pauseRequested_.erase(tid);
+	}
 
 	// Some breakpoint types result in SIGILL or SIGSEGV. We'll transform the
 	// event into breakpoint event if such a breakpoint has triggered.
@@ -594,40 +1131,59 @@ std::shared_ptr<IDebugEvent> DebuggerCore::handleEvent(edb::tid_t tid, int statu
 
 /**
  * @brief DebuggerCore::stopThreads
+ *
+ * Stops every thread which isn't stopped yet. Every thread is seized, so they
+ * are all asked to stop with PTRACE_INTERRUPT first and then waited for, which
+ * lets them stop in parallel.
+ *
  * @return
  */
 Status DebuggerCore::stopThreads() {
 
 	QString errorMessage;
 
-	if (process_) {
+	if (process_ && !coreFile_) {
+		std::vector<std::shared_ptr<PlatformThread>> stopping;
+
 		for (auto &thread : process_->threads()) {
 			const edb::tid_t tid = thread->tid();
 
 			if (!util::contains(waitedThreads_, tid)) {
-
 				if (auto thread_ptr = std::static_pointer_cast<PlatformThread>(thread)) {
-
-					if (syscall(SYS_tgkill, process_->pid(), thread->tid(), SIGSTOP) == -1) {
+					if (ptrace(PTRACE_INTERRUPT, tid, 0, 0) == -1) {
 						const char *const error = strerror(errno);
 						errorMessage += tr("Failed to stop thread %1: %2\n").arg(tid).arg(error);
+						continue;
 					}
 
-					int thread_status;
-					if (Posix::waitpid(thread->tid(), &thread_status, __WALL /* | WNOHANG*/) > 0) {
-						waitedThreads_.insert(tid);
-						thread_ptr->status_ = thread_status;
+					stopping.push_back(thread_ptr);
+				}
+			}
+		}
+
+		for (const std::shared_ptr<PlatformThread> &thread_ptr : stopping) {
+			const edb::tid_t tid = thread_ptr->tid();
 
-						// A thread could have exited between previous waitpid and the latest one...
-						if (WIFEXITED(thread_status)) {
-							handleThreadExit(tid, thread_status);
-						}
+			int thread_status;
+			if (Posix::waitpid(tid, &thread_status, __WALL) > 0) {
+				waitedThreads_.insert(tid);
+				thread_ptr->status_ = thread_status;
 
-						// ..., otherwise it must have stopped.
-						else if (!WIFSTOPPED(thread_status) || WSTOPSIG(thread_status) != SIGSTOP) {
-							qWarning("stop_threads(): paused thread [%d] received an event besides SIGSTOP: status=0x%x", tid, thread_status);
-						}
-					}
+				// A thread could have exited between previous waitpid and the latest one...
+				if (WIFEXITED(thread_status)) {
+					handleThreadExit(tid, thread_status);
+				}
+
+				// ..., or be in a group-stop, which it is put back into when resumed
+				else if (is_group_stop(thread_status)) {
+					groupStopped_.insert(tid);
+				}
+
+				// ..., otherwise it must have stopped. If it was for another
+				// event, the interrupt is still pending and stops it again once
+				// it is resumed, that stop is then continued silently
+				else if (!WIFSTOPPED(thread_status) || !is_stop_event(thread_status)) {
+					qWarning("stop_threads(): paused thread [%d] received an event besides the interrupt: status=0x%x", tid, thread_status);
 				}
 			}
 		}
@@ -642,22 +1198,98 @@ Status DebuggerCore::stopThreads() {
 }
 
 /**
- * waits for a debug event, witha timeout specified in milliseconds
+ * @brief DebuggerCore::stopOtherThreads
  *
- * @brief DebuggerCore::waitDebugEvent
- * @param msecs
- * @return nullptr if an error or timeout occurs
+ * Stops every thread which is running, for something which has to be done
+ * while none of them can run, see resumeStoppedThreads.
+ *
+ * @return the threads which were stopped
  */
-std::shared_ptr<IDebugEvent> DebuggerCore::waitDebugEvent(std::chrono::milliseconds msecs) {
+std::vector<edb::tid_t> DebuggerCore::stopOtherThreads() {
 
-	if (process_) {
-		if (!Posix::wait_for_sigchld(msecs)) {
-			for (auto &thread : process_->threads()) {
-				int status;
-				const edb::tid_t tid = Posix::waitpid(thread->tid(), &status, __WALL | WNOHANG);
-				if (tid > 0) {
-					return handleEvent(tid, status);
-				}
+	const std::set<edb::tid_t> waited = waitedThreads_;
+	stopThreads();
+
+	std::vector<edb::tid_t> stopped;
+	for (edb::tid_t tid : waitedThreads_) {
+		if (!util::contains(waited, tid) && threads_.contains(tid)) {
+			stopped.push_back(tid);
+		}
+	}
+
+	return stopped;
+}
+
+/**
+ * @brief DebuggerCore::resumeStoppedThreads
+ *
+ * Lets the threads which stopOtherThreads stopped carry on as if they never
+ * had been. One which stopped for an event of its own instead, or whose stop
+ * was asked for by a pause, stays stopped, and the event is reported by the
+ * next call to waitDebugEvent.
+ *
+ * @param tids
+ */
+void DebuggerCore::resumeStoppedThreads(const std::vector<edb::tid_t> &tids) {
+
+	for (edb::tid_t tid : tids) {
+		auto it = threads_.find(tid);
+		if (it == threads_.end() || !util::contains(waitedThreads_, tid)) {
+			continue;
+		}
+
+		if (!is_stop_event(it.value()->status_) || util::contains(pauseRequested_, tid)) {
+			pendingEvents_.insert(tid);
+		} else if (util::contains(steppingThreads_, tid)) {
+			ptraceStep(tid, 0);
+		} else {
+			ptraceContinue(tid, 0);
+		}
+	}
+}
+
+/**
+ * @brief DebuggerCore::handlePendingEvent
+ * @return the event of a thread which was left stopped by
+ * resumeStoppedThreads, or nullptr if there is none
+ */
+std::shared_ptr<IDebugEvent> DebuggerCore::handlePendingEvent() {
+
+	while (!pendingEvents_.empty()) {
+		const edb::tid_t tid = *pendingEvents_.begin();
+		pendingEvents_.erase(pendingEvents_.begin());
+
+		auto it = threads_.find(tid);
+		if (it != threads_.end() && util::contains(waitedThreads_, tid)) {
+			return handleEvent(tid, it.value()->status_);
+		}
+	}
+
+	return nullptr;
+}
+
+/**
+ * waits for a debug event, witha timeout specified in milliseconds
+ *
+ * @brief DebuggerCore::waitDebugEvent
+ * @param msecs
+ * @return nullptr if an error or timeout occurs
+ */
+std::shared_ptr<IDebugEvent> DebuggerCore::waitDebugEvent(std::chrono::milliseconds msecs) {
+
+	// the process of a core file is long gone, there is nothing to wait for
+	if (process_ && !coreFile_) {
+		if (std::shared_ptr<IDebugEvent> e = handlePendingEvent()) {
+			return e;
+		}
+
+		if (!Posix::wait_for_sigchld(msecs)) {
+			for (auto &thread : process_->threads()) {
+				int status;
+				const edb::tid_t tid = Posix::waitpid(thread->tid(), &status, __WALL | WNOHANG);
+				if (tid > 0) {
+					return handleEvent(tid, status);
+				}
 			}
 		}
 	}
@@ -665,42 +1297,155 @@ std::shared_ptr<IDebugEvent> DebuggerCore::waitDebugEvent(std::chrono::milliseco
 }
 
 /**
- * @brief DebuggerCore::attachThread
- * @param tid
- * @return 0 if successful, errno if failed
+ * @brief DebuggerCore::seizeThreads
+ *
+ * Seizes every thread of <pid> which we don't have yet, with our options set
+ * from the start, and asks each of them to stop. Unlike PTRACE_ATTACH, this
+ * doesn't send a SIGSTOP, and threads created by a seized thread from now on
+ * are seized along with it and reported through clone events.
+ *
+ * @param pid
+ * @param options
+ * @param lastErr set to the errno of the last thread which couldn't be seized
+ * @return the threads which were seized
+ */
+std::vector<edb::tid_t> DebuggerCore::seizeThreads(edb::pid_t pid, long options, int *lastErr) {
+
+	std::vector<edb::tid_t> seized;
+
+	const QStringList tasks = QDir(QString("/proc/%1/task/").arg(pid)).entryList(QDir::NoDotAndDotDot | QDir::Dirs);
+	for (const QString &s : tasks) {
+		const edb::tid_t tid = s.toInt();
+		if (threads_.contains(tid)) {
+			continue;
+		}
+
+		// NOTE(eteran): a thread created by a seized thread since we listed
+		// the tasks is already ours, which makes this fail with EPERM. The
+		// clone event brings it in instead
+		if (ptrace(PTRACE_SEIZE, tid, 0, options) == -1) {
+			*lastErr = errno;
+			continue;
+		}
+
+		seized.push_back(tid);
+	}
+
+	// first ask all of them to stop, then wait for them, so that they all
+	// stop in parallel. One which can't be asked has just exited, there is
+	// nothing to wait for then
+	std::vector<edb::tid_t> interrupted;
+	interrupted.reserve(seized.size());
+
+	for (edb::tid_t tid : seized) {
+		if (!ptraceInterrupt(tid)) {
+			continue;
+		}
+
+		interrupted.push_back(tid);
+	}
+
+	return interrupted;
+}
+
+/**
+ * @brief DebuggerCore::reapSeizedThreads
+ *
+ * Waits for the interrupt stop of each of <tids>. A thread which stops for
+ * anything else first is let go again, the pending interrupt then stops it
+ * right after. Threads which they create meanwhile are waited for as well.
+ *
+ * @param tids
  */
-int DebuggerCore::attachThread(edb::tid_t tid) {
+void DebuggerCore::reapSeizedThreads(const std::vector<edb::tid_t> &tids) {
+
+	std::deque<edb::tid_t> pending(tids.begin(), tids.end());
+
+	while (!pending.empty()) {
+		const edb::tid_t tid = pending.front();
+		pending.pop_front();
 
-	if (ptrace(PTRACE_ATTACH, tid, 0, 0) == 0) {
+		if (threads_.contains(tid)) {
+			continue;
+		}
 
 		int status;
-		const int ret = Posix::waitpid(tid, &status, __WALL);
-		if (ret > 0) {
+		if (Posix::waitpid(tid, &status, __WALL) == -1) {
+			continue;
+		}
 
+		if (!WIFSTOPPED(status)) {
+			// it exited before it stopped
+			continue;
+		}
+
+		if (is_stop_event(status)) {
 			auto newThread     = std::make_shared<PlatformThread>(this, process_, tid);
 			newThread->status_ = status;
 
 			threads_.insert(tid, newThread);
 			waitedThreads_.insert(tid);
 
-			const long options = ptraceOptions();
+			// a process which was stopped before we came along stays so
+			if (is_group_stop(status)) {
+				groupStopped_.insert(tid);
+			}
+			continue;
+		}
 
-			const auto setoptStatus = ptraceSetOptions(tid, options);
-			if (!setoptStatus) {
-				qDebug() << "[DebuggerCore] failed to set ptrace options: [" << tid << "]" << setoptStatus.error();
+		if (is_clone_event(status)) {
+			// the new thread was seized along with its parent and reports an
+			// event stop of its own
+			unsigned long message;
+			if (ptraceGetEventMessage(tid, &message)) {
+				pending.push_back(static_cast<edb::tid_t>(message));
 			}
 
-			return 0;
-		} else if (ret == -1) {
-			return errno;
+			ptrace(PTRACE_CONT, tid, 0, 0);
 		} else {
-			return -1; // unknown error
+			// a signal which beat the interrupt, it gets delivered as usual
+			ptrace(PTRACE_CONT, tid, 0, resume_code(status));
 		}
-	} else {
-		return errno;
+
+		pending.push_back(tid);
 	}
 }
 
+/**
+ * @brief DebuggerCore::mapScratch
+ *
+ * Maps the scratch page for stepping out of line, if it isn't yet. The
+ * system calls which protect watched pages are run from it as well. Its mmap
+ * system call has to be run from the code <tid> is stopped in, so this does
+ * nothing unless every thread is stopped.
+ *
+ * @param tid a stopped thread
+ */
+void DebuggerCore::mapScratch(edb::tid_t tid) {
+
+	if (displacedStepping_.syscallAddress() != 0) {
+		return;
+	}
+
+	for (auto it = threads_.begin(); it != threads_.end(); ++it) {
+		if (!util::contains(waitedThreads_, it.key())) {
+			return;
+		}
+	}
+
+	auto it = threads_.find(tid);
+	if (it == threads_.end()) {
+		return;
+	}
+
+	if (Status status = displacedStepping_.mapScratch(process_.get(), tid, it.value()->instructionPointer()); !status) {
+		qWarning() << "Unable to map the scratch page:" << status.error();
+		return;
+	}
+
+	pageWatchpoints_.setSyscallAddress(displacedStepping_.syscallAddress());
+}
+
 /**
  * @brief DebuggerCore::attach
  * @param pid
@@ -714,42 +1459,48 @@ Status DebuggerCore::attach(edb::pid_t pid) {
 
 	// create this, so the threads created can refer to it
 	process_ = std::make_shared<PlatformProcess>(this, pid);
+	nonStop_ = edb::v1::config().nonstop_mode;
+
+	const long options = ptraceOptions();
 
-	int lastErr = attachThread(pid); // Fail early if we are going to
-	if (lastErr) {
+	// Fail early if we are going to
+	if (ptrace(PTRACE_SEIZE, pid, 0, options) == -1) {
+		const int err = errno;
+		process_      = nullptr;
+		return Status(std::strerror(err));
+	}
+
+	// NOTE(eteran): this only fails if the process is already gone
+	if (Status status = ptraceInterrupt(pid); !status) {
 		process_ = nullptr;
-		return Status(std::strerror(lastErr));
-	}
-
-	lastErr = -2;
-	bool attached;
-	do {
-		attached = false;
-		QDir proc_directory(QString("/proc/%1/task/").arg(pid));
-		for (const QString &s : proc_directory.entryList(QDir::NoDotAndDotDot | QDir::Dirs)) {
-			// this can get tricky if the threads decide to spawn new threads
-			// when we are attaching. I wish that linux had an atomic way to do this
-			// all in one shot
-			const edb::tid_t tid = s.toInt();
-			if (!threads_.contains(tid)) {
-				const auto errnum = attachThread(tid);
-				if (errnum == 0) {
-					attached = true;
-				} else {
-					lastErr = errnum;
-				}
-			}
+		return status;
+	}
+
+	reapSeizedThreads({pid});
+
+	// NOTE(eteran): a thread which wasn't seized yet can still create threads
+	// that we never hear about. Once everything we have is stopped, that can
+	// only be the threads of the previous sweep, so this settles quickly,
+	// usually the second sweep finds nothing
+	int lastErr = 0;
+	for (;;) {
+		const std::vector<edb::tid_t> seized = seizeThreads(pid, options, &lastErr);
+		if (seized.empty()) {
+			break;
 		}
-	} while (attached);
+
+		reapSeizedThreads(seized);
+	}
 
 	if (!threads_.empty()) {
 		activeThread_ = pid;
 		detectCpuMode();
+		mapScratch(pid);
 		return Status::Ok;
 	}
 
 	process_ = nullptr;
-	return Status(std::strerror(lastErr));
+	return Status(std::strerror(lastErr ? lastErr : ESRCH));
 }
 
 /**
@@ -758,12 +1509,25 @@ Status DebuggerCore::attach(edb::pid_t pid) {
  */
 Status DebuggerCore::detach() {
 
+	if (coreFile_) {
+		coreFile_ = nullptr;
+		process_  = nullptr;
+		reset();
+		return Status::Ok;
+	}
+
 	QString errorMessage;
 
 	if (process_) {
 		stopThreads();
+		displacedStepping_.finishAll(process_.get());
 		clearBreakpoints();
 
+		// put back the original protection of any watched pages
+		if (!waitedThreads_.empty()) {
+			pageWatchpoints_.clear(process_.get(), *waitedThreads_.begin());
+		}
+
 		for (auto &thread : process_->threads()) {
 			if (ptrace(PTRACE_DETACH, thread->tid(), 0, 0) == -1) {
 				const char *const error = strerror(errno);
@@ -787,6 +1551,11 @@ Status DebuggerCore::detach() {
  * @brief DebuggerCore::kill
  */
 void DebuggerCore::kill() {
+	if (coreFile_) {
+		detach();
+		return;
+	}
+
 	if (attached()) {
 		clearBreakpoints();
 
@@ -880,12 +1649,24 @@ Status DebuggerCore::open(const QString &path, const QString &cwd, const QList<Q
 
 	std::memset(ptr, 0, SharedMemSize);
 
+	// the child waits on this until we have seized it
+	int seizePipe[2];
+	if (::pipe2(seizePipe, O_CLOEXEC) == -1) {
+		const int err = errno;
+		::munmap(sharedMem, SharedMemSize);
+		return Status(tr("Failed to create a pipe: %1").arg(std::strerror(err)));
+	}
+
 	switch (pid_t pid = fork()) {
 	case 0: {
 		// we are in the child now...
 
-		// set ourselves (the child proc) up to be traced
-		ptraceTraceme();
+		// wait until we are seized, the exec then stops us with an event
+		::close(seizePipe[1]);
+
+		char seized;
+		while (::read(seizePipe[0], &seized, 1) == -1 && errno == EINTR) {
+		}
 
 		// redirect it's I/O
 		FILE *std_in  = nullptr;
@@ -927,6 +1708,9 @@ Status DebuggerCore::open(const QString &path, const QString &cwd, const QList<Q
 	}
 	case -1:
 		// error! for some reason we couldn't fork
+		::close(seizePipe[0]);
+		::close(seizePipe[1]);
+		::munmap(sharedMem, SharedMemSize);
 		reset();
 		return Status(tr("Failed to fork"));
 	default:
@@ -934,6 +1718,29 @@ Status DebuggerCore::open(const QString &path, const QString &cwd, const QList<Q
 		{
 			reset();
 
+			::close(seizePipe[0]);
+
+			// NOTE(eteran): like an attached process, the child is seized rather
+			// than traced with PTRACE_TRACEME. That way its threads can be
+			// interrupted, rather than sent a SIGSTOP, and it has our options
+			// before it runs a single instruction of the new program
+			const long options = ptraceOptions();
+
+			if (ptrace(PTRACE_SEIZE, pid, 0, options) == -1) {
+				const int err = errno;
+				::close(seizePipe[1]);
+				::kill(pid, SIGKILL);
+				Posix::waitpid(pid, nullptr, __WALL);
+				::munmap(sharedMem, SharedMemSize);
+				return Status(tr("[DebuggerCore] failed to seize the child: %1").arg(std::strerror(err)));
+			}
+
+			const char seized = 0;
+			while (::write(seizePipe[1], &seized, 1) == -1 && errno == EINTR) {
+			}
+
+			::close(seizePipe[1]);
+
 			int status;
 			const auto wpidRet = Posix::waitpid(pid, &status, __WALL);
 			const QString childError(sharedMem);
@@ -956,27 +1763,20 @@ Status DebuggerCore::open(const QString &path, const QString &cwd, const QList<Q
 				return Status(childError.isEmpty() ? tr("The child unexpectedly aborted") : childError);
 			}
 
-			// the very first event should be a STOP of type SIGTRAP
-			if (!WIFSTOPPED(status) || WSTOPSIG(status) != SIGTRAP) {
-				endDebugSession();
-				return Status(tr("First event after waitpid() should be a STOP of type SIGTRAP, but wasn't, instead status=0x%1")
+			// the very first event should be the exec
+			if (!WIFSTOPPED(status) || !is_exec_event(status)) {
+				::kill(pid, SIGKILL);
+				Posix::waitpid(pid, nullptr, __WALL);
+				return Status(tr("First event after waitpid() should be the exec of the child, but wasn't, instead status=0x%1")
 								  .arg(status, 0, 16) +
 							  (childError.isEmpty() ? "" : tr(".\nError returned by child:\n%1.").arg(childError)));
 			}
 
 			waitedThreads_.insert(pid);
 
-			const long options = ptraceOptions();
-
-			// enable following clones (threads) and other options we are concerned with
-			const auto setoptStatus = ptraceSetOptions(pid, options);
-			if (!setoptStatus) {
-				endDebugSession();
-				return Status(tr("[DebuggerCore] failed to set ptrace options: %1").arg(setoptStatus.error()));
-			}
-
 			// create the process
 			process_ = std::make_shared<PlatformProcess>(this, pid);
+			nonStop_ = edb::v1::config().nonstop_mode;
 
 			// the PID == primary TID
 			auto newThread     = std::make_shared<PlatformThread>(this, process_, pid);
@@ -986,12 +1786,131 @@ Status DebuggerCore::open(const QString &path, const QString &cwd, const QList<Q
 
 			activeThread_ = pid;
 			detectCpuMode();
+			mapScratch(pid);
 
 			return Status::Ok;
 		}
 	}
 }
 
+/**
+ * @brief DebuggerCore::openCore
+ *
+ * Debugs the process which a core file was dumped from. There is nothing to
+ * trace, everything is served from the core file, so the process appears
+ * paused for good.
+ *
+ * @param path
+ * @return
+ */
+Status DebuggerCore::openCore(const QString &path) {
+
+	endDebugSession();
+
+	const Result<std::shared_ptr<CoreFile>, QString> core = CoreFile::open(path);
+	if (!core) {
+		return Status(core.error());
+	}
+
+	const bool is64Bit = (*core)->is64Bit();
+
+#if defined(EDB_X86) || defined(EDB_X86_64)
+	if ((*core)->machine() != EM_386 && (*core)->machine() != EM_X86_64) {
+		return Status(tr("%1 wasn't dumped by an x86 process").arg(path));
+	}
+
+	if (is64Bit) {
+		cpuMode_ = CpuMode::x86_64;
+		CapstoneEDB::init(CapstoneEDB::Architecture::ARCH_AMD64);
+	} else {
+		cpuMode_ = CpuMode::x86_32;
+		CapstoneEDB::init(CapstoneEDB::Architecture::ARCH_X86);
+	}
+#elif defined(EDB_ARM32)
+	if ((*core)->machine() != EM_ARM) {
+		return Status(tr("%1 wasn't dumped by an ARM process").arg(path));
+	}
+
+	cpuMode_ = CpuMode::ARM32;
+	CapstoneEDB::init(CapstoneEDB::Architecture::ARCH_ARM32_ARM);
+#elif defined(EDB_ARM64)
+	if ((*core)->machine() != EM_AARCH64) {
+		return Status(tr("%1 wasn't dumped by an AArch64 process").arg(path));
+	}
+
+	cpuMode_ = CpuMode::ARM64;
+	CapstoneEDB::init(CapstoneEDB::Architecture::ARCH_ARM64);
+#else
+#error "Unsupported Architecture"
+#endif
+
+	pointerSize_  = is64Bit ? sizeof(uint64_t) : sizeof(uint32_t);
+	coreFile_     = *core;
+	process_      = std::make_shared<CoreProcess>(coreFile_);
+	activeThread_ = process_->currentThread()->tid();
+	return Status::Ok;
+}
+
+/**
+ * @brief DebuggerCore::generateCore
+ *
+ * Writes the process out as a core file, the process has to be stopped
+ * while it is written so that what ends up in the core is consistent
+ *
+ * @param path
+ * @param skipReadOnlyFiles
+ * @return
+ */
+Status DebuggerCore::generateCore(const QString &path, bool skipReadOnlyFiles) {
+
+	if (!process_ || coreFile_) {
+		return Status(tr("There is no running process to generate a core file of"));
+	}
+
+	if (!process_->isPaused()) {
+		return Status(tr("The process must be paused to generate a core file of it"));
+	}
+
+#if defined(EDB_X86) || defined(EDB_X86_64)
+	const int machine = (pointerSize_ == sizeof(uint64_t)) ? EM_X86_64 : EM_386;
+#elif defined(EDB_ARM32)
+	const int machine = EM_ARM;
+#elif defined(EDB_ARM64)
+	const int machine = EM_AARCH64;
+#else
+#error "Unsupported Architecture"
+#endif
+
+	CoreWriter writer(process_.get(), pointerSize_ == sizeof(uint64_t), machine, PageSize);
+
+	// the current thread goes first, debuggers take the first thread of a
+	// core to be the one which was active
+	std::shared_ptr<IThread> current = process_->currentThread();
+	QList<std::shared_ptr<IThread>> threads = process_->threads();
+	std::stable_partition(threads.begin(), threads.end(), [&current](const std::shared_ptr<IThread> &thread) {
+		return thread == current;
+	});
+
+	for (const std::shared_ptr<IThread> &thread : threads) {
+		State state;
+		thread->getState(&state);
+		if (auto state_impl = static_cast<const PlatformState *>(state.impl_.get())) {
+			writer.addThread(thread->tid(), *state_impl);
+		}
+	}
+
+	edb::v1::memory_regions().sync();
+	for (const std::shared_ptr<IRegion> &region : edb::v1::memory_regions().regions()) {
+		const bool read_only_file = region->name().startsWith('/') && !region->writable();
+		writer.addRegion(*region, region->readable() && !(skipReadOnlyFiles && read_only_file));
+	}
+
+	// NOTE(eteran): the memory can only be read from several threads at once
+	// through /proc/<pid>/mem, ptrace only works from this one
+	const size_t readers = procMemReadBroken_ ? 1 : std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 4);
+	return writer.write(path, readers);
+}
+
 /**
  * @brief DebuggerCore::lastMeansOfCapture
  * @return how the last process was captured to debug
@@ -1004,9 +1923,85 @@ DebuggerCore::MeansOfCapture DebuggerCore::lastMeansOfCapture() const {
  * @brief DebuggerCore::reset
  */
 void DebuggerCore::reset() {
+#if defined(EDB_X86) || defined(EDB_X86_64)
+	// a thread which is attached to again may come back with other debug
+	// registers, and the old object might still be held on to somewhere
+	for (const std::shared_ptr<PlatformThread> &thread : threads_) {
+		thread->invalidateDebugRegisters();
+	}
+#endif
+
 	threads_.clear();
 	waitedThreads_.clear();
+	steppingThreads_.clear();
+	groupStopped_.clear();
+	pauseRequested_.clear();
+	runningOverBreakpoint_.clear();
+	pendingEvents_.clear();
+	passedSignalCounts_.fill(0);
+	pageWatchpoints_.reset();
+	displacedStepping_.reset();
 	activeThread_ = 0;
+#if defined(EDB_X86) || defined(EDB_X86_64)
+	debugRegisterTemplate_.fill(0);
+#endif
+}
+
+/**
+ * @brief DebuggerCore::addWatchpoint
+ * @param address
+ * @param size
+ * @param type
+ * @return
+ */
+Status DebuggerCore::addWatchpoint(edb::address_t address, size_t size, WatchpointType type) {
+	if (!process_ || waitedThreads_.empty()) {
+		return Status(tr("The process must be paused to change watchpoints"));
+	}
+
+	// any stopped thread can run the system calls which protect the pages
+	mapScratch(*waitedThreads_.begin());
+	return pageWatchpoints_.add(process_.get(), *waitedThreads_.begin(), address, size, type);
+}
+
+/**
+ * @brief DebuggerCore::removeWatchpoint
+ * @param address
+ * @return
+ */
+Status DebuggerCore::removeWatchpoint(edb::address_t address) {
+	if (!process_ || waitedThreads_.empty()) {
+		return Status(tr("The process must be paused to change watchpoints"));
+	}
+
+	return pageWatchpoints_.remove(process_.get(), *waitedThreads_.begin(), address);
+}
+
+/**
+ * @brief DebuggerCore::watchpoints
+ * @return
+ */
+std::vector<IDebugger::Watchpoint> DebuggerCore::watchpoints() const {
+	return pageWatchpoints_.watchpoints();
+}
+
+/**
+ * @brief DebuggerCore::setDebugRegisterTemplate
+ *
+ * Linux threads start out with all of their debug registers clear, so the
+ * ones set on every thread of the process are kept here for new threads,
+ * see handleThreadCreate. DR6 is left out, it is only ever set by the CPU.
+ *
+ * @param values
+ */
+void DebuggerCore::setDebugRegisterTemplate(const std::array<edb::reg_t, 8> &values) {
+#if defined(EDB_X86) || defined(EDB_X86_64)
+	for (std::size_t n = 0; n < values.size(); ++n) {
+		debugRegisterTemplate_[n] = (n == 6) ? 0 : values[n].toUint();
+	}
+#else
+	Q_UNUSED(values)
+#endif
 }
 
 /**
@@ -1043,6 +2038,32 @@ QMap<edb::pid_t, std::shared_ptr<IProcess>> DebuggerCore::enumerateProcesses() c
 	return ret;
 }
 
+/**
+ * @brief DebuggerCore::enumerateProcessInfo
+ *
+ * Unlike enumerateProcesses, this doesn't create a PlatformProcess for every
+ * process on the system, so it is cheap enough to call periodically
+ *
+ * @return
+ */
+QMap<edb::pid_t, ProcessInfo> DebuggerCore::enumerateProcessInfo() const {
+	QMap<edb::pid_t, ProcessInfo> ret;
+
+	QDir proc_directory("/proc/");
+	const QStringList entries = proc_directory.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+
+	for (const QString &filename : entries) {
+		if (util::is_numeric(filename)) {
+			ProcessInfo info;
+			if (read_process_info(filename.toInt(), &info)) {
+				ret.insert(info.pid, info);
+			}
+		}
+	}
+
+	return ret;
+}
+
 /**
  * @brief DebuggerCore::parentPid
  * @param pid
@@ -1158,11 +2179,107 @@ IProcess *DebuggerCore::process() const {
 }
 
 /**
- * @brief DebuggerCore::setIgnoredExceptions
- * @param exceptions
+ * @brief DebuggerCore::setExceptionDispositions
+ * @param dispositions
+ */
+void DebuggerCore::setExceptionDispositions(const QMap<qlonglong, ExceptionDisposition> &dispositions) {
+	signalDispositions_.fill(ExceptionDisposition::Stop);
+
+	for (auto it = dispositions.begin(); it != dispositions.end(); ++it) {
+		if (it.key() > 0 && it.key() < NSIG) {
+			signalDispositions_[it.key()] = it.value();
+		}
+	}
+}
+
+/**
+ * @brief DebuggerCore::passedExceptionCounts
+ * @return
  */
-void DebuggerCore::setIgnoredExceptions(const QList<qlonglong> &exceptions) {
-	ignoredExceptions_ = exceptions;
+QMap<qlonglong, uint64_t> DebuggerCore::passedExceptionCounts() const {
+	QMap<qlonglong, uint64_t> counts;
+	for (int signo = 1; signo < NSIG; ++signo) {
+		if (passedSignalCounts_[signo] != 0) {
+			counts.insert(signo, passedSignalCounts_[signo]);
+		}
+	}
+
+	return counts;
+}
+
+/**
+ * @brief DebuggerCore::signalDisposition
+ * @param signo
+ * @return
+ */
+IDebugger::ExceptionDisposition DebuggerCore::signalDisposition(int signo) const {
+	if (signo > 0 && signo < NSIG) {
+		return signalDispositions_[signo];
+	}
+
+	return ExceptionDisposition::Stop;
+}
+
+/**
+ * @brief DebuggerCore::notePassedSignal
+ * @param tid
+ * @param signo
+ */
+void DebuggerCore::notePassedSignal(edb::tid_t tid, int signo) {
+	if (signo > 0 && signo < NSIG) {
+		++passedSignalCounts_[signo];
+		if (signalDispositions_[signo] == ExceptionDisposition::LogAndPass) {
+			qDebug("Passed signal %d (%s) to thread %d", signo, strsignal(signo), tid);
+		}
+	}
+}
+
+/**
+ * @brief DebuggerCore::passSignal
+ *
+ * The fast path for signals which are passed to the application without
+ * stopping. It decides from the wait status alone, so a program which gets
+ * thousands of timer signals a second isn't slowed down by anything being
+ * allocated or fetched for each of them.
+ *
+ * @param tid
+ * @param status
+ * @return true if the signal was passed and the thread resumed
+ */
+bool DebuggerCore::passSignal(edb::tid_t tid, int status) {
+
+	// ptrace event stops also report SIGTRAP, with the event in the high bits
+	if (!WIFSTOPPED(status) || (status >> 16) != 0) {
+		return false;
+	}
+
+	const int signo = WSTOPSIG(status);
+	if (signalDisposition(signo) == ExceptionDisposition::Stop) {
+		return false;
+	}
+
+	switch (signo) {
+	case SIGTRAP: // breakpoints and steps
+	case SIGILL:  // some types of breakpoint
+	case SIGSEGV: // some types of breakpoint, and watchpoints
+		return false;
+	default:
+		break;
+	}
+
+	// a thread which was stepping has to keep doing so, the slow path takes
+	// care of that
+	if (util::contains(steppingThreads_, tid)) {
+		return false;
+	}
+
+	if (ptrace(PTRACE_CONT, tid, 0, signo) == -1) {
+		return false;
+	}
+
+	++resumeCount_;
+	notePassedSignal(tid, signo);
+	return true;
 }
 
 /**
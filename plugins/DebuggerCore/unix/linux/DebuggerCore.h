@@ -20,10 +20,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define DEBUGGER_CORE_H_20090529_
 
 #include "DebuggerCoreBase.h"
+#include "DisplacedStepping.h"
+#include "PageWatchpoints.h"
 #include <QHash>
 #include <QObject>
+#include <array>
 #include <csignal>
 #include <set>
+#include <vector>
 #include <unistd.h>
 
 class IBinary;
@@ -31,6 +35,7 @@ class Status;
 
 namespace DebuggerCorePlugin {
 
+class CoreFile;
 class PlatformThread;
 
 class DebuggerCore final : public DebuggerCoreBase {
@@ -53,19 +58,28 @@ public:
 	Status attach(edb::pid_t pid) override;
 	Status detach() override;
 	Status open(const QString &path, const QString &cwd, const QList<QByteArray> &args, const QString &input, const QString &output) override;
+	Status openCore(const QString &path) override;
+	Status generateCore(const QString &path, bool skipReadOnlyFiles) override;
 	bool hasExtension(uint64_t ext) const override;
 	size_t pageSize() const override;
 	std::shared_ptr<IDebugEvent> waitDebugEvent(std::chrono::milliseconds msecs) override;
 	std::size_t pointerSize() const override;
 	uint8_t nopFillByte() const override;
 	void kill() override;
-	void setIgnoredExceptions(const QList<qlonglong> &exceptions) override;
+	void setExceptionDispositions(const QMap<qlonglong, ExceptionDisposition> &dispositions) override;
+	QMap<qlonglong, uint64_t> passedExceptionCounts() const override;
 
 public:
 	QMap<qlonglong, QString> exceptions() const override;
 	QString exceptionName(qlonglong value) override;
 	qlonglong exceptionValue(const QString &name) override;
 
+public:
+	Status addWatchpoint(edb::address_t address, size_t size, WatchpointType type) override;
+	Status removeWatchpoint(edb::address_t address) override;
+	std::vector<Watchpoint> watchpoints() const override;
+	void setDebugRegisterTemplate(const std::array<edb::reg_t, 8> &values) override;
+
 public:
 	edb::pid_t parentPid(edb::pid_t pid) const override;
 
@@ -77,6 +91,7 @@ public:
 
 private:
 	QMap<edb::pid_t, std::shared_ptr<IProcess>> enumerateProcesses() const override;
+	QMap<edb::pid_t, ProcessInfo> enumerateProcessInfo() const override;
 
 public:
 	QString flagRegister() const override;
@@ -91,16 +106,32 @@ private:
 	Status ptraceContinue(edb::tid_t tid, long status);
 	Status ptraceGetEventMessage(edb::tid_t tid, unsigned long *message);
 	Status ptraceGetSigInfo(edb::tid_t tid, siginfo_t *siginfo);
-	Status ptraceSetOptions(edb::tid_t tid, long options);
+	Status ptraceInterrupt(edb::tid_t tid);
 	Status ptraceStep(edb::tid_t tid, long status);
-	long ptraceTraceme();
+
+private:
+	Status stepOverBreakpoint(edb::tid_t tid, edb::EventStatus status);
+	Status runOverBreakpoint(edb::tid_t tid, edb::EventStatus status);
+	void finishInterruptedSteps(edb::tid_t tid);
+	Status pauseThread(edb::tid_t tid);
+
+private:
+	ExceptionDisposition signalDisposition(int signo) const;
+	bool passSignal(edb::tid_t tid, int status);
+	void notePassedSignal(edb::tid_t tid, int signo);
 
 private:
 	Status stopThreads();
-	int attachThread(edb::tid_t tid);
+	std::vector<edb::tid_t> stopOtherThreads();
+	void resumeStoppedThreads(const std::vector<edb::tid_t> &tids);
+	std::shared_ptr<IDebugEvent> handlePendingEvent();
+	std::vector<edb::tid_t> seizeThreads(edb::pid_t pid, long options, int *lastErr);
+	void reapSeizedThreads(const std::vector<edb::tid_t> &tids);
+	void mapScratch(edb::tid_t tid);
 	long ptraceOptions() const;
 	std::shared_ptr<IDebugEvent> handleEvent(edb::tid_t tid, int status);
 	std::shared_ptr<IDebugEvent> handleThreadCreate(edb::tid_t tid, int status);
+	void handleExec(edb::tid_t tid, int status);
 	void detectCpuMode();
 	void handleThreadExit(edb::tid_t tid, int status);
 	void reset();
@@ -112,15 +143,32 @@ private:
 	// TODO(eteran): a few of these logically belong in PlatformProcess...
 	CpuMode cpuMode_                   = CpuMode::Unknown;
 	MeansOfCapture lastMeansOfCapture_ = MeansOfCapture::NeverCaptured;
-	QList<qlonglong> ignoredExceptions_;
 	std::set<edb::tid_t> waitedThreads_;
+	std::set<edb::tid_t> steppingThreads_; // threads last resumed with a single step
+	std::set<edb::tid_t> groupStopped_;    // threads stopped by a stopping signal, left in that stop when resumed
+	std::set<edb::tid_t> pauseRequested_;  // threads interrupted by pauseThread, whose stop is reported
+	std::set<edb::tid_t> runningOverBreakpoint_; // threads stepping off of a breakpoint out of line, which then carry on
+	std::set<edb::tid_t> pendingEvents_;         // threads stopped with an event which is yet to be reported, see resumeStoppedThreads
+	uint64_t resumeCount_ = 0; // bumped every time a thread runs, see PlatformThread::setState
 	edb::tid_t activeThread_;
 	std::shared_ptr<IProcess> process_;
+	std::shared_ptr<CoreFile> coreFile_; // set while process_ is a core file rather than a live process
 	threads_type threads_;
+	PageWatchpoints pageWatchpoints_;
+	DisplacedStepping displacedStepping_;
+	// indexed by signal number, so that a signal can be dealt with straight
+	// from the wait status
+	std::array<ExceptionDisposition, NSIG> signalDispositions_ = {};
+	std::array<uint64_t, NSIG> passedSignalCounts_             = {};
 	bool procMemReadBroken_  = true;
 	bool procMemWriteBroken_ = true;
+	bool nonStop_            = false; // only stop the thread which reported an event
 	std::size_t pointerSize_ = sizeof(void *);
 #if defined(EDB_X86) || defined(EDB_X86_64)
+	// the debug registers every thread should have, as last set by whoever
+	// sets hardware breakpoints process-wide, so that new threads can be given
+	// them without asking an existing thread, see setDebugRegisterTemplate
+	std::array<unsigned long, 8> debugRegisterTemplate_ = {};
 	const bool osIs64Bit_;
 	const edb::seg_reg_t userCodeSegment32_;
 	const edb::seg_reg_t userCodeSegment64_;
@@ -0,0 +1,474 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DisplacedStepping.h"
+#include "IDebugger.h"
+#include "IProcess.h"
+#include "IRegion.h"
+#include "Instruction.h"
+#include "MemoryRegions.h"
+#include "RemoteSyscall.h"
+#include "edb.h"
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+#include <sys/mman.h>
+#include <sys/ptrace.h>
+#include <sys/user.h>
+
+namespace DebuggerCorePlugin {
+
+namespace {
+
+// each stepping thread gets a slot of a scratch page for its instruction
+constexpr size_t SlotSize = 32;
+
+// how far a 32-bit displacement reaches, less a page so that every slot of a
+// page we accept is in reach
+constexpr uint64_t MaxReach = 0x7fff0000;
+
+/**
+ * @brief distance
+ * @param lhs
+ * @param rhs
+ * @return
+ */
+uint64_t distance(edb::address_t lhs, edb::address_t rhs) {
+	return (lhs > rhs) ? (lhs - rhs).toUint() : (rhs - lhs).toUint();
+}
+
+/**
+ * @brief nearest_gap
+ * @param address
+ * @param size
+ * @return the unmapped address closest to <address> with room for <size>
+ * bytes, or 0 if there is none
+ */
+edb::address_t nearest_gap(edb::address_t address, size_t size) {
+
+	QList<std::shared_ptr<IRegion>> regions = edb::v1::memory_regions().regions();
+	std::sort(regions.begin(), regions.end(), [](const std::shared_ptr<IRegion> &lhs, const std::shared_ptr<IRegion> &rhs) {
+		return lhs->start() < rhs->start();
+	});
+
+	edb::address_t best = 0;
+	for (int i = 1; i < regions.size(); ++i) {
+		const edb::address_t gap_start = regions[i - 1]->end();
+		const edb::address_t gap_end   = regions[i]->start();
+		if (gap_end <= gap_start || (gap_end - gap_start).toUint() < size) {
+			continue;
+		}
+
+		const edb::address_t candidate = (address < gap_start) ? gap_start : gap_end - size;
+		if (best == 0 || distance(candidate, address) < distance(best, address)) {
+			best = candidate;
+		}
+	}
+
+	return best;
+}
+
+}
+
+/**
+ * @brief DisplacedStepping::findSlot
+ * @param address
+ * @param relative true if the instruction has a 32-bit field relative to its
+ * own address, the slot then has to be in reach of <address>
+ * @return a free slot in one of our scratch pages, or 0 if there is none
+ */
+edb::address_t DisplacedStepping::findSlot(edb::address_t address, bool relative) const {
+
+	const size_t page_size = edb::v1::debugger_core->pageSize();
+
+	for (edb::address_t page : pages_) {
+		if (relative && distance(page, address) > MaxReach) {
+			continue;
+		}
+
+		for (edb::address_t slot = page; slot < page + page_size; slot += SlotSize) {
+			if (!usedSlots_.contains(slot)) {
+				return slot;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief DisplacedStepping::mapPage
+ *
+ * Maps another scratch page, as close to <address> as we can get it.
+ *
+ * @param process
+ * @param tid
+ * @param scratch where to run the mmap system call from
+ * @param address
+ * @param relative true if the page is needed in reach of <address>
+ * @return
+ */
+Status DisplacedStepping::mapPage(IProcess *process, edb::tid_t tid, edb::address_t scratch, edb::address_t address, bool relative) {
+
+	const size_t page_size = edb::v1::debugger_core->pageSize();
+
+	// the kernel takes the address as a hint, if it is taken by now the page
+	// ends up wherever it likes and we find out below that it's out of reach
+	const edb::address_t hint = relative ? nearest_gap(address, page_size) : edb::address_t(0);
+
+	// I wish there was a clean way to get the value of this system call for either target
+	const long syscall_number = edb::v1::debuggeeIs32Bit() ? 192 : 9; //__NR_mmap2 : __NR_mmap;
+
+	long result = 0;
+	if (Status status = inject_syscall(process, tid, scratch, syscall_number, {static_cast<unsigned long>(hint.toUint()), page_size, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, static_cast<unsigned long>(-1), 0}, &result); !status) {
+		return status;
+	}
+
+	if (result < 0) {
+		return Status(tr("mmap failed: %1").arg(strerror(static_cast<int>(-result))));
+	}
+
+	pages_.push_back(edb::address_t::fromZeroExtended(static_cast<unsigned long>(result)));
+	return Status::Ok;
+}
+
+/**
+ * @brief DisplacedStepping::mapScratch
+ *
+ * Maps the first scratch page and places a system call instruction in its
+ * first slot. The mmap system call for it is run from <address>, so no other
+ * thread may be running while this is called.
+ *
+ * @param process
+ * @param tid a stopped thread
+ * @param address an address in executable memory
+ * @return
+ */
+Status DisplacedStepping::mapScratch(IProcess *process, edb::tid_t tid, edb::address_t address) {
+#if defined(EDB_X86) || defined(EDB_X86_64)
+	if (syscallAddress_ != 0) {
+		return Status::Ok;
+	}
+
+	if (Status status = mapPage(process, tid, address, address, false); !status) {
+		return status;
+	}
+
+	static constexpr uint8_t Syscall64[] = {0x0f, 0x05}; // syscall
+	static constexpr uint8_t Syscall32[] = {0xcd, 0x80}; // int $0x80
+
+	uint8_t buffer[SlotSize];
+	std::memset(buffer, 0xcc, sizeof(buffer));
+	std::memcpy(buffer, edb::v1::debuggeeIs32Bit() ? Syscall32 : Syscall64, 2);
+
+	const edb::address_t slot = pages_.back();
+	if (process->writeBytes(slot, buffer, sizeof(buffer)) != sizeof(buffer)) {
+		pages_.pop_back();
+		return Status(tr("The system call instruction could not be written to the scratch memory"));
+	}
+
+	// this slot is never handed out for stepping
+	usedSlots_.insert(slot);
+	syscallAddress_ = slot;
+	return Status::Ok;
+#else
+	Q_UNUSED(process)
+	Q_UNUSED(tid)
+	Q_UNUSED(address)
+	return Status(tr("Displaced stepping is not supported on this architecture"));
+#endif
+}
+
+/**
+ * @brief DisplacedStepping::syscallAddress
+ * @return the address of the system call instruction in the first scratch
+ * page, or 0 if it isn't mapped yet
+ */
+edb::address_t DisplacedStepping::syscallAddress() const {
+	return syscallAddress_;
+}
+
+/**
+ * @brief DisplacedStepping::prepare
+ *
+ * Copies the instruction at <address> to a scratch slot and points the
+ * thread at it, the caller then only has to step the thread.
+ *
+ * @param process
+ * @param tid a stopped thread
+ * @param address the address of the breakpoint the thread is on
+ * @return
+ */
+Status DisplacedStepping::prepare(IProcess *process, edb::tid_t tid, edb::address_t address) {
+#if (defined(EDB_X86) || defined(EDB_X86_64)) && CS_API_MAJOR >= 4
+	// NOTE(eteran): reads see the original bytes under a breakpoint
+	uint8_t code[CapstoneEDB::Instruction::MaxSize];
+	const size_t code_size = process->readBytes(address, code, sizeof(code));
+
+	const CapstoneEDB::Instruction insn(code, code + code_size, address.toUint());
+	if (!insn) {
+		return Status(tr("The instruction could not be decoded"));
+	}
+
+	// these return to an address the kernel saved, which would be in the slot
+	if (is_syscall(insn) || is_sysenter(insn) || is_interrupt(insn) || insn.operation() == X86_INS_XBEGIN) {
+		return Status(tr("This instruction can't be stepped out of line"));
+	}
+
+	const bool is_64bit      = !edb::v1::debuggeeIs32Bit();
+	const cs_x86 &x86        = insn->detail->x86;
+	const bool relative_jump = (is_call(insn) || is_jump(insn)) && insn.operation() != X86_INS_LJMP && insn.operation() != X86_INS_LCALL;
+	const size_t insn_size   = insn.byteSize();
+
+	// find the field, if any, which is relative to the address of the instruction
+	int relative_offset  = -1;
+	size_t relative_size = 0;
+	for (uint8_t i = 0; i < x86.op_count; ++i) {
+		const cs_x86_op &op = x86.operands[i];
+		if (op.type == X86_OP_MEM && op.mem.base == X86_REG_RIP) {
+			relative_offset = x86.encoding.disp_offset;
+			relative_size   = x86.encoding.disp_size;
+		} else if (op.type == X86_OP_MEM && op.mem.base == X86_REG_EIP) {
+			return Status(tr("This instruction can't be stepped out of line"));
+		} else if (op.type == X86_OP_IMM && relative_jump) {
+			relative_offset = x86.encoding.imm_offset;
+			relative_size   = x86.encoding.imm_size;
+		}
+	}
+
+	// a short jump can't reach back from the scratch page
+	if (relative_offset != -1 && relative_size != sizeof(int32_t)) {
+		return Status(tr("This instruction can't be stepped out of line"));
+	}
+
+	// outside of 64-bit code everything is in reach
+	const bool needs_reach = is_64bit && relative_offset != -1;
+
+	// NOTE(eteran): until mapScratch was done, the only place to run mmap from
+	// is live code, which another thread could run into
+	if (syscallAddress_ == 0) {
+		return Status(tr("No scratch memory has been mapped yet"));
+	}
+
+	edb::address_t slot = findSlot(address, needs_reach);
+	if (slot == 0) {
+		if (Status status = mapPage(process, tid, syscallAddress_, address, needs_reach); !status) {
+			return status;
+		}
+
+		slot = findSlot(address, needs_reach);
+		if (slot == 0) {
+			return Status(tr("No scratch memory could be mapped in reach of the instruction"));
+		}
+	}
+
+	// anything after the instruction traps, should the thread ever get there
+	uint8_t buffer[SlotSize];
+	std::memset(buffer, 0xcc, sizeof(buffer));
+	std::memcpy(buffer, code, insn_size);
+
+	if (relative_offset != -1) {
+		int32_t value;
+		std::memcpy(&value, &buffer[relative_offset], sizeof(value));
+
+		const int64_t adjusted = int64_t{value} + static_cast<int64_t>(address.toUint()) - static_cast<int64_t>(slot.toUint());
+		if (is_64bit && (adjusted < std::numeric_limits<int32_t>::min() || adjusted > std::numeric_limits<int32_t>::max())) {
+			return Status(tr("No scratch memory could be mapped in reach of the instruction"));
+		}
+
+		// in 32-bit code the address wraps around, so truncating is correct
+		value = static_cast<int32_t>(static_cast<uint32_t>(adjusted));
+		std::memcpy(&buffer[relative_offset], &value, sizeof(value));
+	}
+
+	if (process->writeBytes(slot, buffer, sizeof(buffer)) != sizeof(buffer)) {
+		return Status(tr("The instruction could not be copied to the scratch memory"));
+	}
+
+	user_regs_struct regs;
+	if (ptrace(PTRACE_GETREGS, tid, 0, &regs) == -1) {
+		return Status(strerror(errno));
+	}
+
+#if defined(EDB_X86_64)
+	regs.rip = slot.toUint();
+#else
+	regs.eip = slot.toUint();
+#endif
+
+	if (ptrace(PTRACE_SETREGS, tid, 0, &regs) == -1) {
+		return Status(strerror(errno));
+	}
+
+	usedSlots_.insert(slot);
+	steps_.insert(tid, Step{address, slot, insn_size, is_call(insn), {}});
+	return Status::Ok;
+#else
+	Q_UNUSED(process)
+	Q_UNUSED(tid)
+	Q_UNUSED(address)
+	return Status(tr("Displaced stepping is not supported on this architecture"));
+#endif
+}
+
+/**
+ * @brief DisplacedStepping::isStepping
+ * @param tid
+ * @return true if <tid> is stepping out of line
+ */
+bool DisplacedStepping::isStepping(edb::tid_t tid) const {
+	return steps_.contains(tid);
+}
+
+/**
+ * @brief DisplacedStepping::defer
+ *
+ * Sets aside a signal which arrived while <tid> was stepping out of line, it
+ * is sent again once the step is done.
+ *
+ * @param tid
+ * @param signo
+ */
+void DisplacedStepping::defer(edb::tid_t tid, int signo) {
+	auto it = steps_.find(tid);
+	if (it != steps_.end()) {
+		it->deferred.push_back(signo);
+	}
+}
+
+/**
+ * @brief DisplacedStepping::finish
+ *
+ * Moves a thread which stopped while stepping out of line back to where the
+ * instruction would have left it. Jumps to anywhere but the next instruction
+ * are already where they should be, but a call pushed a return address in the
+ * slot which has to be pointed back at the real code. A thread which was
+ * stopped before it got to run the instruction is moved back onto it, and
+ * one which ran on into the padding after it is moved to the instruction
+ * after it.
+ *
+ * @param process
+ * @param tid a stopped thread
+ * @return true if the thread was stepping out of line
+ */
+bool DisplacedStepping::finish(IProcess *process, edb::tid_t tid) {
+
+	auto it = steps_.find(tid);
+	if (it == steps_.end()) {
+		return false;
+	}
+
+	const Step step = *it;
+	steps_.erase(it);
+	usedSlots_.remove(step.slot);
+
+#if defined(EDB_X86) || defined(EDB_X86_64)
+	user_regs_struct regs;
+	if (ptrace(PTRACE_GETREGS, tid, 0, &regs) == -1) {
+		qWarning("Unable to get the registers of thread %d after stepping out of line: %s", tid, strerror(errno));
+		send_deferred(process, tid, step.deferred);
+		return true;
+	}
+
+#if defined(EDB_X86_64)
+	const edb::address_t ip = edb::address_t::fromZeroExtended(regs.rip);
+	const edb::address_t sp = edb::address_t::fromZeroExtended(regs.rsp);
+#else
+	const edb::address_t ip = edb::address_t::fromZeroExtended(regs.eip);
+	const edb::address_t sp = edb::address_t::fromZeroExtended(regs.esp);
+#endif
+
+	edb::address_t new_ip = ip;
+	if (ip >= step.slot && ip <= step.slot + step.size) {
+		// didn't leave the slot, or continued to the next instruction
+		new_ip = step.address + (ip - step.slot);
+	} else if (ip > step.slot + step.size && ip <= step.slot + SlotSize) {
+		// ran the instruction and then trapped on the padding after it
+		new_ip = step.address + step.size;
+	} else if (step.call) {
+		const size_t pointer_size = edb::v1::debuggeeIs32Bit() ? 4 : 8;
+
+		uint64_t return_address = 0;
+		if (process->readBytes(sp, &return_address, pointer_size) == pointer_size && return_address == (step.slot + step.size).toUint()) {
+			return_address = (step.address + step.size).toUint();
+			process->writeBytes(sp, &return_address, pointer_size);
+		}
+	}
+
+#if defined(EDB_X86_64)
+	regs.rip = new_ip.toUint();
+#else
+	regs.eip = new_ip.toUint();
+#endif
+
+	if (ptrace(PTRACE_SETREGS, tid, 0, &regs) == -1) {
+		qWarning("Unable to move thread %d back after stepping out of line: %s", tid, strerror(errno));
+	}
+#endif
+
+	send_deferred(process, tid, step.deferred);
+	return true;
+}
+
+/**
+ * @brief DisplacedStepping::finishAll
+ *
+ * Moves every thread which is stepping out of line back to the real code,
+ * they all have to be stopped.
+ *
+ * @param process
+ */
+void DisplacedStepping::finishAll(IProcess *process) {
+	for (edb::tid_t tid : steps_.keys()) {
+		finish(process, tid);
+	}
+}
+
+/**
+ * @brief DisplacedStepping::remove
+ *
+ * Forgets about a thread which is gone.
+ *
+ * @param tid
+ */
+void DisplacedStepping::remove(edb::tid_t tid) {
+	auto it = steps_.find(tid);
+	if (it != steps_.end()) {
+		usedSlots_.remove(it->slot);
+		steps_.erase(it);
+	}
+}
+
+/**
+ * @brief DisplacedStepping::reset
+ *
+ * Forgets everything, for when the process is gone.
+ */
+void DisplacedStepping::reset() {
+	pages_.clear();
+	syscallAddress_ = 0;
+	usedSlots_.clear();
+	steps_.clear();
+}
+
+}
@@ -0,0 +1,81 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DISPLACED_STEPPING_H_20261019_
+#define DISPLACED_STEPPING_H_20261019_
+
+#include "OSTypes.h"
+#include "Status.h"
+#include "Types.h"
+#include <QCoreApplication>
+#include <QHash>
+#include <QSet>
+#include <vector>
+
+class IProcess;
+
+namespace DebuggerCorePlugin {
+
+// Displaced stepping. Instead of removing a breakpoint to step the instruction
+// under it, the instruction is copied to a scratch page in the debuggee, with
+// anything relative to its address adjusted, and stepped there. Afterwards the
+// thread is moved back to where the instruction would have left it. Since the
+// breakpoint stays in place, other threads can't run past it meanwhile.
+//
+// The scratch pages are mapped by having the stepping thread run an mmap
+// system call, so all of the functions taking a tid need that thread to be
+// stopped. The first page is mapped by mapScratch, while no thread can run
+// through the code the system call is placed in. It keeps a system call
+// instruction in its first slot, which every later system call is run from.
+class DisplacedStepping {
+	Q_DECLARE_TR_FUNCTIONS(DisplacedStepping)
+
+public:
+	Status mapScratch(IProcess *process, edb::tid_t tid, edb::address_t address);
+	edb::address_t syscallAddress() const;
+	Status prepare(IProcess *process, edb::tid_t tid, edb::address_t address);
+	bool isStepping(edb::tid_t tid) const;
+	void defer(edb::tid_t tid, int signo);
+	bool finish(IProcess *process, edb::tid_t tid);
+	void finishAll(IProcess *process);
+	void remove(edb::tid_t tid);
+	void reset();
+
+private:
+	struct Step {
+		edb::address_t address; // where the instruction really is
+		edb::address_t slot;    // where it is being stepped
+		size_t size;
+		bool call;
+		std::vector<int> deferred; // signals to send once the step is done
+	};
+
+private:
+	edb::address_t findSlot(edb::address_t address, bool relative) const;
+	Status mapPage(IProcess *process, edb::tid_t tid, edb::address_t scratch, edb::address_t address, bool relative);
+
+private:
+	std::vector<edb::address_t> pages_;
+	edb::address_t syscallAddress_ = 0;
+	QSet<edb::address_t> usedSlots_;
+	QHash<edb::tid_t, Step> steps_;
+};
+
+}
+
+#endif
@@ -0,0 +1,525 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PageWatchpoints.h"
+#include "IProcess.h"
+#include "IRegion.h"
+#include "Instruction.h"
+#include "MemoryRegions.h"
+#include "RemoteSyscall.h"
+#include "edb.h"
+
+#include <QDebug>
+#include <QtGlobal>
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/ptrace.h>
+#include <sys/user.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef PTRACE_GETSIGINFO
+#define PTRACE_GETSIGINFO static_cast<__ptrace_request>(0x4202)
+#endif
+
+namespace DebuggerCorePlugin {
+
+namespace {
+
+// the widest access a single instruction is expected to make, assumed when
+// the size of the access can't be told from the instruction
+constexpr size_t MaxAccessSize = 16;
+
+/**
+ * @brief page_of
+ * @param address
+ * @return the address of the page containing <address>
+ */
+edb::address_t page_of(edb::address_t address) {
+	const size_t page_size = edb::v1::debugger_core->pageSize();
+	return address - (address & (page_size - 1));
+}
+
+/**
+ * @brief access_size
+ * @param process
+ * @param tid a stopped thread
+ * @return how many bytes the instruction <tid> is stopped on accesses in
+ * memory, or MaxAccessSize if it can't be told
+ */
+size_t access_size(IProcess *process, edb::tid_t tid) {
+#if (defined(EDB_X86) || defined(EDB_X86_64)) && CS_API_MAJOR >= 4
+	user_regs_struct regs;
+	if (ptrace(PTRACE_GETREGS, tid, 0, &regs) == -1) {
+		return MaxAccessSize;
+	}
+
+#if defined(EDB_X86_64)
+	const edb::address_t ip = edb::address_t::fromZeroExtended(regs.rip);
+#else
+	const edb::address_t ip = edb::address_t::fromZeroExtended(regs.eip);
+#endif
+
+	uint8_t code[CapstoneEDB::Instruction::MaxSize];
+	const size_t code_size = process->readBytes(ip, code, sizeof(code));
+
+	const CapstoneEDB::Instruction insn(code, code + code_size, ip.toUint());
+	if (!insn) {
+		return MaxAccessSize;
+	}
+
+	size_t size       = 0;
+	const cs_x86 &x86 = insn->detail->x86;
+	for (uint8_t i = 0; i < x86.op_count; ++i) {
+		if (x86.operands[i].type == X86_OP_MEM) {
+			size = std::max<size_t>(size, x86.operands[i].size);
+		}
+	}
+
+	if (size != 0) {
+		return size;
+	}
+
+	// these access the stack without it being one of their operands
+	if (is_call(insn) || is_ret(insn) || insn.operation() == X86_INS_PUSH || insn.operation() == X86_INS_POP) {
+		return edb::v1::pointer_size();
+	}
+
+	return MaxAccessSize;
+#else
+	Q_UNUSED(process)
+	Q_UNUSED(tid)
+	return MaxAccessSize;
+#endif
+}
+
+}
+
+/**
+ * @brief PageWatchpoints::setSyscallAddress
+ * @param address the system call instruction to run mprotect with
+ */
+void PageWatchpoints::setSyscallAddress(edb::address_t address) {
+	syscallAddress_ = address;
+}
+
+/**
+ * @brief PageWatchpoints::mprotect
+ * @param process
+ * @param tid
+ * @param address
+ * @param size
+ * @param protection
+ * @return
+ */
+Status PageWatchpoints::mprotect(IProcess *process, edb::tid_t tid, edb::address_t address, size_t size, int protection) {
+
+	// NOTE(eteran): the system call is never placed in the debuggee's own
+	// code, where a running thread could come across it
+	if (syscallAddress_ == 0 || pages_.contains(page_of(syscallAddress_))) {
+		return Status(tr("No scratch memory is mapped to run the mprotect system call from"));
+	}
+
+	// I wish there was a clean way to get the value of this system call for either target
+	const long syscall_number = edb::v1::debuggeeIs32Bit() ? 125 : 10; //__NR_mprotect;
+
+	long result = 0;
+	if (Status status = inject_syscall(process, tid, syscallAddress_, syscall_number, {static_cast<unsigned long>(address.toUint()), size, static_cast<unsigned long>(protection)}, &result); !status) {
+		return status;
+	}
+
+	if (result < 0) {
+		return Status(tr("mprotect failed: %1").arg(strerror(static_cast<int>(-result))));
+	}
+
+	return Status::Ok;
+}
+
+/**
+ * @brief PageWatchpoints::desiredProtection
+ * @param page
+ * @return the protection <page> needs for the watchpoints on it to fault
+ */
+int PageWatchpoints::desiredProtection(const Page &page) const {
+	if (page.accessWatches != 0) {
+		return PROT_NONE;
+	}
+
+	if (page.writeWatches != 0) {
+		return page.originalProtection & ~PROT_WRITE;
+	}
+
+	return page.originalProtection;
+}
+
+/**
+ * @brief PageWatchpoints::updateWatchCounts
+ * @param watchpoint
+ * @param delta
+ * @return the pages <watchpoint> covers
+ */
+std::vector<edb::address_t> PageWatchpoints::updateWatchCounts(const IDebugger::Watchpoint &watchpoint, int delta) {
+
+	const size_t page_size = edb::v1::debugger_core->pageSize();
+
+	std::vector<edb::address_t> pages;
+	for (edb::address_t page = page_of(watchpoint.address); page < watchpoint.address + watchpoint.size; page += page_size) {
+		Page &info = pages_[page];
+		if (watchpoint.type == IDebugger::WatchpointType::ReadWrite) {
+			info.accessWatches += delta;
+		} else {
+			info.writeWatches += delta;
+		}
+		pages.push_back(page);
+	}
+
+	return pages;
+}
+
+/**
+ * @brief PageWatchpoints::applyProtection
+ *
+ * Brings the protection of <pages> in line with the watchpoints on them,
+ * changing runs of neighbouring pages with a single system call. Pages with
+ * no watchpoints left are forgotten.
+ *
+ * @param process
+ * @param tid
+ * @param pages sorted page addresses
+ * @return
+ */
+Status PageWatchpoints::applyProtection(IProcess *process, edb::tid_t tid, const std::vector<edb::address_t> &pages) {
+
+	const size_t page_size = edb::v1::debugger_core->pageSize();
+
+	size_t i = 0;
+	while (i < pages.size()) {
+		const Page &first      = pages_[pages[i]];
+		const int protection   = desiredProtection(first);
+		const bool needs_write = first.currentProtection != protection;
+
+		size_t j = i + 1;
+		while (j < pages.size() && pages[j] == pages[j - 1] + page_size) {
+			const Page &page = pages_[pages[j]];
+			if (desiredProtection(page) != protection || (page.currentProtection != protection) != needs_write) {
+				break;
+			}
+			++j;
+		}
+
+		if (needs_write) {
+			if (Status status = mprotect(process, tid, pages[i], (j - i) * page_size, protection); !status) {
+				return status;
+			}
+		}
+
+		for (size_t k = i; k < j; ++k) {
+			Page &page             = pages_[pages[k]];
+			page.currentProtection = protection;
+			if (page.accessWatches == 0 && page.writeWatches == 0) {
+				pages_.remove(pages[k]);
+			}
+		}
+
+		i = j;
+	}
+
+	return Status::Ok;
+}
+
+/**
+ * @brief PageWatchpoints::add
+ * @param process
+ * @param tid a stopped thread
+ * @param address
+ * @param size
+ * @param type
+ * @return
+ */
+Status PageWatchpoints::add(IProcess *process, edb::tid_t tid, edb::address_t address, size_t size, IDebugger::WatchpointType type) {
+
+	if (size == 0) {
+		return Status(tr("A watchpoint must cover at least one byte"));
+	}
+
+	// the ranges must not overlap, so that a lookup finds at most one
+	auto it = watchpoints_.lower_bound(address);
+	if (it != watchpoints_.end() && it->first < address + size) {
+		return Status(tr("The range overlaps an existing watchpoint"));
+	}
+
+	if (it != watchpoints_.begin() && std::prev(it)->second.address + std::prev(it)->second.size > address) {
+		return Status(tr("The range overlaps an existing watchpoint"));
+	}
+
+	const size_t page_size = edb::v1::debugger_core->pageSize();
+
+	// note the protection of any page we haven't touched yet
+	for (edb::address_t page = page_of(address); page < address + size; page += page_size) {
+		if (!pages_.contains(page)) {
+			std::shared_ptr<IRegion> region = edb::v1::memory_regions().findRegion(page);
+			if (!region) {
+				return Status(tr("The range is not entirely mapped"));
+			}
+		}
+	}
+
+	for (edb::address_t page = page_of(address); page < address + size; page += page_size) {
+		if (!pages_.contains(page)) {
+			const int protection = static_cast<int>(edb::v1::memory_regions().findRegion(page)->permissions());
+
+			Page info;
+			info.originalProtection = protection;
+			info.currentProtection  = protection;
+			pages_.insert(page, info);
+		}
+	}
+
+	const IDebugger::Watchpoint watchpoint = {address, size, type};
+	watchpoints_.emplace(address, watchpoint);
+
+	const std::vector<edb::address_t> pages = updateWatchCounts(watchpoint, +1);
+	if (Status status = applyProtection(process, tid, pages); !status) {
+		watchpoints_.erase(address);
+		updateWatchCounts(watchpoint, -1);
+		applyProtection(process, tid, pages);
+		return status;
+	}
+
+	return Status::Ok;
+}
+
+/**
+ * @brief PageWatchpoints::remove
+ * @param process
+ * @param tid a stopped thread
+ * @param address the start of the watched range
+ * @return
+ */
+Status PageWatchpoints::remove(IProcess *process, edb::tid_t tid, edb::address_t address) {
+
+	auto it = watchpoints_.find(address);
+	if (it == watchpoints_.end()) {
+		return Status::Ok;
+	}
+
+	const IDebugger::Watchpoint watchpoint = it->second;
+	watchpoints_.erase(it);
+
+	return applyProtection(process, tid, updateWatchCounts(watchpoint, -1));
+}
+
+/**
+ * @brief PageWatchpoints::clear
+ *
+ * Removes every watchpoint, restoring the original protection of the pages
+ *
+ * @param process
+ * @param tid a stopped thread
+ * @return
+ */
+Status PageWatchpoints::clear(IProcess *process, edb::tid_t tid) {
+
+	std::vector<edb::address_t> pages;
+	for (auto it = pages_.begin(); it != pages_.end(); ++it) {
+		it->accessWatches = 0;
+		it->writeWatches  = 0;
+		pages.push_back(it.key());
+	}
+
+	std::sort(pages.begin(), pages.end());
+	watchpoints_.clear();
+
+	return applyProtection(process, tid, pages);
+}
+
+/**
+ * @brief PageWatchpoints::reset
+ *
+ * Forgets every watchpoint, for when the process is gone
+ */
+void PageWatchpoints::reset() {
+	watchpoints_.clear();
+	pages_.clear();
+	syscallAddress_ = 0;
+}
+
+/**
+ * @brief PageWatchpoints::watchpoints
+ * @return
+ */
+std::vector<IDebugger::Watchpoint> PageWatchpoints::watchpoints() const {
+	std::vector<IDebugger::Watchpoint> ret;
+	ret.reserve(watchpoints_.size());
+	for (const auto &entry : watchpoints_) {
+		ret.push_back(entry.second);
+	}
+	return ret;
+}
+
+/**
+ * @brief PageWatchpoints::isWatchedPage
+ * @param address
+ * @return true if <address> is on a page we protected
+ */
+bool PageWatchpoints::isWatchedPage(edb::address_t address) const {
+	return !pages_.isEmpty() && pages_.contains(page_of(address));
+}
+
+/**
+ * @brief PageWatchpoints::handleFault
+ *
+ * Steps the faulting instruction of <tid> with the pages it faulted on
+ * unprotected, and decides if it accessed a watched range. When this returns
+ * Missed or Triggered, the thread is stopped after the instruction. The other
+ * threads have to be stopped too, an access they made to the unprotected
+ * pages would go unnoticed.
+ *
+ * @param process
+ * @param tid the thread which faulted, it must be stopped
+ * @param address the faulting address
+ * @param status receives the new wait status of the thread when Interrupted,
+ * or -1 if it could no longer be waited on
+ * @param watchpoint receives the watchpoint which was accessed when Triggered
+ * @return
+ */
+PageWatchpoints::Fault PageWatchpoints::handleFault(IProcess *process, edb::tid_t tid, edb::address_t address, int *status, IDebugger::Watchpoint *watchpoint) {
+
+	Q_ASSERT(status);
+	Q_ASSERT(watchpoint);
+
+	if (!isWatchedPage(address)) {
+		return Fault::NotWatched;
+	}
+
+	const size_t page_size = edb::v1::debugger_core->pageSize();
+
+	// how far past the faulting address the access reaches
+	const size_t size = access_size(process, tid);
+
+	// the ranges this access touched, along with what the part of them within
+	// reach of the access held before it
+	struct Candidate {
+		IDebugger::Watchpoint watchpoint;
+		edb::address_t start;
+		QByteArray before;
+	};
+
+	std::vector<Candidate> candidates;
+
+	auto add_candidate = [&](const IDebugger::Watchpoint &w) {
+		const edb::address_t start = std::max(w.address, address);
+		const edb::address_t end   = std::min(w.address + w.size, address + size);
+
+		QByteArray before(static_cast<int>(end - start), '\0');
+		process->readBytes(start, before.data(), before.size());
+		candidates.push_back(Candidate{w, start, before});
+	};
+
+	auto it = watchpoints_.upper_bound(address);
+	if (it != watchpoints_.begin() && address < std::prev(it)->second.address + std::prev(it)->second.size) {
+		add_candidate(std::prev(it)->second);
+	}
+
+	for (; it != watchpoints_.end() && it->first < address + size; ++it) {
+		add_candidate(it->second);
+	}
+
+	// step the instruction, unprotecting each of our pages it faults on. An
+	// unaligned access may span two of them
+	std::vector<edb::address_t> unprotected;
+	std::vector<int> deferred;
+	edb::address_t fault_page = page_of(address);
+	int step_status           = -1;
+
+	Q_FOREVER {
+		if (Status error = mprotect(process, tid, fault_page, page_size, pages_[fault_page].originalProtection); !error) {
+			qWarning() << "Unable to unprotect a watched page:" << error.error();
+			break;
+		}
+
+		unprotected.push_back(fault_page);
+		step_status = step_thread(tid, &deferred);
+
+		if (step_status != -1 && WIFSTOPPED(step_status) && WSTOPSIG(step_status) == SIGSEGV) {
+			siginfo_t siginfo;
+			if (ptrace(PTRACE_GETSIGINFO, tid, 0, &siginfo) != -1) {
+				const edb::address_t next_page = page_of(edb::address_t::fromZeroExtended(siginfo.si_addr));
+				if (pages_.contains(next_page) && std::find(unprotected.begin(), unprotected.end(), next_page) == unprotected.end()) {
+					fault_page = next_page;
+					continue;
+				}
+			}
+		}
+
+		break;
+	}
+
+	for (edb::address_t page : unprotected) {
+		const Page &info = pages_[page];
+		mprotect(process, tid, page, page_size, info.currentProtection);
+	}
+
+	send_deferred(process, tid, deferred);
+
+	if (unprotected.empty()) {
+		// we couldn't step it, so let it be reported as a regular fault
+		return Fault::NotWatched;
+	}
+
+	if (step_status == -1 || !WIFSTOPPED(step_status) || WSTOPSIG(step_status) != SIGTRAP) {
+		*status = step_status;
+		return Fault::Interrupted;
+	}
+
+	// when the faulting page only lacked write access, the fault was a write
+	const bool was_write = pages_.value(page_of(address)).accessWatches == 0;
+
+	for (const Candidate &candidate : candidates) {
+
+		const IDebugger::Watchpoint &w = candidate.watchpoint;
+
+		bool triggered = false;
+		if (w.type == IDebugger::WatchpointType::ReadWrite) {
+			triggered = true;
+		} else if (was_write && address >= w.address && address < w.address + w.size) {
+			triggered = true;
+		} else {
+			// this could have been a read of a page which is also watched for
+			// reads, or a write just before the range which may have run into
+			// it. Either way, it counts if it changed the range
+			QByteArray after(candidate.before.size(), '\0');
+			process->readBytes(candidate.start, after.data(), after.size());
+			triggered = (after != candidate.before);
+		}
+
+		if (triggered) {
+			*watchpoint = w;
+			return Fault::Triggered;
+		}
+	}
+
+	return Fault::Missed;
+}
+
+}
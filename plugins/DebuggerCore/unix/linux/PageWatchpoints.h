@@ -0,0 +1,89 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PAGE_WATCHPOINTS_H_20261019_
+#define PAGE_WATCHPOINTS_H_20261019_
+
+#include "IDebugger.h"
+#include "Status.h"
+#include <QCoreApplication>
+#include <QHash>
+#include <map>
+#include <vector>
+
+class IProcess;
+
+namespace DebuggerCorePlugin {
+
+// Software watchpoints. The pages holding watched ranges are protected so
+// that accessing them faults, a fault is then filtered by the exact ranges
+// being watched, and the faulting instruction is stepped with the page
+// temporarily unprotected.
+//
+// The protections are changed by having a stopped thread of the debuggee run
+// an mprotect system call, so all of the functions taking a tid need that
+// thread to be stopped. The system call is run from the instruction which
+// DisplacedStepping keeps in its scratch page, see setSyscallAddress.
+class PageWatchpoints {
+	Q_DECLARE_TR_FUNCTIONS(PageWatchpoints)
+
+public:
+	enum class Fault {
+		NotWatched, // not a fault on a page we protected
+		Missed,     // a fault on a protected page, but outside of any watched range
+		Triggered,  // a watched range was accessed
+		Interrupted // the thread stopped for some other reason while stepping
+	};
+
+public:
+	Status add(IProcess *process, edb::tid_t tid, edb::address_t address, size_t size, IDebugger::WatchpointType type);
+	Status remove(IProcess *process, edb::tid_t tid, edb::address_t address);
+	Status clear(IProcess *process, edb::tid_t tid);
+	void reset();
+	void setSyscallAddress(edb::address_t address);
+	std::vector<IDebugger::Watchpoint> watchpoints() const;
+
+public:
+	bool isWatchedPage(edb::address_t address) const;
+	Fault handleFault(IProcess *process, edb::tid_t tid, edb::address_t address, int *status, IDebugger::Watchpoint *watchpoint);
+
+private:
+	struct Page {
+		int originalProtection = 0;
+		int currentProtection  = 0;
+		int writeWatches       = 0;
+		int accessWatches      = 0;
+	};
+
+private:
+	Status applyProtection(IProcess *process, edb::tid_t tid, const std::vector<edb::address_t> &pages);
+	Status mprotect(IProcess *process, edb::tid_t tid, edb::address_t address, size_t size, int protection);
+	int desiredProtection(const Page &page) const;
+	std::vector<edb::address_t> updateWatchCounts(const IDebugger::Watchpoint &watchpoint, int delta);
+
+private:
+	// the watched ranges keyed by their start address, they never overlap so
+	// finding the one containing an address is a single lookup
+	std::map<edb::address_t, IDebugger::Watchpoint> watchpoints_;
+	QHash<edb::address_t, Page> pages_;
+	edb::address_t syscallAddress_ = 0;
+};
+
+}
+
+#endif
@@ -31,7 +31,8 @@ namespace DebuggerCorePlugin {
  */
 int resume_code(int status) {
 
-	if (WIFSTOPPED(status) && WSTOPSIG(status) == SIGSTOP) {
+	// ptrace event stops report SIGTRAP, but there is no signal to deliver
+	if (WIFSTOPPED(status) && (status >> 16) != 0) {
 		return 0;
 	}
 
@@ -41,10 +41,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QFile>
 #include <QFileInfo>
 #include <QTextStream>
+#include <QThread>
 
 #include <fstream>
+#include <limits>
 
 #include <elf.h>
+#include <fcntl.h>
 #include <linux/limits.h>
 #include <pwd.h>
 #include <sys/mman.h>
@@ -216,25 +219,37 @@ QList<Module> get_loaded_modules(const IProcess *process) {
 	return ret;
 }
 
+/**
+ * pread64 and pwrite64 take a signed offset, so addresses in the upper half of
+ * the address space can't be reached through /proc/<pid>/mem with them
+ *
+ * @brief is_file_offset
+ * @param address
+ * @return
+ */
+bool is_file_offset(edb::address_t address) {
+	return address <= static_cast<edb::address_t>(std::numeric_limits<off64_t>::max());
+}
+
 /**
  * seeks memory file to given address, taking possible negativity of the
- * address into account
+ * address into account. /proc/<pid>/mem allows file positions past the
+ * largest off64_t, it just can't be given one in a single call
  *
  * @brief seek_addr
- * @param file
+ * @param fd
  * @param address
+ * @return
  */
-void seek_addr(QFile &file, edb::address_t address) {
-	if (address <= UINT64_MAX / 2) {
-		file.seek(address);
-	} else {
-		const int fd = file.handle();
-		// Seek in two parts to avoid specifying negative offset: off64_t is a signed type
-		const off64_t halfAddressTruncated = address >> 1;
-		lseek64(fd, halfAddressTruncated, SEEK_SET);
-		const off64_t secondHalfAddress = address - halfAddressTruncated;
-		lseek64(fd, secondHalfAddress, SEEK_CUR);
+bool seek_addr(int fd, edb::address_t address) {
+	// Seek in two parts to avoid specifying negative offset: off64_t is a signed type
+	const off64_t halfAddressTruncated = address >> 1;
+	if (lseek64(fd, halfAddressTruncated, SEEK_SET) == -1) {
+		return false;
 	}
+
+	const off64_t secondHalfAddress = address - halfAddressTruncated;
+	return lseek64(fd, secondHalfAddress, SEEK_CUR) != -1;
 }
 
 }
@@ -246,22 +261,46 @@ void seek_addr(QFile &file, edb::address_t address) {
  */
 PlatformProcess::PlatformProcess(DebuggerCore *core, edb::pid_t pid)
 	: core_(core), pid_(pid) {
+}
+
+/**
+ * @brief PlatformProcess::~PlatformProcess
+ */
+PlatformProcess::~PlatformProcess() {
+	if (memFile_ != -1) {
+		::close(memFile_);
+	}
+}
 
-	if (!core_->procMemReadBroken_) {
-		auto memory_file = std::make_shared<QFile>(QString("/proc/%1/mem").arg(pid_));
+/**
+ * Most PlatformProcess objects are only ever asked for things like their name
+ * or parent, so /proc/<pid>/mem is only opened the first time that memory is
+ * actually accessed.
+ *
+ * @brief PlatformProcess::memoryFile
+ * @return a descriptor for /proc/<pid>/mem, or -1 if it isn't usable
+ */
+int PlatformProcess::memoryFile() const {
+
+	std::call_once(memFileOnce_, [this]() {
+		if (core_->procMemReadBroken_) {
+			return;
+		}
+
+		char path[64];
+		snprintf(path, sizeof(path), "/proc/%d/mem", pid_);
 
-		QIODevice::OpenMode flags = QIODevice::ReadOnly | QIODevice::Unbuffered;
 		if (!core_->procMemWriteBroken_) {
-			flags |= QIODevice::WriteOnly;
+			memFile_         = ::open(path, O_RDWR | O_CLOEXEC);
+			memFileWritable_ = (memFile_ != -1);
 		}
 
-		if (memory_file->open(flags)) {
-			readOnlyMemFile_ = memory_file;
-			if (!core_->procMemWriteBroken_) {
-				readWriteMemFile_ = memory_file;
-			}
+		if (memFile_ == -1) {
+			memFile_ = ::open(path, O_RDONLY | O_CLOEXEC);
 		}
-	}
+	});
+
+	return memFile_;
 }
 
 /**
@@ -277,6 +316,9 @@ std::size_t PlatformProcess::readBytes(edb::address_t address, void *buf, std::s
 
 	// NOTE(eteran): returns the number of bytes read <N>
 	// NOTE(eteran): if the read is short, only the first <N> bytes are defined
+	// NOTE(eteran): pread has no shared file position, so as long as
+	// /proc/<pid>/mem is usable, this may be called from any thread. Anything
+	// else goes through readBytesSerialized.
 
 	quint64 read = 0;
 
@@ -290,55 +332,33 @@ std::size_t PlatformProcess::readBytes(edb::address_t address, void *buf, std::s
 		// small reads take the fast path
 		if (len == 1) {
 
-			auto it = core_->breakpoints_.find(address);
-			if (it != core_->breakpoints_.end()) {
-				*ptr = (*it)->originalBytes()[0];
+			if (std::shared_ptr<IBreakpoint> bp = core_->findBreakpoint(address)) {
+				*ptr = bp->originalBytes()[0];
 				return 1;
 			}
 
-			if (readOnlyMemFile_) {
-				seek_addr(*readOnlyMemFile_, address);
-				read = readOnlyMemFile_->read(ptr, 1);
-				if (read == 1) {
-					return 1;
-				}
-				return 0;
-			} else {
-				bool ok;
-				uint8_t x = ptraceReadByte(address, &ok);
-				if (ok) {
-					*ptr = x;
-					return 1;
-				}
-				return 0;
+			const int fd = memoryFile();
+			if (fd != -1 && is_file_offset(address)) {
+				return ::pread64(fd, ptr, 1, static_cast<off64_t>(address)) == 1 ? 1 : 0;
 			}
+
+			return readBytesSerialized(address, ptr, 1);
 		}
 
-		if (readOnlyMemFile_) {
-			seek_addr(*readOnlyMemFile_, address);
-			read = readOnlyMemFile_->read(ptr, len);
-			if (read == 0 || read == quint64(-1)) {
+		const int fd = memoryFile();
+		if (fd != -1 && is_file_offset(address)) {
+			const ssize_t n = ::pread64(fd, ptr, len, static_cast<off64_t>(address));
+			if (n <= 0) {
 				return 0;
 			}
+			read = static_cast<quint64>(n);
 		} else {
-			for (std::size_t index = 0; index < len; ++index) {
-
-				// read a byte, if we failed, we are done
-				bool ok;
-				const uint8_t x = ptraceReadByte(address + index, &ok);
-				if (!ok) {
-					break;
-				}
-
-				// store it
-				reinterpret_cast<char *>(buf)[index] = x;
-
-				++read;
-			}
+			read = readBytesSerialized(address, ptr, len);
 		}
 
 		// replace any breakpoints
-		Q_FOREACH (const std::shared_ptr<IBreakpoint> &bp, core_->breakpoints_) {
+		const IDebugger::BreakpointList breakpoints = core_->backupBreakpoints();
+		for (const std::shared_ptr<IBreakpoint> &bp : breakpoints) {
 			auto bpBytes                = bp->originalBytes();
 			const edb::address_t bpAddr = bp->address();
 			// show the original bytes in the buffer..
@@ -406,26 +426,109 @@ std::size_t PlatformProcess::writeBytes(edb::address_t address, const void *buf,
 	Q_ASSERT(core_->process_.get() == this);
 
 	if (len != 0) {
-		if (readWriteMemFile_) {
-			seek_addr(*readWriteMemFile_, address);
-			written = readWriteMemFile_->write(reinterpret_cast<const char *>(buf), len);
-			if (written == 0 || written == quint64(-1)) {
+		const int fd = memoryFile();
+		if (fd != -1 && memFileWritable_ && is_file_offset(address)) {
+			const ssize_t n = ::pwrite64(fd, buf, len, static_cast<off64_t>(address));
+			if (n <= 0) {
 				return 0;
 			}
+			written = static_cast<quint64>(n);
 		} else {
-			// TODO write whole words at a time using ptrace_poke.
-			for (std::size_t byteIndex = 0; byteIndex < len; ++byteIndex) {
-				bool ok = false;
-				ptraceWriteByte(address + byteIndex, *(reinterpret_cast<const char *>(buf) + byteIndex), &ok);
-				if (!ok) return written;
-				++written;
-			}
+			written = writeBytesSerialized(address, static_cast<const char *>(buf), len);
 		}
 	}
 
 	return written;
 }
 
+/**
+ * reads memory which a single pread64 can't, either because the address is
+ * past the largest offset it takes, or because /proc/<pid>/mem isn't usable
+ * at all. Both take a sequence of calls which mustn't be interleaved with
+ * those of another thread, so only one thread at a time gets here.
+ *
+ * @brief PlatformProcess::readBytesSerialized
+ * @param address
+ * @param buf
+ * @param len
+ * @return the number of bytes read
+ */
+std::size_t PlatformProcess::readBytesSerialized(edb::address_t address, char *buf, std::size_t len) const {
+
+	std::lock_guard<std::mutex> lock(serializedAccessMutex_);
+
+	if (const int fd = memoryFile(); fd != -1) {
+		if (!seek_addr(fd, address)) {
+			return 0;
+		}
+
+		const ssize_t n = ::read(fd, buf, len);
+		return (n > 0) ? static_cast<std::size_t>(n) : 0;
+	}
+
+	// NOTE(eteran): ptrace only works from the thread which is tracing the
+	// process, which is also the only one allowed to look at its threads
+	if (QThread::currentThread() != core_->thread()) {
+		return 0;
+	}
+
+	std::size_t read = 0;
+	for (std::size_t index = 0; index < len; ++index) {
+
+		// read a byte, if we failed, we are done
+		bool ok;
+		const uint8_t x = ptraceReadByte(address + index, &ok);
+		if (!ok) {
+			break;
+		}
+
+		buf[index] = x;
+		++read;
+	}
+
+	return read;
+}
+
+/**
+ * the writing counterpart of readBytesSerialized
+ *
+ * @brief PlatformProcess::writeBytesSerialized
+ * @param address
+ * @param buf
+ * @param len
+ * @return the number of bytes written
+ */
+std::size_t PlatformProcess::writeBytesSerialized(edb::address_t address, const char *buf, std::size_t len) {
+
+	std::lock_guard<std::mutex> lock(serializedAccessMutex_);
+
+	if (const int fd = memoryFile(); fd != -1 && memFileWritable_) {
+		if (!seek_addr(fd, address)) {
+			return 0;
+		}
+
+		const ssize_t n = ::write(fd, buf, len);
+		return (n > 0) ? static_cast<std::size_t>(n) : 0;
+	}
+
+	if (QThread::currentThread() != core_->thread()) {
+		return 0;
+	}
+
+	// TODO write whole words at a time using ptrace_poke.
+	std::size_t written = 0;
+	for (std::size_t byteIndex = 0; byteIndex < len; ++byteIndex) {
+		bool ok = false;
+		ptraceWriteByte(address + byteIndex, buf[byteIndex], &ok);
+		if (!ok) {
+			break;
+		}
+		++written;
+	}
+
+	return written;
+}
+
 /**
  * reads <count> pages from the process starting at <address>
  *
@@ -707,7 +810,7 @@ long PlatformProcess::ptracePeek(edb::address_t address, bool *ok) const {
 	// NOTE: on some Linux systems ptrace prototype has ellipsis instead of third and fourth arguments
 	// Thus we can't just pass address as is on IA32 systems: it'd put 64 bit integer on stack and cause UB
 	auto nativeAddress = reinterpret_cast<const void *>(address.toUint());
-	const long v       = ptrace(PTRACE_PEEKTEXT, pid_, nativeAddress, 0);
+	const long v       = ptrace(PTRACE_PEEKTEXT, ptraceThread(), nativeAddress, 0);
 	*ok                = set_ok(v);
 	return v;
 }
@@ -730,7 +833,23 @@ bool PlatformProcess::ptracePoke(edb::address_t address, long value) {
 	// NOTE: on some Linux systems ptrace prototype has ellipsis instead of third and fourth arguments
 	// Thus we can't just pass address as is on IA32 systems: it'd put 64 bit integer on stack and cause UB
 	auto nativeAddress = reinterpret_cast<const void *>(address.toUint());
-	return ptrace(PTRACE_POKETEXT, pid_, nativeAddress, value) != -1;
+	return ptrace(PTRACE_POKETEXT, ptraceThread(), nativeAddress, value) != -1;
+}
+
+/**
+ * @brief PlatformProcess::ptraceThread
+ *
+ * ptrace can only access memory through a stopped thread. In non-stop mode
+ * that isn't necessarily the main thread.
+ *
+ * @return a stopped thread of the process, preferring the main thread
+ */
+edb::tid_t PlatformProcess::ptraceThread() const {
+	if (core_->waitedThreads_.empty() || util::contains(core_->waitedThreads_, pid_)) {
+		return pid_;
+	}
+
+	return *core_->waitedThreads_.begin();
 }
 
 /**
@@ -829,14 +948,13 @@ QList<Module> PlatformProcess::loadedModules() const {
  */
 Status PlatformProcess::pause() {
 	// belive it or not, I belive that this is sufficient for all threads.
-	// This is because in the debug event handler, a SIGSTOP is sent
-	// to all threads when any event arrives, so no need to explicitly do
-	// it here. We just need any thread to stop. So we'll just target the
-	// pid_ which will send it to any one of the threads in the process.
-	if (::kill(pid_, SIGSTOP) == -1) {
-		const char *const strError = strerror(errno);
-		qWarning() << "Unable to pause process" << pid_ << ": kill(SIGSTOP) failed:" << strError;
-		return Status(strError);
+	// This is because in the debug event handler, the other threads are
+	// interrupted when any event arrives, so no need to explicitly do it
+	// here. We just need any thread to stop
+	for (auto &thread : threads()) {
+		if (!thread->isPaused()) {
+			return core_->pauseThread(thread->tid());
+		}
 	}
 
 	return Status::Ok;
@@ -869,12 +987,16 @@ Status PlatformProcess::resume(edb::EventStatus status) {
 				errorMessage += tr("Failed to resume thread %1: %2\n").arg(thread->tid()).arg(resumeStatus.error());
 			}
 
-			// resume the other threads passing the signal they originally reported had
-			for (auto &other_thread : threads()) {
-				if (util::contains(core_->waitedThreads_, other_thread->tid())) {
-					const auto resumeStatus = other_thread->resume();
-					if (!resumeStatus) {
-						errorMessage += tr("Failed to resume thread %1: %2\n").arg(thread->tid()).arg(resumeStatus.error());
+			// resume the other threads passing the signal they originally reported had.
+			// In non-stop mode they were stopped by their own events, so they
+			// stay stopped until they are resumed individually
+			if (!core_->nonStop_) {
+				for (auto &other_thread : threads()) {
+					if (util::contains(core_->waitedThreads_, other_thread->tid())) {
+						const auto resumeStatus = other_thread->resume();
+						if (!resumeStatus) {
+							errorMessage += tr("Failed to resume thread %1: %2\n").arg(thread->tid()).arg(resumeStatus.error());
+						}
 					}
 				}
 			}
@@ -908,6 +1030,103 @@ Status PlatformProcess::step(edb::EventStatus status) {
 	return Status::Ok;
 }
 
+/**
+ * stops a single thread, its stop is then reported like any other event
+ *
+ * @brief PlatformProcess::pause
+ * @param thread
+ * @return
+ */
+Status PlatformProcess::pause(IThread &thread) {
+
+	if (thread.isPaused()) {
+		return Status::Ok;
+	}
+
+	return core_->pauseThread(thread.tid());
+}
+
+/**
+ * resumes a single thread, the other threads are left as they are
+ *
+ * @brief PlatformProcess::resume
+ * @param thread
+ * @param status
+ * @return
+ */
+Status PlatformProcess::resume(IThread &thread, edb::EventStatus status) {
+	Q_ASSERT(core_->process_.get() == this);
+
+	if (status != edb::DEBUG_STOP) {
+		return thread.resume(status);
+	}
+	return Status::Ok;
+}
+
+/**
+ * steps a single thread, the other threads are left as they are
+ *
+ * @brief PlatformProcess::step
+ * @param thread
+ * @param status
+ * @return
+ */
+Status PlatformProcess::step(IThread &thread, edb::EventStatus status) {
+	Q_ASSERT(core_->process_.get() == this);
+
+	if (status != edb::DEBUG_STOP) {
+		return thread.step(status);
+	}
+	return Status::Ok;
+}
+
+/**
+ * @brief PlatformProcess::stepOverBreakpoint
+ * @param thread
+ * @param status
+ * @return
+ */
+Status PlatformProcess::stepOverBreakpoint(IThread &thread, edb::EventStatus status) {
+	Q_ASSERT(core_->process_.get() == this);
+	return core_->stepOverBreakpoint(thread.tid(), status);
+}
+
+/**
+ * @brief PlatformProcess::runOverBreakpoint
+ *
+ * Steps <thread> off of its breakpoint out of line and resumes the other
+ * threads alongside it, the thread itself carries on once its step is done.
+ *
+ * @param thread
+ * @param status
+ * @return
+ */
+Status PlatformProcess::runOverBreakpoint(IThread &thread, edb::EventStatus status) {
+	Q_ASSERT(core_->process_.get() == this);
+
+	if (status == edb::DEBUG_STOP) {
+		return Status::Ok;
+	}
+
+	if (Status stepped = core_->runOverBreakpoint(thread.tid(), status); !stepped) {
+		return stepped;
+	}
+
+	// the thread is on its way already, so one of the others which fails to
+	// resume is only warned about
+	if (!core_->nonStop_) {
+		for (auto &other_thread : threads()) {
+			if (util::contains(core_->waitedThreads_, other_thread->tid())) {
+				if (const auto resumeStatus = other_thread->resume(); !resumeStatus) {
+					qWarning() << tr("Failed to resume thread %1: %2").arg(other_thread->tid()).arg(resumeStatus.error()).toStdString().c_str();
+				}
+			}
+		}
+	}
+
+	return Status::Ok;
+}
+
 /**
  * @brief PlatformProcess::isPaused
  * @return true if ALL threads are currently in the debugger's wait list
@@ -23,7 +23,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Status.h"
 
 #include <QCoreApplication>
-#include <QFile>
+
+#include <mutex>
 
 namespace DebuggerCorePlugin {
 
@@ -35,7 +36,7 @@ class PlatformProcess final : public IProcess {
 
 public:
 	PlatformProcess(DebuggerCore *core, edb::pid_t pid);
-	~PlatformProcess() override                         = default;
+	~PlatformProcess() override;
 	PlatformProcess(const PlatformProcess &)            = delete;
 	PlatformProcess &operator=(const PlatformProcess &) = delete;
 
@@ -70,6 +71,13 @@ public:
 	Status step(edb::EventStatus status) override;
 	bool isPaused() const override;
 
+public:
+	Status pause(IThread &thread) override;
+	Status resume(IThread &thread, edb::EventStatus status) override;
+	Status step(IThread &thread, edb::EventStatus status) override;
+	Status stepOverBreakpoint(IThread &thread, edb::EventStatus status) override;
+	Status runOverBreakpoint(IThread &thread, edb::EventStatus status) override;
+
 public:
 	std::size_t writeBytes(edb::address_t address, const void *buf, size_t len) override;
 	std::size_t patchBytes(edb::address_t address, const void *buf, size_t len) override;
@@ -78,6 +86,10 @@ public:
 	QMap<edb::address_t, Patch> patches() const override;
 
 private:
+	int memoryFile() const;
+	std::size_t readBytesSerialized(edb::address_t address, char *buf, std::size_t len) const;
+	std::size_t writeBytesSerialized(edb::address_t address, const char *buf, std::size_t len);
+	edb::tid_t ptraceThread() const;
 	bool ptracePoke(edb::address_t address, long value);
 	long ptracePeek(edb::address_t address, bool *ok) const;
 	uint8_t ptraceReadByte(edb::address_t address, bool *ok) const;
@@ -86,8 +98,10 @@ private:
 private:
 	DebuggerCore *core_ = nullptr;
 	edb::pid_t pid_;
-	std::shared_ptr<QFile> readOnlyMemFile_;
-	std::shared_ptr<QFile> readWriteMemFile_;
+	mutable std::once_flag memFileOnce_;
+	mutable int memFile_          = -1;
+	mutable bool memFileWritable_ = false;
+	mutable std::mutex serializedAccessMutex_; // see readBytesSerialized
 	QMap<edb::address_t, Patch> patches_;
 	QString input_;
 	QString output_;
@@ -119,7 +119,7 @@ QString PlatformThread::runState() const {
 
 /**
  * resumes this thread, passing the signal that stopped it
- * (unless the signal was SIGSTOP)
+ * (unless it stopped for a ptrace event rather than a signal)
  *
  * @brief PlatformThread::resume
  * @return
@@ -130,7 +130,7 @@ Status PlatformThread::resume() {
 
 /**
  * resumes this thread, passing the signal that stopped it
- * (unless the signal was SIGSTOP, or the passed status != DEBUG_EXCEPTION_NOT_HANDLED)
+ * (unless it stopped for a ptrace event, or the passed status != DEBUG_EXCEPTION_NOT_HANDLED)
  * @brief PlatformThread::resume
  * @param status
  * @return
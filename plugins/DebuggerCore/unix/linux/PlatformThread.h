@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "IBreakpoint.h"
 #include "IThread.h"
 #include <QCoreApplication>
+#include <array>
 #include <memory>
 
 class IProcess;
@@ -79,6 +80,23 @@ private:
 	edb::tid_t tid_;
 	int status_ = 0;
 
+#if defined(EDB_X86) || defined(EDB_X86_64)
+private:
+	void initDebugRegisters(const std::array<unsigned long, 8> &values);
+	void invalidateDebugRegisters();
+
+private:
+	// the last values read from or written to this thread's debug registers,
+	// only the debugger changes them so they only need to be fetched once,
+	// until an exec or a detach resets them, see invalidateDebugRegisters
+	std::array<unsigned long, 8> debugRegisters_ = {};
+	uint8_t debugRegistersCached_                = 0;
+
+	// bumped by every setState, a state read before the last one was written
+	// no longer matches the thread, see PlatformState::dirtyClasses
+	uint64_t stateWrites_ = 0;
+#endif
+
 #if defined(EDB_ARM32) || defined(EDB_ARM64)
 private:
 	Status doStep(edb::tid_t tid, long status);
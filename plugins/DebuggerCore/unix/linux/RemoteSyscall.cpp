@@ -0,0 +1,190 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "RemoteSyscall.h"
+#include "IProcess.h"
+#include "Posix.h"
+#include "edb.h"
+
+#include <QObject>
+#include <QtGlobal>
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#include <sys/ptrace.h>
+#include <sys/syscall.h>
+#include <sys/user.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace DebuggerCorePlugin {
+
+/**
+ * @brief step_thread
+ *
+ * Single steps a stopped thread. Signals which arrive in the meantime don't
+ * count as the step completing, they are set aside in <deferred> so that the
+ * caller can send them again once it is done with the thread.
+ *
+ * @param tid
+ * @param deferred
+ * @return the wait status of the thread once it stopped for a reason we care
+ * about, or -1 on error
+ */
+int step_thread(edb::tid_t tid, std::vector<int> *deferred) {
+
+	Q_FOREVER {
+		if (ptrace(PTRACE_SINGLESTEP, tid, 0, 0) == -1) {
+			return -1;
+		}
+
+		int status;
+		if (Posix::waitpid(tid, &status, __WALL) == -1) {
+			return -1;
+		}
+
+		if (WIFSTOPPED(status) && WSTOPSIG(status) != SIGTRAP && WSTOPSIG(status) != SIGSEGV) {
+			deferred->push_back(WSTOPSIG(status));
+			continue;
+		}
+
+		return status;
+	}
+}
+
+/**
+ * @brief send_deferred
+ * @param process
+ * @param tid
+ * @param deferred
+ */
+void send_deferred(IProcess *process, edb::tid_t tid, const std::vector<int> &deferred) {
+	for (int signo : deferred) {
+		syscall(SYS_tgkill, process->pid(), tid, signo);
+	}
+}
+
+/**
+ * @brief inject_syscall
+ *
+ * Has the stopped thread <tid> run a system call, by placing the instruction
+ * at <scratch> and stepping over it. The thread's registers and the code at
+ * <scratch> are restored afterwards.
+ *
+ * @param process
+ * @param tid
+ * @param scratch an address in executable memory
+ * @param number
+ * @param args the arguments of the system call, unused ones should be 0
+ * @param result
+ * @return
+ */
+Status inject_syscall(IProcess *process, edb::tid_t tid, edb::address_t scratch, long number, const std::array<unsigned long, 6> &args, long *result) {
+#if defined(EDB_X86) || defined(EDB_X86_64)
+	user_regs_struct saved_regs;
+	if (ptrace(PTRACE_GETREGS, tid, 0, &saved_regs) == -1) {
+		return Status(strerror(errno));
+	}
+
+	// NOTE(eteran): we poke the code directly rather than using
+	// IProcess::writeBytes, so that a breakpoint at <scratch> is kept as is
+	errno                 = 0;
+	const long saved_code = ptrace(PTRACE_PEEKTEXT, tid, scratch.toUint(), 0);
+	if (errno != 0) {
+		return Status(strerror(errno));
+	}
+
+	static constexpr uint8_t Syscall64[] = {0x0f, 0x05}; // syscall
+	static constexpr uint8_t Syscall32[] = {0xcd, 0x80}; // int $0x80
+
+	long code = saved_code;
+	std::memcpy(&code, edb::v1::debuggeeIs32Bit() ? Syscall32 : Syscall64, 2);
+
+	user_regs_struct regs = saved_regs;
+#if defined(EDB_X86_64)
+	// an orig_rax of -1 keeps the kernel from trying to restart a system call
+	// which the thread may have been stopped in
+	regs.rip      = scratch.toUint();
+	regs.orig_rax = static_cast<unsigned long>(-1);
+	regs.rax      = static_cast<unsigned long>(number);
+	if (edb::v1::debuggeeIs32Bit()) {
+		regs.rbx = args[0];
+		regs.rcx = args[1];
+		regs.rdx = args[2];
+		regs.rsi = args[3];
+		regs.rdi = args[4];
+		regs.rbp = args[5];
+	} else {
+		regs.rdi = args[0];
+		regs.rsi = args[1];
+		regs.rdx = args[2];
+		regs.r10 = args[3];
+		regs.r8  = args[4];
+		regs.r9  = args[5];
+	}
+#else
+	regs.eip      = scratch.toUint();
+	regs.orig_eax = -1;
+	regs.eax      = number;
+	regs.ebx      = args[0];
+	regs.ecx      = args[1];
+	regs.edx      = args[2];
+	regs.esi      = args[3];
+	regs.edi      = args[4];
+	regs.ebp      = args[5];
+#endif
+
+	if (ptrace(PTRACE_POKETEXT, tid, scratch.toUint(), code) == -1) {
+		return Status(strerror(errno));
+	}
+
+	std::vector<int> deferred;
+	int status = -1;
+	if (ptrace(PTRACE_SETREGS, tid, 0, &regs) != -1) {
+		status = step_thread(tid, &deferred);
+		ptrace(PTRACE_GETREGS, tid, 0, &regs);
+	}
+
+	ptrace(PTRACE_POKETEXT, tid, scratch.toUint(), saved_code);
+	ptrace(PTRACE_SETREGS, tid, 0, &saved_regs);
+	send_deferred(process, tid, deferred);
+
+	if (status == -1 || !WIFSTOPPED(status) || WSTOPSIG(status) != SIGTRAP) {
+		return Status(QObject::tr("The system call did not complete"));
+	}
+
+#if defined(EDB_X86_64)
+	*result = static_cast<long>(regs.rax);
+#else
+	*result = regs.eax;
+#endif
+	return Status::Ok;
+#else
+	Q_UNUSED(process)
+	Q_UNUSED(tid)
+	Q_UNUSED(scratch)
+	Q_UNUSED(number)
+	Q_UNUSED(args)
+	Q_UNUSED(result)
+	return Status(QObject::tr("Injecting system calls is not supported on this architecture"));
+#endif
+}
+
+}
@@ -0,0 +1,41 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef REMOTE_SYSCALL_H_20261019_
+#define REMOTE_SYSCALL_H_20261019_
+
+#include "OSTypes.h"
+#include "Status.h"
+#include "Types.h"
+#include <array>
+#include <vector>
+
+class IProcess;
+
+namespace DebuggerCorePlugin {
+
+// Helpers for making a stopped thread of the debuggee do work on our behalf,
+// such as running a system call which only affects its own process
+
+int step_thread(edb::tid_t tid, std::vector<int> *deferred);
+void send_deferred(IProcess *process, edb::tid_t tid, const std::vector<int> &deferred);
+Status inject_syscall(IProcess *process, edb::tid_t tid, edb::address_t scratch, long number, const std::array<unsigned long, 6> &args, long *result);
+
+}
+
+#endif
@@ -0,0 +1,59 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CoreThread.h"
+#include "CoreFile.h"
+#include "PlatformState.h"
+#include "State.h"
+
+#include <cstring>
+
+namespace DebuggerCorePlugin {
+
+/**
+ * @brief CoreThread::instructionPointer
+ * @return
+ */
+edb::address_t CoreThread::instructionPointer() const {
+	return 0;
+}
+
+/**
+ * @brief CoreThread::getState
+ *
+ * Only the general purpose registers are filled, the VFP registers of a core
+ * file aren't read yet
+ *
+ * @param state
+ */
+void CoreThread::getState(State *state) {
+
+	if (auto state_impl = static_cast<PlatformState *>(state->impl_.get())) {
+
+		state_impl->clear();
+
+		const CoreFile::Thread &thread = core_->threads()[index_];
+		if (thread.regs.size >= sizeof(user_regs)) {
+			user_regs regs;
+			std::memcpy(&regs, thread.regs.data, sizeof(regs));
+			state_impl->fillFrom(regs);
+		}
+	}
+}
+
+}
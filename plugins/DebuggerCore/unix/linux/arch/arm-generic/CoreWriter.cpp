@@ -0,0 +1,39 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CoreWriter.h"
+#include "PlatformState.h"
+
+namespace DebuggerCorePlugin {
+
+/**
+ * @brief CoreWriter::addThread
+ *
+ * Only the general purpose registers are written, the VFP registers aren't
+ * read back from core files yet either
+ *
+ * @param tid
+ * @param state
+ */
+void CoreWriter::addThread(edb::tid_t tid, const PlatformState &state) {
+	user_regs regs;
+	state.fillStruct(regs);
+	addPrStatus(tid, &regs, sizeof(regs));
+}
+
+}
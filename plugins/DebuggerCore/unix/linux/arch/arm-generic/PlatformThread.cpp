@@ -356,7 +356,7 @@ Status PlatformThread::doStep(const edb::tid_t tid, const long status) {
 
 /**
  * steps this thread one instruction, passing the signal that stopped it
- * (unless the signal was SIGSTOP)
+ * (unless it stopped for a ptrace event rather than a signal)
  *
  * @brief PlatformThread::step
  * @return
@@ -367,7 +367,7 @@ Status PlatformThread::step() {
 
 /**
  * steps this thread one instruction, passing the signal that stopped it
- * (unless the signal was SIGSTOP, or the passed status != DEBUG_EXCEPTION_NOT_HANDLED)
+ * (unless it stopped for a ptrace event, or the passed status != DEBUG_EXCEPTION_NOT_HANDLED)
  *
  * @brief PlatformThread::step
  * @param status
@@ -0,0 +1,130 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CoreThread.h"
+#include "CoreFile.h"
+#include "PlatformState.h"
+#include "State.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace DebuggerCorePlugin {
+namespace {
+
+/**
+ * @brief read_note
+ * @param note
+ * @param value
+ * @return false if <note> is too small to hold a <T>
+ */
+template <class T>
+bool read_note(const CoreFile::Note &note, T *value) {
+	if (!note.data || note.size < sizeof(T)) {
+		return false;
+	}
+
+	std::memcpy(value, note.data, sizeof(T));
+	return true;
+}
+
+}
+
+/**
+ * @brief CoreThread::instructionPointer
+ * @return
+ */
+edb::address_t CoreThread::instructionPointer() const {
+	const CoreFile::Thread &thread = core_->threads()[index_];
+
+	if (core_->is64Bit()) {
+		PrStatus_X86_64 regs;
+		if (read_note(thread.regs, &regs)) {
+			return regs.rip;
+		}
+	} else {
+		PrStatus_X86 regs;
+		if (read_note(thread.regs, &regs)) {
+			return regs.eip;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief CoreThread::getState
+ *
+ * Fills the state from the notes of the thread, preferring the same sources
+ * as a live thread does. The debug registers aren't part of a core file.
+ *
+ * @param state
+ */
+void CoreThread::getState(State *state) {
+
+	if (auto state_impl = static_cast<PlatformState *>(state->impl_.get())) {
+
+		state_impl->clear();
+
+		const CoreFile::Thread &thread = core_->threads()[index_];
+
+		if (core_->is64Bit()) {
+			PrStatus_X86_64 regs;
+			if (read_note(thread.regs, &regs)) {
+				state_impl->fillFrom(regs);
+			}
+		} else {
+			PrStatus_X86 regs;
+			if (read_note(thread.regs, &regs)) {
+				state_impl->fillFrom(regs);
+			}
+		}
+
+		X86XState xstate;
+		const size_t xstate_size = std::min(thread.xstate.size, sizeof(xstate));
+		if (xstate_size) {
+			std::memcpy(&xstate, thread.xstate.data, xstate_size);
+		}
+
+		if (!xstate_size || !state_impl->fillFrom(xstate, xstate_size)) {
+			if (core_->is64Bit()) {
+				UserFPRegsStructX86_64 fpregs;
+				if (read_note(thread.fpregs, &fpregs)) {
+					state_impl->fillFrom(fpregs);
+				}
+			} else if (EDB_IS_64_BIT) {
+				// NOTE(eteran): NT_PRXFPREG is an FXSAVE area, which is what
+				// the 64-bit FP register struct is too
+				UserFPRegsStructX86_64 fpregs;
+				if (read_note(thread.fpxregs, &fpregs)) {
+					state_impl->fillFrom(fpregs);
+				}
+			} else {
+				UserFPXRegsStructX86 fpxregs;
+				UserFPRegsStructX86 fpregs;
+				if (read_note(thread.fpxregs, &fpxregs)) {
+					state_impl->fillFrom(fpxregs);
+				} else if (read_note(thread.fpregs, &fpregs)) {
+					state_impl->fillFrom(fpregs);
+				}
+			}
+		}
+	}
+}
+
+}
@@ -0,0 +1,72 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CoreWriter.h"
+#include "CoreLayout.h"
+#include "PlatformState.h"
+#include "PrStatus.h"
+
+namespace DebuggerCorePlugin {
+
+/**
+ * @brief CoreWriter::addThread
+ *
+ * Adds the notes for a thread, the general purpose registers go in
+ * NT_PRSTATUS and the FPU/SSE registers in whichever note the kernel would
+ * use for the process, with NT_X86_XSTATE holding the rest
+ *
+ * @param tid
+ * @param state
+ */
+void CoreWriter::addThread(edb::tid_t tid, const PlatformState &state) {
+
+	if (is64Bit_) {
+		PrStatus_X86_64 regs;
+		UserFPRegsStructX86_64 fpregs;
+		state.fillStruct(regs);
+		state.fillStruct(fpregs);
+		addPrStatus(tid, &regs, sizeof(regs));
+		addNote(&threadNotes_, NtFpRegSet, &fpregs, sizeof(fpregs));
+	} else {
+		UserRegsStructX86 regs;
+		state.fillStruct(regs);
+		addPrStatus(tid, &regs, sizeof(regs));
+
+		if (EDB_IS_64_BIT) {
+			// NOTE(eteran): NT_PRXFPREG is an FXSAVE area, which is what
+			// the 64-bit FP register struct is too
+			UserFPRegsStructX86_64 fpxregs;
+			state.fillStruct(fpxregs);
+			addNote(&threadNotes_, NtPrXFpReg, &fpxregs, sizeof(fpxregs));
+		} else {
+			UserFPRegsStructX86 fpregs;
+			UserFPXRegsStructX86 fpxregs;
+			state.fillStruct(fpregs);
+			state.fillStruct(fpxregs);
+			addNote(&threadNotes_, NtFpRegSet, &fpregs, sizeof(fpregs));
+			addNote(&threadNotes_, NtPrXFpReg, &fpxregs, sizeof(fpxregs));
+		}
+	}
+
+	X86XState xstate;
+	if (const size_t size = state.fillStruct(xstate)) {
+		addNote(&threadNotes_, NtX86XState, &xstate, size);
+	}
+}
+
+}
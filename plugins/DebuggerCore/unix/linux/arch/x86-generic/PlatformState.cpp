@@ -1200,6 +1200,7 @@ edb::value16 PlatformState::fpuTagWord() const {
  */
 void PlatformState::adjustStack(int bytes) {
 	x86.GPRegs[X86::RSP] += bytes;
+	markDirty(REG_CLASS_GPR);
 }
 
 /**
@@ -1209,6 +1210,7 @@ void PlatformState::clear() {
 	x86.clear();
 	x87.clear();
 	avx.clear();
+	setSource(0, 0, 0, REG_CLASS_ALL);
 }
 
 /**
@@ -1227,6 +1229,7 @@ bool PlatformState::empty() const {
 void PlatformState::setDebugRegister(size_t n, edb::reg_t value) {
 	assert(dbgIndexValid(n));
 	x86.dbgRegs[n] = value;
+	markDirty(REG_CLASS_DEBUG);
 }
 
 /**
@@ -1235,6 +1238,7 @@ void PlatformState::setDebugRegister(size_t n, edb::reg_t value) {
  */
 void PlatformState::setFlags(edb::reg_t flags) {
 	x86.flags = flags;
+	markDirty(REG_CLASS_GPR);
 }
 /**
  * @brief PlatformState::setInstructionPointer
@@ -1243,6 +1247,7 @@ void PlatformState::setFlags(edb::reg_t flags) {
 void PlatformState::setInstructionPointer(edb::address_t value) {
 	x86.IP      = value;
 	x86.orig_ax = -1;
+	markDirty(REG_CLASS_GPR);
 }
 
 /**
@@ -1276,6 +1281,7 @@ void PlatformState::setRegister(const Register &reg) {
 	if (GPRegNameFoundIter != gpr_end) {
 		size_t index      = GPRegNameFoundIter - GPRegNames().begin();
 		x86.GPRegs[index] = reg.value<edb::value64>();
+		markDirty(REG_CLASS_GPR);
 		return;
 	}
 
@@ -1284,21 +1290,25 @@ void PlatformState::setRegister(const Register &reg) {
 	if (segRegNameFoundIter != x86.segRegNames.end()) {
 		size_t index       = segRegNameFoundIter - x86.segRegNames.begin();
 		x86.segRegs[index] = reg.value<edb::seg_reg_t>();
+		markDirty(REG_CLASS_GPR);
 		return;
 	}
 
 	if (regName == IPName()) {
 		x86.IP = reg.value<edb::value64>();
+		markDirty(REG_CLASS_GPR);
 		return;
 	}
 
 	if (regName == flagsName()) {
 		x86.flags = reg.value<edb::value64>();
+		markDirty(REG_CLASS_GPR);
 		return;
 	}
 
 	if (regName == avx.mxcsrName) {
 		avx.mxcsr = reg.value<edb::value32>();
+		markDirty(REG_CLASS_FPU);
 		return;
 	}
 
@@ -1318,6 +1328,7 @@ void PlatformState::setRegister(const Register &reg) {
 
 			const uint16_t RiUpper = 0xffff;
 			std::memcpy(reinterpret_cast<char *>(&x87.R[i]) + sizeof(value), &RiUpper, sizeof(RiUpper));
+			markDirty(REG_CLASS_FPU);
 			return;
 		}
 	}
@@ -1332,6 +1343,7 @@ void PlatformState::setRegister(const Register &reg) {
 			assert(fpuIndexValid(i));
 			const auto value = reg.value<edb::value80>();
 			std::memcpy(&x87.R[i], &value, sizeof(value));
+			markDirty(REG_CLASS_FPU);
 			return;
 		}
 	}
@@ -1346,6 +1358,7 @@ void PlatformState::setRegister(const Register &reg) {
 			assert(fpuIndexValid(i));
 			const auto value = reg.value<edb::value80>();
 			std::memcpy(&x87.st(i), &value, sizeof(value));
+			markDirty(REG_CLASS_FPU);
 			return;
 		}
 	}
@@ -1359,6 +1372,7 @@ void PlatformState::setRegister(const Register &reg) {
 			assert(indexReadOK && xmmIndexValid(i));
 
 			avx.zmmStorage[i].load(value);
+			markDirty(REG_CLASS_FPU);
 			return;
 		}
 	}
@@ -1372,37 +1386,44 @@ void PlatformState::setRegister(const Register &reg) {
 			assert(indexReadOK && ymmIndexValid(i));
 
 			avx.zmmStorage[i].load(value);
+			markDirty(REG_CLASS_FPU);
 			return;
 		}
 	}
 
 	if (regName == "ftr" || regName == "ftw") {
 		x87.tagWord = reg.value<edb::value16>();
+		markDirty(REG_CLASS_FPU);
 		return;
 	}
 
 	if (regName == "fsr" || regName == "fsw") {
 		x87.statusWord = reg.value<edb::value16>();
+		markDirty(REG_CLASS_FPU);
 		return;
 	}
 
 	if (regName == "fcr" || regName == "fcw") {
 		x87.controlWord = reg.value<edb::value16>();
+		markDirty(REG_CLASS_FPU);
 		return;
 	}
 
 	if (regName == "fis" || regName == "fds") {
 		(regName == "fis" ? x87.instPtrSelector : x87.dataPtrSelector) = reg.value<edb::value16>();
+		markDirty(REG_CLASS_FPU);
 		return;
 	}
 
 	if (regName == "fip" || regName == "fdp") {
 		(regName == "fip" ? x87.instPtrOffset : x87.dataPtrOffset) = reg.valueAsAddress();
+		markDirty(REG_CLASS_FPU);
 		return;
 	}
 
 	if (regName == "fopcode" || regName == "fop") {
 		x87.opCode = reg.value<edb::value16>();
+		markDirty(REG_CLASS_FPU);
 		return;
 	}
 
@@ -1415,6 +1436,7 @@ void PlatformState::setRegister(const Register &reg) {
 			size_t i       = digitChar - '0';
 			assert(dbgIndexValid(i));
 			x86.dbgRegs[i] = reg.valueAsAddress();
+			markDirty(REG_CLASS_DEBUG);
 			return;
 		}
 	}
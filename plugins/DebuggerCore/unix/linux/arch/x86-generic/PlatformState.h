@@ -224,6 +224,16 @@ class PlatformState final : public IState {
 	friend class DebuggerCore;
 	friend class PlatformThread;
 
+public:
+	// The classes of registers which are written back to the thread
+	// independently of each other
+	enum RegisterClass : uint32_t {
+		REG_CLASS_GPR   = 0x01, // general purpose, segment, flags and instruction pointer
+		REG_CLASS_FPU   = 0x02, // x87, MMX, SSE and AVX state
+		REG_CLASS_DEBUG = 0x04,
+		REG_CLASS_ALL   = REG_CLASS_GPR | REG_CLASS_FPU | REG_CLASS_DEBUG,
+	};
+
 public:
 	PlatformState();
 
@@ -502,6 +512,28 @@ private:
 		return n < zmm_reg_count();
 	}
 
+	// NOTE(eteran): a state remembers which thread it was read from, and when.
+	// As long as that thread hasn't run since, and no other state was written
+	// to it since, only the register classes which were modified need to be
+	// written back to it.
+	void markDirty(uint32_t classes) {
+		dirty_ |= classes;
+	}
+
+	void setSource(edb::tid_t tid, uint64_t generation, uint64_t writes, uint32_t dirty) {
+		sourceThread_     = tid;
+		sourceGeneration_ = generation;
+		sourceWrites_     = writes;
+		dirty_            = dirty;
+	}
+
+	uint32_t dirtyClasses(edb::tid_t tid, uint64_t generation, uint64_t writes) const {
+		if (sourceThread_ != tid || sourceGeneration_ != generation || sourceWrites_ != writes) {
+			return REG_CLASS_ALL;
+		}
+		return dirty_;
+	}
+
 	void fillFrom(const UserRegsStructX86 &regs);
 	void fillFrom(const UserRegsStructX86_64 &regs);
 	void fillFrom(const PrStatus_X86 &regs);
@@ -518,6 +550,12 @@ private:
 	void fillStruct(UserFPRegsStructX86_64 &regs) const;
 	void fillStruct(UserFPXRegsStructX86 &regs) const;
 	size_t fillStruct(X86XState &regs) const;
+
+private:
+	uint32_t dirty_            = REG_CLASS_ALL;
+	edb::tid_t sourceThread_   = 0;
+	uint64_t sourceGeneration_ = 0;
+	uint64_t sourceWrites_     = 0;
 };
 
 }
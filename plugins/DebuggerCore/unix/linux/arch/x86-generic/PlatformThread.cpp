@@ -219,6 +219,8 @@ void PlatformThread::getState(State *state) {
 		for (std::size_t i = 0; i < 8; ++i) {
 			state_impl->x86.dbgRegs[i] = getDebugRegister(i);
 		}
+
+		state_impl->setSource(tid_, core_->resumeCount_, stateWrites_, 0);
 	}
 }
 
@@ -231,66 +233,110 @@ void PlatformThread::setState(const State &state) {
 	// TODO: assert that we are paused
 
 	if (auto state_impl = static_cast<PlatformState *>(state.impl_.get())) {
-		bool setPrStatusDone = false;
 
-		if (EDB_IS_32_BIT && state_impl->is64Bit()) {
-			// Try to set 64-bit state
-			PrStatus_X86_64 prstat64;
-			state_impl->fillStruct(prstat64);
+		// if this state was read from this thread, and neither has the thread
+		// run nor was another state written to it since, then we only need to
+		// write back what was actually modified. For example, rewinding over a
+		// breakpoint only needs to set the IP
+		uint32_t dirty = state_impl->dirtyClasses(tid_, core_->resumeCount_, stateWrites_);
+		++stateWrites_;
 
-			struct iovec prstat_iov = {&prstat64, sizeof(prstat64)};
-			if (ptrace(PTRACE_SETREGSET, tid_, NT_PRSTATUS, &prstat_iov) != -1) {
-				setPrStatusDone = true;
-			} else {
-				perror("PTRACE_SETREGSET failed");
+		if (dirty & PlatformState::REG_CLASS_GPR) {
+			bool setPrStatusDone = false;
+
+			if (EDB_IS_32_BIT && state_impl->is64Bit()) {
+				// Try to set 64-bit state
+				PrStatus_X86_64 prstat64;
+				state_impl->fillStruct(prstat64);
+
+				struct iovec prstat_iov = {&prstat64, sizeof(prstat64)};
+				if (ptrace(PTRACE_SETREGSET, tid_, NT_PRSTATUS, &prstat_iov) != -1) {
+					setPrStatusDone = true;
+				} else {
+					perror("PTRACE_SETREGSET failed");
+				}
 			}
-		}
 
-		// Fallback to setting 32-bit set
-		if (!setPrStatusDone) {
-			struct user_regs_struct regs;
-			state_impl->fillStruct(regs);
-			ptrace(PTRACE_SETREGS, tid_, 0, &regs);
-		}
+			// Fallback to setting 32-bit set
+			if (!setPrStatusDone) {
+				struct user_regs_struct regs;
+				state_impl->fillStruct(regs);
+				if (ptrace(PTRACE_SETREGS, tid_, 0, &regs) != -1) {
+					setPrStatusDone = true;
+				}
+			}
 
-		// debug registers
-		for (std::size_t i = 0; i < 8; ++i) {
-			setDebugRegister(i, state_impl->x86.dbgRegs[i]);
+			if (setPrStatusDone) {
+				dirty &= ~PlatformState::REG_CLASS_GPR;
+			}
 		}
 
-		// hope for the best, adjust for reality
-		static bool xsaveSupported = true;
+		// debug registers, only the ones which differ from what the thread
+		// already has will actually be written
+		if (dirty & PlatformState::REG_CLASS_DEBUG) {
+			bool setDebugRegistersDone = true;
+			for (std::size_t i = 0; i < 8; ++i) {
+				// DR4 and DR5 are not writable through ptrace
+				if (i != 4 && i != 5 && setDebugRegister(i, state_impl->x86.dbgRegs[i]) == -1) {
+					setDebugRegistersDone = false;
+				}
+			}
 
-		if (xsaveSupported) {
-			X86XState xstate;
-			const auto size  = state_impl->fillStruct(xstate);
-			struct iovec iov = {&xstate, size};
-			if (ptrace(PTRACE_SETREGSET, tid_, NT_X86_XSTATE, &iov) == -1) {
-				xsaveSupported = false;
+			if (setDebugRegistersDone) {
+				dirty &= ~PlatformState::REG_CLASS_DEBUG;
 			}
 		}
 
-		// If xsave/xrstor appears unsupported, fallback to fxrstor
-		// NOTE: it's not "else", it's an independent check for possibly modified flag
-		if (!xsaveSupported) {
-			static bool setFPXRegsSupported = EDB_IS_32_BIT;
-			if (setFPXRegsSupported) {
-				UserFPXRegsStructX86 fpxregs;
-				state_impl->fillStruct(fpxregs);
-				setFPXRegsSupported = (ptrace(PTRACE_SETFPXREGS, tid_, 0, &fpxregs) != -1);
+		if (dirty & PlatformState::REG_CLASS_FPU) {
+			bool setFPUDone = false;
+
+			// hope for the best, adjust for reality
+			static bool xsaveSupported = true;
+
+			if (xsaveSupported) {
+				X86XState xstate;
+				const auto size  = state_impl->fillStruct(xstate);
+				struct iovec iov = {&xstate, size};
+				if (ptrace(PTRACE_SETREGSET, tid_, NT_X86_XSTATE, &iov) == -1) {
+					xsaveSupported = false;
+				} else {
+					setFPUDone = true;
+				}
 			}
 
-			if (!setFPXRegsSupported) {
-				// No SETFPXREGS: on x86 this means SSE is not supported
-				//                on x86_64 FPREGS already contain SSE state
-				// Just set fpregs then
-				struct user_fpregs_struct fpregs;
-				state_impl->fillStruct(fpregs);
-				if (ptrace(PTRACE_SETFPREGS, tid_, 0, &fpregs) == -1) {
-					perror("PTRACE_SETFPREGS failed");
+			// If xsave/xrstor appears unsupported, fallback to fxrstor
+			// NOTE: it's not "else", it's an independent check for possibly modified flag
+			if (!xsaveSupported) {
+				static bool setFPXRegsSupported = EDB_IS_32_BIT;
+				if (setFPXRegsSupported) {
+					UserFPXRegsStructX86 fpxregs;
+					state_impl->fillStruct(fpxregs);
+					setFPXRegsSupported = (ptrace(PTRACE_SETFPXREGS, tid_, 0, &fpxregs) != -1);
+					setFPUDone          = setFPXRegsSupported;
+				}
+
+				if (!setFPXRegsSupported) {
+					// No SETFPXREGS: on x86 this means SSE is not supported
+					//                on x86_64 FPREGS already contain SSE state
+					// Just set fpregs then
+					struct user_fpregs_struct fpregs;
+					state_impl->fillStruct(fpregs);
+					if (ptrace(PTRACE_SETFPREGS, tid_, 0, &fpregs) == -1) {
+						perror("PTRACE_SETFPREGS failed");
+					} else {
+						setFPUDone = true;
+					}
 				}
 			}
+
+			if (setFPUDone) {
+				dirty &= ~PlatformState::REG_CLASS_FPU;
+			}
 		}
+
+		// the thread now matches the state (except for anything which failed
+		// to be written), so writing it again is free until either changes
+		state_impl->setSource(tid_, core_->resumeCount_, stateWrites_, dirty);
 	}
 }
 
@@ -318,8 +364,19 @@ edb::address_t PlatformThread::instructionPointer() const {
  * @return
  */
 unsigned long PlatformThread::getDebugRegister(std::size_t n) {
-	size_t drOffset = offsetof(struct user, u_debugreg) + n * sizeof(user::u_debugreg[0]);
-	return ptrace(PTRACE_PEEKUSER, tid_, drOffset, 0);
+
+	// NOTE(eteran): DR6 is updated by the CPU whenever a debug exception
+	// occurs, so unlike the others, it can't be cached
+	if (n != 6 && (debugRegistersCached_ & (1u << n))) {
+		return debugRegisters_[n];
+	}
+
+	size_t drOffset     = offsetof(struct user, u_debugreg) + n * sizeof(user::u_debugreg[0]);
+	unsigned long value = ptrace(PTRACE_PEEKUSER, tid_, drOffset, 0);
+
+	debugRegisters_[n] = value;
+	debugRegistersCached_ |= (1u << n);
+	return value;
 }
 
 /**
@@ -329,13 +386,58 @@ unsigned long PlatformThread::getDebugRegister(std::size_t n) {
  * @return
  */
 long PlatformThread::setDebugRegister(std::size_t n, unsigned long value) {
+
+	if (n != 6 && (debugRegistersCached_ & (1u << n)) && debugRegisters_[n] == value) {
+		return 0;
+	}
+
 	size_t drOffset = offsetof(struct user, u_debugreg) + n * sizeof(user::u_debugreg[0]);
-	return ptrace(PTRACE_POKEUSER, tid_, drOffset, value);
+	long ret        = ptrace(PTRACE_POKEUSER, tid_, drOffset, value);
+	if (ret != -1) {
+		debugRegisters_[n] = value;
+		debugRegistersCached_ |= (1u << n);
+	} else {
+		debugRegistersCached_ &= ~(1u << n);
+	}
+	return ret;
+}
+
+/**
+ * @brief PlatformThread::initDebugRegisters
+ *
+ * Sets up the debug registers of a thread which was just created. A new
+ * thread doesn't inherit any hardware breakpoints, so its registers are all
+ * known to be zero, and only the non-zero ones of <values> need writing.
+ * DR7 is written last so that no breakpoint is enabled before its address is
+ * in place.
+ *
+ * @param values
+ */
+void PlatformThread::initDebugRegisters(const std::array<unsigned long, 8> &values) {
+
+	debugRegisters_.fill(0);
+	debugRegistersCached_ = 0xff;
+
+	for (std::size_t n : {0, 1, 2, 3, 7}) {
+		if (values[n] != 0) {
+			setDebugRegister(n, values[n]);
+		}
+	}
+}
+
+/**
+ * @brief PlatformThread::invalidateDebugRegisters
+ *
+ * Forgets the cached debug registers, for when the kernel may have reset them
+ * behind our back, such as on exec or once we detached.
+ */
+void PlatformThread::invalidateDebugRegisters() {
+	debugRegistersCached_ = 0;
 }
 
 /**
  * steps this thread one instruction, passing the signal that stopped it
- * (unless the signal was SIGSTOP)
+ * (unless it stopped for a ptrace event rather than a signal)
  *
  * @brief PlatformThread::step
  * @return
@@ -346,7 +448,7 @@ Status PlatformThread::step() {
 
 /**
  * steps this thread one instruction, passing the signal that stopped it
- * (unless the signal was SIGSTOP, or the passed status != DEBUG_EXCEPTION_NOT_HANDLED)
+ * (unless it stopped for a ptrace event, or the passed status != DEBUG_EXCEPTION_NOT_HANDLED)
  *
  * @brief PlatformThread::step
  * @param status
@@ -400,6 +400,23 @@ QMap<edb::pid_t, std::shared_ptr<IProcess>> DebuggerCore::enumerateProcesses() c
 	return ret;
 }
 
+/**
+ * @brief DebuggerCore::enumerateProcessInfo
+ * @return
+ */
+QMap<edb::pid_t, ProcessInfo> DebuggerCore::enumerateProcessInfo() const {
+	QMap<edb::pid_t, ProcessInfo> ret;
+
+	// TODO(eteran): query the toolhelp snapshot directly instead of opening
+	// every process
+	const QMap<edb::pid_t, std::shared_ptr<IProcess>> processes = enumerateProcesses();
+	for (const std::shared_ptr<IProcess> &process : processes) {
+		ret.insert(process->pid(), ProcessInfo{process->pid(), process->uid(), process->user(), process->name()});
+	}
+
+	return ret;
+}
+
 /**
  * @brief DebuggerCore::parentPid
  * @param pid
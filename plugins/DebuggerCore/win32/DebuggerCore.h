@@ -97,6 +97,7 @@ public:
 
 private:
 	QMap<edb::pid_t, std::shared_ptr<IProcess>> enumerateProcesses() const override;
+	QMap<edb::pid_t, ProcessInfo> enumerateProcessInfo() const override;
 
 public:
 	QString stackPointer() const override;
@@ -107,9 +108,13 @@ public:
 		return "";
 	}
 
-	void setIgnoredExceptions(const QList<qlonglong> &exceptions) override {
-		Q_UNUSED(exceptions)
-		qDebug("TODO: Implement DebuggerCore::set_ignored_exceptions");
+	void setExceptionDispositions(const QMap<qlonglong, ExceptionDisposition> &dispositions) override {
+		Q_UNUSED(dispositions)
+		qDebug("TODO: Implement DebuggerCore::setExceptionDispositions");
+	}
+
+	QMap<qlonglong, uint64_t> passedExceptionCounts() const override {
+		return {};
 	}
 
 public:
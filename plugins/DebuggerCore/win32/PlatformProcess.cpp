@@ -609,6 +609,64 @@ Status PlatformProcess::step(edb::EventStatus status) {
 	return Status::Ok;
 }
 
+/**
+ * @brief PlatformProcess::pause
+ *
+ * Windows reports every debug event with the whole process stopped, so single
+ * threads can't be paused on their own.
+ *
+ * @param thread
+ * @return
+ */
+Status PlatformProcess::pause(IThread &thread) {
+	Q_UNUSED(thread)
+	return Status("Pausing a single thread is not supported");
+}
+
+/**
+ * @brief PlatformProcess::resume
+ * @param thread
+ * @param status
+ * @return
+ */
+Status PlatformProcess::resume(IThread &thread, edb::EventStatus status) {
+	return thread.resume(status);
+}
+
+/**
+ * @brief PlatformProcess::step
+ * @param thread
+ * @param status
+ * @return
+ */
+Status PlatformProcess::step(IThread &thread, edb::EventStatus status) {
+	return thread.step(status);
+}
+
+/**
+ * @brief PlatformProcess::stepOverBreakpoint
+ * @param thread
+ * @param status
+ * @return
+ */
+Status PlatformProcess::stepOverBreakpoint(IThread &thread, edb::EventStatus status) {
+	Q_UNUSED(thread)
+	Q_UNUSED(status)
+	return Status("Stepping over a breakpoint in place is not supported");
+}
+
+/**
+ * @brief PlatformProcess::runOverBreakpoint
+ * @param thread
+ * @param status
+ * @return
+ */
+Status PlatformProcess::runOverBreakpoint(IThread &thread, edb::EventStatus status) {
+	Q_UNUSED(thread)
+	Q_UNUSED(status)
+	return Status("Stepping over a breakpoint in place is not supported");
+}
+
 bool PlatformProcess::isPaused() const {
 	for (auto &thread : threads()) {
 		if (!thread->isPaused()) {
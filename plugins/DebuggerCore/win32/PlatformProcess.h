@@ -109,6 +109,11 @@ public:
 
 	Status resume(edb::EventStatus status) override;
 	Status step(edb::EventStatus status) override;
+	Status pause(IThread &thread) override;
+	Status resume(IThread &thread, edb::EventStatus status) override;
+	Status step(IThread &thread, edb::EventStatus status) override;
+	Status stepOverBreakpoint(IThread &thread, edb::EventStatus status) override;
+	Status runOverBreakpoint(IThread &thread, edb::EventStatus status) override;
 	bool isPaused() const override;
 	QMap<edb::address_t, Patch> patches() const override;
 
@@ -23,12 +23,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "edb.h"
 
 #include <QDialog>
+#include <QFutureWatcher>
 #include <QHeaderView>
 #include <QMenu>
 #include <QMessageBox>
 #include <QPushButton>
 #include <QSortFilterProxyModel>
 
+#include <vector>
+
 namespace FunctionFinderPlugin {
 
 /**
@@ -46,13 +49,7 @@ DialogFunctions::DialogFunctions(QWidget *parent, Qt::WindowFlags f)
 	connect(ui.txtSearch, &QLineEdit::textChanged, filterModel_, &QSortFilterProxyModel::setFilterFixedString);
 
 	buttonFind_ = new QPushButton(QIcon::fromTheme("edit-find"), tr("Find"));
-	connect(buttonFind_, &QPushButton::clicked, this, [this]() {
-		buttonFind_->setEnabled(false);
-		ui.progressBar->setValue(0);
-		doFind();
-		ui.progressBar->setValue(100);
-		buttonFind_->setEnabled(true);
-	});
+	connect(buttonFind_, &QPushButton::clicked, this, &DialogFunctions::doFind);
 
 	ui.buttonBox->addButton(buttonFind_, QDialogButtonBox::ActionRole);
 }
@@ -70,6 +67,9 @@ void DialogFunctions::showEvent(QShowEvent *) {
 
 /**
  * @brief DialogFunctions::doFind
+ *
+ * Starts the analysis of the selected regions, the results are shown once
+ * all of them are done.
  */
 void DialogFunctions::doFind() {
 
@@ -82,40 +82,71 @@ void DialogFunctions::doFind() {
 			return;
 		}
 
-		auto analyzer_object = dynamic_cast<QObject *>(analyzer);
-		if (analyzer_object) {
+		buttonFind_->setEnabled(false);
+		ui.progressBar->setValue(0);
+
+		if (auto analyzer_object = dynamic_cast<QObject *>(analyzer)) {
 			connect(analyzer_object, SIGNAL(updateProgress(int)), ui.progressBar, SLOT(setValue(int)));
 		}
 
-		auto resultsDialog = new DialogResults(this);
-
+		std::vector<std::shared_ptr<IRegion>> regions;
 		for (const QModelIndex &selected_item : sel) {
-
 			const QModelIndex index = filterModel_->mapToSource(selected_item);
-
-			// do the search for this region!
 			if (auto region = *reinterpret_cast<const std::shared_ptr<IRegion> *>(index.internalPointer())) {
+				regions.push_back(region);
+			}
+		}
 
-				analyzer->analyze(region);
-
-				const IAnalyzer::FunctionMap &results = analyzer->functions(region);
-				for (const Function &function : results) {
-					resultsDialog->addResult(function);
+		// they all run in the background, the last one to finish shows the results
+		auto remaining = std::make_shared<size_t>(regions.size());
+		for (const std::shared_ptr<IRegion> &region : regions) {
+			auto watcher = new QFutureWatcher<void>(this);
+			connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, remaining, regions]() {
+				watcher->deleteLater();
+				if (--*remaining == 0) {
+					showResults(regions);
 				}
-			}
+			});
+
+			watcher->setFuture(analyzer->analyze(region));
 		}
 
-		if (resultsDialog->resultCount() == 0) {
-			QMessageBox::information(this, tr("No Results"), tr("No Functions Found!"));
-			delete resultsDialog;
-		} else {
-			resultsDialog->show();
+		if (regions.empty()) {
+			showResults(regions);
 		}
+	}
+}
+
+/**
+ * @brief DialogFunctions::showResults
+ * @param regions
+ */
+void DialogFunctions::showResults(const std::vector<std::shared_ptr<IRegion>> &regions) {
+
+	IAnalyzer *const analyzer = edb::v1::analyzer();
 
-		if (analyzer_object) {
-			disconnect(analyzer_object, SIGNAL(updateProgress(int)), ui.progressBar, SLOT(setValue(int)));
+	if (auto analyzer_object = dynamic_cast<QObject *>(analyzer)) {
+		disconnect(analyzer_object, SIGNAL(updateProgress(int)), ui.progressBar, SLOT(setValue(int)));
+	}
+
+	ui.progressBar->setValue(100);
+	buttonFind_->setEnabled(true);
+
+	auto resultsDialog = new DialogResults(this);
+
+	for (const std::shared_ptr<IRegion> &region : regions) {
+		const IAnalyzer::FunctionMap &results = analyzer->functions(region);
+		for (const Function &function : results) {
+			resultsDialog->addResult(function);
 		}
 	}
+
+	if (resultsDialog->resultCount() == 0) {
+		QMessageBox::information(this, tr("No Results"), tr("No Functions Found!"));
+		delete resultsDialog;
+	} else {
+		resultsDialog->show();
+	}
 }
 
 }
@@ -22,7 +22,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Types.h"
 #include "ui_DialogFunctions.h"
 #include <QDialog>
+#include <memory>
+#include <vector>
 
+class IRegion;
 class QSortFilterProxyModel;
 
 namespace FunctionFinderPlugin {
@@ -39,6 +42,7 @@ private:
 
 private:
 	void doFind();
+	void showResults(const std::vector<std::shared_ptr<IRegion>> &regions);
 
 private:
 	Ui::DialogFunctions ui;
@@ -72,11 +72,9 @@ DialogResults::DialogResults(QWidget *parent, Qt::WindowFlags f)
 				const edb::address_t addr = item->startAddress;
 
 				if (IAnalyzer *const analyzer = edb::v1::analyzer()) {
-					const IAnalyzer::FunctionMap &functions = analyzer->functions();
-
-					auto it = functions.find(addr);
-					if (it != functions.end()) {
-						Function f = *it;
+					const Function *const function = analyzer->findFunction(addr);
+					if (function && function->entryAddress() == addr) {
+						const Function &f = *function;
 
 						auto graph = new GraphWidget(nullptr);
 						graph->setAttribute(Qt::WA_DeleteOnClose);
@@ -23,13 +23,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "IProcess.h"
 #include "IThread.h"
 #include "State.h"
+#include "Status.h"
 #include "edb.h"
 
+#include <QCheckBox>
 #include <QDialog>
 #include <QMenu>
 #include <QMessageBox>
+#include <QSettings>
 #include <QtDebug>
 
+#include <array>
+
 #include "ui_DialogHwBreakpoints.h"
 
 // TODO: at the moment, nearly this entire file is x86/x86-64 specific
@@ -41,6 +46,23 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #endif
 
 namespace HardwareBreakpointsPlugin {
+namespace {
+
+/**
+ * @brief debug_registers
+ * @param state
+ * @return the debug registers of <state> which make up its hardware
+ * breakpoints
+ */
+std::array<edb::reg_t, 8> debug_registers(const State &state) {
+	std::array<edb::reg_t, 8> values = {};
+	for (std::size_t n : {0, 1, 2, 3, 7}) {
+		values[n] = state.debugRegister(n);
+	}
+	return values;
+}
+
+}
 
 /**
  * @brief HardwareBreakpoints::HardwareBreakpoints
@@ -172,6 +194,10 @@ void HardwareBreakpoints::setupBreakpoints() {
 				}
 			}
 
+			// every thread ends up with the same hardware breakpoints, and so
+			// do the ones created later on
+			std::array<edb::reg_t, 8> debugRegisters = {};
+
 			for (std::shared_ptr<IThread> &thread : process->threads()) {
 				State state;
 				thread->getState(&state);
@@ -189,8 +215,11 @@ void HardwareBreakpoints::setupBreakpoints() {
 				}
 
 				thread->setState(state);
+				debugRegisters = debug_registers(state);
 			}
 
+			edb::v1::debugger_core->setDebugRegisterTemplate(debugRegisters);
+
 		} else {
 
 			for (std::shared_ptr<IThread> &thread : process->threads()) {
@@ -199,6 +228,8 @@ void HardwareBreakpoints::setupBreakpoints() {
 				state.setDebugRegister(7, 0);
 				thread->setState(state);
 			}
+
+			edb::v1::debugger_core->setDebugRegisterTemplate({});
 		}
 	}
 
@@ -307,11 +338,23 @@ QList<QAction *> HardwareBreakpoints::dataContextMenu() {
 	wo3->setData(2);
 	wo4->setData(2);
 
+	const QString watch_limitation = tr("Accesses made by the kernel on behalf of a system call aren't caught, the system call fails with EFAULT instead");
+
+	auto watch_menu = new QMenu(tr("Software Watchpoints"));
+	watch_menu->setToolTipsVisible(true);
+	watch_menu->addAction(tr("Watch Selection, On Write"), this, SLOT(watchWrite()))->setToolTip(watch_limitation);
+	watch_menu->addAction(tr("Watch Selection, On Read/Write"), this, SLOT(watchReadWrite()))->setToolTip(watch_limitation);
+	watch_menu->addAction(tr("Remove Watchpoint"), this, SLOT(removeWatchpoint()));
+
 	QList<QAction *> ret;
 
 	auto action = new QAction(tr("Hardware Breakpoints"), this);
 	action->setMenu(menu);
 	ret << action;
+
+	auto watch_action = new QAction(tr("Software Watchpoints"), this);
+	watch_action->setMenu(watch_menu);
+	ret << watch_action;
 	return ret;
 }
 
@@ -386,12 +429,16 @@ void HardwareBreakpoints::setExecuteBP(int index, bool inUse) {
 
 		edb::address_t address = edb::v1::cpu_selected_address();
 
+		std::array<edb::reg_t, 8> debugRegisters = {};
 		for (std::shared_ptr<IThread> &thread : process->threads()) {
 			State state;
 			thread->getState(&state);
 			set_breakpoint_state(&state, index, {true, address, 0, 0});
 			thread->setState(state);
+			debugRegisters = debug_registers(state);
 		}
+
+		edb::v1::debugger_core->setDebugRegisterTemplate(debugRegisters);
 	}
 
 	edb::v1::update_ui();
@@ -423,6 +470,7 @@ void HardwareBreakpoints::setWriteBP(int index, bool inUse, edb::address_t addre
 			}
 		}
 
+		std::array<edb::reg_t, 8> debugRegisters = {};
 		for (std::shared_ptr<IThread> &thread : process->threads()) {
 			State state;
 			thread->getState(&state);
@@ -446,7 +494,10 @@ void HardwareBreakpoints::setWriteBP(int index, bool inUse, edb::address_t addre
 			}
 
 			thread->setState(state);
+			debugRegisters = debug_registers(state);
 		}
+
+		edb::v1::debugger_core->setDebugRegisterTemplate(debugRegisters);
 	}
 
 	edb::v1::update_ui();
@@ -482,6 +533,7 @@ void HardwareBreakpoints::setReadWriteBP(int index, bool inUse, edb::address_t a
 			}
 		}
 
+		std::array<edb::reg_t, 8> debugRegisters = {};
 		for (std::shared_ptr<IThread> &thread : process->threads()) {
 			State state;
 			thread->getState(&state);
@@ -505,7 +557,10 @@ void HardwareBreakpoints::setReadWriteBP(int index, bool inUse, edb::address_t a
 			}
 
 			thread->setState(state);
+			debugRegisters = debug_registers(state);
 		}
+
+		edb::v1::debugger_core->setDebugRegisterTemplate(debugRegisters);
 	}
 
 	edb::v1::update_ui();
@@ -724,4 +779,73 @@ void HardwareBreakpoints::setWrite4() {
 	setWrite(Register4);
 }
 
+/**
+ * @brief HardwareBreakpoints::setWatchpoint
+ *
+ * Watches the selection in the data view by protecting the pages it is on,
+ * this isn't limited to 4 ranges of up to 8 bytes like the debug registers
+ *
+ * @param type
+ */
+void HardwareBreakpoints::setWatchpoint(IDebugger::WatchpointType type) {
+
+	const edb::address_t address = edb::v1::selected_data_address();
+	const size_t size            = edb::v1::selected_data_size();
+
+	if (Status status = edb::v1::debugger_core->addWatchpoint(address, size, type); !status) {
+		QMessageBox::critical(nullptr, tr("Unable To Set Watchpoint"), status.error());
+		return;
+	}
+
+	// NOTE(eteran): the kernel doesn't fault when a system call touches a
+	// protected page, it just fails the call. So the user has to know that a
+	// watched buffer handed to read() and the like behaves differently
+	QSettings settings;
+	if (settings.value("HardwareBreakpoints/warn_on_watchpoint_syscalls.enabled", true).toBool()) {
+		QMessageBox message(
+			QMessageBox::Information,
+			tr("Software Watchpoints"),
+			tr("Software watchpoints only catch accesses made by the program itself. When a system call accesses a watched page, such as read() filling a watched buffer, no watchpoint triggers and the system call fails with EFAULT instead, which the program may not expect."));
+
+		auto dont_warn = new QCheckBox(tr("Don't show this again"));
+		message.setCheckBox(dont_warn);
+		message.exec();
+
+		settings.setValue("HardwareBreakpoints/warn_on_watchpoint_syscalls.enabled", !dont_warn->isChecked());
+	}
+}
+
+/**
+ * @brief HardwareBreakpoints::watchWrite
+ */
+void HardwareBreakpoints::watchWrite() {
+	setWatchpoint(IDebugger::WatchpointType::Write);
+}
+
+/**
+ * @brief HardwareBreakpoints::watchReadWrite
+ */
+void HardwareBreakpoints::watchReadWrite() {
+	setWatchpoint(IDebugger::WatchpointType::ReadWrite);
+}
+
+/**
+ * @brief HardwareBreakpoints::removeWatchpoint
+ *
+ * Removes the watchpoint covering the selected address
+ */
+void HardwareBreakpoints::removeWatchpoint() {
+
+	const edb::address_t address = edb::v1::selected_data_address();
+
+	for (const IDebugger::Watchpoint &watchpoint : edb::v1::debugger_core->watchpoints()) {
+		if (address >= watchpoint.address && address < watchpoint.address + watchpoint.size) {
+			if (Status status = edb::v1::debugger_core->removeWatchpoint(watchpoint.address); !status) {
+				QMessageBox::critical(nullptr, tr("Unable To Remove Watchpoint"), status.error());
+			}
+			return;
+		}
+	}
+}
+
 }
@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define HARDWARE_BREAKPOINTS_H_20080228_
 
 #include "IDebugEventHandler.h"
+#include "IDebugger.h"
 #include "IPlugin.h"
 #include "libHardwareBreakpoints.h"
 
@@ -72,6 +73,7 @@ private:
 	void setExec(int index);
 	void setWrite(int index);
 	void setAccess(int index);
+	void setWatchpoint(IDebugger::WatchpointType type);
 
 private Q_SLOTS:
 	void setWrite1();
@@ -89,6 +91,10 @@ private Q_SLOTS:
 	void setExec3();
 	void setExec4();
 
+	void watchWrite();
+	void watchReadWrite();
+	void removeWatchpoint();
+
 private:
 	QMenu *menu_              = nullptr;
 	QPointer<QDialog> dialog_ = nullptr;
@@ -184,8 +184,6 @@ DialogHeap::DialogHeap(QWidget *parent, Qt::WindowFlags f)
 
 	connect(buttonGraph_, &QPushButton::clicked, this, [this]() {
 #ifdef ENABLE_GRAPH
-		constexpr int MaxNodes = 5000;
-
 		auto graph = new GraphWidget(nullptr);
 		graph->setAttribute(Qt::WA_DeleteOnClose);
 
@@ -225,12 +223,6 @@ DialogHeap::DialogHeap(QWidget *parent, Qt::WindowFlags f)
 			}
 			qDebug("[Heap Analyzer] Done Processing %d Nodes", nodes.size());
 
-			if (nodes.size() > MaxNodes) {
-				qDebug("[Heap Analyzer] Too Many Nodes! (%d)", nodes.size());
-				delete graph;
-				return;
-			}
-
 			Q_FOREACH (const ResultViewModel::Result *result, result_map) {
 				const edb::address_t addr = result->address;
 				if (nodes.contains(addr)) {
@@ -0,0 +1,236 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DialogProfiler.h"
+#include "IAnalyzer.h"
+#include "IDebugger.h"
+#include "IProcess.h"
+#include "ISymbolManager.h"
+#include "InterruptSampler.h"
+#include "ProfileModel.h"
+#include "Symbol.h"
+#include "edb.h"
+
+#include <QDebug>
+#include <QHeaderView>
+#include <QSortFilterProxyModel>
+#include <QTimer>
+
+namespace ProfilerPlugin {
+namespace {
+
+// how often the table and the heat in the disassembly view are updated
+constexpr int RefreshInterval = 500;
+
+}
+
+/**
+ * @brief DialogProfiler::DialogProfiler
+ * @param parent
+ * @param f
+ */
+DialogProfiler::DialogProfiler(QWidget *parent, Qt::WindowFlags f)
+	: QDialog(parent, f) {
+
+	ui.setupUi(this);
+	ui.tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+	model_ = new ProfileModel(this);
+
+	filterModel_ = new QSortFilterProxyModel(this);
+	filterModel_->setFilterKeyColumn(ProfileModel::ColumnSymbol);
+	filterModel_->setSortRole(ProfileModel::SortRole);
+	filterModel_->setSourceModel(model_);
+	connect(ui.textFilter, &QLineEdit::textChanged, filterModel_, &QSortFilterProxyModel::setFilterFixedString);
+	ui.tableView->setModel(filterModel_);
+	ui.tableView->sortByColumn(ProfileModel::ColumnSamples, Qt::DescendingOrder);
+
+	interruptSampler_ = new InterruptSampler(this);
+
+	refreshTimer_ = new QTimer(this);
+	refreshTimer_->setInterval(RefreshInterval);
+	connect(refreshTimer_, &QTimer::timeout, this, &DialogProfiler::refresh);
+
+	ui.buttonStop->setEnabled(false);
+}
+
+/**
+ * @brief DialogProfiler::~DialogProfiler
+ */
+DialogProfiler::~DialogProfiler() {
+	if (sampler_) {
+		sampler_->stop();
+	}
+}
+
+/**
+ * @brief DialogProfiler::on_buttonStart_clicked
+ *
+ * Samples with perf if the kernel lets us and falls back to interrupting the
+ * debuggee otherwise.
+ */
+void DialogProfiler::on_buttonStart_clicked() {
+
+	IProcess *process = edb::v1::debugger_core ? edb::v1::debugger_core->process() : nullptr;
+	if (!process) {
+		ui.labelStatus->setText(tr("No process is being debugged"));
+		return;
+	}
+
+	functionCache_.clear();
+	model_->clear();
+	edb::v1::set_instruction_heat({});
+
+	sampler_ = &perfSampler_;
+
+	Status status = perfSampler_.start(process->pid());
+	if (!status) {
+		qDebug() << "[Profiler]" << status.error() << "falling back to interrupts";
+
+		sampler_ = interruptSampler_;
+		status   = interruptSampler_->start(process->pid());
+	}
+
+	if (!status) {
+		sampler_ = nullptr;
+		ui.labelStatus->setText(status.error());
+		return;
+	}
+
+	ui.labelStatus->setText(tr("Sampling using %1...").arg(sampler_->name()));
+	ui.buttonStart->setEnabled(false);
+	ui.buttonStop->setEnabled(true);
+	refreshTimer_->start();
+}
+
+/**
+ * @brief DialogProfiler::on_buttonStop_clicked
+ */
+void DialogProfiler::on_buttonStop_clicked() {
+	stopSampling();
+}
+
+/**
+ * @brief DialogProfiler::on_tableView_doubleClicked
+ * @param index
+ */
+void DialogProfiler::on_tableView_doubleClicked(const QModelIndex &index) {
+
+	if (index.isValid()) {
+		const QModelIndex realIndex = filterModel_->mapToSource(index);
+		if (auto item = static_cast<ProfileModel::Result *>(realIndex.internalPointer())) {
+			edb::v1::jump_to_address(item->address);
+		}
+	}
+}
+
+/**
+ * @brief DialogProfiler::stopSampling
+ */
+void DialogProfiler::stopSampling() {
+
+	refreshTimer_->stop();
+
+	if (sampler_) {
+		sampler_->stop();
+		refresh();
+	}
+
+	ui.buttonStart->setEnabled(true);
+	ui.buttonStop->setEnabled(false);
+}
+
+/**
+ * @brief DialogProfiler::containingFunction
+ *
+ * Prefers the analyzer's idea of a function, falls back to the symbol the
+ * address lies in, and failing that the address stands on its own.
+ *
+ * @param address
+ * @return
+ */
+edb::address_t DialogProfiler::containingFunction(edb::address_t address) {
+
+	auto it = functionCache_.find(address);
+	if (it != functionCache_.end()) {
+		return *it;
+	}
+
+	edb::address_t function = address;
+
+	if (IAnalyzer *analyzer = edb::v1::analyzer()) {
+		if (Result<edb::address_t, QString> function_address = analyzer->findContainingFunction(address)) {
+			functionCache_.insert(address, *function_address);
+			return *function_address;
+		}
+	}
+
+	if (const std::shared_ptr<Symbol> symbol = edb::v1::symbol_manager().findNearSymbol(address)) {
+		function = symbol->address;
+	}
+
+	functionCache_.insert(address, function);
+	return function;
+}
+
+/**
+ * @brief DialogProfiler::refresh
+ *
+ * Totals the samples taken so far per function and shows them.
+ */
+void DialogProfiler::refresh() {
+
+	if (!sampler_) {
+		return;
+	}
+
+	const QHash<edb::address_t, uint64_t> samples = sampler_->samples();
+
+	QHash<edb::address_t, ProfileModel::Result> functions;
+	uint64_t total = 0;
+
+	for (auto it = samples.begin(); it != samples.end(); ++it) {
+		const edb::address_t function = containingFunction(it.key());
+
+		ProfileModel::Result &result = functions[function];
+		result.address               = function;
+
+		result.samples += it.value();
+		total += it.value();
+	}
+
+	QVector<ProfileModel::Result> results;
+	results.reserve(functions.size());
+
+	for (ProfileModel::Result &result : functions) {
+		result.symbol = edb::v1::symbol_manager().findAddressName(result.address);
+		results.push_back(result);
+	}
+
+	model_->setResults(results, total);
+	edb::v1::set_instruction_heat(samples);
+
+	ui.labelStatus->setText(tr("%1 samples using %2, %3 lost").arg(total).arg(sampler_->name()).arg(sampler_->lost()));
+
+	// the debuggee went away, there is nothing left to sample
+	if (refreshTimer_->isActive() && !edb::v1::debugger_core->process()) {
+		stopSampling();
+	}
+}
+
+}
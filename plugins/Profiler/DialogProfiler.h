@@ -0,0 +1,66 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DIALOG_PROFILER_H_20261019_
+#define DIALOG_PROFILER_H_20261019_
+
+#include "PerfSampler.h"
+#include "Types.h"
+#include "ui_DialogProfiler.h"
+#include <QDialog>
+#include <QHash>
+
+class QSortFilterProxyModel;
+class QTimer;
+
+namespace ProfilerPlugin {
+
+class InterruptSampler;
+class ProfileModel;
+
+class DialogProfiler : public QDialog {
+	Q_OBJECT
+
+public:
+	explicit DialogProfiler(QWidget *parent = nullptr, Qt::WindowFlags f = Qt::WindowFlags());
+	~DialogProfiler() override;
+
+public Q_SLOTS:
+	void on_buttonStart_clicked();
+	void on_buttonStop_clicked();
+	void on_tableView_doubleClicked(const QModelIndex &index);
+
+private:
+	void refresh();
+	void stopSampling();
+	edb::address_t containingFunction(edb::address_t address);
+
+private:
+	Ui::DialogProfiler ui;
+	ProfileModel *model_                = nullptr;
+	QSortFilterProxyModel *filterModel_ = nullptr;
+	QTimer *refreshTimer_               = nullptr;
+	InterruptSampler *interruptSampler_ = nullptr;
+	Sampler *sampler_                   = nullptr;
+	PerfSampler perfSampler_;
+	QHash<edb::address_t, edb::address_t> functionCache_;
+};
+
+}
+
+#endif
@@ -0,0 +1,161 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "InterruptSampler.h"
+#include "IDebugEvent.h"
+#include "IDebugger.h"
+#include "IProcess.h"
+#include "IThread.h"
+#include "edb.h"
+
+#include <QTimer>
+
+namespace ProfilerPlugin {
+namespace {
+
+// stopping the debuggee is expensive, so sample much less often than perf does
+constexpr int SampleInterval = 10;
+
+}
+
+/**
+ * @brief InterruptSampler::InterruptSampler
+ * @param parent
+ */
+InterruptSampler::InterruptSampler(QObject *parent)
+	: QObject(parent) {
+
+	timer_ = new QTimer(this);
+	timer_->setInterval(SampleInterval);
+	connect(timer_, &QTimer::timeout, this, &InterruptSampler::interrupt);
+}
+
+/**
+ * @brief InterruptSampler::~InterruptSampler
+ */
+InterruptSampler::~InterruptSampler() {
+	stop();
+}
+
+/**
+ * @brief InterruptSampler::name
+ * @return
+ */
+QString InterruptSampler::name() const {
+	return tr("periodic interrupts");
+}
+
+/**
+ * @brief InterruptSampler::start
+ * @param pid
+ * @return
+ */
+Status InterruptSampler::start(edb::pid_t pid) {
+
+	Q_UNUSED(pid)
+
+	stop();
+
+	if (!edb::v1::debugger_core || !edb::v1::debugger_core->process()) {
+		return Status(tr("No process is being debugged"));
+	}
+
+	samples_.clear();
+	lost_ = 0;
+
+	edb::v1::add_debug_event_handler(this);
+	timer_->start();
+	running_ = true;
+	return Status::Ok;
+}
+
+/**
+ * @brief InterruptSampler::stop
+ */
+void InterruptSampler::stop() {
+
+	if (running_) {
+		// NOTE(eteran): a stop we asked for but haven't seen yet will now reach
+		// the debugger, which treats it like the user pausing the process
+		timer_->stop();
+		edb::v1::remove_debug_event_handler(this);
+		running_ = false;
+		pending_ = false;
+	}
+}
+
+/**
+ * @brief InterruptSampler::samples
+ * @return
+ */
+QHash<edb::address_t, uint64_t> InterruptSampler::samples() const {
+	return samples_;
+}
+
+/**
+ * @brief InterruptSampler::lost
+ * @return the number of ticks which were skipped because the previous sample
+ * hadn't been taken yet
+ */
+uint64_t InterruptSampler::lost() const {
+	return lost_;
+}
+
+/**
+ * @brief InterruptSampler::interrupt
+ */
+void InterruptSampler::interrupt() {
+
+	if (pending_) {
+		++lost_;
+		return;
+	}
+
+	if (IProcess *process = edb::v1::debugger_core->process()) {
+		pending_ = process->pause().success();
+	}
+}
+
+/**
+ * @brief InterruptSampler::handleEvent
+ *
+ * Takes the sample once the stop we asked for arrives and lets the debuggee
+ * continue. An event which beats it stops the process just as well, so the
+ * sample is taken then instead, and the event goes on to the other handlers.
+ *
+ * @param event
+ * @return
+ */
+edb::EventStatus InterruptSampler::handleEvent(const std::shared_ptr<IDebugEvent> &event) {
+
+	if (!pending_ || !event->stopped()) {
+		return edb::DEBUG_NEXT_HANDLER;
+	}
+
+	pending_ = false;
+
+	if (IProcess *process = edb::v1::debugger_core->process()) {
+		for (const std::shared_ptr<IThread> &thread : process->threads()) {
+			++samples_[thread->instructionPointer()];
+		}
+	}
+
+	return event->isStop() ? edb::DEBUG_CONTINUE : edb::DEBUG_NEXT_HANDLER;
+}
+
+}
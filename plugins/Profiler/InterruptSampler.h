@@ -0,0 +1,64 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INTERRUPT_SAMPLER_H_20261019_
+#define INTERRUPT_SAMPLER_H_20261019_
+
+#include "IDebugEventHandler.h"
+#include "Sampler.h"
+#include <QObject>
+
+class QTimer;
+
+namespace ProfilerPlugin {
+
+// The fallback for when perf events are unavailable. Stops the debuggee on a
+// timer, records where each of its threads is and lets it run on. This is much
+// slower than perf and only sees the threads while they are stopped, but it
+// works wherever the debugger does.
+class InterruptSampler final : public QObject, public Sampler, public IDebugEventHandler {
+	Q_OBJECT
+
+public:
+	explicit InterruptSampler(QObject *parent = nullptr);
+	~InterruptSampler() override;
+
+public:
+	QString name() const override;
+	Status start(edb::pid_t pid) override;
+	void stop() override;
+	QHash<edb::address_t, uint64_t> samples() const override;
+	uint64_t lost() const override;
+
+public:
+	edb::EventStatus handleEvent(const std::shared_ptr<IDebugEvent> &event) override;
+
+private:
+	void interrupt();
+
+private:
+	QTimer *timer_ = nullptr;
+	bool pending_  = false;
+	bool running_  = false;
+	QHash<edb::address_t, uint64_t> samples_;
+	uint64_t lost_ = 0;
+};
+
+}
+
+#endif
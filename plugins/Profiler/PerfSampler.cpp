@@ -0,0 +1,348 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PerfSampler.h"
+
+#include <QDir>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace ProfilerPlugin {
+namespace {
+
+// how often a second each thread is sampled
+constexpr uint64_t SampleFrequency = 997;
+
+// the size of each ring buffer, must be a power of two
+constexpr size_t DataPages = 64;
+
+// how often the worker looks for threads which were created since it started
+constexpr auto ThreadScanInterval = std::chrono::milliseconds(250);
+
+struct SampleRecord {
+	perf_event_header header;
+	uint64_t ip;
+	uint32_t pid;
+	uint32_t tid;
+};
+
+struct LostRecord {
+	perf_event_header header;
+	uint64_t id;
+	uint64_t lost;
+};
+
+/**
+ * @brief perf_event_open
+ * @param attr
+ * @param tid
+ * @return
+ */
+int perf_event_open(perf_event_attr *attr, edb::tid_t tid) {
+	return static_cast<int>(::syscall(__NR_perf_event_open, attr, tid, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+/**
+ * @brief copy_from_ring
+ *
+ * Copies <n> bytes starting at <offset> out of the ring buffer <data>,
+ * records may wrap around its end.
+ *
+ * @param dest
+ * @param data
+ * @param size
+ * @param offset
+ * @param n
+ */
+void copy_from_ring(void *dest, const uint8_t *data, size_t size, uint64_t offset, size_t n) {
+	const size_t first = offset % size;
+	const size_t chunk = std::min(n, size - first);
+
+	std::memcpy(dest, data + first, chunk);
+	std::memcpy(static_cast<uint8_t *>(dest) + chunk, data, n - chunk);
+}
+
+}
+
+/**
+ * @brief PerfSampler::~PerfSampler
+ */
+PerfSampler::~PerfSampler() {
+	stop();
+}
+
+/**
+ * @brief PerfSampler::name
+ * @return
+ */
+QString PerfSampler::name() const {
+	return tr("perf cpu-clock");
+}
+
+/**
+ * @brief PerfSampler::start
+ *
+ * Opens an event for every thread of <pid>. Fails if the kernel won't let us
+ * open one for the first thread, which is the case without perf support or
+ * when perf_event_paranoid forbids it.
+ *
+ * @param pid
+ * @return
+ */
+Status PerfSampler::start(edb::pid_t pid) {
+
+	stop();
+
+	pid_      = pid;
+	pageSize_ = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	dataSize_ = DataPages * pageSize_;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		samples_.clear();
+		lost_ = 0;
+	}
+
+	const Status status = openEvent(pid);
+	if (!status) {
+		return status;
+	}
+
+	syncThreads();
+
+	running_ = true;
+	worker_  = std::thread(&PerfSampler::run, this);
+	return Status::Ok;
+}
+
+/**
+ * @brief PerfSampler::stop
+ */
+void PerfSampler::stop() {
+
+	running_ = false;
+	if (worker_.joinable()) {
+		worker_.join();
+	}
+
+	for (Event &event : events_) {
+		closeEvent(event);
+	}
+
+	events_.clear();
+}
+
+/**
+ * @brief PerfSampler::samples
+ * @return the number of samples taken at each address so far
+ */
+QHash<edb::address_t, uint64_t> PerfSampler::samples() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return samples_;
+}
+
+/**
+ * @brief PerfSampler::lost
+ * @return the number of samples the kernel dropped because a buffer was full
+ */
+uint64_t PerfSampler::lost() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return lost_;
+}
+
+/**
+ * @brief PerfSampler::openEvent
+ * @param tid
+ * @return
+ */
+Status PerfSampler::openEvent(edb::tid_t tid) {
+
+	perf_event_attr attr = {};
+	attr.size            = sizeof(attr);
+	attr.type            = PERF_TYPE_SOFTWARE;
+	attr.config          = PERF_COUNT_SW_CPU_CLOCK;
+	attr.sample_freq     = SampleFrequency;
+	attr.freq            = 1;
+	attr.sample_type     = PERF_SAMPLE_IP | PERF_SAMPLE_TID;
+	attr.exclude_kernel  = 1;
+	attr.exclude_hv      = 1;
+	attr.wakeup_events   = 64;
+
+	// NOTE(eteran): inherit would cover threads created later on, but the
+	// kernel refuses to map the buffer of an inherited per thread event, so we
+	// open one for each new thread ourselves instead
+	const int fd = perf_event_open(&attr, tid);
+	if (fd == -1) {
+		return Status(tr("perf_event_open failed for thread %1: %2").arg(tid).arg(strerror(errno)));
+	}
+
+	void *const buffer = mmap(nullptr, pageSize_ + dataSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (buffer == MAP_FAILED) {
+		const int err = errno;
+		close(fd);
+		return Status(tr("Unable to map the sample buffer of thread %1: %2").arg(tid).arg(strerror(err)));
+	}
+
+	events_.push_back(Event{tid, fd, buffer});
+	return Status::Ok;
+}
+
+/**
+ * @brief PerfSampler::closeEvent
+ * @param event
+ */
+void PerfSampler::closeEvent(Event &event) {
+	munmap(event.buffer, pageSize_ + dataSize_);
+	close(event.fd);
+}
+
+/**
+ * @brief PerfSampler::syncThreads
+ *
+ * Opens events for the threads of the process which don't have one yet.
+ */
+void PerfSampler::syncThreads() {
+
+	const QStringList tasks = QDir(QString("/proc/%1/task").arg(pid_)).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+
+	for (const QString &task : tasks) {
+		bool ok;
+		const edb::tid_t tid = task.toInt(&ok);
+		if (!ok) {
+			continue;
+		}
+
+		auto it = std::find_if(events_.begin(), events_.end(), [tid](const Event &event) {
+			return event.tid == tid;
+		});
+
+		if (it == events_.end()) {
+			// the thread may have exited since we listed it, so this isn't an error
+			openEvent(tid);
+		}
+	}
+}
+
+/**
+ * @brief PerfSampler::drain
+ *
+ * Reads the records which the kernel wrote into <event>'s buffer since the
+ * last call and hands the space back to it.
+ *
+ * @param event
+ * @param samples
+ * @param lost
+ */
+void PerfSampler::drain(Event &event, QHash<edb::address_t, uint64_t> *samples, uint64_t *lost) {
+
+	auto meta                 = static_cast<perf_event_mmap_page *>(event.buffer);
+	const uint8_t *const data = static_cast<const uint8_t *>(event.buffer) + pageSize_;
+
+	// pairs with the kernel's write barrier, the records are valid up to head
+	const uint64_t head = __atomic_load_n(&meta->data_head, __ATOMIC_ACQUIRE);
+	uint64_t tail       = meta->data_tail;
+
+	while (tail < head) {
+		perf_event_header header;
+		copy_from_ring(&header, data, dataSize_, tail, sizeof(header));
+
+		if (header.size < sizeof(header)) {
+			// shouldn't happen, but don't spin on a corrupt buffer
+			tail = head;
+			break;
+		}
+
+		if (header.type == PERF_RECORD_SAMPLE && header.size >= sizeof(SampleRecord)) {
+			SampleRecord record;
+			copy_from_ring(&record, data, dataSize_, tail, sizeof(record));
+			++(*samples)[record.ip];
+		} else if (header.type == PERF_RECORD_LOST && header.size >= sizeof(LostRecord)) {
+			LostRecord record;
+			copy_from_ring(&record, data, dataSize_, tail, sizeof(record));
+			*lost += record.lost;
+		}
+
+		tail += header.size;
+	}
+
+	// let the kernel reuse the space we've read
+	__atomic_store_n(&meta->data_tail, tail, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief PerfSampler::run
+ *
+ * The worker, sleeps until a buffer has records to read and merges them into
+ * the totals.
+ */
+void PerfSampler::run() {
+
+	auto last_scan = std::chrono::steady_clock::now();
+
+	std::vector<pollfd> fds;
+
+	while (running_) {
+
+		const auto now = std::chrono::steady_clock::now();
+		if (now - last_scan >= ThreadScanInterval) {
+			syncThreads();
+			last_scan = now;
+		}
+
+		fds.clear();
+		for (const Event &event : events_) {
+			fds.push_back(pollfd{event.fd, POLLIN, 0});
+		}
+
+		// the timeout keeps us responsive to stop() and new threads
+		poll(fds.data(), fds.size(), 100);
+
+		QHash<edb::address_t, uint64_t> samples;
+		uint64_t lost = 0;
+
+		for (size_t i = 0; i < events_.size(); ++i) {
+			drain(events_[i], &samples, &lost);
+		}
+
+		// the events of threads which exited won't get any more samples
+		for (size_t i = fds.size(); i-- > 0;) {
+			if (fds[i].revents & POLLHUP) {
+				closeEvent(events_[i]);
+				events_.erase(events_.begin() + static_cast<std::ptrdiff_t>(i));
+			}
+		}
+
+		if (!samples.isEmpty() || lost != 0) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (auto it = samples.begin(); it != samples.end(); ++it) {
+				samples_[it.key()] += it.value();
+			}
+			lost_ += lost;
+		}
+	}
+}
+
+}
@@ -0,0 +1,77 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PERF_SAMPLER_H_20261019_
+#define PERF_SAMPLER_H_20261019_
+
+#include "Sampler.h"
+#include <QCoreApplication>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ProfilerPlugin {
+
+// Samples the debuggee with a software cpu-clock perf event per thread. The
+// kernel writes the samples into a ring buffer per event, which a worker
+// thread drains, so the debuggee is never stopped to take a sample.
+class PerfSampler final : public Sampler {
+	Q_DECLARE_TR_FUNCTIONS(PerfSampler)
+
+public:
+	PerfSampler() = default;
+	~PerfSampler() override;
+
+public:
+	QString name() const override;
+	Status start(edb::pid_t pid) override;
+	void stop() override;
+	QHash<edb::address_t, uint64_t> samples() const override;
+	uint64_t lost() const override;
+
+private:
+	struct Event {
+		edb::tid_t tid;
+		int fd;
+		void *buffer;
+	};
+
+private:
+	Status openEvent(edb::tid_t tid);
+	void closeEvent(Event &event);
+	void syncThreads();
+	void drain(Event &event, QHash<edb::address_t, uint64_t> *samples, uint64_t *lost);
+	void run();
+
+private:
+	edb::pid_t pid_  = 0;
+	size_t pageSize_ = 0;
+	size_t dataSize_ = 0;
+	std::atomic<bool> running_{false};
+	std::thread worker_;
+	std::vector<Event> events_; // only touched by the worker once it runs
+
+	mutable std::mutex mutex_;
+	QHash<edb::address_t, uint64_t> samples_;
+	uint64_t lost_ = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,177 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ProfileModel.h"
+#include "edb.h"
+
+namespace ProfilerPlugin {
+
+/**
+ * @brief ProfileModel::ProfileModel
+ * @param parent
+ */
+ProfileModel::ProfileModel(QObject *parent)
+	: QAbstractItemModel(parent) {
+}
+
+/**
+ * @brief ProfileModel::headerData
+ * @param section
+ * @param orientation
+ * @param role
+ * @return
+ */
+QVariant ProfileModel::headerData(int section, Qt::Orientation orientation, int role) const {
+
+	if (role == Qt::DisplayRole && orientation == Qt::Horizontal) {
+		switch (section) {
+		case ColumnAddress:
+			return tr("Function");
+		case ColumnSymbol:
+			return tr("Symbol");
+		case ColumnSamples:
+			return tr("Samples");
+		case ColumnPercent:
+			return tr("%");
+		}
+	}
+
+	return QVariant();
+}
+
+/**
+ * @brief ProfileModel::data
+ * @param index
+ * @param role
+ * @return
+ */
+QVariant ProfileModel::data(const QModelIndex &index, int role) const {
+
+	if (!index.isValid()) {
+		return QVariant();
+	}
+
+	const Result &result = results_[index.row()];
+	const double percent = total_ ? (100.0 * result.samples) / total_ : 0.0;
+
+	if (role == Qt::DisplayRole) {
+		switch (index.column()) {
+		case ColumnAddress:
+			return edb::v1::format_pointer(result.address);
+		case ColumnSymbol:
+			return result.symbol;
+		case ColumnSamples:
+			return static_cast<quint64>(result.samples);
+		case ColumnPercent:
+			return QString::number(percent, 'f', 2);
+		default:
+			return QVariant();
+		}
+	} else if (role == SortRole) {
+		switch (index.column()) {
+		case ColumnAddress:
+			return static_cast<quint64>(result.address);
+		case ColumnSymbol:
+			return result.symbol;
+		case ColumnSamples:
+		case ColumnPercent:
+			return static_cast<quint64>(result.samples);
+		default:
+			return QVariant();
+		}
+	} else if (role == Qt::TextAlignmentRole) {
+		if (index.column() == ColumnSamples || index.column() == ColumnPercent) {
+			return static_cast<int>(Qt::AlignRight | Qt::AlignVCenter);
+		}
+	}
+
+	return QVariant();
+}
+
+/**
+ * @brief ProfileModel::setResults
+ * @param results
+ * @param total the number of samples taken over all results
+ */
+void ProfileModel::setResults(const QVector<Result> &results, uint64_t total) {
+	beginResetModel();
+	results_ = results;
+	total_   = total;
+	endResetModel();
+}
+
+/**
+ * @brief ProfileModel::clear
+ */
+void ProfileModel::clear() {
+	setResults({}, 0);
+}
+
+/**
+ * @brief ProfileModel::index
+ * @param row
+ * @param column
+ * @param parent
+ * @return
+ */
+QModelIndex ProfileModel::index(int row, int column, const QModelIndex &parent) const {
+
+	Q_UNUSED(parent)
+
+	if (row < 0 || row >= results_.size()) {
+		return QModelIndex();
+	}
+
+	if (column < 0 || column >= ColumnCount) {
+		return QModelIndex();
+	}
+
+	return createIndex(row, column, const_cast<Result *>(&results_[row]));
+}
+
+/**
+ * @brief ProfileModel::parent
+ * @param index
+ * @return
+ */
+QModelIndex ProfileModel::parent(const QModelIndex &index) const {
+	Q_UNUSED(index)
+	return QModelIndex();
+}
+
+/**
+ * @brief ProfileModel::rowCount
+ * @param parent
+ * @return
+ */
+int ProfileModel::rowCount(const QModelIndex &parent) const {
+	Q_UNUSED(parent)
+	return results_.size();
+}
+
+/**
+ * @brief ProfileModel::columnCount
+ * @param parent
+ * @return
+ */
+int ProfileModel::columnCount(const QModelIndex &parent) const {
+	Q_UNUSED(parent)
+	return ColumnCount;
+}
+
+}
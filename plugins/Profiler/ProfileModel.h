@@ -0,0 +1,70 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROFILE_MODEL_H_20261019_
+#define PROFILE_MODEL_H_20261019_
+
+#include "Types.h"
+#include <QAbstractItemModel>
+#include <QVector>
+
+namespace ProfilerPlugin {
+
+class ProfileModel : public QAbstractItemModel {
+	Q_OBJECT
+public:
+	enum Column {
+		ColumnAddress,
+		ColumnSymbol,
+		ColumnSamples,
+		ColumnPercent,
+		ColumnCount
+	};
+
+	// sorting uses the raw values rather than their formatted text
+	static constexpr int SortRole = Qt::UserRole;
+
+	struct Result {
+		edb::address_t address = 0;
+		uint64_t samples       = 0;
+		QString symbol;
+	};
+
+public:
+	explicit ProfileModel(QObject *parent = nullptr);
+
+public:
+	QVariant data(const QModelIndex &index, int role) const override;
+	QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+	QModelIndex parent(const QModelIndex &index) const override;
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+public:
+	void setResults(const QVector<Result> &results, uint64_t total);
+	void clear();
+
+private:
+	QVector<Result> results_;
+	uint64_t total_ = 0;
+};
+
+}
+
+#endif
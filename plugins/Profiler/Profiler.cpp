@@ -0,0 +1,70 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Profiler.h"
+#include "DialogProfiler.h"
+#include "edb.h"
+#include <QMenu>
+
+namespace ProfilerPlugin {
+
+/**
+ * @brief Profiler::Profiler
+ * @param parent
+ */
+Profiler::Profiler(QObject *parent)
+	: QObject(parent) {
+}
+
+/**
+ * @brief Profiler::~Profiler
+ */
+Profiler::~Profiler() {
+	delete dialog_;
+}
+
+/**
+ * @brief Profiler::menu
+ * @param parent
+ * @return
+ */
+QMenu *Profiler::menu(QWidget *parent) {
+
+	Q_ASSERT(parent);
+
+	if (!menu_) {
+		menu_ = new QMenu(tr("Profiler"), parent);
+		menu_->addAction(tr("&Profiler"), this, SLOT(showMenu()));
+	}
+
+	return menu_;
+}
+
+/**
+ * @brief Profiler::showMenu
+ */
+void Profiler::showMenu() {
+
+	if (!dialog_) {
+		dialog_ = new DialogProfiler(edb::v1::debugger_ui);
+	}
+
+	dialog_->show();
+}
+
+}
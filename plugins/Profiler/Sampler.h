@@ -0,0 +1,43 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SAMPLER_H_20261019_
+#define SAMPLER_H_20261019_
+
+#include "Status.h"
+#include "Types.h"
+#include <QHash>
+
+namespace ProfilerPlugin {
+
+// Collects the instruction pointers of the debuggee's threads
+class Sampler {
+public:
+	virtual ~Sampler() = default;
+
+public:
+	virtual QString name() const                            = 0;
+	virtual Status start(edb::pid_t pid)                    = 0;
+	virtual void stop()                                     = 0;
+	virtual QHash<edb::address_t, uint64_t> samples() const = 0;
+	virtual uint64_t lost() const                           = 0;
+};
+
+}
+
+#endif
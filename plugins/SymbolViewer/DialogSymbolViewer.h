@@ -25,7 +25,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 class QModelIndex;
 class QPoint;
-class QSortFilterProxyModel;
 class QStringListModel;
 
 namespace SymbolViewerPlugin {
@@ -55,9 +54,8 @@ private:
 
 private:
 	Ui::DialogSymbolViewer ui;
-	QStringListModel *model_            = nullptr;
-	QSortFilterProxyModel *filterModel_ = nullptr;
-	QPushButton *buttonRefresh_         = nullptr;
+	QStringListModel *model_    = nullptr;
+	QPushButton *buttonRefresh_ = nullptr;
 };
 
 }
@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "IDebugger.h"
 #include "IProcess.h"
 #include "Instruction.h"
+#include "MemorySnapshot.h"
 #include "edb.h"
 
 namespace {
@@ -108,12 +109,18 @@ Result<QString, QString> CommentServer::resolveString(edb::address_t address) co
 
 /**
  * @brief CommentServer::comment
+ *
+ * Words which changed since the previous stop are marked, followed by whatever
+ * they would be commented with anyway.
+ *
  * @param address
  * @param size
  * @return
  */
 QString CommentServer::comment(edb::address_t address, int size) const {
 
+	QString text;
+
 	if (IProcess *process = edb::v1::debugger_core->process()) {
 		// if the view is currently looking at words which are a pointer in size
 		// then see if it points to anything...
@@ -123,17 +130,21 @@ QString CommentServer::comment(edb::address_t address, int size) const {
 
 				auto it = customComments_.find(value);
 				if (it != customComments_.end()) {
-					return it.value();
+					text = it.value();
 				} else {
 					if (Result<QString, QString> ret = resolveFunctionCall(value)) {
-						return *ret;
+						text = *ret;
 					} else if (Result<QString, QString> ret = resolveString(value)) {
-						return *ret;
+						text = *ret;
 					}
 				}
 			}
 		}
+
+		if (edb::v1::memory_changes().changed(address, static_cast<size_t>(size))) {
+			return text.isEmpty() ? tr("[changed]") : tr("[changed] %1").arg(text);
+		}
 	}
 
-	return QString();
+	return text;
 }
@@ -87,6 +87,26 @@ void Configuration::sendChangeNotification() {
 	Q_EMIT settingsUpdated();
 }
 
+//------------------------------------------------------------------------------
+// Name: exceptionDispositions
+// Desc: what the debugger core should do with each exception, anything which
+//       isn't ignored or logged stops
+//------------------------------------------------------------------------------
+QMap<qlonglong, IDebugger::ExceptionDisposition> Configuration::exceptionDispositions() const {
+
+	QMap<qlonglong, IDebugger::ExceptionDisposition> dispositions;
+
+	for (qlonglong exception : ignored_exceptions) {
+		dispositions[exception] = IDebugger::ExceptionDisposition::Pass;
+	}
+
+	for (qlonglong exception : logged_exceptions) {
+		dispositions[exception] = IDebugger::ExceptionDisposition::LogAndPass;
+	}
+
+	return dispositions;
+}
+
 //------------------------------------------------------------------------------
 // Name: read_settings
 // Desc: read in the options from the file
@@ -138,6 +158,7 @@ void Configuration::readSettings() {
 	disableASLR             = settings.value("debugger.disableASLR.enabled", false).toBool();
 	disableLazyBinding      = settings.value("debugger.disableLazyBinding.enabled", false).toBool();
 	break_on_library_load   = settings.value("debugger.break_on_library_load_event.enabled", false).toBool();
+	nonstop_mode            = settings.value("debugger.nonstop.enabled", false).toBool();
 	default_breakpoint_type = settings.value("debugger.default_breakpoint_type", QVariant::fromValue(IBreakpoint::TypeId::Automatic)).value<IBreakpoint::TypeId>();
 	settings.endGroup();
 
@@ -177,6 +198,13 @@ void Configuration::readSettings() {
 		ignored_exceptions.push_back(exception.toLongLong());
 	}
 
+	QVariantList temp_logged_exceptions = settings.value("signals.log_list", QVariantList()).toList();
+
+	logged_exceptions.clear();
+	for (QVariant &exception : temp_logged_exceptions) {
+		logged_exceptions.push_back(exception.toLongLong());
+	}
+
 	settings.endGroup();
 
 	settings.beginGroup("Window");
@@ -254,6 +282,7 @@ void Configuration::writeSettings() {
 	settings.setValue("debugger.disableASLR.enabled", disableASLR);
 	settings.setValue("debugger.disableLazyBinding.enabled", disableLazyBinding);
 	settings.setValue("debugger.break_on_library_load_event.enabled", break_on_library_load);
+	settings.setValue("debugger.nonstop.enabled", nonstop_mode);
 	settings.setValue("debugger.default_breakpoint_type", QVariant::fromValue(default_breakpoint_type));
 	settings.endGroup();
 
@@ -289,6 +318,14 @@ void Configuration::writeSettings() {
 	}
 
 	settings.setValue("signals.ignore_list", temp_ignored_exceptions);
+
+	QVariantList temp_logged_exceptions;
+
+	Q_FOREACH (qlonglong exception, logged_exceptions) {
+		temp_logged_exceptions.push_back(exception);
+	}
+
+	settings.setValue("signals.log_list", temp_logged_exceptions);
 	settings.endGroup();
 
 	settings.beginGroup("Window");
@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "DialogArguments.h"
 #include "DialogAttach.h"
 #include "DialogBreakpoints.h"
+#include "DialogMemoryChanges.h"
 #include "DialogMemoryRegions.h"
 #include "DialogOpenProgram.h"
 #include "DialogOptions.h"
@@ -127,10 +128,9 @@ void handle_library_event(IProcess *process, edb::address_t debug_pointer) {
 
 		switch (dynamic_info.r_state) {
 		case edb::linux_struct::r_debug<Addr>::RT_CONSISTENT:
-			// TODO(eteran): enable this once we are confident
-#if 0
+			// a library was just loaded or unloaded, which is when the
+			// regions and the symbols of the modules change
 			edb::v1::memory_regions().sync();
-#endif
 			break;
 		case edb::linux_struct::r_debug<Addr>::RT_ADD:
 			// qDebug("LIBRARY LOAD EVENT");
@@ -546,6 +546,7 @@ void Debugger::updateMenuState(GuiState state) {
 		ui.action_Run_Pass_Signal_To_Application->setEnabled(true);
 		ui.action_Detach->setEnabled(true);
 		ui.action_Kill->setEnabled(true);
+		ui.action_Generate_Core->setEnabled(true);
 		tabCreate_->setEnabled(true);
 		status_->setText(tr("paused"));
 		status_->repaint();
@@ -563,6 +564,7 @@ void Debugger::updateMenuState(GuiState state) {
 		ui.action_Run_Pass_Signal_To_Application->setEnabled(false);
 		ui.action_Detach->setEnabled(true);
 		ui.action_Kill->setEnabled(true);
+		ui.action_Generate_Core->setEnabled(false);
 		tabCreate_->setEnabled(true);
 		status_->setText(tr("running"));
 		status_->repaint();
@@ -580,10 +582,29 @@ void Debugger::updateMenuState(GuiState state) {
 		ui.action_Run_Pass_Signal_To_Application->setEnabled(false);
 		ui.action_Detach->setEnabled(false);
 		ui.action_Kill->setEnabled(false);
+		ui.action_Generate_Core->setEnabled(false);
 		tabCreate_->setEnabled(false);
 		status_->setText(tr("terminated"));
 		status_->repaint();
 		break;
+	case PostMortem:
+		ui.actionRun_Until_Return->setEnabled(false);
+		ui.action_Restart->setEnabled(false);
+		ui.action_Run->setEnabled(false);
+		ui.action_Pause->setEnabled(false);
+		ui.action_Step_Into->setEnabled(false);
+		ui.action_Step_Over->setEnabled(false);
+		ui.actionStep_Out->setEnabled(false);
+		ui.action_Step_Into_Pass_Signal_To_Application->setEnabled(false);
+		ui.action_Step_Over_Pass_Signal_To_Application->setEnabled(false);
+		ui.action_Run_Pass_Signal_To_Application->setEnabled(false);
+		ui.action_Detach->setEnabled(true);
+		ui.action_Kill->setEnabled(false);
+		ui.action_Generate_Core->setEnabled(false);
+		tabCreate_->setEnabled(true);
+		status_->setText(tr("core file"));
+		status_->repaint();
+		break;
 	}
 
 	guiState_ = state;
@@ -2516,6 +2537,12 @@ edb::EventStatus Debugger::handleEvent(const std::shared_ptr<IDebugEvent> &event
 
 	Q_ASSERT(!(reenableBreakpointStep_ && reenableBreakpointRun_));
 
+	// NOTE(eteran): in non-stop mode, other threads keep running while one
+	// steps off of a breakpoint, so this may be an event for one of them
+	if (event->thread() != reenableBreakpointThread_) {
+		return status;
+	}
+
 	// re-enable any breakpoints we previously disabled
 	if (reenableBreakpointStep_) {
 		reenableBreakpointStep_->enable();
@@ -2649,6 +2676,95 @@ void Debugger::updateDataViews() {
 	}
 }
 
+//------------------------------------------------------------------------------
+// Name: revalidateMemoryRegions
+// Desc: reads the memory regions again if they may have changed since the
+//       debuggee was resumed. The stack is the one region which grows without
+//       a syscall, so a stack pointer outside of any region means that it did.
+//       In non-stop mode the other threads may have changed them while this
+//       one was stopped, so they are always read again
+//------------------------------------------------------------------------------
+void Debugger::revalidateMemoryRegions() {
+
+	MemoryRegions &regions = edb::v1::memory_regions();
+
+	if (edb::v1::config().nonstop_mode) {
+		regions.invalidate();
+	}
+
+	if (!regions.isStale()) {
+		if (IProcess *process = edb::v1::debugger_core->process()) {
+			if (std::shared_ptr<IThread> thread = process->currentThread()) {
+				State state;
+				thread->getState(&state);
+				if (!regions.findRegion(state.stackPointer())) {
+					regions.invalidate();
+				}
+			}
+		}
+	}
+
+	regions.revalidate();
+}
+
+//------------------------------------------------------------------------------
+// Name: regionTracked
+// Desc: returns true if the region starting at <region_start> is snapshotted at
+//       each stop
+//------------------------------------------------------------------------------
+bool Debugger::regionTracked(edb::address_t region_start) const {
+	return trackedRegions_.contains(region_start);
+}
+
+//------------------------------------------------------------------------------
+// Name: setRegionTracked
+// Desc: adds or removes the region starting at <region_start> from the set of
+//       regions which are snapshotted at each stop
+//------------------------------------------------------------------------------
+void Debugger::setRegionTracked(edb::address_t region_start, bool tracked) {
+	if (tracked) {
+		trackedRegions_.insert(region_start);
+	} else {
+		trackedRegions_.remove(region_start);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Name: memoryChanges
+// Desc: returns what changed in the tracked regions between the last two stops
+//------------------------------------------------------------------------------
+const MemoryDiff &Debugger::memoryChanges() const {
+	return memoryChanges_;
+}
+
+//------------------------------------------------------------------------------
+// Name: updateMemoryChanges
+// Desc: snapshots the tracked regions, and finds what changed since the last stop
+//------------------------------------------------------------------------------
+void Debugger::updateMemoryChanges() {
+
+	// NOTE(eteran): this runs on every stop, so unless the user asked for some
+	// regions to be tracked, we don't read any memory at all
+	if (trackedRegions_.isEmpty()) {
+		memorySnapshot_ = nullptr;
+		memoryChanges_  = MemoryDiff();
+		return;
+	}
+
+	QList<std::shared_ptr<IRegion>> regions;
+	for (edb::address_t start : trackedRegions_) {
+		std::shared_ptr<IRegion> region = edb::v1::memory_regions().findRegion(start);
+		if (region && region->start() == start) {
+			regions.push_back(region);
+		}
+	}
+
+	std::shared_ptr<const MemorySnapshot> snapshot = MemorySnapshot::capture(regions, memorySnapshot_);
+
+	memoryChanges_  = memorySnapshot_ ? MemoryDiff(*memorySnapshot_, *snapshot) : MemoryDiff();
+	memorySnapshot_ = snapshot;
+}
+
 //------------------------------------------------------------------------------
 // Name: refresh_gui
 // Desc: refreshes all the different displays
@@ -2735,35 +2851,73 @@ void Debugger::resumeExecution(ExceptionResume pass_exception, DebugMode mode, R
 			// as normal
 			const edb::EventStatus status = resumeStatus(pass_exception == PassException);
 
-			// if we are on a breakpoint, disable it
 			std::shared_ptr<IBreakpoint> bp;
 			if (flags != ResumeFlag::Forced) {
 				State state;
 				thread->getState(&state);
 				bp = edb::v1::debugger_core->findBreakpoint(state.instructionPointer());
-				if (bp) {
-					bp->disable();
-				}
 			}
 
 			edb::v1::arch_processor().aboutToResume();
 
+			// while the process runs it can do anything to its memory map, a
+			// step can only change it through a syscall
+			if (mode == Run) {
+				edb::v1::memory_regions().invalidate();
+			} else {
+				State state;
+				thread->getState(&state);
+
+				const edb::address_t ip = state.instructionPointer();
+				uint8_t buffer[edb::Instruction::MaxSize];
+				if (const int sz = edb::v1::get_instruction_bytes(ip, buffer)) {
+					const edb::Instruction inst(buffer, buffer + sz, ip);
+					if (edb::v1::arch_processor().changesMemoryMap(inst, state)) {
+						edb::v1::memory_regions().invalidate();
+					}
+				}
+			}
+
+			reenableBreakpointThread_ = thread->tid();
+
+			// if we are on a breakpoint, step off of it with the breakpoint left
+			// in place if we can, so that other threads can't run past it
+			// meanwhile. When running, the process then carries on by itself.
+			// Otherwise the breakpoint is disabled for the step
+			bool displaced = false;
+			if (bp) {
+				if (bp->enabled()) {
+					displaced = (mode == Run) ? process->runOverBreakpoint(*thread, status) : process->stepOverBreakpoint(*thread, status);
+				}
+
+				if (!displaced) {
+					bp->disable();
+				}
+			}
+
 			if (mode == Step) {
 				reenableBreakpointStep_ = bp;
-				const auto stepStatus   = thread->step(status);
-				if (!stepStatus) {
-					QMessageBox::critical(this, tr("Error"), tr("Failed to step thread: %1").arg(stepStatus.error()));
-					return;
+				if (!displaced) {
+					const auto stepStatus = thread->step(status);
+					if (!stepStatus) {
+						QMessageBox::critical(this, tr("Error"), tr("Failed to step thread: %1").arg(stepStatus.error()));
+						return;
+					}
 				}
 			} else if (mode == Run) {
-				reenableBreakpointRun_ = bp;
-				if (bp) {
-					const auto stepStatus = thread->step(status);
+				if (displaced) {
+					// nothing left to re-enable, the process is already running
+					reenableBreakpointRun_ = nullptr;
+				} else if (bp) {
+					// once the thread is off of the breakpoint, it is resumed
+					reenableBreakpointRun_ = bp;
+					const auto stepStatus  = thread->step(status);
 					if (!stepStatus) {
 						QMessageBox::critical(this, tr("Error"), tr("Failed to step thread: %1").arg(stepStatus.error()));
 						return;
 					}
 				} else {
+					reenableBreakpointRun_ = nullptr;
 					const auto resumeStatus = process->resume(status);
 					if (!resumeStatus) {
 						QMessageBox::critical(this, tr("Error"), tr("Failed to resume process: %1").arg(resumeStatus.error()));
@@ -2900,6 +3054,10 @@ void Debugger::cleanupDebugger() {
 	Q_ASSERT(!dataRegions_.isEmpty());
 	dataRegions_.first()->region = nullptr;
 
+	trackedRegions_.clear();
+	memorySnapshot_ = nullptr;
+	memoryChanges_  = MemoryDiff();
+
 	Q_EMIT detachEvent();
 
 	setWindowTitle(tr("edb"));
@@ -2989,8 +3147,9 @@ void Debugger::setInitialDebuggerState() {
 		analyzer->invalidateAnalysis();
 	}
 
-	reenableBreakpointRun_  = nullptr;
-	reenableBreakpointStep_ = nullptr;
+	reenableBreakpointRun_    = nullptr;
+	reenableBreakpointStep_   = nullptr;
+	reenableBreakpointThread_ = 0;
 
 #ifdef Q_OS_LINUX
 	debugPointer_             = 0;
@@ -3312,6 +3471,75 @@ void Debugger::on_action_Attach_triggered() {
 	delete dlg;
 }
 
+//------------------------------------------------------------------------------
+// Name: on_action_Open_Core_triggered
+// Desc: inspects the process a core file was dumped from
+//------------------------------------------------------------------------------
+void Debugger::on_action_Open_Core_triggered() {
+
+	const QString filename = QFileDialog::getOpenFileName(this, tr("Choose a core file"), lastOpenDirectory_);
+	if (filename.isEmpty()) {
+		return;
+	}
+
+	// ensure that the previous running process (if any) is dealt with...
+	detachFromProcess(KillOnDetach);
+
+	if (const Status status = edb::v1::debugger_core->openCore(filename)) {
+		attachComplete();
+
+		// a core file never reports any events, so don't wait for them
+		timer_->stop();
+		updateMenuState(PostMortem);
+	} else {
+		QMessageBox::critical(this, tr("Open Core File"), tr("Failed to open the core file: %1").arg(status.error()));
+	}
+
+	updateUi();
+}
+
+//------------------------------------------------------------------------------
+// Name: on_action_Generate_Core_triggered
+// Desc: writes the paused process out as a core file
+//------------------------------------------------------------------------------
+void Debugger::on_action_Generate_Core_triggered() {
+
+	IProcess *process = edb::v1::debugger_core->process();
+	if (!process) {
+		return;
+	}
+
+	const QString filename = QFileDialog::getSaveFileName(this, tr("Save the core file as"), QString("core.%1").arg(process->pid()));
+	if (filename.isEmpty()) {
+		return;
+	}
+
+	// read only file mappings can be read from the files themselves when the
+	// core is opened, leaving them out makes the core much smaller
+	const int ret = QMessageBox::question(this,
+										  tr("Generate Core File"),
+										  tr("Leave out the contents of read only file mappings, such as the code of the executable and its libraries?"),
+										  QMessageBox::Yes | QMessageBox::No,
+										  QMessageBox::Yes);
+
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+	const Status status = edb::v1::debugger_core->generateCore(filename, ret == QMessageBox::Yes);
+	QApplication::restoreOverrideCursor();
+
+	if (!status) {
+		QMessageBox::critical(this, tr("Generate Core File"), tr("Failed to generate the core file: %1").arg(status.error()));
+	}
+}
+
+//------------------------------------------------------------------------------
+// Name: on_action_Memory_Changes_triggered
+// Desc: displays the memory which changed since the debuggee last stopped
+//------------------------------------------------------------------------------
+void Debugger::on_action_Memory_Changes_triggered() {
+	static QPointer<DialogMemoryChanges> dlg = new DialogMemoryChanges(this);
+	dlg->show();
+}
+
 //------------------------------------------------------------------------------
 // Name: on_action_Memory_Regions_triggered
 // Desc: displays the memory regions dialog, and optionally dumps some data
@@ -3530,24 +3758,23 @@ void Debugger::nextDebugEvent() {
 
 	using namespace std::chrono_literals;
 
-	// TODO(eteran): come up with a nice system to inject a debug event
-	//               into the system, for example on windows, we want
-	//               to deliver real "memory map updated" events, but
-	//               on linux, (at least for now), I would want to send
-	//               a fake one before every event so it is always up to
-	//               date.
-
 	Q_ASSERT(edb::v1::debugger_core);
 
 	if (std::shared_ptr<IDebugEvent> e = edb::v1::debugger_core->waitDebugEvent(10ms)) {
 
 		lastEvent_ = e;
 
-		// TODO(eteran): disable this in favor of only doing it on library load events
-		//               once we are confident. We should be able to just enclose it inside
-		//               an "if(!dynamic_info_bp_set_) {" test (since we still want to
-		//               do this when the hook isn't set.
+		// NOTE(eteran): once the dynamic linker's hook is set, the regions are
+		// read again when libraries are loaded, when the process ran or made
+		// a syscall which maps memory, or when a lookup misses. Until then we
+		// can't tell when libraries come and go, so do it for every event
+#if defined(Q_OS_LINUX)
+		if (!dynamicInfoBreakpointSet_) {
+			edb::v1::memory_regions().sync();
+		}
+#else
 		edb::v1::memory_regions().sync();
+#endif
 
 #if defined(Q_OS_LINUX)
 		if (!dynamicInfoBreakpointSet_) {
@@ -3576,6 +3803,8 @@ void Debugger::nextDebugEvent() {
 		const edb::EventStatus status = edb::v1::execute_debug_event_handlers(e);
 		switch (status) {
 		case edb::DEBUG_STOP:
+			revalidateMemoryRegions();
+			updateMemoryChanges();
 			updateUi();
 			updateMenuState(edb::v1::debugger_core->process() ? Paused : Terminated);
 			break;
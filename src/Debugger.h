@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "DataViewInfo.h"
 #include "IDebugEventHandler.h"
+#include "MemorySnapshot.h"
 #include "OSTypes.h"
 #include "QDisassemblyView.h"
 #include "QHexView"
@@ -29,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QDockWidget>
 #include <QMainWindow>
 #include <QProcess>
+#include <QSet>
 #include <QVector>
 
 #include <memory>
@@ -93,7 +95,8 @@ private:
 	enum GuiState {
 		Paused,
 		Running,
-		Terminated
+		Terminated,
+		PostMortem // inspecting a core file, which can't run
 	};
 
 public:
@@ -111,6 +114,9 @@ public:
 	void updateUi();
 	QLabel *statusLabel() const;
 	Register activeRegister() const;
+	bool regionTracked(edb::address_t region_start) const;
+	const MemoryDiff &memoryChanges() const;
+	void setRegionTracked(edb::address_t region_start, bool tracked);
 
 Q_SIGNALS:
 	void uiUpdated();
@@ -132,9 +138,12 @@ public Q_SLOTS:
 	void on_action_Attach_triggered();
 	void on_action_Configure_Debugger_triggered();
 	void on_action_Detach_triggered();
+	void on_action_Generate_Core_triggered();
 	void on_action_Help_triggered();
 	void on_action_Kill_triggered();
+	void on_action_Memory_Changes_triggered();
 	void on_action_Memory_Regions_triggered();
+	void on_action_Open_Core_triggered();
 	void on_action_Open_triggered();
 	void on_action_Pause_triggered();
 	void on_action_Plugins_triggered();
@@ -253,6 +262,7 @@ private:
 	void followRegisterInDump(bool tabbed);
 	void loadSession(const QString &session_file);
 	void resumeExecution(ExceptionResume pass_exception, DebugMode mode, ResumeFlag flags);
+	void revalidateMemoryRegions();
 	void saveSession(const QString &session_file);
 	void setDebuggerCaption(const QString &appname);
 	void setInitialBreakpoint(const QString &s);
@@ -264,6 +274,7 @@ private:
 	void testNativeBinary();
 	void updateDataViews();
 	void updateDisassembly(edb::address_t address, const std::shared_ptr<IRegion> &r);
+	void updateMemoryChanges();
 	void updateMenuState(GuiState state);
 	void updateStackView(const State &state);
 	void updateTabCaption(const std::shared_ptr<QHexView> &view, edb::address_t start, edb::address_t end);
@@ -336,12 +347,18 @@ private:
 	QVector<std::shared_ptr<DataViewInfo>> dataRegions_;
 	std::shared_ptr<IBreakpoint> reenableBreakpointRun_;
 	std::shared_ptr<IBreakpoint> reenableBreakpointStep_;
+	edb::tid_t reenableBreakpointThread_ = 0;
 	std::shared_ptr<CommentServer> commentServer_;
 	std::shared_ptr<QHexView> stackView_;
 	std::shared_ptr<const IDebugEvent> lastEvent_;
 	std::unique_ptr<IBinary> binaryInfo_;
 	QPointer<QDialog> breakpointDialog_ = nullptr;
 
+	// the regions the user asked to watch for changes, by start address
+	QSet<edb::address_t> trackedRegions_;
+	std::shared_ptr<const MemorySnapshot> memorySnapshot_;
+	MemoryDiff memoryChanges_;
+
 private:
 	QAction *gotoAddressAction_;
 	QAction *editCommentAction_;
@@ -18,7 +18,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "DialogAttach.h"
 #include "IDebugger.h"
-#include "IProcess.h"
 #include "ProcessModel.h"
 #include "edb.h"
 #include "util/String.h"
@@ -61,6 +60,8 @@ DialogAttach::DialogAttach(QWidget *parent, Qt::WindowFlags f)
 	processPidFilter_->setFilterKeyColumn(0);
 
 	ui.processes_table->setModel(processPidFilter_);
+
+	connect(&updateTimer_, &QTimer::timeout, this, &DialogAttach::updateList);
 }
 
 //------------------------------------------------------------------------------
@@ -89,31 +90,25 @@ void DialogAttach::updateList() {
 		return;
 	}
 
-	const auto selected_pid = selectedPid();
-
-	processModel_->clear();
-
+	// NOTE(eteran): the model only changes the rows which need it, so there is
+	// no need to restore the selection after an update
 	if (edb::v1::debugger_core) {
-		QMap<edb::pid_t, std::shared_ptr<IProcess>> procs = edb::v1::debugger_core->enumerateProcesses();
-
-		const edb::uid_t user_id = getuid();
-		const bool filterUID     = ui.filter_uid->isChecked();
-
-		for (const std::shared_ptr<IProcess> &process : procs) {
-			if (!filterUID || process->uid() == user_id) {
-				processModel_->addProcess(process);
+		QMap<edb::pid_t, ProcessInfo> procs = edb::v1::debugger_core->enumerateProcessInfo();
+
+		if (ui.filter_uid->isChecked()) {
+			const edb::uid_t user_id = getuid();
+			for (auto it = procs.begin(); it != procs.end();) {
+				if (it->uid != user_id) {
+					it = procs.erase(it);
+				} else {
+					++it;
+				}
 			}
 		}
-	}
 
-	if (selected_pid) {
-		const auto pid          = selected_pid.value();
-		const auto *const model = ui.processes_table->model();
-		for (int row = 0; row < model->rowCount(); ++row) {
-			if (static_cast<edb::pid_t>(model->index(row, 0).data().toUInt()) == pid) {
-				ui.processes_table->selectRow(row);
-			}
-		}
+		processModel_->update(procs);
+	} else {
+		processModel_->clear();
 	}
 }
 
@@ -124,7 +119,6 @@ void DialogAttach::updateList() {
 void DialogAttach::showEvent(QShowEvent *event) {
 	Q_UNUSED(event)
 	updateList();
-	connect(&updateTimer_, &QTimer::timeout, this, &DialogAttach::updateList);
 	updateTimer_.start(1000);
 }
 
@@ -0,0 +1,98 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DialogMemoryChanges.h"
+#include "IRegion.h"
+#include "MemoryRegions.h"
+#include "MemorySnapshot.h"
+#include "edb.h"
+
+#include <QHeaderView>
+#include <QTableWidgetItem>
+
+//------------------------------------------------------------------------------
+// Name: DialogMemoryChanges
+// Desc:
+//------------------------------------------------------------------------------
+DialogMemoryChanges::DialogMemoryChanges(QWidget *parent, Qt::WindowFlags f)
+	: QDialog(parent, f) {
+
+	ui.setupUi(this);
+
+	// NOTE(eteran): the diff is taken before the UI is refreshed, so by the
+	// time uiUpdated fires, it describes the latest stop
+	connect(edb::v1::debugger_ui, SIGNAL(uiUpdated()), this, SLOT(updateChanges()));
+	connect(edb::v1::debugger_ui, SIGNAL(detachEvent()), this, SLOT(updateChanges()));
+}
+
+//------------------------------------------------------------------------------
+// Name: showEvent
+// Desc:
+//------------------------------------------------------------------------------
+void DialogMemoryChanges::showEvent(QShowEvent *) {
+	updateChanges();
+}
+
+//------------------------------------------------------------------------------
+// Name: on_changes_table_cellDoubleClicked
+// Desc: shows the changed bytes in the data view
+//------------------------------------------------------------------------------
+void DialogMemoryChanges::on_changes_table_cellDoubleClicked(int row, int column) {
+	Q_UNUSED(column)
+
+	if (QTableWidgetItem *const item = ui.changes_table->item(row, 0)) {
+		const edb::address_t address = item->data(Qt::UserRole).toULongLong();
+		edb::v1::dump_data(address, false);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Name: updateChanges
+// Desc: lists the ranges which changed between the last two stops
+//------------------------------------------------------------------------------
+void DialogMemoryChanges::updateChanges() {
+
+	const std::vector<MemoryDiff::Range> &ranges = edb::v1::memory_changes().ranges();
+
+	ui.changes_table->setSortingEnabled(false);
+	ui.changes_table->setRowCount(0);
+	ui.changes_table->setRowCount(static_cast<int>(ranges.size()));
+
+	int row = 0;
+	for (const MemoryDiff::Range &range : ranges) {
+
+		auto address_item = new QTableWidgetItem(edb::v1::format_pointer(range.start));
+		address_item->setData(Qt::UserRole, static_cast<qulonglong>(range.start));
+
+		QString region_name;
+		if (std::shared_ptr<IRegion> region = edb::v1::memory_regions().findRegion(range.start)) {
+			region_name = region->name();
+		}
+
+		auto size_item = new QTableWidgetItem;
+		size_item->setData(Qt::DisplayRole, static_cast<qulonglong>(range.end - range.start));
+
+		ui.changes_table->setItem(row, 0, address_item);
+		ui.changes_table->setItem(row, 1, size_item);
+		ui.changes_table->setItem(row, 2, new QTableWidgetItem(region_name));
+		++row;
+	}
+
+	ui.changes_table->setSortingEnabled(true);
+	ui.label->setText(tr("%n range(s) changed since the previous stop", "", static_cast<int>(ranges.size())));
+}
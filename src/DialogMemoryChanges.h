@@ -0,0 +1,43 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DIALOG_MEMORY_CHANGES_H_20261019_
+#define DIALOG_MEMORY_CHANGES_H_20261019_
+
+#include <QDialog>
+
+#include "ui_DialogMemoryChanges.h"
+
+class DialogMemoryChanges : public QDialog {
+	Q_OBJECT
+public:
+	explicit DialogMemoryChanges(QWidget *parent = nullptr, Qt::WindowFlags f = Qt::WindowFlags());
+	~DialogMemoryChanges() override = default;
+
+private Q_SLOTS:
+	void on_changes_table_cellDoubleClicked(int row, int column);
+	void updateChanges();
+
+public:
+	void showEvent(QShowEvent *) override;
+
+private:
+	Ui::DialogMemoryChanges ui;
+};
+
+#endif
@@ -77,6 +77,16 @@ void DialogMemoryRegions::on_regions_table_customContextMenuRequested(const QPoi
 	menu.addAction(tr("View in &CPU"), this, SLOT(viewInCpu()));
 	menu.addAction(tr("View in &Stack"), this, SLOT(viewInStack()));
 	menu.addAction(tr("View in &Dump"), this, SLOT(viewInDump()));
+	menu.addSeparator();
+
+	QAction *const track_action = menu.addAction(tr("&Track Changes"), this, SLOT(toggleTracked()));
+	track_action->setCheckable(true);
+	if (std::shared_ptr<IRegion> region = selectedRegion()) {
+		track_action->setChecked(edb::v1::region_tracked(region->start()));
+	} else {
+		track_action->setEnabled(false);
+	}
+
 	menu.exec(ui.regions_table->mapToGlobal(pos));
 }
 
@@ -201,6 +211,17 @@ void DialogMemoryRegions::viewInDump() {
 	}
 }
 
+//------------------------------------------------------------------------------
+// Name: toggleTracked
+// Desc: toggles whether the selected region is included in the memory snapshot
+//       taken at each stop
+//------------------------------------------------------------------------------
+void DialogMemoryRegions::toggleTracked() {
+	if (std::shared_ptr<IRegion> region = selectedRegion()) {
+		edb::v1::set_region_tracked(region->start(), !edb::v1::region_tracked(region->start()));
+	}
+}
+
 //------------------------------------------------------------------------------
 // Name: on_regions_table_doubleClicked
 // Desc:
@@ -53,6 +53,7 @@ private Q_SLOTS:
 	void viewInCpu();
 	void viewInStack();
 	void viewInDump();
+	void toggleTracked();
 
 private:
 	std::shared_ptr<IRegion> selectedRegion() const;
@@ -23,10 +23,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "edb.h"
 
 #include <QCloseEvent>
+#include <QComboBox>
 #include <QDebug>
 #include <QFileDialog>
 #include <QFont>
 #include <QFontDialog>
+#include <QTableWidgetItem>
 #include <QToolBox>
 
 namespace {
@@ -182,6 +184,7 @@ void DialogOptions::showEvent(QShowEvent *event) {
 	ui.chkDisableLazyBinding->setChecked(config.disableLazyBinding);
 
 	ui.chkBreakOnLibraryLoad->setChecked(config.break_on_library_load);
+	ui.chkNonStop->setChecked(config.nonstop_mode);
 
 	ui.chkZerosAreFilling->setChecked(config.zeros_are_filling);
 	ui.chkRegisterBadges->setChecked(config.show_register_badges);
@@ -224,21 +227,33 @@ void DialogOptions::showEvent(QShowEvent *event) {
 	ui.rdoPlaceCentered->setChecked(config.startup_window_location == Configuration::Centered);
 	ui.rdoPlaceRestore->setChecked(config.startup_window_location == Configuration::Restore);
 
-	ui.listIgnoredExceptions->clear();
+	ui.tableExceptions->setRowCount(0);
 	if (edb::v1::debugger_core) {
-		QMap<qlonglong, QString> known_exceptions = edb::v1::debugger_core->exceptions();
+		const QMap<qlonglong, QString> known_exceptions                     = edb::v1::debugger_core->exceptions();
+		const QMap<qlonglong, IDebugger::ExceptionDisposition> dispositions = config.exceptionDispositions();
+		const QMap<qlonglong, uint64_t> passed_counts                       = edb::v1::debugger_core->passedExceptionCounts();
 
 		for (auto it = known_exceptions.begin(); it != known_exceptions.end(); ++it) {
-			auto item = new QListWidgetItem(*it, ui.listIgnoredExceptions);
-			item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-
-			if (config.ignored_exceptions.contains(it.key())) {
-				item->setCheckState(Qt::Checked);
-			} else {
-				item->setCheckState(Qt::Unchecked);
-			}
-			item->setData(Qt::UserRole, it.key());
+			const int row = ui.tableExceptions->rowCount();
+			ui.tableExceptions->insertRow(row);
+
+			auto name_item = new QTableWidgetItem(*it);
+			name_item->setData(Qt::UserRole, it.key());
+			ui.tableExceptions->setItem(row, 0, name_item);
+
+			auto combo = new QComboBox;
+			combo->addItem(tr("Stop"), static_cast<int>(IDebugger::ExceptionDisposition::Stop));
+			combo->addItem(tr("Pass"), static_cast<int>(IDebugger::ExceptionDisposition::Pass));
+			combo->addItem(tr("Log and pass"), static_cast<int>(IDebugger::ExceptionDisposition::LogAndPass));
+			combo->setCurrentIndex(combo->findData(static_cast<int>(dispositions.value(it.key(), IDebugger::ExceptionDisposition::Stop))));
+			ui.tableExceptions->setCellWidget(row, 1, combo);
+
+			auto count_item = new QTableWidgetItem(QString::number(passed_counts.value(it.key(), 0)));
+			count_item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+			ui.tableExceptions->setItem(row, 2, count_item);
 		}
+
+		ui.tableExceptions->resizeColumnsToContents();
 	}
 
 	if (IDebugger *core = edb::v1::debugger_core) {
@@ -309,6 +324,7 @@ void DialogOptions::closeEvent(QCloseEvent *event) {
 	config.disableASLR             = ui.chkDisableASLR->isChecked();
 	config.disableLazyBinding      = ui.chkDisableLazyBinding->isChecked();
 	config.break_on_library_load   = ui.chkBreakOnLibraryLoad->isChecked();
+	config.nonstop_mode            = ui.chkNonStop->isChecked();
 	config.default_breakpoint_type = ui.cmbDefaultBreakpointType->itemData(ui.cmbDefaultBreakpointType->currentIndex()).value<IBreakpoint::TypeId>();
 
 	config.function_offsets_in_hex = ui.chkHexOffsets->isChecked();
@@ -361,15 +377,26 @@ void DialogOptions::closeEvent(QCloseEvent *event) {
 	}
 
 	config.ignored_exceptions.clear();
-	for (int i = 0; i < ui.listIgnoredExceptions->count(); ++i) {
-		auto item = ui.listIgnoredExceptions->item(i);
-		if (item->checkState() == Qt::Checked) {
-			config.ignored_exceptions.push_back(item->data(Qt::UserRole).toLongLong());
+	config.logged_exceptions.clear();
+	for (int row = 0; row < ui.tableExceptions->rowCount(); ++row) {
+		const qlonglong exception = ui.tableExceptions->item(row, 0)->data(Qt::UserRole).toLongLong();
+
+		if (auto combo = qobject_cast<QComboBox *>(ui.tableExceptions->cellWidget(row, 1))) {
+			switch (static_cast<IDebugger::ExceptionDisposition>(combo->currentData().toInt())) {
+			case IDebugger::ExceptionDisposition::Pass:
+				config.ignored_exceptions.push_back(exception);
+				break;
+			case IDebugger::ExceptionDisposition::LogAndPass:
+				config.logged_exceptions.push_back(exception);
+				break;
+			case IDebugger::ExceptionDisposition::Stop:
+				break;
+			}
 		}
 	}
 
 	if (IDebugger *core = edb::v1::debugger_core) {
-		core->setIgnoredExceptions(config.ignored_exceptions);
+		core->setExceptionDispositions(config.exceptionDispositions());
 	}
 
 	QString newThemeName = ui.comboTheme->currentData().toString();
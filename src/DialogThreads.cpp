@@ -17,6 +17,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "DialogThreads.h"
+#include "Configuration.h"
 #include "IDebugger.h"
 #include "IProcess.h"
 #include "IThread.h"
@@ -24,6 +25,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "edb.h"
 
 #include <QHeaderView>
+#include <QMenu>
+#include <QMessageBox>
 #include <QSortFilterProxyModel>
 
 //------------------------------------------------------------------------------
@@ -42,6 +45,7 @@ DialogThreads::DialogThreads(QWidget *parent, Qt::WindowFlags f)
 	threadsFilter_->setFilterCaseSensitivity(Qt::CaseInsensitive);
 
 	ui.thread_table->setModel(threadsFilter_);
+	ui.thread_table->setContextMenuPolicy(Qt::CustomContextMenu);
 
 	connect(edb::v1::debugger_ui, SIGNAL(debugEvent()), this, SLOT(updateThreads()));
 	connect(edb::v1::debugger_ui, SIGNAL(detachEvent()), this, SLOT(updateThreads()));
@@ -62,15 +66,67 @@ void DialogThreads::showEvent(QShowEvent *) {
 //------------------------------------------------------------------------------
 void DialogThreads::on_thread_table_doubleClicked(const QModelIndex &index) {
 
+	if (std::shared_ptr<IThread> thread = threadAt(index)) {
+		if (IProcess *process = edb::v1::debugger_core->process()) {
+			process->setCurrentThread(*thread);
+			updateThreads();
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Name: on_thread_table_customContextMenuRequested
+// Desc: lets the user pause and resume threads one at a time
+//------------------------------------------------------------------------------
+void DialogThreads::on_thread_table_customContextMenuRequested(const QPoint &pos) {
+
+	IProcess *process = edb::v1::debugger_core->process();
+	if (!process) {
+		return;
+	}
+
+	std::shared_ptr<IThread> thread = threadAt(ui.thread_table->indexAt(pos));
+	if (!thread) {
+		return;
+	}
+
+	QMenu menu;
+	QAction *const pauseAction  = menu.addAction(tr("&Pause Thread"));
+	QAction *const resumeAction = menu.addAction(tr("&Resume Thread"));
+
+	// NOTE(eteran): without non-stop mode, all threads are resumed together
+	pauseAction->setEnabled(!thread->isPaused());
+	resumeAction->setEnabled(thread->isPaused() && edb::v1::config().nonstop_mode);
+
+	QAction *const action = menu.exec(ui.thread_table->viewport()->mapToGlobal(pos));
+
+	if (action == pauseAction) {
+		const Status status = process->pause(*thread);
+		if (!status) {
+			QMessageBox::critical(this, tr("Error"), tr("Failed to pause thread: %1").arg(status.error()));
+		}
+	} else if (action == resumeAction) {
+		// resuming goes through the normal run logic, which knows how to get
+		// the thread off of a breakpoint
+		process->setCurrentThread(*thread);
+		QMetaObject::invokeMethod(edb::v1::debugger_ui, "on_action_Run_triggered");
+	}
+
+	updateThreads();
+}
+
+//------------------------------------------------------------------------------
+// Name: threadAt
+// Desc:
+//------------------------------------------------------------------------------
+std::shared_ptr<IThread> DialogThreads::threadAt(const QModelIndex &index) const {
+
 	const QModelIndex internal_index = threadsFilter_->mapToSource(index);
 	if (auto item = reinterpret_cast<ThreadsModel::Item *>(internal_index.internalPointer())) {
-		if (std::shared_ptr<IThread> thread = item->thread) {
-			if (IProcess *process = edb::v1::debugger_core->process()) {
-				process->setCurrentThread(*thread);
-				updateThreads();
-			}
-		}
+		return item->thread;
 	}
+
+	return nullptr;
 }
 
 //------------------------------------------------------------------------------
@@ -20,12 +20,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define DIALOG_THREADS_H_20101026_
 
 #include <QDialog>
+#include <memory>
 
 #include "ui_DialogThreads.h"
 
+class IThread;
 class ThreadsModel;
 class QSortFilterProxyModel;
 class QModelIndex;
+class QPoint;
 
 class DialogThreads : public QDialog {
 	Q_OBJECT
@@ -35,8 +38,12 @@ public:
 
 private Q_SLOTS:
 	void on_thread_table_doubleClicked(const QModelIndex &index);
+	void on_thread_table_customContextMenuRequested(const QPoint &pos);
 	void updateThreads();
 
+private:
+	std::shared_ptr<IThread> threadAt(const QModelIndex &index) const;
+
 public:
 	void showEvent(QShowEvent *) override;
 
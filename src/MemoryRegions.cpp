@@ -25,6 +25,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QDebug>
 
+#include <algorithm>
+
 //------------------------------------------------------------------------------
 // Name: MemoryRegions
 // Desc: constructor
@@ -40,9 +42,30 @@ MemoryRegions::MemoryRegions()
 void MemoryRegions::clear() {
 	beginResetModel();
 	regions_.clear();
+	buildIndex();
+	stale_ = false;
 	endResetModel();
 }
 
+//------------------------------------------------------------------------------
+// Name: invalidate
+// Desc: notes that the memory map of the process may have changed, without
+//       reading it again until it is needed
+//------------------------------------------------------------------------------
+void MemoryRegions::invalidate() {
+	stale_ = true;
+}
+
+//------------------------------------------------------------------------------
+// Name: revalidate
+// Desc: reads the memory map again, but only if it may have changed
+//------------------------------------------------------------------------------
+void MemoryRegions::revalidate() {
+	if (stale_) {
+		sync();
+	}
+}
+
 //------------------------------------------------------------------------------
 // Name: sync
 // Desc: reads a memory map file line by line
@@ -79,21 +102,64 @@ void MemoryRegions::sync() {
 	}
 
 	std::swap(regions_, regions);
+	buildIndex();
+	stale_ = false;
 	endResetModel();
 }
 
+//------------------------------------------------------------------------------
+// Name: buildIndex
+// Desc: creates a sorted table of the address ranges of the regions so that
+//       we can binary search it instead of asking each region in turn
+//------------------------------------------------------------------------------
+void MemoryRegions::buildIndex() {
+
+	index_.clear();
+	index_.reserve(static_cast<size_t>(regions_.size()));
+
+	for (int i = 0; i < regions_.size(); ++i) {
+		index_.push_back({regions_[i]->start(), regions_[i]->end(), i});
+	}
+
+	std::sort(index_.begin(), index_.end(), [](const RegionRange &lhs, const RegionRange &rhs) {
+		return lhs.start < rhs.start;
+	});
+
+	lastHit_ = 0;
+}
+
 //------------------------------------------------------------------------------
 // Name: find_region
-// Desc:
+// Desc: if the address isn't in any region and the regions may be out of date,
+//       they are read again before giving up
 //------------------------------------------------------------------------------
-std::shared_ptr<IRegion> MemoryRegions::findRegion(edb::address_t address) const {
+std::shared_ptr<IRegion> MemoryRegions::findRegion(edb::address_t address) {
 
-	auto it = std::find_if(regions_.begin(), regions_.end(), [address](const std::shared_ptr<IRegion> &region) {
-		return region->contains(address);
+	// NOTE(eteran): lookups tend to come in runs for the same region
+	// (painting a view, walking a function, etc), so check the last hit first
+	if (lastHit_ < index_.size()) {
+		const RegionRange &range = index_[lastHit_];
+		if (address >= range.start && address < range.end) {
+			return regions_[range.row];
+		}
+	}
+
+	// find the last region which starts at or before address
+	auto it = std::upper_bound(index_.begin(), index_.end(), address, [](edb::address_t addr, const RegionRange &range) {
+		return addr < range.start;
 	});
 
-	if (it != regions_.end()) {
-		return *it;
+	if (it != index_.begin()) {
+		--it;
+		if (address < it->end) {
+			lastHit_ = static_cast<size_t>(it - index_.begin());
+			return regions_[it->row];
+		}
+	}
+
+	if (stale_) {
+		sync();
+		return findRegion(address);
 	}
 
 	return nullptr;
@@ -0,0 +1,278 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "MemorySnapshot.h"
+#include "IDebugger.h"
+#include "IProcess.h"
+#include "IRegion.h"
+#include "edb.h"
+
+#include <QtConcurrentMap>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// How much of a region we read at once, the pages of each batch are then
+// hashed in parallel
+constexpr size_t BatchPages = 16384;
+
+// How many pages a single job hashes, small enough to spread a batch over all
+// cores, big enough that scheduling the jobs doesn't dominate
+constexpr size_t JobPages = 64;
+
+/**
+ * @brief hash_page
+ *
+ * A simple multiply/rotate hash, processing a word at a time. It only has to
+ * tell if a page changed, so it doesn't need to be cryptographically strong,
+ * just fast.
+ *
+ * @param p
+ * @param n must be a multiple of 8
+ * @return
+ */
+uint64_t hash_page(const uint8_t *p, size_t n) {
+
+	uint64_t h = 0x9e3779b97f4a7c15ull ^ n;
+
+	for (size_t i = 0; i < n; i += sizeof(uint64_t)) {
+		uint64_t w;
+		std::memcpy(&w, p + i, sizeof(w));
+
+		h ^= w * 0xff51afd7ed558ccdull;
+		h = ((h << 31) | (h >> 33)) * 0xc4ceb9fe1a85ec53ull;
+	}
+
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdull;
+	h ^= h >> 33;
+	return h;
+}
+
+/**
+ * @brief find_page
+ * @param snapshot
+ * @param address a page aligned address
+ * @return the page of <snapshot> at <address>, or nullptr if it has none
+ */
+const MemorySnapshot::Page *find_page(const MemorySnapshot &snapshot, edb::address_t address) {
+	if (const MemorySnapshot::Region *region = snapshot.findRegion(address)) {
+		const size_t index = (address - region->start) / snapshot.pageSize();
+		if (index < region->pages.size()) {
+			return &region->pages[index];
+		}
+	}
+
+	return nullptr;
+}
+
+}
+
+/**
+ * @brief MemorySnapshot::capture
+ *
+ * Takes a snapshot of <regions>. If a previous snapshot is given, unchanged
+ * pages are shared with it instead of being copied.
+ *
+ * @param regions
+ * @param previous
+ * @return
+ */
+std::shared_ptr<const MemorySnapshot> MemorySnapshot::capture(const QList<std::shared_ptr<IRegion>> &regions, const std::shared_ptr<const MemorySnapshot> &previous) {
+
+	auto snapshot = std::make_shared<MemorySnapshot>();
+
+	IProcess *process = edb::v1::debugger_core ? edb::v1::debugger_core->process() : nullptr;
+	if (!process) {
+		return snapshot;
+	}
+
+	const size_t page_size = edb::v1::debugger_core->pageSize();
+	snapshot->pageSize_    = page_size;
+
+	// we can only reuse pages of a snapshot taken with the same page size
+	const MemorySnapshot *const prev = (previous && previous->pageSize_ == page_size) ? previous.get() : nullptr;
+
+	struct Job {
+		Region *region;
+		const uint8_t *buffer;
+		size_t first;
+		size_t count;
+	};
+
+	QByteArray buffer;
+
+	for (const std::shared_ptr<IRegion> &r : regions) {
+		if (!r || !r->readable()) {
+			continue;
+		}
+
+		Region region;
+		region.start = r->start();
+		region.end   = r->end();
+		region.name  = r->name();
+		region.pages.resize((region.end - region.start) / page_size);
+
+		for (size_t first = 0; first < region.pages.size(); first += BatchPages) {
+			const size_t count = std::min(BatchPages, region.pages.size() - first);
+
+			// NOTE(eteran): the reads stay on this thread, the ptrace fallback
+			// only works from the thread which is tracing the process
+			buffer.resize(static_cast<int>(count * page_size));
+			const size_t pages_read = process->readPages(region.start + first * page_size, buffer.data(), count);
+
+			std::vector<Job> jobs;
+			for (size_t i = 0; i < pages_read; i += JobPages) {
+				jobs.push_back(Job{&region, reinterpret_cast<const uint8_t *>(buffer.constData()) + i * page_size, first + i, std::min(JobPages, pages_read - i)});
+			}
+
+			QtConcurrent::blockingMap(jobs, [prev, page_size](const Job &job) {
+				for (size_t i = 0; i < job.count; ++i) {
+					const uint8_t *const bytes   = job.buffer + i * page_size;
+					const edb::address_t address = job.region->start + (job.first + i) * page_size;
+
+					Page &page = job.region->pages[job.first + i];
+					page.hash  = hash_page(bytes, page_size);
+
+					// copy on diff, an unchanged page keeps pointing at the same data
+					if (prev) {
+						const Page *old_page = find_page(*prev, address);
+						if (old_page && old_page->bytes && old_page->hash == page.hash) {
+							page.bytes = old_page->bytes;
+							continue;
+						}
+					}
+
+					page.bytes = std::make_shared<const QByteArray>(reinterpret_cast<const char *>(bytes), static_cast<int>(page_size));
+				}
+			});
+		}
+
+		snapshot->regions_.push_back(std::move(region));
+	}
+
+	std::sort(snapshot->regions_.begin(), snapshot->regions_.end(), [](const Region &lhs, const Region &rhs) {
+		return lhs.start < rhs.start;
+	});
+
+	return snapshot;
+}
+
+/**
+ * @brief MemorySnapshot::findRegion
+ * @param address
+ * @return the region of the snapshot which contains <address> or nullptr
+ */
+const MemorySnapshot::Region *MemorySnapshot::findRegion(edb::address_t address) const {
+
+	auto it = std::upper_bound(regions_.begin(), regions_.end(), address, [](edb::address_t addr, const Region &region) {
+		return addr < region.start;
+	});
+
+	if (it == regions_.begin()) {
+		return nullptr;
+	}
+
+	--it;
+	return (address < it->end) ? &*it : nullptr;
+}
+
+/**
+ * @brief MemoryDiff::MemoryDiff
+ *
+ * Pages which hash the same in both snapshots are considered unchanged, only
+ * the rest are compared byte by byte. Pages which weren't part of <before>
+ * are entirely changed.
+ *
+ * @param before
+ * @param after
+ */
+MemoryDiff::MemoryDiff(const MemorySnapshot &before, const MemorySnapshot &after) {
+
+	const size_t page_size = after.pageSize();
+	if (page_size == 0 || before.pageSize() != page_size) {
+		return;
+	}
+
+	auto add_range = [this](edb::address_t start, edb::address_t end) {
+		if (!ranges_.empty() && ranges_.back().end == start) {
+			ranges_.back().end = end;
+		} else {
+			ranges_.push_back(Range{start, end});
+		}
+	};
+
+	for (const MemorySnapshot::Region &region : after.regions()) {
+		for (size_t i = 0; i < region.pages.size(); ++i) {
+			const MemorySnapshot::Page &page = region.pages[i];
+			if (!page.bytes) {
+				continue;
+			}
+
+			const edb::address_t address = region.start + i * page_size;
+
+			const MemorySnapshot::Page *old_page = find_page(before, address);
+			if (old_page && old_page->bytes) {
+				if (old_page->bytes == page.bytes || old_page->hash == page.hash) {
+					continue;
+				}
+
+				pages_.push_back(address);
+
+				const char *const lhs = old_page->bytes->constData();
+				const char *const rhs = page.bytes->constData();
+
+				size_t j = 0;
+				while (j < page_size) {
+					if (lhs[j] == rhs[j]) {
+						++j;
+						continue;
+					}
+
+					const size_t first = j;
+					while (j < page_size && lhs[j] != rhs[j]) {
+						++j;
+					}
+
+					add_range(address + first, address + j);
+				}
+			} else {
+				pages_.push_back(address);
+				add_range(address, address + page_size);
+			}
+		}
+	}
+}
+
+/**
+ * @brief MemoryDiff::changed
+ * @param address
+ * @param size
+ * @return true if any of the <size> bytes at <address> changed
+ */
+bool MemoryDiff::changed(edb::address_t address, size_t size) const {
+
+	// find the first range which ends after <address>
+	auto it = std::upper_bound(ranges_.begin(), ranges_.end(), address, [](edb::address_t addr, const Range &range) {
+		return addr < range.end;
+	});
+
+	return it != ranges_.end() && it->start < address + size;
+}
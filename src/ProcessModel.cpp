@@ -17,10 +17,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "ProcessModel.h"
-#include "IProcess.h"
 
 #include <QtAlgorithms>
 
+#include <algorithm>
+
 ProcessModel::ProcessModel(QObject *parent)
 	: QAbstractItemModel(parent) {
 }
@@ -93,18 +94,57 @@ int ProcessModel::rowCount(const QModelIndex &parent) const {
 	return items_.size();
 }
 
-void ProcessModel::addProcess(const std::shared_ptr<IProcess> &process) {
-	beginInsertRows(QModelIndex(), rowCount(), rowCount());
+/**
+ * @brief ProcessModel::update
+ *
+ * Brings the model in line with <processes>, only touching the rows which
+ * actually changed so that views keep their selection and scroll position.
+ * Rows are kept sorted by pid, which lets us do this in a single merge pass.
+ *
+ * @param processes
+ */
+void ProcessModel::update(const QMap<edb::pid_t, ProcessInfo> &processes) {
+
+	int row = 0;
+	auto it = processes.begin();
+
+	while (row < items_.size() || it != processes.end()) {
+
+		if (it == processes.end() || (row < items_.size() && items_[row].pid < it.key())) {
+			// these processes have gone away
+			int last = row;
+			while (last + 1 < items_.size() && (it == processes.end() || items_[last + 1].pid < it.key())) {
+				++last;
+			}
 
-	const Item item = {
-		process->pid(),
-		process->uid(),
-		process->user(),
-		process->name(),
-	};
+			beginRemoveRows(QModelIndex(), row, last);
+			items_.erase(items_.begin() + row, items_.begin() + last + 1);
+			endRemoveRows();
+		} else if (row == items_.size() || it.key() < items_[row].pid) {
+			// and these are new
+			QVector<Item> added;
+			while (it != processes.end() && (row == items_.size() || it.key() < items_[row].pid)) {
+				added.push_back(*it);
+				++it;
+			}
 
-	items_.push_back(item);
-	endInsertRows();
+			beginInsertRows(QModelIndex(), row, row + added.size() - 1);
+			items_.insert(row, added.size(), Item());
+			std::copy(added.begin(), added.end(), items_.begin() + row);
+			endInsertRows();
+
+			row += added.size();
+		} else {
+			// the pid may have been reused, or the process may have exec'd
+			if (items_[row] != *it) {
+				items_[row] = *it;
+				Q_EMIT dataChanged(index(row, 0), index(row, columnCount() - 1));
+			}
+
+			++row;
+			++it;
+		}
+	}
 }
 
 void ProcessModel::clear() {
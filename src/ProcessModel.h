@@ -20,25 +20,17 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define PROCESS_MODEL_H_20191119_
 
 #include "OSTypes.h"
+#include "ProcessInfo.h"
 
 #include <QAbstractItemModel>
-#include <QString>
+#include <QMap>
 #include <QVector>
 
-#include <memory>
-
-class IProcess;
-
 class ProcessModel final : public QAbstractItemModel {
 	Q_OBJECT
 
 public:
-	struct Item {
-		edb::pid_t pid;
-		edb::uid_t uid;
-		QString user;
-		QString name;
-	};
+	using Item = ProcessInfo;
 
 public:
 	explicit ProcessModel(QObject *parent = nullptr);
@@ -53,7 +45,7 @@ public:
 	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
 
 public:
-	void addProcess(const std::shared_ptr<IProcess> &process);
+	void update(const QMap<edb::pid_t, ProcessInfo> &processes);
 	void clear();
 
 private:
@@ -28,9 +28,32 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QProcess>
 #include <QtDebug>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <istream>
+#include <iterator>
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Name: trigram
+// Desc: the case folded three characters starting at <p> as a single key
+//------------------------------------------------------------------------------
+uint64_t trigram(const QChar *p) {
+	return (uint64_t{p[0].toCaseFolded().unicode()} << 32) | (uint64_t{p[1].toCaseFolded().unicode()} << 16) | p[2].toCaseFolded().unicode();
+}
+
+//------------------------------------------------------------------------------
+// Name: name_less
+// Desc: the order of the sorted name index, names which start with the same
+//       text (ignoring case) are next to each other
+//------------------------------------------------------------------------------
+bool name_less(const QString &lhs, const QString &rhs) {
+	return QString::compare(lhs, rhs, Qt::CaseInsensitive) < 0;
+}
+
+}
 
 //------------------------------------------------------------------------------
 // Name: clear
@@ -42,8 +65,13 @@ void SymbolManager::clear() {
 	symbolsByAddress_.clear();
 	symbolsByFile_.clear();
 	symbolsByName_.clear();
+	symbolsByUnprefixedName_.clear();
 	labels_.clear();
 	labelsByName_.clear();
+	names_.clear();
+	namesSorted_.clear();
+	namesByTrigram_.clear();
+	namesIndexed_ = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -62,29 +90,33 @@ void SymbolManager::loadSymbolFile(const QString &filename, edb::address_t base)
 		return;
 	}
 
+	QFileInfo info(filename);
+
+	if (info.isRelative()) {
+		info.makeAbsolute();
+	}
+
+	// NOTE(eteran): this is called for every module each time the memory
+	// regions are read, so skip the ones we have before touching the disk
+	if (symbolFiles_.contains(info.absoluteFilePath())) {
+		return;
+	}
+
 	// ensure that the directory exists
 	QDir().mkpath(symbol_directory);
 
-	QFileInfo info(filename);
-
 	if (info.exists() && info.isReadable()) {
 
-		if (info.isRelative()) {
-			info.makeAbsolute();
-		}
-
 		const QString path = QString("%1/%2").arg(symbol_directory, info.absolutePath());
 		const QString name = info.fileName();
 
 		// ensure that the sub-directory exists
 		QDir().mkpath(path);
 
-		if (!symbolFiles_.contains(info.absoluteFilePath())) {
-			const QString map_file = QString("%1/%2.map").arg(path, name);
+		const QString map_file = QString("%1/%2.map").arg(path, name);
 
-			if (processSymbolFile(map_file, base, filename, true)) {
-				symbolFiles_.insert(info.absoluteFilePath());
-			}
+		if (processSymbolFile(map_file, base, filename, true)) {
+			symbolFiles_.insert(info.absoluteFilePath());
 		}
 	}
 }
@@ -100,18 +132,163 @@ const std::shared_ptr<Symbol> SymbolManager::find(const QString &name) const {
 		return it.value();
 	}
 
-	// slow path... look for any symbol which matches the name, but skipping the prefix
-	// we can make this faster later at the cost of yet another hash table if we
-	// feel the need
-	auto it2 = std::find_if(symbols_.begin(), symbols_.end(), [&name](const std::shared_ptr<Symbol> &symbol) {
-		return symbol->name_no_prefix == name;
+	// look for any symbol which matches the name, but skipping the prefix
+	auto it2 = symbolsByUnprefixedName_.find(name);
+	if (it2 != symbolsByUnprefixedName_.end() && !it2->isEmpty()) {
+		return it2->front();
+	}
+
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------
+// Name: search
+// Desc: finds up to <limit> symbols whose unprefixed name contains <text>,
+//       ignoring case. Names which start with <text> come first. If <text> is
+//       of the form "module!name", only symbols from a module containing
+//       "module" are considered
+//------------------------------------------------------------------------------
+std::vector<std::shared_ptr<Symbol>> SymbolManager::search(const QString &text, std::size_t limit) const {
+
+	std::vector<std::shared_ptr<Symbol>> results;
+	if (limit == 0) {
+		return results;
+	}
+
+	QString module;
+	QString name = text;
+
+	const int n = text.indexOf(QLatin1Char('!'));
+	if (n != -1) {
+		module = text.left(n);
+		name   = text.mid(n + 1);
+	}
+
+	// returns false once we have enough results
+	auto add_symbol = [&](const std::shared_ptr<Symbol> &symbol) {
+		if (module.isEmpty() || symbol->name.leftRef(symbol->name.indexOf(QLatin1Char('!'))).contains(module, Qt::CaseInsensitive)) {
+			results.push_back(symbol);
+		}
+		return results.size() < limit;
+	};
+
+	auto add_name = [&](uint32_t id) {
+		for (const std::shared_ptr<Symbol> &symbol : symbolsByUnprefixedName_[names_[id]]) {
+			if (!add_symbol(symbol)) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	// names which contain <name>, but which we haven't already added
+	auto add_other = [&](uint32_t id) {
+		const QString &s = names_[id];
+		if (!s.startsWith(name, Qt::CaseInsensitive) && s.contains(name, Qt::CaseInsensitive)) {
+			return add_name(id);
+		}
+		return true;
+	};
+
+	if (name.isEmpty()) {
+		for (const std::shared_ptr<Symbol> &symbol : symbols_) {
+			if (!add_symbol(symbol)) {
+				break;
+			}
+		}
+		return results;
+	}
+
+	updateIndex();
+
+	// the names which start with <name> are one run of the sorted index
+	auto it = std::lower_bound(namesSorted_.begin(), namesSorted_.end(), name, [this](uint32_t id, const QString &s) {
+		return name_less(names_[id], s);
 	});
 
-	if (it2 != symbols_.end()) {
-		return *it2;
+	for (; it != namesSorted_.end() && names_[*it].startsWith(name, Qt::CaseInsensitive); ++it) {
+		if (!add_name(*it)) {
+			return results;
+		}
 	}
 
-	return nullptr;
+	// too short to have a trigram, so there is nothing to narrow it down with
+	if (name.size() < 3) {
+		for (uint32_t id = 0; id < names_.size(); ++id) {
+			if (!add_other(id)) {
+				break;
+			}
+		}
+		return results;
+	}
+
+	// only the names which have every trigram of <name> can contain it, so
+	// intersect their lists, starting with the shortest
+	std::vector<const std::vector<uint32_t> *> lists;
+	for (int i = 0; i + 3 <= name.size(); ++i) {
+		auto list = namesByTrigram_.constFind(trigram(name.constData() + i));
+		if (list == namesByTrigram_.constEnd()) {
+			return results;
+		}
+		lists.push_back(&list.value());
+	}
+
+	std::sort(lists.begin(), lists.end(), [](const std::vector<uint32_t> *lhs, const std::vector<uint32_t> *rhs) {
+		return lhs->size() < rhs->size();
+	});
+
+	std::vector<uint32_t> candidates = *lists.front();
+	for (std::size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+		std::vector<uint32_t> matches;
+		std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(matches));
+		candidates.swap(matches);
+	}
+
+	for (uint32_t id : candidates) {
+		if (!add_other(id)) {
+			break;
+		}
+	}
+
+	return results;
+}
+
+//------------------------------------------------------------------------------
+// Name: updateIndex
+// Desc: adds the names which were added since the last search to the sorted
+//       and trigram indexes
+//------------------------------------------------------------------------------
+void SymbolManager::updateIndex() const {
+
+	const std::size_t first = namesIndexed_;
+	if (first == names_.size()) {
+		return;
+	}
+
+	for (std::size_t i = first; i < names_.size(); ++i) {
+		const auto id       = static_cast<uint32_t>(i);
+		const QString &name = names_[i];
+
+		// ids are added in increasing order, so the lists stay sorted
+		for (int j = 0; j + 3 <= name.size(); ++j) {
+			std::vector<uint32_t> &list = namesByTrigram_[trigram(name.constData() + j)];
+			if (list.empty() || list.back() != id) {
+				list.push_back(id);
+			}
+		}
+
+		namesSorted_.push_back(id);
+	}
+
+	auto by_name = [this](uint32_t lhs, uint32_t rhs) {
+		return name_less(names_[lhs], names_[rhs]);
+	};
+
+	const auto middle = namesSorted_.begin() + static_cast<std::ptrdiff_t>(first);
+	std::sort(middle, namesSorted_.end(), by_name);
+	std::inplace_merge(namesSorted_.begin(), middle, namesSorted_.end(), by_name);
+
+	namesIndexed_ = names_.size();
 }
 
 //------------------------------------------------------------------------------
@@ -161,6 +338,14 @@ void SymbolManager::addSymbol(const std::shared_ptr<Symbol> &symbol) {
 	symbolsByAddress_[symbol->address] = symbol;
 	symbolsByName_[symbol->name]       = symbol;
 	symbolsByFile_[symbol->file].push_back(symbol);
+
+	auto it = symbolsByUnprefixedName_.find(symbol->name_no_prefix);
+	if (it == symbolsByUnprefixedName_.end()) {
+		// the name table shares the key's string data
+		it = symbolsByUnprefixedName_.insert(symbol->name_no_prefix, {});
+		names_.push_back(it.key());
+	}
+	it->push_back(symbol);
 }
 
 //------------------------------------------------------------------------------
@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QHash>
 #include <QMap>
 #include <QSet>
+#include <vector>
 
 class QString;
 
@@ -39,6 +40,7 @@ public:
 	const std::shared_ptr<Symbol> find(const QString &name) const override;
 	const std::shared_ptr<Symbol> find(edb::address_t address) const override;
 	const std::shared_ptr<Symbol> findNearSymbol(edb::address_t address) const override;
+	std::vector<std::shared_ptr<Symbol>> search(const QString &text, std::size_t limit) const override;
 	void addSymbol(const std::shared_ptr<Symbol> &symbol) override;
 	void clear() override;
 	void loadSymbolFile(const QString &filename, edb::address_t base) override;
@@ -50,6 +52,7 @@ public:
 
 private:
 	bool processSymbolFile(const QString &f, edb::address_t base, const QString &library_filename, bool allow_retry);
+	void updateIndex() const;
 
 private:
 	QSet<QString> symbolFiles_;
@@ -57,10 +60,19 @@ private:
 	QMap<edb::address_t, std::shared_ptr<Symbol>> symbolsByAddress_;
 	QHash<QString, QList<std::shared_ptr<Symbol>>> symbolsByFile_;
 	QHash<QString, std::shared_ptr<Symbol>> symbolsByName_;
+	QHash<QString, QList<std::shared_ptr<Symbol>>> symbolsByUnprefixedName_;
 	QHash<edb::address_t, QString> labels_;
 	QHash<QString, edb::address_t> labelsByName_;
 	ISymbolGenerator *symbolGenerator_ = nullptr;
 	bool showPathNotice_               = true;
+
+private:
+	// every distinct unprefixed name, a name's index here is its id. The
+	// indexes over them are brought up to date when they are searched
+	std::vector<QString> names_;
+	mutable std::vector<uint32_t> namesSorted_;
+	mutable QHash<uint64_t, std::vector<uint32_t>> namesByTrigram_;
+	mutable std::size_t namesIndexed_ = 0;
 };
 
 #endif
@@ -62,6 +62,11 @@ QVariant ThreadsModel::data(const QModelIndex &index, int role) const {
 			case 1:
 				return item.thread->priority();
 			case 2: {
+				// a running thread's registers can't be read
+				if (!item.thread->isPaused()) {
+					return tr("(running)");
+				}
+
 				const QString default_region_name;
 				const QString symname = edb::v1::find_function_symbol(item.thread->instructionPointer(), default_region_name);
 
@@ -75,6 +80,8 @@ QVariant ThreadsModel::data(const QModelIndex &index, int role) const {
 				return item.thread->runState();
 			case 4:
 				return item.thread->name();
+			case 5:
+				return item.thread->isPaused() ? tr("Stopped") : tr("Running");
 			}
 		} else if (role == Qt::UserRole) {
 			return QVariant::fromValue(item.thread->tid());
@@ -98,6 +105,8 @@ QVariant ThreadsModel::headerData(int section, Qt::Orientation orientation, int
 			return tr("State");
 		case 4:
 			return tr("Name");
+		case 5:
+			return tr("Debugger State");
 		}
 	}
 
@@ -106,7 +115,7 @@ QVariant ThreadsModel::headerData(int section, Qt::Orientation orientation, int
 
 int ThreadsModel::columnCount(const QModelIndex &parent) const {
 	Q_UNUSED(parent)
-	return 5;
+	return 6;
 }
 
 int ThreadsModel::rowCount(const QModelIndex &parent) const {
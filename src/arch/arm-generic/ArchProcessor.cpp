@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "State.h"
 #include "Util.h"
 #include "edb.h"
+#include "util/Container.h"
 
 #include <QWidget>
 #include <cstdint>
@@ -33,6 +34,22 @@ using std::uint32_t;
 
 namespace {
 static constexpr size_t GPR_COUNT = 16;
+
+// the syscalls which can change the memory map of a process, the EABI
+// passes the number in r7
+constexpr uint32_t MemoryMapSyscalls[] = {
+	11,  // execve
+	45,  // brk
+	91,  // munmap
+	125, // mprotect
+	163, // mremap
+	192, // mmap2
+	253, // remap_file_pages
+	305, // shmat
+	306, // shmdt
+	387, // execveat
+	394, // pkey_mprotect
+};
 }
 
 int capstoneRegToGPRIndex(int capstoneReg, bool &ok) {
@@ -250,6 +267,10 @@ bool ArchProcessor::canStepOver(const edb::Instruction &inst) const {
 	return inst && (is_call(inst) || is_interrupt(inst) || !modifies_pc(inst));
 }
 
+bool ArchProcessor::changesMemoryMap(const edb::Instruction &inst, const State &state) const {
+	return inst && inst.operation() == ARM_INS_SVC && util::contains(MemoryMapSyscalls, static_cast<uint32_t>(state.gpRegister(7).valueAsInteger()));
+}
+
 bool ArchProcessor::isFilling(const edb::Instruction &inst) const {
 	Q_UNUSED(inst)
 	return false;
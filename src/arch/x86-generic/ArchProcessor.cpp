@@ -26,17 +26,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Prototype.h"
 #include "RegisterViewModel.h"
 #include "State.h"
+#include "SyscallTable.h"
 #include "Util.h"
 #include "edb.h"
 #include "string_hash.h"
+#include "util/Container.h"
 
 #include <QApplication>
 #include <QDebug>
-#include <QDomDocument>
-#include <QFile>
 #include <QVector>
 #include <QWidget>
-#include <QXmlQuery>
 
 #include <cctype>
 #include <climits>
@@ -128,6 +127,40 @@ constexpr size_t MAX_MMX_REGS_COUNT   = MAX_FPU_REGS_COUNT;
 using edb::v1::debuggeeIs32Bit;
 using edb::v1::debuggeeIs64Bit;
 
+#ifdef Q_OS_LINUX
+// the syscalls which can change the memory map of a process, <asm/unistd.h>
+// only has the numbers for the ABI edb itself was built for
+constexpr std::uint64_t MemoryMapSyscalls64[] = {
+	9,   // mmap
+	10,  // mprotect
+	11,  // munmap
+	12,  // brk
+	25,  // mremap
+	30,  // shmat
+	59,  // execve
+	67,  // shmdt
+	216, // remap_file_pages
+	322, // execveat
+	329, // pkey_mprotect
+};
+
+constexpr std::uint64_t MemoryMapSyscalls32[] = {
+	11,  // execve
+	45,  // brk
+	90,  // mmap
+	91,  // munmap
+	117, // ipc
+	125, // mprotect
+	163, // mremap
+	192, // mmap2
+	257, // remap_file_pages
+	358, // execveat
+	380, // pkey_mprotect
+	397, // shmat
+	398, // shmdt
+};
+#endif
+
 int func_param_regs_count() {
 	return debuggeeIs32Bit() ? 0 : 6;
 }
@@ -859,30 +892,13 @@ void analyze_syscall(const State &state, const edb::Instruction &inst, QStringLi
 	const bool isX32 = regAX & __X32_SYSCALL_BIT;
 	regAX &= ~__X32_SYSCALL_BIT;
 
-	QString syscall_entry;
-	QDomDocument syscall_xml;
-	QFile file(":/debugger/xml/syscalls.xml");
-	if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-
-		QXmlQuery query;
-		query.setFocus(&file);
-		const QString arch = debuggeeIs64Bit() ? "x86-64" : "x86";
-		query.setQuery(QString("syscalls[@version='1.0']/linux[@arch='" + arch + "']/syscall[index=%1]").arg(regAX));
-		if (query.isValid()) {
-			query.evaluateTo(&syscall_entry);
-		}
-		file.close();
-	}
-
-	if (!syscall_entry.isEmpty()) {
-		syscall_xml.setContent("" + syscall_entry + "");
-		QDomElement root = syscall_xml.documentElement();
+	if (const SyscallEntry *const syscall = find_syscall(debuggeeIs64Bit(), regAX)) {
 
 		QStringList arguments;
 
-		for (QDomElement argument = root.firstChildElement("argument"); !argument.isNull(); argument = argument.nextSiblingElement("argument")) {
-			const QString argument_type     = argument.attribute("type");
-			const QString argument_register = argument.attribute("register");
+		for (std::size_t i = 0; i < syscall->argumentCount; ++i) {
+			const QString argument_type     = QString::fromLatin1(syscall->arguments[i].type);
+			const QString argument_register = QString::fromLatin1(syscall->arguments[i].reg);
 			if (argument_register == "ebp" && inst.operation() == X86_INS_SYSENTER) {
 				if (IProcess *process = edb::v1::debugger_core->process()) {
 					char buf[4];
@@ -917,7 +933,7 @@ void analyze_syscall(const State &state, const edb::Instruction &inst, QStringLi
 			}
 		}
 
-		ret << ArchProcessor::tr("SYSCALL: %1%2(%3)").arg(isX32 ? "x32:" : "", root.attribute("name"), arguments.join(","));
+		ret << ArchProcessor::tr("SYSCALL: %1%2(%3)").arg(isX32 ? "x32:" : "", QString::fromLatin1(syscall->name), arguments.join(","));
 	}
 #else
 	Q_UNUSED(regAX)
@@ -1525,6 +1541,37 @@ bool ArchProcessor::canStepOver(const edb::Instruction &inst) const {
 	return inst && (is_call(inst) || is_repeat(inst));
 }
 
+//------------------------------------------------------------------------------
+// Name: changes_memory_map
+// Desc: returns true if executing inst may map, unmap or change the protection
+//       of memory, which is only the case for some syscalls
+//------------------------------------------------------------------------------
+bool ArchProcessor::changesMemoryMap(const edb::Instruction &inst, const State &state) const {
+
+	if (!inst) {
+		return false;
+	}
+
+	// NOTE(eteran): a 64-bit process can still make 32-bit syscalls through
+	// int 0x80, which use the 32-bit numbers
+	const bool int80 = inst.operation() == X86_INS_INT && is_immediate(inst[0]) && inst[0]->imm == 0x80;
+	if (!int80 && !is_syscall(inst) && !is_sysenter(inst)) {
+		return false;
+	}
+
+#ifdef Q_OS_LINUX
+	const std::uint64_t regAX = state.gpRegister(rAX).valueAsInteger();
+	if (is_syscall(inst) && debuggeeIs64Bit()) {
+		return util::contains(MemoryMapSyscalls64, regAX & ~std::uint64_t(__X32_SYSCALL_BIT));
+	}
+
+	return util::contains(MemoryMapSyscalls32, regAX & 0xffffffff);
+#else
+	Q_UNUSED(state)
+	return true;
+#endif
+}
+
 //------------------------------------------------------------------------------
 // Name: is_filling
 // Desc:
@@ -0,0 +1,55 @@
+/*
+Copyright (C) 2006 - 2023 Evan Teran
+						  evan.teran@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SYSCALL_TABLE_H_20261019_
+#define SYSCALL_TABLE_H_20261019_
+
+#include <cstddef>
+#include <cstdint>
+
+struct SyscallArgument {
+	const char *type; // mangled, as in the function database
+	const char *reg;  // the register holding it, or a high:low pair of them
+};
+
+struct SyscallEntry {
+	const char *name; // nullptr if no syscall has this number
+	std::size_t argumentCount;
+	SyscallArgument arguments[6];
+};
+
+// SyscallsX86 and SyscallsX86_64, generated from syscalls.xml at build time
+#include "SyscallTableData.h"
+
+template <std::size_t N>
+constexpr const SyscallEntry *find_syscall(const SyscallEntry (&table)[N], std::uint64_t number) {
+	return (number < N && table[number].name) ? &table[number] : nullptr;
+}
+
+/**
+ * @brief find_syscall
+ * @param is64Bit
+ * @param number
+ * @return the syscall with <number> for the given ABI, or nullptr if there is
+ * none
+ */
+constexpr const SyscallEntry *find_syscall(bool is64Bit, std::uint64_t number) {
+	return is64Bit ? find_syscall(SyscallsX86_64, number) : find_syscall(SyscallsX86, number);
+}
+
+#endif
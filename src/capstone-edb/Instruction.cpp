@@ -23,11 +23,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QStringList>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cctype>
 #include <cstring>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
 namespace CapstoneEDB {
@@ -36,11 +38,88 @@ namespace {
 
 constexpr int MaxOperands = 3;
 
-Architecture capstoneArch = Architecture::ARCH_X86;
-bool capstoneInitialized  = false;
-csh csh                   = 0;
+std::atomic<Architecture> capstoneArch(Architecture::ARCH_X86);
+bool capstoneInitialized = false;
+csh csh                  = 0;
 Formatter activeFormatter;
 
+// NOTE: capstone handles may not be used by more than one thread at a
+// time. The thread which calls init() uses the handle above, all others lazily
+// open their own, and re-open it whenever the configuration generation changes
+std::atomic<std::thread::id> capstoneThread;
+std::atomic<int> capstoneGeneration(0);
+std::atomic<int> capstoneSyntax(CS_OPT_SYNTAX_DEFAULT);
+
+struct ThreadHandle {
+	::csh handle   = 0;
+	int generation = -1;
+
+	~ThreadHandle() {
+		if (handle) {
+			cs_close(&handle);
+		}
+	}
+};
+
+/**
+ * @brief open_handle
+ * @param arch
+ * @param handle
+ * @return
+ */
+cs_err open_handle(Architecture arch, ::csh *handle) {
+	switch (arch) {
+	case Architecture::ARCH_AMD64:
+		return cs_open(CS_ARCH_X86, CS_MODE_64, handle);
+	case Architecture::ARCH_X86:
+		return cs_open(CS_ARCH_X86, CS_MODE_32, handle);
+	case Architecture::ARCH_ARM32_ARM:
+		return cs_open(CS_ARCH_ARM, CS_MODE_ARM, handle);
+	case Architecture::ARCH_ARM32_THUMB:
+		return cs_open(CS_ARCH_ARM, CS_MODE_THUMB, handle);
+	case Architecture::ARCH_ARM64:
+		return cs_open(CS_ARCH_ARM64, CS_MODE_ARM, handle);
+	default:
+		return CS_ERR_ARCH;
+	}
+}
+
+/**
+ * @brief current_handle
+ * @return the capstone handle which the calling thread should use
+ */
+::csh current_handle() {
+
+	if (std::this_thread::get_id() == capstoneThread) {
+		return csh;
+	}
+
+	thread_local ThreadHandle thread_handle;
+
+	const int generation = capstoneGeneration.load();
+	if (thread_handle.generation != generation) {
+		if (thread_handle.handle) {
+			cs_close(&thread_handle.handle);
+			thread_handle.handle = 0;
+		}
+
+		if (open_handle(capstoneArch, &thread_handle.handle) == CS_ERR_OK) {
+			cs_option(thread_handle.handle, CS_OPT_DETAIL, CS_OPT_ON);
+
+			const int syntax = capstoneSyntax.load();
+			if (syntax != CS_OPT_SYNTAX_DEFAULT) {
+				cs_option(thread_handle.handle, CS_OPT_SYNTAX, syntax);
+			}
+		} else {
+			thread_handle.handle = 0;
+		}
+
+		thread_handle.generation = generation;
+	}
+
+	return thread_handle.handle;
+}
+
 #if defined(EDB_X86) || defined(EDB_X86_64)
 /**
  * @brief is_simd_register
@@ -202,7 +281,12 @@ std::vector<std::string> to_operands(QString str) {
 
 bool init(Architecture arch) {
 
-	capstoneArch = arch;
+	capstoneArch   = arch;
+	capstoneThread = std::this_thread::get_id();
+
+	// other threads need to pick up the new architecture, even if opening
+	// our own handle fails below
+	++capstoneGeneration;
 
 	if (capstoneInitialized) {
 		cs_close(&csh);
@@ -210,23 +294,7 @@ bool init(Architecture arch) {
 
 	capstoneInitialized = false;
 
-	const cs_err result = [arch]() {
-		switch (arch) {
-		case Architecture::ARCH_AMD64:
-			return cs_open(CS_ARCH_X86, CS_MODE_64, &csh);
-		case Architecture::ARCH_X86:
-			return cs_open(CS_ARCH_X86, CS_MODE_32, &csh);
-		case Architecture::ARCH_ARM32_ARM:
-			return cs_open(CS_ARCH_ARM, CS_MODE_ARM, &csh);
-		case Architecture::ARCH_ARM32_THUMB:
-			return cs_open(CS_ARCH_ARM, CS_MODE_THUMB, &csh);
-		case Architecture::ARCH_ARM64:
-			return cs_open(CS_ARCH_ARM64, CS_MODE_ARM, &csh);
-		default:
-			return CS_ERR_ARCH;
-		}
-	}();
-
+	const cs_err result = open_handle(arch, &csh);
 	if (result != CS_ERR_OK) {
 		return false;
 	}
@@ -274,7 +342,7 @@ Instruction::Instruction(const void *first, const void *last, uint64_t rva) noex
 	byte0_ = codeBegin[0];
 
 	cs_insn *insn = nullptr;
-	if (first < last && cs_disasm(csh, codeBegin, codeEnd - codeBegin, rva, 1, &insn)) {
+	if (first < last && cs_disasm(current_handle(), codeBegin, codeEnd - codeBegin, rva, 1, &insn)) {
 		insn_ = insn;
 #if defined(EDB_ARM32)
 		if (insn_->detail->arm.op_count >= 2) {
@@ -436,16 +504,23 @@ void Formatter::setOptions(const Formatter::FormatOptions &options) {
 
 #if defined(EDB_X86) || defined(EDB_X86_64)
 	if (options.syntax == SyntaxAtt) {
-		cs_option(csh, CS_OPT_SYNTAX, CS_OPT_SYNTAX_ATT);
+		capstoneSyntax = CS_OPT_SYNTAX_ATT;
 	} else {
-		cs_option(csh, CS_OPT_SYNTAX, CS_OPT_SYNTAX_INTEL);
+		capstoneSyntax = CS_OPT_SYNTAX_INTEL;
 	}
 #elif defined(EDB_ARM32) // FIXME(ARM): does this apply to AArch64?
 	// TODO: make this optional. Don't forget to reflect this in register view!
-	cs_option(csh, CS_OPT_SYNTAX, CS_OPT_SYNTAX_NOREGNAME);
+	capstoneSyntax = CS_OPT_SYNTAX_NOREGNAME;
 #endif
 
+	if (capstoneSyntax != CS_OPT_SYNTAX_DEFAULT) {
+		cs_option(csh, CS_OPT_SYNTAX, capstoneSyntax);
+	}
+
 	activeFormatter = *this;
+
+	// other threads need to pick up the new syntax
+	++capstoneGeneration;
 }
 
 std::string Formatter::toString(const Instruction &insn) const {
@@ -544,7 +619,7 @@ std::string Formatter::toString(const Operand &operand) const {
 
 std::string Formatter::registerName(unsigned int reg) const {
 	assert(capstoneInitialized);
-	const char *raw = cs_reg_name(csh, reg);
+	const char *raw = cs_reg_name(current_handle(), reg);
 	if (!raw)
 		return "(invalid register)";
 	std::string str(raw);
@@ -1164,17 +1239,17 @@ bool is_SIMD_USI(const Operand &operand) {
 
 bool is_return(const Instruction &insn) {
 	if (!insn) return false;
-	return cs_insn_group(csh, insn.native(), CS_GRP_RET);
+	return cs_insn_group(current_handle(), insn.native(), CS_GRP_RET);
 }
 
 bool is_jump(const Instruction &insn) {
 	if (!insn) return false;
-	return cs_insn_group(csh, insn.native(), CS_GRP_JUMP);
+	return cs_insn_group(current_handle(), insn.native(), CS_GRP_JUMP);
 }
 
 bool is_call(const Instruction &insn) {
 	if (!insn) return false;
-	return cs_insn_group(csh, insn.native(), CS_GRP_CALL);
+	return cs_insn_group(current_handle(), insn.native(), CS_GRP_CALL);
 }
 
 bool modifies_pc(const Instruction &insn) {
@@ -35,7 +35,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "IRegion.h"
 #include "IThread.h"
 #include "MemoryRegions.h"
+#include "MemorySnapshot.h"
 #include "Prototype.h"
+#include "QDisassemblyView.h"
 #include "QHexView"
 #include "QtHelper.h"
 #include "State.h"
@@ -1302,6 +1304,40 @@ address_t current_data_view_address() {
 	return qobject_cast<QHexView *>(ui()->tabWidget_->currentWidget())->firstVisibleAddress();
 }
 
+//------------------------------------------------------------------------------
+// Name: set_region_tracked
+// Desc: adds or removes the region starting at <region_start> from the set of
+//       regions which are snapshotted at each stop
+//------------------------------------------------------------------------------
+void set_region_tracked(address_t region_start, bool tracked) {
+	ui()->setRegionTracked(region_start, tracked);
+}
+
+//------------------------------------------------------------------------------
+// Name: region_tracked
+// Desc:
+//------------------------------------------------------------------------------
+bool region_tracked(address_t region_start) {
+	return ui()->regionTracked(region_start);
+}
+
+//------------------------------------------------------------------------------
+// Name: memory_changes
+// Desc: returns what changed in the tracked regions between the last two stops
+//------------------------------------------------------------------------------
+const MemoryDiff &memory_changes() {
+	return ui()->memoryChanges();
+}
+
+//------------------------------------------------------------------------------
+// Name: set_instruction_heat
+// Desc: sets the sample counts which the disassembly view shades instructions
+//       by, an empty set clears the heat
+//------------------------------------------------------------------------------
+void set_instruction_heat(const QHash<address_t, uint64_t> &samples) {
+	ui()->cpuView_->setInstructionHeat(samples);
+}
+
 //------------------------------------------------------------------------------
 // Name: set_status
 // Desc:
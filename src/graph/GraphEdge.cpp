@@ -20,10 +20,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "GraphNode.h"
 #include "GraphWidget.h"
 
-#include <QGraphicsPolygonItem>
 #include <QPainter>
+#include <QPainterPath>
+#include <QPainterPathStroker>
+#include <QStyleOptionGraphicsItem>
 #include <QtDebug>
 
+#include <algorithm>
+
 namespace {
 
 constexpr int LineThickness = 2;
@@ -56,21 +60,18 @@ QPolygonF create_arrow(QLineF line, int size) {
 // Desc:
 //------------------------------------------------------------------------------
 GraphEdge::GraphEdge(GraphNode *from, GraphNode *to, const QColor &color, QGraphicsItem *parent)
-	: QGraphicsItemGroup(parent), from_(from), to_(to), graph_(from->graph_), color_(color) {
-
-	setFlag(QGraphicsItem::ItemHasNoContents, true);
+	: QGraphicsItem(parent), from_(from), to_(to), graph_(from->graph_), color_(color) {
 
 	Q_ASSERT(from->graph_ == to->graph_);
 
-	// we don't want this object to interfere with the line's events
-	setAcceptHoverEvents(false);
+	setAcceptHoverEvents(true);
+	setZValue(EdgeZValue);
 
 	from_->addEdge(this);
 	to_->addEdge(this);
 
-	graph_->scene()->addItem(this);
-
-	edge_ = agedge(graph_->graph_, from->node_, to->node_, nullptr, true);
+	// NOTE(eteran): the edge is added to the scene once it has been laid out
+	graph_->addEdge(this);
 }
 
 //------------------------------------------------------------------------------
@@ -82,7 +83,7 @@ GraphEdge::~GraphEdge() {
 	from_->removeEdge(this);
 	to_->removeEdge(this);
 
-	clear();
+	graph_->removeEdge(this);
 }
 
 //------------------------------------------------------------------------------
@@ -106,8 +107,9 @@ GraphNode *GraphEdge::to() const {
 // Desc:
 //------------------------------------------------------------------------------
 void GraphEdge::clear() {
-	const QList<QGraphicsItem *> items = childItems();
-	qDeleteAll(items);
+	prepareGeometryChange();
+	line_      = QLineF();
+	arrowHead_ = QPolygonF();
 }
 
 //------------------------------------------------------------------------------
@@ -140,40 +142,20 @@ QLineF GraphEdge::shortenLineToNode(QLineF line) {
 	return line;
 }
 
-//------------------------------------------------------------------------------
-// Name: createLineSegment
-// Desc:
-//------------------------------------------------------------------------------
-QGraphicsLineItem *GraphEdge::createLineSegment(const QLineF &line, const QPen &pen) {
-	auto l = new QGraphicsLineItem(line, this);
-	l->setPen(pen);
-	l->setAcceptHoverEvents(true);
-	l->setZValue(EdgeZValue);
-	return l;
-}
-
-//------------------------------------------------------------------------------
-// Name: createLineSegment
-// Desc:
-//------------------------------------------------------------------------------
-QGraphicsLineItem *GraphEdge::createLineSegment(const QPointF &p1, const QPointF &p2, const QPen &pen) {
-	return createLineSegment(QLineF(p1, p2), pen);
-}
-
 //------------------------------------------------------------------------------
 // Name: createLine
 // Desc:
 //------------------------------------------------------------------------------
 void GraphEdge::createLine() {
-	clear();
+	prepareGeometryChange();
 
 	const QPointF p1 = from_->sceneBoundingRect().center();
 	const QPointF p2 = to_->sceneBoundingRect().center();
-	const QPen pen(lineColor(), lineThickness(), Qt::SolidLine, Qt::RoundCap);
-	const QLineF line = shortenLineToNode(QLineF(p1, p2));
-	auto segment      = createLineSegment(line, pen);
-	addToGroup(segment);
-	addArrowHead(line);
+
+	const int arrowHeadSize = std::max(lineThickness() * 5, 20);
+
+	line_      = shortenLineToNode(QLineF(p1, p2));
+	arrowHead_ = create_arrow(line_, arrowHeadSize);
 }
 
 //------------------------------------------------------------------------------
@@ -185,40 +167,66 @@ void GraphEdge::syncState() {
 }
 
 //------------------------------------------------------------------------------
-// Name: addArrowHead
-// Desc:
+// Name: updateLines
+// Desc: replaces all of the lines with a single straight line
 //------------------------------------------------------------------------------
-QGraphicsPolygonItem *GraphEdge::addArrowHead(const QLineF &line, int lineThickness, const QColor &color, int ZValue) {
-
-	const int arrowHeadSize = std::max(lineThickness * 5, 20);
+void GraphEdge::updateLines() {
 
-	QPolygonF arrow = create_arrow(line, arrowHeadSize);
-	auto arrowHead  = new QGraphicsPolygonItem(this);
-	arrowHead->setPolygon(arrow);
-	arrowHead->setPen(QPen(color));
-	arrowHead->setBrush(QBrush(color));
-	arrowHead->setZValue(ZValue);
-	addToGroup(arrowHead);
-	return arrowHead;
+	if (!line_.isNull()) {
+		createLine();
+	}
 }
 
 //------------------------------------------------------------------------------
-// Name: addArrowHead
+// Name: boundingRect
 // Desc:
 //------------------------------------------------------------------------------
-QGraphicsPolygonItem *GraphEdge::addArrowHead(const QLineF &line) {
-	return addArrowHead(line, lineThickness(), lineColor(), EdgeZValue);
+QRectF GraphEdge::boundingRect() const {
+	const qreal extra = lineThickness() / 2.0;
+	return QRectF(line_.p1(), line_.p2()).normalized().united(arrowHead_.boundingRect()).adjusted(-extra, -extra, +extra, +extra);
 }
 
 //------------------------------------------------------------------------------
-// Name: updateLines
-// Desc: replaces all of the lines with a single straight line
+// Name: shape
+// Desc: just the line and the arrow head, so that the empty space around a
+//       diagonal edge doesn't hide what is under it
 //------------------------------------------------------------------------------
-void GraphEdge::updateLines() {
+QPainterPath GraphEdge::shape() const {
+	QPainterPath path(line_.p1());
+	path.lineTo(line_.p2());
 
-	if (!childItems().empty()) {
-		createLine();
+	QPainterPathStroker stroker;
+	stroker.setWidth(lineThickness());
+
+	QPainterPath shape = stroker.createStroke(path);
+	shape.addPolygon(arrowHead_);
+	return shape;
+}
+
+//------------------------------------------------------------------------------
+// Name: paint
+// Desc:
+//------------------------------------------------------------------------------
+void GraphEdge::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+
+	Q_UNUSED(widget)
+
+	if (line_.isNull()) {
+		return;
 	}
+
+	painter->save();
+	painter->setPen(QPen(lineColor(), lineThickness(), Qt::SolidLine, Qt::RoundCap));
+	painter->drawLine(line_);
+
+	// an arrow head would be a few pixels at most, so skip it
+	if (option->levelOfDetailFromTransform(painter->worldTransform()) >= MinimumArrowDetail) {
+		painter->setPen(QPen(lineColor()));
+		painter->setBrush(QBrush(lineColor()));
+		painter->drawPolygon(arrowHead_);
+	}
+
+	painter->restore();
 }
 
 //------------------------------------------------------------------------------
@@ -20,7 +20,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Configuration.h"
 #include "GraphEdge.h"
 #include "GraphWidget.h"
-#include "GraphvizHelper.h"
 #include "SyntaxHighlighter.h"
 #include "edb.h"
 
@@ -28,6 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QGraphicsColorizeEffect>
 #include <QPainter>
 #include <QPainterPath>
+#include <QStyleOptionGraphicsItem>
 #include <QtDebug>
 
 #include <cmath>
@@ -57,14 +57,8 @@ GraphNode::GraphNode(GraphWidget *graph, const QString &text, const QColor &colo
 
 	drawLabel(text);
 
-	graph->scene()->addItem(this);
-
-	QString name = QString("Node%1").arg(reinterpret_cast<uintptr_t>(this));
-	node_        = _agnode(graph->graph_, name);
-
-	_agset(node_, "fixedsize", "0");
-	_agset(node_, "width", QString("%1").arg(boundingRect().width() / 96.0));
-	_agset(node_, "height", QString("%1").arg(boundingRect().height() / 96.0));
+	// NOTE(eteran): the node is added to the scene once it has been laid out
+	graph->addNode(this);
 }
 
 //------------------------------------------------------------------------------
@@ -79,6 +73,8 @@ GraphNode::~GraphNode() {
 	Q_FOREACH (GraphEdge *const edge, edges_) {
 		delete edge;
 	}
+
+	graph_->removeNode(this);
 }
 
 //------------------------------------------------------------------------------
@@ -97,9 +93,15 @@ QRectF GraphNode::boundingRect() const {
 //------------------------------------------------------------------------------
 void GraphNode::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
 
-	Q_UNUSED(option)
 	Q_UNUSED(widget)
 
+	// too small to read, so just draw the box
+	if (option->levelOfDetailFromTransform(painter->worldTransform()) < MinimumLabelDetail) {
+		painter->fillRect(boundingRect(), BorderColor);
+		painter->fillRect(picture_.boundingRect(), color_);
+		return;
+	}
+
 	painter->save();
 
 	// draw border
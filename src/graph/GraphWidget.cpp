@@ -24,19 +24,29 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QAbstractAnimation>
 #include <QDebug>
+#include <QFutureWatcher>
 #include <QGraphicsOpacityEffect>
 #include <QGraphicsSceneMouseEvent>
 #include <QHBoxLayout>
+#include <QHash>
 #include <QKeyEvent>
 #include <QLabel>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QProgressBar>
 #include <QPropertyAnimation>
+#include <QPushButton>
 #include <QScrollBar>
+#include <QTimer>
 #include <QWheelEvent>
+#include <QtConcurrentRun>
 
 #include <graphviz/cgraph.h>
 #include <graphviz/gvc.h>
 
+#include <algorithm>
 #include <cmath>
+#include <utility>
 
 namespace {
 
@@ -44,10 +54,21 @@ constexpr int ScenePadding  = 30000;
 constexpr qreal ZoomFactor  = 1.2;
 constexpr qreal MinimumZoom = 0.001;
 constexpr qreal MaximumZoom = 8.000;
+
+// how many items are added to the scene at a time once a layout is done, the
+// GUI stays responsive in between
+constexpr std::size_t PopulateBatchSize = 1000;
 }
 
 namespace {
 
+// everything the layout engine needs to know about a graph, so that it can
+// run without touching the scene
+struct LayoutInput {
+	std::vector<QSizeF> nodes;
+	std::vector<std::pair<int, int>> edges;
+};
+
 qreal graph_height(Agraph_t *graph) {
 	return GD_bb(graph).UR.y;
 }
@@ -60,6 +81,73 @@ QPointF center_to_origin(const QPointF &p, qreal width, qreal height) {
 	return QPointF(p.x() - width / 2, p.y() - height / 2);
 }
 
+//------------------------------------------------------------------------------
+// Name: run_layout
+// Desc: builds a graphviz graph out of <input>, lays it out with dot and
+//       returns the center of each node. This runs on a worker thread
+//------------------------------------------------------------------------------
+std::vector<QPointF> run_layout(const LayoutInput &input) {
+
+	// NOTE(eteran): graphviz keeps global state, so only one layout may run at
+	// a time, even if several graphs are open
+	static QMutex mutex;
+	QMutexLocker locker(&mutex);
+
+	GVC_t *const context  = gvContext();
+	Agraph_t *const graph = _agopen("GraphName", Agstrictdirected);
+
+	// Set graph attributes
+	_agset(graph, "overlap", "prism");
+	_agset(graph, "pad", "0,2");
+	_agset(graph, "dpi", "96,0");
+	_agset(graph, "nodesep", "2,5");
+	_agset(graph, "nslimit", "1");
+	_agset(graph, "nslimit1", "1");
+	_agset(graph, "splines", "line"); // ugly but should be much faster
+
+	// Set default attributes for the future nodes
+	_agnodeattr(graph, "fixedsize", "false");
+	_agnodeattr(graph, "label", "");
+	_agnodeattr(graph, "regular", "true");
+
+	// Divide the wanted width by the DPI to get the value in points
+	QString nodePtsWidth = QString("%1").arg(NodeWidth / _agget(graph, "dpi", "96,0").toDouble());
+	// GV uses , instead of . for the separator in floats
+	_agnodeattr(graph, "width", nodePtsWidth.replace('.', ","));
+
+	std::vector<Agnode_t *> nodes;
+	nodes.reserve(input.nodes.size());
+
+	for (std::size_t i = 0; i < input.nodes.size(); ++i) {
+		Agnode_t *const node = _agnode(graph, QString("Node%1").arg(i));
+		_agset(node, "fixedsize", "0");
+		_agset(node, "width", QString("%1").arg(input.nodes[i].width() / 96.0));
+		_agset(node, "height", QString("%1").arg(input.nodes[i].height() / 96.0));
+		nodes.push_back(node);
+	}
+
+	for (const std::pair<int, int> &edge : input.edges) {
+		agedge(graph, nodes[edge.first], nodes[edge.second], nullptr, true);
+	}
+
+	qDebug() << "Starting Layout Engine";
+	gvLayout(context, graph, "dot");
+	qDebug() << "Layout Complete";
+
+	std::vector<QPointF> points;
+	points.reserve(nodes.size());
+
+	const qreal gheight = graph_height(graph);
+	for (Agnode_t *node : nodes) {
+		points.push_back(to_point(ND_coord(node), gheight));
+	}
+
+	gvFreeLayout(context, graph);
+	agclose(graph);
+	gvFreeContext(context);
+	return points;
+}
+
 }
 
 //------------------------------------------------------------------------------
@@ -74,6 +162,10 @@ GraphWidget::GraphWidget(QWidget *parent)
 #endif
 	setDragMode(ScrollHandDrag);
 
+	// the items paint only what they need for the current zoom and save and
+	// restore the painter themselves
+	setOptimizationFlags(QGraphicsView::DontSavePainterState | QGraphicsView::DontAdjustForAntialiasing);
+
 	setScene(new GraphicsScene(this));
 
 	// Setup the HUD
@@ -86,62 +178,24 @@ GraphWidget::GraphWidget(QWidget *parent)
 	HUDLayout_ = new QHBoxLayout(this);
 	HUDLayout_->addWidget(HUDLabel_);
 
-	context_ = gvContext();
-	graph_   = _agopen("GraphName", Agstrictdirected);
+	// the progress of a layout, shown in the corner while one is running
+	layoutPanel_ = new QWidget(this);
+	layoutPanel_->setAutoFillBackground(true);
+	layoutPanel_->hide();
 
-	// Set graph attributes
-	setGraphAttribute("overlap", "prism");
-	setGraphAttribute("pad", "0,2");
-	setGraphAttribute("dpi", "96,0");
-	setGraphAttribute("nodesep", "2,5");
-	setGraphAttribute("nslimit", "1");
-	setGraphAttribute("nslimit1", "1");
-	setGraphAttribute("splines", "line"); // ugly but should be much faster
+	layoutStatus_   = new QLabel(layoutPanel_);
+	layoutProgress_ = new QProgressBar(layoutPanel_);
 
-	// Set default attributes for the future nodes
-	setNodeAttribute("fixedsize", "false");
-	setNodeAttribute("label", "");
-	setNodeAttribute("regular", "true");
-
-	// Divide the wanted width by the DPI to get the value in points
-	QString nodePtsWidth = QString("%1").arg(NodeWidth / _agget(graph_, "dpi", "96,0").toDouble());
-	// GV uses , instead of . for the separator in floats
-	setNodeAttribute("width", nodePtsWidth.replace('.', ","));
-
-	// set font
-	QFont font = QFont("Arial");
-	setGraphAttribute("fontname", font.family());
-	setGraphAttribute("fontsize", QString("%1").arg(font.pointSizeF()));
-
-	setNodeAttribute("fontname", font.family());
-	setNodeAttribute("fontsize", QString("%1").arg(font.pointSizeF()));
-
-	setEdgeAttribute("fontname", font.family());
-	setEdgeAttribute("fontsize", QString("%1").arg(font.pointSizeF()));
-}
+	auto cancelButton = new QPushButton(tr("Cancel"), layoutPanel_);
+	connect(cancelButton, &QPushButton::clicked, this, &GraphWidget::cancelLayout);
 
-//------------------------------------------------------------------------------
-// Name: setGraphAttribute
-// Desc:
-//------------------------------------------------------------------------------
-void GraphWidget::setGraphAttribute(const QString name, const QString value) {
-	_agset(graph_, name, value);
-}
-
-//------------------------------------------------------------------------------
-// Name: setNodeAttribute
-// Desc:
-//------------------------------------------------------------------------------
-void GraphWidget::setNodeAttribute(const QString name, const QString value) {
-	_agnodeattr(graph_, name, value);
-}
+	auto panelLayout = new QHBoxLayout(layoutPanel_);
+	panelLayout->addWidget(layoutStatus_);
+	panelLayout->addWidget(layoutProgress_);
+	panelLayout->addWidget(cancelButton);
 
-//------------------------------------------------------------------------------
-// Name: setEdgeAttribute
-// Desc:
-//------------------------------------------------------------------------------
-void GraphWidget::setEdgeAttribute(const QString name, const QString value) {
-	_agedgeattr(graph_, name, value);
+	populateTimer_ = new QTimer(this);
+	connect(populateTimer_, &QTimer::timeout, this, &GraphWidget::populateBatch);
 }
 
 //------------------------------------------------------------------------------
@@ -171,39 +225,175 @@ void GraphWidget::setHUDNotification(const QString &s, int duration) {
 
 //------------------------------------------------------------------------------
 // Name: layout
-// Desc:
+// Desc: lays out the graph on a worker thread, using a copy of its structure.
+//       Once that is done, the nodes are moved into place and the items are
+//       added to the scene a batch at a time
 //------------------------------------------------------------------------------
 void GraphWidget::layout() {
 
+	cancelLayout();
+	const int generation = ++layoutGeneration_;
+
+	std::vector<GraphNode *> nodes(nodes_.begin(), nodes_.end());
+	QHash<GraphNode *, int> indexes;
+
+	LayoutInput input;
+	input.nodes.reserve(nodes.size());
+
+	for (std::size_t i = 0; i < nodes.size(); ++i) {
+		indexes.insert(nodes[i], static_cast<int>(i));
+		input.nodes.push_back(nodes[i]->boundingRect().size());
+	}
+
+	input.edges.reserve(edges_.size());
+	for (GraphEdge *edge : edges_) {
+		input.edges.emplace_back(indexes.value(edge->from()), indexes.value(edge->to()));
+	}
+
+	layoutStatus_->setText(tr("Laying out %1 nodes...").arg(nodes.size()));
+	layoutProgress_->setRange(0, 0);
+	layoutPanel_->adjustSize();
+	layoutPanel_->move(10, 10);
+	layoutPanel_->show();
+
+	auto watcher = new QFutureWatcher<std::vector<QPointF>>(this);
+	connect(watcher, &QFutureWatcher<std::vector<QPointF>>::finished, this, [this, watcher, generation, nodes]() {
+		watcher->deleteLater();
+
+		// cancelled, or another layout was started since
+		if (generation == layoutGeneration_) {
+			applyLayout(nodes, watcher->result());
+		}
+	});
+
+	watcher->setFuture(QtConcurrent::run(run_layout, input));
+}
+
+//------------------------------------------------------------------------------
+// Name: cancelLayout
+// Desc: stops waiting for a running layout and stops adding its items.
+//       graphviz can't be interrupted, so a running layout still finishes in
+//       the background, but its result is ignored
+//------------------------------------------------------------------------------
+void GraphWidget::cancelLayout() {
+	++layoutGeneration_;
+	populateTimer_->stop();
+	pendingNodes_.clear();
+	pendingEdges_.clear();
+	layoutPanel_->hide();
+}
+
+//------------------------------------------------------------------------------
+// Name: applyLayout
+// Desc: moves <nodes> to the centers the layout found for them and starts
+//       adding the items to the scene
+//------------------------------------------------------------------------------
+void GraphWidget::applyLayout(const std::vector<GraphNode *> &nodes, const std::vector<QPointF> &points) {
+
 	inLayout_ = true;
 
-	qDebug() << "Starting Layout Engine";
+	for (std::size_t i = 0; i < nodes.size(); ++i) {
+		GraphNode *const node = nodes[i];
 
-	gvFreeLayout(context_, graph_);
-	gvLayout(context_, graph_, "dot");
+		// nodes may have been deleted while the layout was running
+		if (nodes_.contains(node)) {
+			const QRectF rect = node->boundingRect();
+			node->setPos(center_to_origin(points[i], rect.width(), rect.height()));
+			pendingNodes_.push_back(node);
+		}
+	}
+
+	inLayout_ = false;
+
+	pendingEdges_.assign(edges_.begin(), edges_.end());
+	pendingDone_ = 0;
+
+	// NOTE(eteran): maintaining the index while tens of thousands of items are
+	// added one by one is far slower than building it once at the end
+	scene()->setItemIndexMethod(QGraphicsScene::NoIndex);
+
+	layoutStatus_->setText(tr("Adding items..."));
+	layoutProgress_->setRange(0, static_cast<int>(pendingNodes_.size() + pendingEdges_.size()));
+	layoutProgress_->setValue(0);
+	layoutPanel_->adjustSize();
+
+	populateTimer_->start(0);
+}
+
+//------------------------------------------------------------------------------
+// Name: populateBatch
+// Desc: adds the next batch of laid out items to the scene, nodes first and
+//       then the edges between them
+//------------------------------------------------------------------------------
+void GraphWidget::populateBatch() {
 
-	Q_FOREACH (QGraphicsItem *item, items()) {
-		if (auto node = qgraphicsitem_cast<GraphNode *>(item)) {
-			qreal gheight = graph_height(graph_);
-			if (auto internalNode = node->node_) {
-				QPointF point = to_point(ND_coord(internalNode), gheight);
-				node->setPos(center_to_origin(point, node->boundingRect().width(), node->boundingRect().height()));
+	const std::size_t total = pendingNodes_.size() + pendingEdges_.size();
+	const std::size_t last  = std::min(pendingDone_ + PopulateBatchSize, total);
+
+	for (; pendingDone_ < last; ++pendingDone_) {
+		if (pendingDone_ < pendingNodes_.size()) {
+			GraphNode *const node = pendingNodes_[pendingDone_];
+			if (nodes_.contains(node) && !node->scene()) {
+				scene()->addItem(node);
+			}
+		} else {
+			GraphEdge *const edge = pendingEdges_[pendingDone_ - pendingNodes_.size()];
+			if (edges_.contains(edge)) {
+				edge->syncState();
+				if (!edge->scene()) {
+					scene()->addItem(edge);
+				}
 			}
 		}
 	}
 
-	Q_FOREACH (QGraphicsItem *item, items()) {
-		if (auto edge = qgraphicsitem_cast<GraphEdge *>(item)) {
-			edge->syncState();
-		}
+	layoutProgress_->setValue(static_cast<int>(pendingDone_));
+
+	if (pendingDone_ == total) {
+		populateTimer_->stop();
+		pendingNodes_.clear();
+		pendingEdges_.clear();
+
+		// the index is what lets the view only visit the visible items
+		scene()->setItemIndexMethod(QGraphicsScene::BspTreeIndex);
+
+		// make the scene HUGE so it feels like you can just scroll forever
+		scene()->setSceneRect(scene()->itemsBoundingRect().adjusted(-ScenePadding, -ScenePadding, +ScenePadding, +ScenePadding));
+
+		layoutPanel_->hide();
 	}
+}
 
-	qDebug() << "Layout Complete";
+//------------------------------------------------------------------------------
+// Name: addNode
+// Desc:
+//------------------------------------------------------------------------------
+void GraphWidget::addNode(GraphNode *node) {
+	nodes_.insert(node);
+}
+
+//------------------------------------------------------------------------------
+// Name: removeNode
+// Desc:
+//------------------------------------------------------------------------------
+void GraphWidget::removeNode(GraphNode *node) {
+	nodes_.remove(node);
+}
 
-	// make the scene HUGE so it feels like you can just scroll forever
-	scene()->setSceneRect(sceneRect().adjusted(-ScenePadding, -ScenePadding, +ScenePadding, +ScenePadding));
+//------------------------------------------------------------------------------
+// Name: addEdge
+// Desc:
+//------------------------------------------------------------------------------
+void GraphWidget::addEdge(GraphEdge *edge) {
+	edges_.insert(edge);
+}
 
-	inLayout_ = false;
+//------------------------------------------------------------------------------
+// Name: removeEdge
+// Desc:
+//------------------------------------------------------------------------------
+void GraphWidget::removeEdge(GraphEdge *edge) {
+	edges_.remove(edge);
 }
 
 //------------------------------------------------------------------------------
@@ -211,9 +401,10 @@ void GraphWidget::layout() {
 // Desc:
 //------------------------------------------------------------------------------
 GraphWidget::~GraphWidget() {
-	gvFreeLayout(context_, graph_);
-	agclose(graph_);
-	gvFreeContext(context_);
+
+	// NOTE(eteran): items which haven't been added to the scene yet are only
+	// owned by us
+	clear();
 }
 
 //------------------------------------------------------------------------------
@@ -301,11 +492,8 @@ void GraphWidget::contextMenuEvent(QContextMenuEvent *event) {
 
 	if (auto node = qgraphicsitem_cast<GraphNode *>(item)) {
 		Q_EMIT nodeContextMenuEvent(event, node);
-	} else if (const auto node = qgraphicsitem_cast<QGraphicsLineItem *>(item)) {
-		auto parent = node->parentItem();
-		if (const auto edge = qgraphicsitem_cast<GraphEdge *>(parent)) {
-			Q_UNUSED(edge)
-		}
+	} else if (const auto edge = qgraphicsitem_cast<GraphEdge *>(item)) {
+		Q_UNUSED(edge)
 	} else {
 		Q_EMIT backgroundContextMenuEvent(event);
 	}
@@ -321,11 +509,8 @@ void GraphWidget::mouseDoubleClickEvent(QMouseEvent *event) {
 
 	if (auto node = qgraphicsitem_cast<GraphNode *>(item)) {
 		Q_EMIT nodeDoubleClickEvent(event, node);
-	} else if (const auto node = qgraphicsitem_cast<QGraphicsLineItem *>(item)) {
-		auto parent = node->parentItem();
-		if (const auto edge = qgraphicsitem_cast<GraphEdge *>(parent)) {
-			Q_UNUSED(edge)
-		}
+	} else if (const auto edge = qgraphicsitem_cast<GraphEdge *>(item)) {
+		Q_UNUSED(edge)
 	} else {
 	}
 }
@@ -335,5 +520,13 @@ void GraphWidget::mouseDoubleClickEvent(QMouseEvent *event) {
 // Desc:
 //------------------------------------------------------------------------------
 void GraphWidget::clear() {
-	qDeleteAll(scene()->items());
+	cancelLayout();
+
+	// NOTE(eteran): we delete copies of the sets, because deleting an item
+	// removes it from them. Deleting a node also deletes its edges
+	const QSet<GraphNode *> nodes = nodes_;
+	qDeleteAll(nodes);
+
+	const QSet<GraphEdge *> edges = edges_;
+	qDeleteAll(edges);
 }
@@ -133,7 +133,7 @@ void load_plugins(const QString &directory) {
 						edb::v1::debugger_core = core_plugin;
 
 						// load in the settings that the core needs
-						edb::v1::debugger_core->setIgnoredExceptions(edb::v1::config().ignored_exceptions);
+						edb::v1::debugger_core->setExceptionDispositions(edb::v1::config().exceptionDispositions());
 					}
 				} else if (qobject_cast<IPlugin *>(plugin)) {
 					if (edb::internal::register_plugin(full_path, plugin)) {
@@ -0,0 +1,268 @@
+// Measures how long the DebuggerCore plugin takes to capture a process with
+// many threads, both by attaching to a running one and by launching one, and
+// how long it then takes to stop all of them again once they are running.
+// The plugin is loaded the same way edb loads it, and is driven through its
+// public interface, so that this measures what the user waits for.
+//
+// usage: AttachBenchmark <path to DebuggerCore plugin> <path to AttachTarget> [thread count] [rounds]
+
+#include "IDebugEvent.h"
+#include "IDebugger.h"
+#include "IProcess.h"
+#include "IThread.h"
+#include "Status.h"
+#include "edb.h"
+
+#include <QApplication>
+#include <QDir>
+#include <QPluginLoader>
+#include <QSettings>
+#include <QTemporaryDir>
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define TEST(expr)                                                  \
+	do {                                                            \
+		if (!(expr)) {                                              \
+			fprintf(stderr, "FAILED: [@%d] %s\n", __LINE__, #expr); \
+			abort();                                                \
+		}                                                           \
+	} while (0)
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// tells CTest that the test was skipped, see SKIP_RETURN_CODE
+constexpr int SkipReturnCode = 77;
+
+// how long the threads of a launched target get to all start
+constexpr std::chrono::seconds StartTimeout(30);
+
+struct Timings {
+	clock_type::duration capture{};
+	clock_type::duration stopAll{};
+};
+
+/**
+ * @brief milliseconds
+ * @param duration
+ * @param rounds
+ * @return
+ */
+double milliseconds(clock_type::duration duration, int rounds) {
+	return std::chrono::duration<double, std::milli>(duration).count() / rounds;
+}
+
+/**
+ * @brief spawn_target
+ * @param path
+ * @param threads
+ * @return the pid of the target, once all of its threads are running
+ */
+pid_t spawn_target(const char *path, int threads) {
+
+	int fds[2];
+	TEST(pipe(fds) == 0);
+
+	const std::string count = std::to_string(threads);
+
+	const pid_t pid = fork();
+	TEST(pid != -1);
+
+	if (pid == 0) {
+		dup2(fds[1], STDOUT_FILENO);
+		close(fds[0]);
+		close(fds[1]);
+		execl(path, path, count.c_str(), static_cast<char *>(nullptr));
+		_exit(EXIT_FAILURE);
+	}
+
+	close(fds[1]);
+
+	char ready;
+	TEST(read(fds[0], &ready, 1) == 1);
+	close(fds[0]);
+	return pid;
+}
+
+/**
+ * @brief stop_all
+ *
+ * Pauses the running debuggee. The pause is reported once every thread is
+ * stopped again.
+ *
+ * @return how long the pause took
+ */
+clock_type::duration stop_all() {
+
+	IProcess *process = edb::v1::debugger_core->process();
+	TEST(process);
+
+	const clock_type::time_point start = clock_type::now();
+	TEST(process->pause());
+
+	for (;;) {
+		if (std::shared_ptr<IDebugEvent> event = edb::v1::debugger_core->waitDebugEvent(std::chrono::milliseconds(1000))) {
+			TEST(event->isStop());
+			break;
+		}
+	}
+
+	const clock_type::duration elapsed = clock_type::now() - start;
+	TEST(process->isPaused());
+	return elapsed;
+}
+
+/**
+ * @brief wait_for_threads
+ *
+ * Runs the debuggee until it has <count> threads, the clone events of the new
+ * threads are dealt with along the way. It is left running.
+ *
+ * @param count
+ */
+void wait_for_threads(int count) {
+
+	IProcess *process = edb::v1::debugger_core->process();
+	TEST(process);
+	TEST(process->resume(edb::DEBUG_CONTINUE));
+
+	const clock_type::time_point deadline = clock_type::now() + StartTimeout;
+	while (process->threads().size() < count) {
+		TEST(clock_type::now() < deadline);
+
+		// every event besides the clone events would be a surprise here
+		TEST(!edb::v1::debugger_core->waitDebugEvent(std::chrono::milliseconds(10)));
+	}
+}
+
+/**
+ * @brief measure_attach
+ * @param target
+ * @param threads
+ * @param rounds
+ * @param timings
+ * @return false if attaching isn't permitted
+ */
+bool measure_attach(const char *target, int threads, int rounds, Timings *timings) {
+
+	const pid_t pid = spawn_target(target, threads);
+
+	bool permitted = true;
+	for (int i = 0; i < rounds; ++i) {
+
+		const clock_type::time_point start = clock_type::now();
+		const Status status                = edb::v1::debugger_core->attach(pid);
+		if (!status) {
+			// only the first attempt tells us whether we may attach at all
+			fprintf(stderr, "attach: %s\n", qPrintable(status.error()));
+			TEST(i == 0);
+			permitted = false;
+			break;
+		}
+		timings->capture += clock_type::now() - start;
+
+		// the main thread and every thread it started
+		IProcess *process = edb::v1::debugger_core->process();
+		TEST(process->threads().size() == threads + 1);
+
+		TEST(process->resume(edb::DEBUG_CONTINUE));
+		timings->stopAll += stop_all();
+		TEST(edb::v1::debugger_core->detach());
+	}
+
+	kill(pid, SIGKILL);
+	waitpid(pid, nullptr, 0);
+	return permitted;
+}
+
+/**
+ * @brief measure_launch
+ * @param target
+ * @param threads
+ * @param rounds
+ * @param timings
+ * @return false if launching under the debugger isn't permitted
+ */
+bool measure_launch(const char *target, int threads, int rounds, Timings *timings) {
+
+	const QList<QByteArray> args = {QByteArray::number(threads)};
+
+	for (int i = 0; i < rounds; ++i) {
+
+		// from the fork until every thread runs under the debugger
+		const clock_type::time_point start = clock_type::now();
+		const Status status                = edb::v1::debugger_core->open(target, QDir::currentPath(), args, QString(), "/dev/null");
+		if (!status) {
+			fprintf(stderr, "launch: %s\n", qPrintable(status.error()));
+			TEST(i == 0);
+			return false;
+		}
+
+		wait_for_threads(threads + 1);
+		timings->capture += clock_type::now() - start;
+
+		timings->stopAll += stop_all();
+		edb::v1::debugger_core->kill();
+	}
+
+	return true;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+
+	if (argc < 3) {
+		fprintf(stderr, "usage: %s <DebuggerCore plugin> <target> [threads] [rounds]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const int threads = (argc > 3) ? std::atoi(argv[3]) : 256;
+	const int rounds  = (argc > 4) ? std::atoi(argv[4]) : 3;
+
+	QApplication app(argc, argv);
+
+	// keep the settings of a real edb out of this, in particular the ones
+	// the core and its dialogs ask for
+	QTemporaryDir settingsDir;
+	TEST(settingsDir.isValid());
+	QSettings::setPath(QSettings::NativeFormat, QSettings::UserScope, settingsDir.path());
+	QApplication::setOrganizationName("codef00.com");
+	QApplication::setApplicationName("AttachBenchmark");
+	QSettings().setValue("DebuggerCore/warn_on_broken_proc_mem.enabled", false);
+
+	QPluginLoader loader(argv[1]);
+	loader.setLoadHints(QLibrary::ExportExternalSymbolsHint);
+
+	edb::v1::debugger_core = qobject_cast<IDebugger *>(loader.instance());
+	if (!edb::v1::debugger_core) {
+		fprintf(stderr, "FAILED: unable to load the debugger core: %s\n", qPrintable(loader.errorString()));
+		return EXIT_FAILURE;
+	}
+
+	edb::v1::debugger_core->setExceptionDispositions(edb::v1::config().exceptionDispositions());
+
+	Timings attach;
+	Timings launch;
+
+	const bool permitted = measure_attach(argv[2], threads, rounds, &attach) &&
+						   measure_launch(argv[2], threads, rounds, &launch);
+
+	if (!permitted) {
+		fprintf(stderr, "SKIPPED: ptrace is not permitted here\n");
+		return SkipReturnCode;
+	}
+
+	printf("%-8s %5d threads: %8.3f ms, stopping all: %8.3f ms\n", "attach", threads + 1, milliseconds(attach.capture, rounds), milliseconds(attach.stopAll, rounds));
+	printf("%-8s %5d threads: %8.3f ms, stopping all: %8.3f ms\n", "launch", threads + 1, milliseconds(launch.capture, rounds), milliseconds(launch.stopAll, rounds));
+}
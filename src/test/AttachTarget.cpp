@@ -0,0 +1,54 @@
+// A synthetic debuggee for AttachBenchmark. It starts the requested number of
+// threads, a quarter of which spin while the rest sleep, writes a byte to stdout
+// once they are all running, and then waits to be killed.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+std::atomic<int> running(0);
+
+void spin() {
+	++running;
+	for (;;) {
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+	}
+}
+
+void nap() {
+	++running;
+	for (;;) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+}
+
+}
+
+int main(int argc, char *argv[]) {
+
+	const int count = (argc > 1) ? std::atoi(argv[1]) : 256;
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < count; ++i) {
+		threads.emplace_back((i % 4 == 0) ? spin : nap);
+	}
+
+	while (running != count) {
+		std::this_thread::yield();
+	}
+
+	const char ready = '!';
+	if (write(STDOUT_FILENO, &ready, 1) != 1) {
+		return EXIT_FAILURE;
+	}
+
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+}
@@ -0,0 +1,100 @@
+
+#include "SyscallTable.h"
+#include <QDomDocument>
+#include <QFile>
+#include <cstdio>
+#include <cstdlib>
+
+#define TEST(expr)                                                  \
+	do {                                                            \
+		if (!(expr)) {                                              \
+			fprintf(stderr, "FAILED: [@%d] %s\n", __LINE__, #expr); \
+			abort();                                                \
+		}                                                           \
+	} while (0)
+
+namespace {
+
+// checks every syscall of <abi> against the generated table, and that the
+// table has nothing which isn't in the XML
+template <std::size_t N>
+void testArch(const QDomElement &abi, const SyscallEntry (&table)[N]) {
+
+	std::size_t count = 0;
+
+	for (QDomElement syscall = abi.firstChildElement("syscall"); !syscall.isNull(); syscall = syscall.nextSiblingElement("syscall")) {
+
+		bool ok;
+		const uint number = syscall.firstChildElement("index").text().toUInt(&ok);
+		TEST(ok);
+
+		const SyscallEntry *const entry = find_syscall(table, number);
+		TEST(entry);
+		TEST(syscall.attribute("name") == QLatin1String(entry->name));
+
+		std::size_t i = 0;
+		for (QDomElement argument = syscall.firstChildElement("argument"); !argument.isNull(); argument = argument.nextSiblingElement("argument")) {
+			TEST(i < entry->argumentCount);
+			TEST(argument.attribute("type") == QLatin1String(entry->arguments[i].type));
+			TEST(argument.attribute("register") == QLatin1String(entry->arguments[i].reg));
+			++i;
+		}
+
+		TEST(i == entry->argumentCount);
+		++count;
+	}
+
+	std::size_t entries = 0;
+	for (const SyscallEntry &entry : table) {
+		if (entry.name) {
+			++entries;
+		}
+	}
+
+	TEST(count != 0);
+	TEST(count == entries);
+	TEST(!find_syscall(table, N));
+}
+
+void testSyscallTable() {
+	QFile file(SYSCALLS_XML);
+	TEST(file.open(QIODevice::ReadOnly));
+
+	QDomDocument doc;
+	TEST(doc.setContent(&file));
+
+	const QDomElement root = doc.firstChildElement("syscalls");
+	TEST(!root.isNull());
+
+	bool seen_x86    = false;
+	bool seen_x86_64 = false;
+
+	for (QDomElement abi = root.firstChildElement("linux"); !abi.isNull(); abi = abi.nextSiblingElement("linux")) {
+		const QString arch = abi.attribute("arch");
+		if (arch == "x86") {
+			testArch(abi, SyscallsX86);
+			seen_x86 = true;
+		} else if (arch == "x86-64") {
+			testArch(abi, SyscallsX86_64);
+			seen_x86_64 = true;
+		} else {
+			TEST(!"unexpected architecture");
+		}
+	}
+
+	TEST(seen_x86 && seen_x86_64);
+}
+
+void testFindSyscall() {
+	TEST(find_syscall(false, 1) == &SyscallsX86[1]);
+	TEST(find_syscall(true, 1) == &SyscallsX86_64[1]);
+	TEST(!find_syscall(false, 0xffffffff));
+	TEST(!find_syscall(true, 0xffffffff));
+}
+
+}
+
+int main() {
+	testSyscallTable();
+	testFindSyscall();
+}
@@ -827,6 +827,30 @@ void QDisassemblyView::drawHeaderAndBackground(QPainter &painter, const DrawingC
 	painter.restore();
 }
 
+//------------------------------------------------------------------------------
+// Name: drawInstructionHeat
+// Desc: draws a bar behind the bytes of each sampled instruction, as long as
+//       its share of the hottest instruction's samples
+//------------------------------------------------------------------------------
+void QDisassemblyView::drawInstructionHeat(QPainter &painter, const DrawingContext *ctx) {
+
+	if (heat_.isEmpty() || maxHeat_ == 0) {
+		return;
+	}
+
+	const int width = ctx->l3 - ctx->l2;
+
+	for (int line = 0; line < ctx->linesToRender; ++line) {
+		auto it = heat_.find(showAddresses_[line]);
+		if (it == heat_.end()) {
+			continue;
+		}
+
+		const double share = static_cast<double>(*it) / maxHeat_;
+		painter.fillRect(ctx->l2, line * ctx->lineHeight, std::max(1, static_cast<int>(width * share)), ctx->lineHeight, QColor(255, 64, 0, 64 + static_cast<int>(128 * share)));
+	}
+}
+
 //------------------------------------------------------------------------------
 // Name: drawRegiserBadges
 // Desc:
@@ -836,10 +860,13 @@ void QDisassemblyView::drawRegiserBadges(QPainter &painter, DrawingContext *ctx)
 	painter.save();
 	if (IProcess *process = edb::v1::debugger_core->process()) {
 
-		if (process->isPaused()) {
+		// NOTE(eteran): in non-stop mode, only the current thread needs to be
+		// paused for its registers to be read
+		std::shared_ptr<IThread> thread = process->currentThread();
+		if (thread && thread->isPaused()) {
 
 			State state;
-			process->currentThread()->getState(&state);
+			thread->getState(&state);
 
 			std::vector<QString> badge_labels(ctx->linesToRender);
 			{
@@ -1604,6 +1631,7 @@ void QDisassemblyView::paintEvent(QPaintEvent *) {
 		std::map<int, int>()};
 
 	drawHeaderAndBackground(painter, &context, binary_info);
+	drawInstructionHeat(painter, &context);
 
 	if (edb::v1::config().show_register_badges) {
 		drawRegiserBadges(painter, &context);
@@ -2123,6 +2151,21 @@ void QDisassemblyView::clearComments() {
 	comments_.clear();
 }
 
+//------------------------------------------------------------------------------
+// Name: setInstructionHeat
+// Desc: Sets the sample counts which instructions are shaded by.
+//------------------------------------------------------------------------------
+void QDisassemblyView::setInstructionHeat(const QHash<edb::address_t, uint64_t> &samples) {
+	heat_    = samples;
+	maxHeat_ = 0;
+
+	for (uint64_t count : heat_) {
+		maxHeat_ = std::max(maxHeat_, count);
+	}
+
+	viewport()->update();
+}
+
 //------------------------------------------------------------------------------
 // Name: saveState
 // Desc:
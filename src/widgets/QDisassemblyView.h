@@ -87,6 +87,7 @@ public:
 	void restoreComments(QVariantList &);
 	void restoreState(const QByteArray &stateBuffer);
 	void setSelectedAddress(edb::address_t address);
+	void setInstructionHeat(const QHash<edb::address_t, uint64_t> &samples);
 
 Q_SIGNALS:
 	void signalUpdated();
@@ -132,6 +133,7 @@ private:
 
 	void drawInstruction(QPainter &painter, const edb::Instruction &inst, const DrawingContext *ctx, int y, bool selected);
 	void drawHeaderAndBackground(QPainter &painter, const DrawingContext *ctx, const std::unique_ptr<IBinary> &binary_info);
+	void drawInstructionHeat(QPainter &painter, const DrawingContext *ctx);
 	void drawRegiserBadges(QPainter &painter, DrawingContext *ctx);
 	void drawSymbolNames(QPainter &painter, const DrawingContext *ctx);
 	void drawSidebarElements(QPainter &painter, const DrawingContext *ctx);
@@ -175,6 +177,8 @@ private:
 	SyntaxHighlighter *highlighter_;
 	bool showAddressSeparator_;
 	QHash<edb::address_t, QString> comments_;
+	QHash<edb::address_t, uint64_t> heat_;
+	uint64_t maxHeat_ = 0;
 	NavigationHistory history_;
 	QSvgRenderer breakpointRenderer_;
 	QSvgRenderer currentRenderer_;